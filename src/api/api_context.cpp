@@ -129,9 +129,13 @@ namespace api {
             SASSERT(m_ctx.m_interruptable == 0);
             m_ctx.m_interruptable = &i;
         }
+        m_ctx.m_memory_budget.reset();
+        m_ctx.m_memory_budget.set_max_size(megabytes_to_bytes(m_ctx.m_params.m_memory_budget));
+        m_old_budget = memory::set_thread_budget(&m_ctx.m_memory_budget);
     }
 
     context::set_interruptable::~set_interruptable() {
+        memory::set_thread_budget(m_old_budget);
         #pragma omp critical (set_interruptable) 
         {
             m_ctx.m_interruptable = 0;
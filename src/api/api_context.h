@@ -93,11 +93,14 @@ namespace api {
         Z3_ast_print_mode          m_print_mode;
 
         event_handler *            m_interruptable; // Reference to an object that can be interrupted by Z3_interrupt
+        memory_budget              m_memory_budget; // Memory allocated while m_interruptable is set
 
      public:
-        // Scoped obj for setting m_interruptable
+        // Scoped obj for setting m_interruptable.
+        // It also charges the memory allocated by the current thread to the budget of the context.
         class set_interruptable {
-            context & m_ctx;
+            context &       m_ctx;
+            memory_budget * m_old_budget;
         public:
             set_interruptable(context & ctx, event_handler & i);
             ~set_interruptable();
@@ -1305,7 +1305,8 @@ decl_plugin * user_sort_plugin::mk_fresh() {
 // -----------------------------------
 
 ast_manager::ast_manager(proof_gen_mode m, char const * trace_file, bool is_format_manager):
-    m_alloc("ast_manager"),
+    m_chunk_alloc(mk_context_chunk_allocator()),
+    m_alloc("ast_manager", m_chunk_alloc.get()),
     m_expr_array_manager(*this, m_alloc),
     m_expr_dependency_manager(*this, m_alloc),
     m_expr_dependency_array_manager(*this, m_alloc),
@@ -1327,7 +1328,8 @@ ast_manager::ast_manager(proof_gen_mode m, char const * trace_file, bool is_form
 }
 
 ast_manager::ast_manager(proof_gen_mode m, std::fstream * trace_stream, bool is_format_manager):
-    m_alloc("ast_manager"),
+    m_chunk_alloc(mk_context_chunk_allocator()),
+    m_alloc("ast_manager", m_chunk_alloc.get()),
     m_expr_array_manager(*this, m_alloc),
     m_expr_dependency_manager(*this, m_alloc),
     m_expr_dependency_array_manager(*this, m_alloc),
@@ -1344,7 +1346,8 @@ ast_manager::ast_manager(proof_gen_mode m, std::fstream * trace_stream, bool is_
 }
 
 ast_manager::ast_manager(ast_manager const & src, bool disable_proofs):
-    m_alloc("ast_manager"),
+    m_chunk_alloc(mk_context_chunk_allocator()),
+    m_alloc("ast_manager", m_chunk_alloc.get()),
     m_expr_array_manager(*this, m_alloc),
     m_expr_dependency_manager(*this, m_alloc),
     m_expr_dependency_array_manager(*this, m_alloc),
@@ -1498,6 +1501,13 @@ ast_manager::~ast_manager() {
     }
 }
 
+void ast_manager::disable_trace_stream() {
+    SASSERT(!m_trace_stream_owner);
+    m_trace_stream = 0;
+    if (m_format_manager != 0)
+        m_format_manager->m_trace_stream = 0;
+}
+
 void ast_manager::compact_memory() {
     m_alloc.consolidate();
     unsigned capacity = m_ast_table.capacity();
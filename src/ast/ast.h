@@ -1425,6 +1425,7 @@ public:
 
 protected:
     reslimit                  m_limit;
+    scoped_ptr<chunk_allocator> m_chunk_alloc; // arena of this manager, 0 if the default backend is used
     small_object_allocator    m_alloc;
     family_manager            m_family_manager;
     expr_array_manager        m_expr_array_manager;
@@ -1475,6 +1476,11 @@ public:
 
     bool has_trace_stream() const { return m_trace_stream != 0; }
     std::ostream & trace_stream() { SASSERT(has_trace_stream()); return *m_trace_stream; }
+    /**
+       \brief Stop writing to the trace stream shared with the manager this manager was copied from.
+       It is used by managers that run concurrently with the source manager.
+    */
+    void disable_trace_stream();
 
     void enable_int_real_coercions(bool f) { m_int_real_coercions = f; }
     bool int_real_coercions() const { return m_int_real_coercions; }
@@ -25,6 +25,7 @@ Notes:
 #include"ast_util.h"
 #include"ast_pp.h"
 #include"lbool.h"
+#include"gparams.h"
 
 
 struct pb2bv_rewriter::imp {
@@ -35,6 +36,7 @@ struct pb2bv_rewriter::imp {
     func_decl_ref_vector      m_fresh;       // all fresh variables
     unsigned_vector           m_fresh_lim;
     unsigned                  m_num_translated;
+    bool                      m_keep_cardinality_constraints;
 
     struct card2bv_rewriter {               
         typedef expr* literal;
@@ -243,24 +245,27 @@ struct pb2bv_rewriter::imp {
 
         bool mk_app(bool full, func_decl * f, unsigned sz, expr * const* args, expr_ref & result) {
             if (f->get_family_id() == pb.get_family_id()) {
+                if (keep_pb(f, sz)) {
+                    return false;
+                }
                 mk_pb(full, f, sz, args, result);
             }
             else if (au.is_le(f) && is_pb(args[0], args[1])) {
-                result = mk_le_ge<l_true>(m_args.size(), m_args.c_ptr(), m_k);
+                result = mk_pb_or_bv<l_true>(m_args.size(), m_args.c_ptr(), m_k);
             }
             else if (au.is_lt(f) && is_pb(args[0], args[1])) {
                 ++m_k;
-                result = mk_le_ge<l_true>(m_args.size(), m_args.c_ptr(), m_k);
+                result = mk_pb_or_bv<l_true>(m_args.size(), m_args.c_ptr(), m_k);
             }
             else if (au.is_ge(f) && is_pb(args[1], args[0])) {
-                result = mk_le_ge<l_true>(m_args.size(), m_args.c_ptr(), m_k);
+                result = mk_pb_or_bv<l_true>(m_args.size(), m_args.c_ptr(), m_k);
             }
             else if (au.is_gt(f) && is_pb(args[1], args[0])) {
                 ++m_k;
-                result = mk_le_ge<l_true>(m_args.size(), m_args.c_ptr(), m_k);
+                result = mk_pb_or_bv<l_true>(m_args.size(), m_args.c_ptr(), m_k);
             }
             else if (m.is_eq(f) && is_pb(args[0], args[1])) {
-                result = mk_le_ge<l_undef>(m_args.size(), m_args.c_ptr(), m_k);
+                result = mk_pb_or_bv<l_undef>(m_args.size(), m_args.c_ptr(), m_k);
             }
             else {
                 return false;
@@ -269,6 +274,40 @@ struct pb2bv_rewriter::imp {
             return true;
         }
 
+        // The SAT solver handles constraints with integer coefficients and bounds that fit in 31 bits.
+        bool is_small(rational const& k, unsigned sz, rational const* coeffs) const {
+            if (!k.is_int()) return false;
+            rational sum = abs(k);
+            for (unsigned i = 0; i < sz; ++i) {
+                if (!coeffs[i].is_int()) return false;
+                sum += abs(coeffs[i]);
+            }
+            return sum < rational(INT_MAX);
+        }
+
+        bool keep_pb(func_decl * f, unsigned sz) {
+            if (!m_imp.m_keep_cardinality_constraints || is_or(f)) {
+                return false;
+            }
+            m_coeffs.reset();
+            for (unsigned i = 0; i < sz; ++i) {
+                m_coeffs.push_back(pb.get_coeff(f, i));
+            }
+            return is_small(pb.get_k(f), sz, m_coeffs.c_ptr());
+        }
+
+        // sum m_coeffs[i]*args[i] <= k (is_le = l_true) or = k (is_le = l_undef).
+        template<lbool is_le>
+        expr_ref mk_pb_or_bv(unsigned sz, expr * const* args, rational const & k) {
+            if (m_imp.m_keep_cardinality_constraints && is_small(k, sz, m_coeffs.c_ptr())) {
+                if (is_le == l_true) {
+                    return expr_ref(pb.mk_le(sz, m_coeffs.c_ptr(), args, k), m);
+                }
+                return expr_ref(pb.mk_eq(sz, m_coeffs.c_ptr(), args, k), m);
+            }
+            return mk_le_ge<is_le>(sz, args, k);
+        }
+
         br_status mk_app_core(func_decl * f, unsigned sz, expr * const* args, expr_ref & result) {
             if (mk_app(true, f, sz, args, result)) {
                 return BR_DONE;
@@ -423,10 +462,21 @@ struct pb2bv_rewriter::imp {
         m(m), m_params(p), m_lemmas(m),
         m_fresh(m),
         m_num_translated(0), 
+        m_keep_cardinality_constraints(keep_cardinality_constraints(p)),
         m_rw(*this, m) {
     }
 
-    void updt_params(params_ref const & p) {}
+    // cardinality constraints are kept when the SAT solver handles them natively.
+    static bool keep_cardinality_constraints(params_ref const & p) {
+        return 
+            p.get_bool("keep_cardinality_constraints", false) ||
+            p.get_bool("cardinality.solver", gparams::get_module("sat"), false);
+    }
+
+    void updt_params(params_ref const & p) {
+        m_params.copy(p);
+        m_keep_cardinality_constraints = keep_cardinality_constraints(m_params);
+    }
     unsigned get_num_steps() const { return m_rw.get_num_steps(); }
     void cleanup() { m_rw.cleanup(); }
     void operator()(expr * e, expr_ref & result, proof_ref & result_proof) {
@@ -30,7 +30,8 @@ simplifier::simplifier(ast_manager & m):
     m_need_reset(false),
     m_use_oeq(false),
     m_visited_quantifier(false),
-    m_ac_support(true) {
+    m_ac_support(true),
+    m_cache_trail(m) {
 }
 
 void simplifier::register_plugin(plugin * p) { 
@@ -115,6 +116,13 @@ void simplifier::operator()(expr * s, expr_ref & r, proof_ref & p) {
 
 void simplifier::flush_cache() {
     m_cache.flush();
+    m_cache_trail.reset();
+    for (unsigned i = 0; i < m_cache_lim.size(); ++i)
+        m_cache_lim[i] = 0;
+    flush_plugin_caches();
+}
+
+void simplifier::flush_plugin_caches() {
     ptr_vector<plugin>::const_iterator it  = m_plugins.begin();
     ptr_vector<plugin>::const_iterator end = m_plugins.end();
     for (; it != end; ++it) {
@@ -124,6 +132,18 @@ void simplifier::flush_cache() {
     }
 }
 
+void simplifier::pop_scope(unsigned num_scopes) {
+    SASSERT(num_scopes <= m_cache_lim.size());
+    unsigned new_lvl = m_cache_lim.size() - num_scopes;
+    unsigned old_sz  = m_cache_lim[new_lvl];
+    for (unsigned i = old_sz; i < m_cache_trail.size(); ++i) 
+        m_cache.erase(m_cache_trail.get(i));
+    m_cache_trail.shrink(old_sz);
+    m_cache_lim.shrink(new_lvl);
+    // the caches of the plugins are small, they are not scoped.
+    flush_plugin_caches();
+}
+
 bool simplifier::get_subst(expr * n, expr_ref & r, proof_ref & p) {
     return false;
 }
@@ -81,6 +81,9 @@ protected:
     obj_map<expr, int>             m_colors;      // temporary cache for topological sort.
     obj_map<expr, rational>        m_ac_mults;
 
+    expr_ref_vector                m_cache_trail; // keys cached since the first active scope.
+    unsigned_vector                m_cache_lim;
+
     /*
       Simplifier uses an idiom for rewriting ASTs without using recursive calls.
 
@@ -159,6 +162,7 @@ protected:
      */
 
     void flush_cache();
+    void flush_plugin_caches();
 
     /**
        \brief This method can be redefined in subclasses of simplifier to implement substitutions.
@@ -202,7 +206,18 @@ public:
     bool visited_quantifier() const { return m_visited_quantifier; }
 
     void mk_app(func_decl * decl, unsigned num_args, expr * const * args, expr_ref & r);
-    void cache_result(expr * n, expr * r, proof * p) { m_need_reset = true;  base_simplifier::cache_result(n, r, p); }
+    void cache_result(expr * n, expr * r, proof * p) { 
+        m_need_reset = true;  
+        if (!m_cache_lim.empty()) m_cache_trail.push_back(n);
+        base_simplifier::cache_result(n, r, p); 
+    }
+
+    /**
+       \brief Scopes of the cache. The entries added after a push_scope are removed by the matching pop_scope, 
+       the older entries are preserved. flush_cache removes all entries.
+    */
+    void push_scope() { m_cache_lim.push_back(m_cache_trail.size()); }
+    void pop_scope(unsigned num_scopes);
 
     void register_plugin(plugin * p);
     ptr_vector<plugin>::const_iterator begin_plugins() const { return m_plugins.begin(); }
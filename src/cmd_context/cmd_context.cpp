@@ -1644,6 +1644,7 @@ void cmd_context::display_statistics(bool show_total_time, double total_time) {
     st.update("time", get_seconds());
     get_memory_statistics(st);
     get_rlimit_statistics(m().limit(), st);
+    m().get_allocator().collect_statistics(st);
     if (m_check_sat_result) {
         m_check_sat_result->collect_statistics(st);
     }
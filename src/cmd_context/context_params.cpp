@@ -36,6 +36,7 @@ context_params::context_params() {
     m_well_sorted_check = false;
     m_timeout = UINT_MAX;
     m_rlimit  = 0;
+    m_memory_budget = 0;
     updt_params();
 }
 
@@ -87,6 +88,9 @@ void context_params::set(char const * param, char const * value) {
     else if (p == "rlimit") {
         set_uint(m_rlimit, param, value);
     }
+    else if (p == "memory_budget") {
+        set_uint(m_memory_budget, param, value);
+    }
     else if (p == "type_check" || p == "well_sorted_check") {
         set_bool(m_well_sorted_check, param, value);
     }
@@ -138,6 +142,7 @@ void context_params::updt_params() {
 void context_params::updt_params(params_ref const & p) {
     m_timeout           = p.get_uint("timeout", m_timeout);
     m_rlimit            = p.get_uint("rlimit", m_rlimit);
+    m_memory_budget     = p.get_uint("memory_budget", m_memory_budget);
     m_well_sorted_check = p.get_bool("type_check", p.get_bool("well_sorted_check", m_well_sorted_check));
     m_auto_config       = p.get_bool("auto_config", m_auto_config);
     m_proof             = p.get_bool("proof", m_proof);
@@ -154,6 +159,7 @@ void context_params::updt_params(params_ref const & p) {
 void context_params::collect_param_descrs(param_descrs & d) {
     d.insert("timeout", CPK_UINT, "default timeout (in milliseconds) used for solvers", "4294967295");
     d.insert("rlimit", CPK_UINT, "default resource limit used for solvers. Unrestricted when set to 0.", "0");
+    d.insert("memory_budget", CPK_UINT, "maximum amount of memory in megabytes a context may allocate during a single solver call, other contexts are not affected when it is exceeded. Unrestricted when set to 0.", "0");
     d.insert("well_sorted_check", CPK_BOOL, "type checker", "false");
     d.insert("type_check", CPK_BOOL, "type checker (alias for well_sorted_check)", "true");
     d.insert("auto_config", CPK_BOOL, "use heuristics to automatically select solver and configure it", "true");
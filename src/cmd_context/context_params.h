@@ -42,6 +42,7 @@ public:
     bool        m_smtlib2_compliant; // it must be here because it enable/disable the use of coercions in the ast_manager.
     unsigned    m_timeout;
     unsigned    m_rlimit;
+    unsigned    m_memory_budget;
 
     context_params();
     void set(char const * param, char const * value);
@@ -0,0 +1,299 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    fp_simplex.cpp
+
+Abstract:
+
+    Double precision sparse simplex for bound feasibility.
+
+Author:
+
+
+
+Notes:
+
+--*/
+
+#include"fp_simplex.h"
+#include"trace.h"
+
+namespace simplex {
+
+    fp_simplex::fp_simplex():
+        m_mark(0),
+        m_work(0),
+        m_tolerance(1e-9),
+        m_pivot_tolerance(1e-9),
+        m_drop_tolerance(1e-14) {
+    }
+
+    void fp_simplex::reset(unsigned num_vars) {
+        m_rows.reset();
+        m_cols.reset();
+        m_cols.resize(num_vars);
+        m_var2row.reset();
+        m_var2row.resize(num_vars, null_row);
+        m_value.reset();
+        m_value.resize(num_vars, 0.0);
+        m_lower.reset();
+        m_lower.resize(num_vars, 0.0);
+        m_upper.reset();
+        m_upper.resize(num_vars, 0.0);
+        m_has_lower.reset();
+        m_has_lower.resize(num_vars, false);
+        m_has_upper.reset();
+        m_has_upper.resize(num_vars, false);
+        m_pos.reset();
+        m_pos.resize(num_vars, -1);
+        m_row_mark.reset();
+        m_mark = 0;
+    }
+
+    void fp_simplex::add_row(unsigned x_b, unsigned num_vars, unsigned const* vars, double const* coeffs) {
+        SASSERT(!is_base(x_b));
+        unsigned r_id = m_rows.size();
+        m_rows.push_back(row());
+        row & r = m_rows.back();
+        r.m_base = x_b;
+        for (unsigned i = 0; i < num_vars; ++i) {
+            SASSERT(!is_base(vars[i]));
+            if (coeffs[i] != 0.0) {
+                r.m_entries.push_back(entry(vars[i], coeffs[i]));
+                m_cols[vars[i]].push_back(r_id);
+            }
+        }
+        m_var2row[x_b] = r_id;
+        m_row_mark.push_back(0);
+    }
+
+    unsigned fp_simplex::get_num_entries() const {
+        unsigned result = 0;
+        for (unsigned i = 0; i < m_rows.size(); ++i) {
+            result += m_rows[i].m_entries.size();
+        }
+        return result;
+    }
+
+    bool fp_simplex::at_lower(unsigned v) const {
+        return m_has_lower[v] && !can_decrease(v);
+    }
+
+    bool fp_simplex::at_upper(unsigned v) const {
+        return m_has_upper[v] && !can_increase(v);
+    }
+
+    double fp_simplex::violation(unsigned v) const {
+        if (below_lower(v)) return m_lower[v] - m_value[v];
+        if (above_upper(v)) return m_value[v] - m_upper[v];
+        return 0.0;
+    }
+
+    unsigned fp_simplex::next_mark() {
+        ++m_mark;
+        if (m_mark == 0) {
+            for (unsigned i = 0; i < m_row_mark.size(); ++i) m_row_mark[i] = 0;
+            m_mark = 1;
+        }
+        return m_mark;
+    }
+
+    /**
+       \brief The values of base variables are recomputed from the non-base variables
+       to avoid accumulating rounding errors.
+    */
+    void fp_simplex::compute_base_values() {
+        for (unsigned i = 0; i < m_rows.size(); ++i) {
+            row const & r = m_rows[i];
+            double val = 0.0;
+            for (unsigned j = 0; j < r.m_entries.size(); ++j) {
+                val += r.m_entries[j].m_coeff * m_value[r.m_entries[j].m_var];
+            }
+            m_value[r.m_base] = val;
+        }
+    }
+
+    unsigned fp_simplex::select_var_to_fix(bool bland) const {
+        unsigned best = UINT_MAX;
+        double best_error = 0.0;
+        for (unsigned i = 0; i < m_rows.size(); ++i) {
+            unsigned v = m_rows[i].m_base;
+            double err = violation(v);
+            if (err <= 0.0) continue;
+            if (best == UINT_MAX || (bland ? v < best : err > best_error)) {
+                best = v;
+                best_error = err;
+            }
+        }
+        return best;
+    }
+
+    /**
+       \brief Select a non-base variable of the row of x_i that can move x_i towards its violated bound.
+       Among the variables whose coefficient is not much smaller than the largest coefficient,
+       prefer the one that occurs in the fewest rows to limit fill-in, unless Bland's rule is used.
+    */
+    unsigned fp_simplex::select_pivot(unsigned x_i, bool is_below, bool bland, double & a_ij) const {
+        row const & r = m_rows[m_var2row[x_i]];
+        double max_abs = 0.0;
+        for (unsigned i = 0; i < r.m_entries.size(); ++i) {
+            if (can_move(r.m_entries[i], is_below)) {
+                double c = r.m_entries[i].m_coeff;
+                max_abs = std::max(max_abs, c < 0 ? -c : c);
+            }
+        }
+        double min_abs = std::max(m_pivot_tolerance, 0.1 * max_abs);
+        unsigned best = UINT_MAX;
+        unsigned best_col_size = UINT_MAX;
+        for (unsigned i = 0; i < r.m_entries.size(); ++i) {
+            unsigned x_j = r.m_entries[i].m_var;
+            double c = r.m_entries[i].m_coeff;
+            double abs_c = c < 0 ? -c : c;
+            if (abs_c < min_abs || !can_move(r.m_entries[i], is_below)) continue;
+            unsigned col_size = m_cols[x_j].size();
+            if (best == UINT_MAX || (bland ? x_j < best : col_size < best_col_size)) {
+                best = x_j;
+                best_col_size = col_size;
+                a_ij = c;
+            }
+        }
+        return best;
+    }
+
+    void fp_simplex::update_value(unsigned v, double delta) {
+        SASSERT(!is_base(v));
+        m_value[v] += delta;
+        unsigned mark = next_mark();
+        unsigned_vector const & col = m_cols[v];
+        for (unsigned i = 0; i < col.size(); ++i) {
+            unsigned r_id = col[i];
+            if (m_row_mark[r_id] == mark) continue;
+            m_row_mark[r_id] = mark;
+            row const & r = m_rows[r_id];
+            for (unsigned j = 0; j < r.m_entries.size(); ++j) {
+                if (r.m_entries[j].m_var == v) {
+                    m_value[r.m_base] += r.m_entries[j].m_coeff * delta;
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+       \brief Make x_j the base variable of the row of x_i.
+    */
+    void fp_simplex::pivot(unsigned x_i, unsigned x_j) {
+        m_stats.m_num_pivots++;
+        unsigned r_id = m_var2row[x_i];
+        row & r = m_rows[r_id];
+        // x_i = a_ij*x_j + sum_k a_k*x_k  ==>  x_j = x_i/a_ij - sum_k (a_k/a_ij)*x_k
+        unsigned pos = 0;
+        while (r.m_entries[pos].m_var != x_j) {
+            ++pos;
+        }
+        double a_ij = r.m_entries[pos].m_coeff;
+        SASSERT(a_ij != 0.0);
+        for (unsigned i = 0; i < r.m_entries.size(); ++i) {
+            r.m_entries[i].m_coeff /= -a_ij;
+        }
+        r.m_entries[pos] = entry(x_i, 1.0 / a_ij);
+        r.m_base = x_j;
+        m_var2row[x_j] = r_id;
+        m_var2row[x_i] = null_row;
+        m_cols[x_i].push_back(r_id);
+        eliminate(x_j, r_id);
+    }
+
+    /**
+       \brief Substitute the definition of x_j in row r_id into the other rows that contain x_j.
+    */
+    void fp_simplex::eliminate(unsigned x_j, unsigned r_id) {
+        unsigned mark = next_mark();
+        m_row_mark[r_id] = mark;
+        unsigned_vector col;
+        col.swap(m_cols[x_j]);
+        svector<entry> const & def = m_rows[r_id].m_entries;
+        for (unsigned i = 0; i < col.size(); ++i) {
+            unsigned s_id = col[i];
+            if (m_row_mark[s_id] == mark) continue;
+            m_row_mark[s_id] = mark;
+            svector<entry> & es = m_rows[s_id].m_entries;
+            m_work += es.size() + def.size();
+            double d = 0.0;
+            for (unsigned j = 0; j < es.size(); ++j) {
+                m_pos[es[j].m_var] = j;
+                if (es[j].m_var == x_j) d = es[j].m_coeff;
+            }
+            if (d != 0.0) {
+                es[m_pos[x_j]].m_coeff = 0.0;
+                for (unsigned j = 0; j < def.size(); ++j) {
+                    unsigned v = def[j].m_var;
+                    int p = m_pos[v];
+                    if (p >= 0) {
+                        es[p].m_coeff += d * def[j].m_coeff;
+                    }
+                    else {
+                        m_pos[v] = es.size();
+                        es.push_back(entry(v, d * def[j].m_coeff));
+                        m_cols[v].push_back(s_id);
+                    }
+                }
+            }
+            // remove x_j and cancelled coefficients.
+            unsigned k = 0;
+            for (unsigned j = 0; j < es.size(); ++j) {
+                m_pos[es[j].m_var] = -1;
+                double c = es[j].m_coeff;
+                if (c > m_drop_tolerance || c < -m_drop_tolerance) {
+                    es[k++] = es[j];
+                }
+            }
+            es.shrink(k);
+        }
+    }
+
+    lbool fp_simplex::make_feasible(unsigned max_pivots) {
+        m_stats.m_num_checks++;
+        compute_base_values();
+        // give up when the tableau fills in.
+        unsigned num_entries = get_num_entries();
+        unsigned max_work = num_entries < 40000000 ? 100 * num_entries + 1000000 : UINT_MAX;
+        m_work = 0;
+        // switch to Bland's rule when the number of pivots exceeds the number of rows.
+        unsigned bland_threshold = 2 * m_rows.size() + 100;
+        for (unsigned num_pivots = 0; num_pivots < max_pivots && m_work < max_work; ++num_pivots) {
+            bool bland = num_pivots > bland_threshold;
+            unsigned x_i = select_var_to_fix(bland);
+            if (x_i == UINT_MAX) {
+                m_stats.m_num_feasible++;
+                return l_true;
+            }
+            bool is_below = below_lower(x_i);
+            double a_ij = 0.0;
+            unsigned x_j = select_pivot(x_i, is_below, bland, a_ij);
+            if (x_j == UINT_MAX) {
+                TRACE("fp_simplex", tout << "infeasible row of v" << x_i << "\n";);
+                m_stats.m_num_infeasible++;
+                return l_false;
+            }
+            double target = is_below ? m_lower[x_i] : m_upper[x_i];
+            update_value(x_j, (target - m_value[x_i]) / a_ij);
+            m_value[x_i] = target;
+            pivot(x_i, x_j);
+            if (num_pivots % 100 == 99) {
+                compute_base_values();
+            }
+        }
+        return l_undef;
+    }
+
+    void fp_simplex::collect_statistics(::statistics & st) const {
+        st.update("fp simplex checks", m_stats.m_num_checks);
+        st.update("fp simplex pivots", m_stats.m_num_pivots);
+        st.update("fp simplex feasible", m_stats.m_num_feasible);
+        st.update("fp simplex infeasible", m_stats.m_num_infeasible);
+    }
+
+};
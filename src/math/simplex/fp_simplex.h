@@ -0,0 +1,129 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    fp_simplex.h
+
+Abstract:
+
+    Double precision sparse simplex for bound feasibility.
+
+    - Rows have the form x_b = sum_j a_j * x_j, where x_b is the base variable.
+
+    - The result is only a hint: clients copy their exact tableau, solve it in
+      floating point, and then move their exact tableau to the basis found here.
+      The exact solver verifies feasibility, and continues with exact pivoting
+      when the floating point basis is not exactly feasible.
+
+    - It follows the pivoting scheme of theory_arith and simplex<Ext>:
+      pick a base variable that violates a bound, and pivot it with a
+      non-base variable of its row that has slack. Bland's rule is used
+      to avoid cycling after a number of pivots.
+
+Author:
+
+
+
+Notes:
+
+--*/
+
+#ifndef FP_SIMPLEX_H_
+#define FP_SIMPLEX_H_
+
+#include"vector.h"
+#include"lbool.h"
+#include"statistics.h"
+
+namespace simplex {
+
+    class fp_simplex {
+        struct entry {
+            unsigned m_var;
+            double   m_coeff;
+            entry(unsigned v, double c): m_var(v), m_coeff(c) {}
+        };
+
+        struct row {
+            unsigned      m_base;
+            svector<entry> m_entries;
+        };
+
+        struct stats {
+            unsigned m_num_checks;
+            unsigned m_num_pivots;
+            unsigned m_num_feasible;
+            unsigned m_num_infeasible;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        static const unsigned null_row = UINT_MAX;
+
+        vector<row>             m_rows;
+        vector<unsigned_vector> m_cols;       // rows where a variable occurs as a non-base variable, may contain stale rows.
+        unsigned_vector         m_var2row;    // row of a base variable, null_row for non-base variables.
+        svector<double>         m_value;
+        svector<double>         m_lower;
+        svector<double>         m_upper;
+        svector<bool>           m_has_lower;
+        svector<bool>           m_has_upper;
+        svector<int>            m_pos;        // scratch: position of a variable in the row being updated.
+        unsigned_vector         m_row_mark;
+        unsigned                m_mark;
+        unsigned                m_work;       // number of entries visited during elimination.
+        double                  m_tolerance;  // feasibility tolerance relative to the bound.
+        double                  m_pivot_tolerance;
+        double                  m_drop_tolerance;
+        stats                   m_stats;
+
+        double tolerance(double bound) const { return m_tolerance * (1.0 + (bound < 0 ? -bound : bound)); }
+        bool below_lower(unsigned v) const { return m_has_lower[v] && m_value[v] < m_lower[v] - tolerance(m_lower[v]); }
+        bool above_upper(unsigned v) const { return m_has_upper[v] && m_value[v] > m_upper[v] + tolerance(m_upper[v]); }
+        bool can_increase(unsigned v) const { return !m_has_upper[v] || m_value[v] < m_upper[v] - tolerance(m_upper[v]); }
+        bool can_decrease(unsigned v) const { return !m_has_lower[v] || m_value[v] > m_lower[v] + tolerance(m_lower[v]); }
+        bool can_move(entry const & e, bool is_below) const { return (e.m_coeff > 0) == is_below ? can_increase(e.m_var) : can_decrease(e.m_var); }
+        double violation(unsigned v) const;
+        unsigned next_mark();
+        unsigned select_var_to_fix(bool bland) const;
+        unsigned select_pivot(unsigned x_i, bool is_below, bool bland, double & a_ij) const;
+        void update_value(unsigned v, double delta);
+        void pivot(unsigned x_i, unsigned x_j);
+        void eliminate(unsigned x_j, unsigned r_id);
+        void compute_base_values();
+
+    public:
+        fp_simplex();
+
+        void reset(unsigned num_vars);
+        void set_lower(unsigned v, double b) { m_has_lower[v] = true; m_lower[v] = b; }
+        void set_upper(unsigned v, double b) { m_has_upper[v] = true; m_upper[v] = b; }
+        void set_value(unsigned v, double val) { m_value[v] = val; }
+        /**
+           \brief Add the row x_b = sum_i coeffs[i] * vars[i].
+           x_b must not be used in other rows, and vars must not be base variables.
+        */
+        void add_row(unsigned x_b, unsigned num_vars, unsigned const* vars, double const* coeffs);
+
+        /**
+           \brief Search for an assignment that satisfies the bounds up to the tolerance.
+           Return l_false if a row cannot be satisfied, l_undef if max_pivots was reached
+           or the rows filled in.
+        */
+        lbool make_feasible(unsigned max_pivots);
+
+        unsigned get_num_vars() const { return m_value.size(); }
+        unsigned get_num_entries() const;
+        bool is_base(unsigned v) const { return m_var2row[v] != null_row; }
+        double get_value(unsigned v) const { return m_value[v]; }
+        bool at_lower(unsigned v) const;
+        bool at_upper(unsigned v) const;
+
+        void collect_statistics(::statistics & st) const;
+        void reset_statistics() { m_stats.reset(); }
+    };
+
+};
+
+#endif
@@ -0,0 +1,733 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    card_extension.cpp
+
+Abstract:
+
+    Extension for cardinality and pseudo-Boolean constraints.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include<algorithm>
+#include"card_extension.h"
+
+namespace sat {
+
+    card_extension::card::card(unsigned index, literal lit, literal_vector const& lits, unsigned k):
+        m_index(index),
+        m_lit(lit),
+        m_k(k),
+        m_size(lits.size()) {
+        for (unsigned i = 0; i < lits.size(); ++i) {
+            m_lits[i] = lits[i];
+        }
+    }
+
+    card_extension::pb::pb(unsigned index, literal lit, svector<wliteral> const& wlits, unsigned k):
+        m_index(index),
+        m_lit(lit),
+        m_k(k),
+        m_size(wlits.size()),
+        m_slack(0),
+        m_num_watch(0),
+        m_max_weight(0) {
+        for (unsigned i = 0; i < wlits.size(); ++i) {
+            m_wlits[i] = wlits[i];
+            if (wlits[i].first > m_max_weight) m_max_weight = wlits[i].first;
+        }
+    }
+
+    card_extension::card_extension():
+        m_solver(0),
+        m_stamp_counter(0),
+        m_gauss(num_tag_bits, xor_watch_tag, xor_reason_tag) {
+    }
+
+    card_extension::~card_extension() {
+        // the watch lists are owned by the solver, only the constraints are released.
+        for (unsigned i = 0; i < m_cards.size(); ++i) {
+            m_cards[i]->~card();
+            memory::deallocate(m_cards[i]);
+        }
+        for (unsigned i = 0; i < m_pbs.size(); ++i) {
+            m_pbs[i]->~pb();
+            memory::deallocate(m_pbs[i]);
+        }
+    }
+
+    void card_extension::set_solver(solver* s) {
+        m_solver = s;
+        m_gauss.set_solver(s);
+        // the extension may be installed after user scopes were created.
+        while (m_card_lim.size() < s->m_user_scope_literals.size()) {
+            m_card_lim.push_back(0);
+            m_pb_lim.push_back(0);
+        }
+    }
+
+    void card_extension::watch_literal(literal lit, unsigned idx) {
+        s().get_wlist(~lit).push_back(watched(idx));
+    }
+
+    void card_extension::unwatch_literal(literal lit, unsigned idx) {
+        s().get_wlist(~lit).erase(watched(idx));
+    }
+
+    void card_extension::watch_guard(literal guard, unsigned idx) {
+        s().get_wlist(guard).push_back(watched(idx));
+    }
+
+    void card_extension::unwatch_guard(literal guard, unsigned idx) {
+        s().get_wlist(guard).erase(watched(idx));
+    }
+
+    void card_extension::assign(unsigned idx, literal lit) {
+        switch (value(lit)) {
+        case l_true:
+            break;
+        case l_false:
+            set_conflict(idx, lit);
+            break;
+        default:
+            m_stats.m_num_propagations++;
+            s().assign(lit, justification::mk_ext_justification(idx));
+            break;
+        }
+    }
+
+    void card_extension::set_conflict(unsigned idx, literal lit) {
+        SASSERT(value(lit) == l_false);
+        TRACE("sat", tout << "conflict " << idx << " " << lit << "\n";);
+        m_stats.m_num_conflicts++;
+        s().set_conflict(justification::mk_ext_justification(idx), ~lit);
+    }
+
+    // -----------------------
+    //
+    // Cardinality constraints
+    //
+    // -----------------------
+
+    void card_extension::init_watch(card& c) {
+        clear_watch(c);
+        unsigned sz = c.size(), bound = c.k();
+        SASSERT(bound < sz);
+        // move the non-false literals to the front.
+        unsigned j = 0;
+        for (unsigned i = 0; i < sz; ++i) {
+            if (value(c[i]) != l_false) {
+                c.swap(i, j);
+                ++j;
+            }
+        }
+        for (unsigned i = 0; i <= bound; ++i) {
+            watch_literal(c[i], c.index());
+        }
+        if (j < bound) {
+            set_conflict(c.index(), c[j]);
+        }
+        else if (j == bound) {
+            for (unsigned i = 0; i < bound && !s().inconsistent(); ++i) {
+                assign(c.index(), c[i]);
+            }
+        }
+    }
+
+    void card_extension::clear_watch(card& c) {
+        for (unsigned i = 0; i <= c.k(); ++i) {
+            unwatch_literal(c[i], c.index());
+        }
+    }
+
+    /**
+       \brief alit = c[index] was assigned to false, index <= k.
+       Return true if alit remains watched.
+    */
+    bool card_extension::add_assign(card& c, literal alit) {
+        unsigned sz = c.size(), bound = c.k(), index = 0;
+        while (index <= bound && c[index] != alit) ++index;
+        if (index > bound) {
+            // alit is no longer watched.
+            return false;
+        }
+        for (unsigned i = bound + 1; i < sz; ++i) {
+            literal lit2 = c[i];
+            if (value(lit2) != l_false) {
+                c.swap(index, i);
+                watch_literal(lit2, c.index());
+                return false;
+            }
+        }
+        // c[bound+1..sz-1] are false.
+        if (index != bound && value(c[bound]) == l_false) {
+            set_conflict(c.index(), alit);
+            return true;
+        }
+        // all remaining watched literals must be true.
+        c.swap(index, bound);
+        for (unsigned i = 0; i < bound && !s().inconsistent(); ++i) {
+            assign(c.index(), c[i]);
+        }
+        return true;
+    }
+
+    void card_extension::del_card(card* c) {
+        clear_watch(*c);
+        if (c->lit() != null_literal) unwatch_guard(c->lit(), c->index());
+        c->~card();
+        memory::deallocate(c);
+    }
+
+    // -----------------------
+    //
+    // Pseudo-Boolean constraints
+    //
+    // -----------------------
+
+    void card_extension::init_watch(pb& p) {
+        clear_watch(p);
+        unsigned sz = p.size(), k = p.k(), max_w = p.max_weight();
+        unsigned j = 0;
+        for (unsigned i = 0; i < sz; ++i) {
+            if (value(p[i].second) != l_false) {
+                p.swap(i, j);
+                ++j;
+            }
+        }
+        unsigned slack = 0, num_watch = 0;
+        for (; num_watch < j && slack < k + max_w; ++num_watch) {
+            slack += p[num_watch].first;
+            watch_literal(p[num_watch].second, p.index());
+        }
+        p.set_slack(slack);
+        p.set_num_watch(num_watch);
+        if (slack < k) {
+            // all non-false literals are watched, so p[j] exists and is false.
+            set_conflict(p.index(), p[j].second);
+        }
+        else if (slack < k + max_w) {
+            for (unsigned i = 0; i < num_watch && !s().inconsistent(); ++i) {
+                if (p[i].first > slack - k) {
+                    assign(p.index(), p[i].second);
+                }
+            }
+        }
+    }
+
+    void card_extension::clear_watch(pb& p) {
+        for (unsigned i = 0; i < p.num_watch(); ++i) {
+            unwatch_literal(p[i].second, p.index());
+        }
+        p.set_num_watch(0);
+        p.set_slack(0);
+    }
+
+    /**
+       \brief alit was assigned to false.
+       Watch unwatched non-false literals until the slack covers k and the maximal weight.
+       If the slack is below k + max_weight, then all non-false literals are watched and
+       the literals whose weight exceeds slack - k are propagated.
+       Return true if alit remains watched.
+    */
+    bool card_extension::add_assign(pb& p, literal alit) {
+        unsigned sz = p.size(), k = p.k(), max_w = p.max_weight();
+        unsigned num_watch = p.num_watch(), index = 0;
+        while (index < num_watch && p[index].second != alit) ++index;
+        if (index == num_watch) {
+            return false;
+        }
+        unsigned weight = p[index].first;
+        unsigned slack = p.slack() - weight;
+        for (unsigned j = num_watch; j < sz && slack < k + max_w; ++j) {
+            if (value(p[j].second) != l_false) {
+                slack += p[j].first;
+                watch_literal(p[j].second, p.index());
+                p.swap(num_watch, j);
+                ++num_watch;
+            }
+        }
+        if (slack < k) {
+            // alit remains watched, such that the constraint is revisited after backtracking.
+            p.set_slack(slack + weight);
+            p.set_num_watch(num_watch);
+            set_conflict(p.index(), alit);
+            return true;
+        }
+        --num_watch;
+        p.swap(index, num_watch);
+        p.set_slack(slack);
+        p.set_num_watch(num_watch);
+        if (slack < k + max_w) {
+            for (unsigned i = 0; i < num_watch && !s().inconsistent(); ++i) {
+                if (p[i].first > slack - k) {
+                    assign(p.index(), p[i].second);
+                }
+            }
+        }
+        return false;
+    }
+
+    void card_extension::del_pb(pb* p) {
+        clear_watch(*p);
+        if (p->lit() != null_literal) unwatch_guard(p->lit(), p->index());
+        p->~pb();
+        memory::deallocate(p);
+    }
+
+    // -----------------------
+    //
+    // Constraint creation
+    //
+    // -----------------------
+
+    void card_extension::add_card(literal lit, literal_vector const& lits, unsigned k) {
+        unsigned index = card2index(m_cards.size());
+        void * mem = memory::allocate(card::get_obj_size(lits.size()));
+        card* c = new (mem) card(index, lit, lits, k);
+        m_cards.push_back(c);
+        for (unsigned i = 0; i < lits.size(); ++i) {
+            s().set_external(lits[i].var());
+        }
+        if (lit != null_literal) {
+            s().set_external(lit.var());
+            watch_guard(lit, index);
+        }
+        if (is_active(lit)) {
+            init_watch(*c);
+        }
+    }
+
+    void card_extension::add_pb(literal lit, svector<wliteral> const& wlits, unsigned k) {
+        unsigned index = pb2index(m_pbs.size());
+        void * mem = memory::allocate(pb::get_obj_size(wlits.size()));
+        pb* p = new (mem) pb(index, lit, wlits, k);
+        m_pbs.push_back(p);
+        for (unsigned i = 0; i < wlits.size(); ++i) {
+            s().set_external(wlits[i].second.var());
+        }
+        if (lit != null_literal) {
+            s().set_external(lit.var());
+            watch_guard(lit, index);
+        }
+        if (is_active(lit)) {
+            init_watch(*p);
+        }
+    }
+
+    void card_extension::add_clause(literal guard, bool root, literal_vector& lits) {
+        // the solver adds the user scope literals to the clause.
+        if (!root) lits.push_back(~guard);
+        s().mk_clause(lits);
+    }
+
+    struct wliteral_var_lt {
+        bool operator()(card_extension::wliteral const& a, card_extension::wliteral const& b) const {
+            return a.second.index() < b.second.index();
+        }
+    };
+
+    struct wliteral_weight_gt {
+        bool operator()(card_extension::wliteral const& a, card_extension::wliteral const& b) const {
+            return a.first > b.first;
+        }
+    };
+
+    /**
+       \brief Add guard => wlits >= k, where the guard is the innermost user scope if root is true.
+       Literals over the same variable are merged, weights are capped by k and
+       constraints that are clauses or conjunctions are added as clauses.
+    */
+    void card_extension::add_pb_core(literal guard, bool root, svector<wliteral> const& wlits, unsigned k) {
+        m_wlits.reset();
+        m_wlits.append(wlits);
+        std::sort(m_wlits.begin(), m_wlits.end(), wliteral_var_lt());
+        unsigned j = 0;
+        for (unsigned i = 0; i < m_wlits.size(); ++i) {
+            wliteral wl = m_wlits[i];
+            if (wl.first == 0) {
+                continue;
+            }
+            if (j > 0 && m_wlits[j-1].second.var() == wl.second.var()) {
+                wliteral & prev = m_wlits[j-1];
+                if (prev.second == wl.second) {
+                    prev.first += wl.first;
+                }
+                else {
+                    // w1*l + w2*~l = min(w1,w2) + (w1 - min(w1,w2))*l + (w2 - min(w1,w2))*~l
+                    unsigned w = std::min(prev.first, wl.first);
+                    k = k > w ? k - w : 0;
+                    if (prev.first > w) prev.first -= w;
+                    else if (wl.first > w) prev = wliteral(wl.first - w, wl.second);
+                    else --j;
+                }
+            }
+            else {
+                m_wlits[j++] = wl;
+            }
+        }
+        m_wlits.shrink(j);
+        if (k == 0) {
+            return;
+        }
+        uint64 sum = 0;
+        bool is_card = true;
+        for (unsigned i = 0; i < m_wlits.size(); ++i) {
+            if (m_wlits[i].first > k) m_wlits[i].first = k;
+            sum += m_wlits[i].first;
+            is_card &= m_wlits[i].first == m_wlits[0].first;
+        }
+        TRACE("sat", tout << guard << " => " << m_wlits.size() << " literals >= " << k << "\n";);
+        literal_vector lits;
+        if (sum < k) {
+            add_clause(guard, root, lits);
+            return;
+        }
+        literal lit = guard;
+        if (root) {
+            lit = s().m_user_scope_literals.empty() ? null_literal : ~s().m_user_scope_literals.back();
+        }
+        if (is_card) {
+            unsigned w = m_wlits[0].first;
+            unsigned k1 = static_cast<unsigned>((static_cast<uint64>(k) + w - 1) / w);
+            for (unsigned i = 0; i < m_wlits.size(); ++i) {
+                lits.push_back(m_wlits[i].second);
+            }
+            if (k1 == 1) {
+                add_clause(guard, root, lits);
+            }
+            else if (k1 == lits.size()) {
+                literal_vector unit;
+                for (unsigned i = 0; i < lits.size(); ++i) {
+                    unit.reset();
+                    unit.push_back(lits[i]);
+                    add_clause(guard, root, unit);
+                }
+            }
+            else {
+                add_card(lit, lits, k1);
+            }
+        }
+        else {
+            std::sort(m_wlits.begin(), m_wlits.end(), wliteral_weight_gt());
+            add_pb(lit, m_wlits, k);
+        }
+    }
+
+    void card_extension::add_at_least(bool_var v, literal_vector const& lits, unsigned k) {
+        svector<wliteral> wlits;
+        for (unsigned i = 0; i < lits.size(); ++i) {
+            wlits.push_back(wliteral(1, lits[i]));
+        }
+        add_pb_ge(v, wlits, k);
+    }
+
+    void card_extension::add_pb_ge(bool_var v, svector<wliteral> const& wlits, unsigned k) {
+        if (v == null_bool_var) {
+            add_pb_core(null_literal, true, wlits, k);
+            return;
+        }
+        literal lit(v, false);
+        add_pb_core(lit, false, wlits, k);
+        // ~v => w_1*~l_1 + ... + w_n*~l_n >= w_1 + ... + w_n - k + 1
+        uint64 sum = 0;
+        svector<wliteral> nwlits;
+        for (unsigned i = 0; i < wlits.size(); ++i) {
+            sum += wlits[i].first;
+            nwlits.push_back(wliteral(wlits[i].first, ~wlits[i].second));
+        }
+        if (sum >= k) {
+            add_pb_core(~lit, false, nwlits, static_cast<unsigned>(sum - k + 1));
+        }
+    }
+
+    void card_extension::add_xor(bool_var_vector const& vars, bool rhs) {
+        for (unsigned i = 0; i < vars.size(); ++i) {
+            s().set_external(vars[i]);
+        }
+        m_gauss.add_xor(vars, rhs);
+    }
+
+    // -----------------------
+    //
+    // extension interface
+    //
+    // -----------------------
+
+    void card_extension::propagate(literal l, ext_constraint_idx idx, bool & keep) {
+        TRACE("sat", tout << l << " " << idx << "\n";);
+        if (get_tag(idx) == xor_watch_tag) {
+            m_gauss.propagate(l, idx);
+            keep = true;
+        }
+        else if (is_card(idx)) {
+            card& c = index2card(idx);
+            if (c.lit() == l) {
+                init_watch(c);
+                keep = true;
+            }
+            else if (!is_active(c.lit())) {
+                keep = true;
+            }
+            else {
+                keep = add_assign(c, ~l);
+            }
+        }
+        else {
+            pb& p = index2pb(idx);
+            if (p.lit() == l) {
+                init_watch(p);
+                keep = true;
+            }
+            else if (!is_active(p.lit())) {
+                keep = true;
+            }
+            else {
+                keep = add_assign(p, ~l);
+            }
+        }
+    }
+
+    /**
+       \brief If l was propagated by the constraint, then the antecedents are
+       the false literals of the constraint that were assigned before l.
+       Otherwise the constraint is in conflict and l is the negation of one of its literals,
+       all false literals are antecedents. The guard is an antecedent in both cases.
+    */
+    void card_extension::get_antecedents(literal l, ext_justification_idx idx, literal_vector & r) {
+        if (get_tag(idx) == xor_reason_tag) {
+            m_gauss.get_antecedents(idx, r);
+            return;
+        }
+        bool is_prop = false;
+        literal guard;
+        if (is_card(idx)) {
+            card& c = index2card(idx);
+            guard = c.lit();
+            for (unsigned i = 0; !is_prop && i < c.size(); ++i) {
+                is_prop = c[i] == l;
+            }
+            uint64 bound = is_prop ? stamp(l.var()) : UINT64_MAX;
+            for (unsigned i = 0; i < c.size(); ++i) {
+                literal lit = c[i];
+                if (value(lit) == l_false && stamp(lit.var()) < bound) {
+                    r.push_back(~lit);
+                }
+            }
+        }
+        else {
+            pb& p = index2pb(idx);
+            guard = p.lit();
+            for (unsigned i = 0; !is_prop && i < p.size(); ++i) {
+                is_prop = p[i].second == l;
+            }
+            uint64 bound = is_prop ? stamp(l.var()) : UINT64_MAX;
+            for (unsigned i = 0; i < p.size(); ++i) {
+                literal lit = p[i].second;
+                if (value(lit) == l_false && stamp(lit.var()) < bound) {
+                    r.push_back(~lit);
+                }
+            }
+        }
+        if (guard != null_literal) {
+            SASSERT(value(guard) == l_true);
+            r.push_back(guard);
+        }
+        TRACE("sat", tout << l << " " << idx << " " << r << "\n";);
+    }
+
+    void card_extension::asserted(literal l) {
+        bool_var v = l.var();
+        if (v >= m_stamp.size()) {
+            m_stamp.resize(v + 1, 0);
+        }
+        m_stamp[v] = ++m_stamp_counter;
+    }
+
+    check_result card_extension::check() {
+        DEBUG_CODE(
+            for (unsigned i = 0; i < m_cards.size(); ++i) {
+                SASSERT(validate(*m_cards[i]));
+            }
+            for (unsigned i = 0; i < m_pbs.size(); ++i) {
+                SASSERT(validate(*m_pbs[i]));
+            });
+        return CR_DONE;
+    }
+
+    void card_extension::push() {
+        m_gauss.push();
+    }
+
+    void card_extension::pop(unsigned n) {
+        m_gauss.pop(n);
+    }
+
+    void card_extension::simplify() {
+        m_gauss.init();
+    }
+
+    void card_extension::user_push() {
+        m_card_lim.push_back(m_cards.size());
+        m_pb_lim.push_back(m_pbs.size());
+    }
+
+    void card_extension::user_pop(unsigned num_scopes) {
+        SASSERT(num_scopes <= m_card_lim.size());
+        unsigned new_lim = m_card_lim.size() - num_scopes;
+        unsigned num_cards = m_card_lim[new_lim];
+        unsigned num_pbs = m_pb_lim[new_lim];
+        m_card_lim.shrink(new_lim);
+        m_pb_lim.shrink(new_lim);
+        while (m_cards.size() > num_cards) {
+            del_card(m_cards.back());
+            m_cards.pop_back();
+        }
+        while (m_pbs.size() > num_pbs) {
+            del_pb(m_pbs.back());
+            m_pbs.pop_back();
+        }
+        init_constraints();
+    }
+
+    /**
+       \brief Re-attach the remaining constraints.
+       The solver unassigns the literals that were implied in the popped scope and
+       the watch lists of literals that were assigned at the base level may have been
+       released by the cleaner.
+    */
+    void card_extension::init_constraints() {
+        for (unsigned i = 0; i < m_cards.size(); ++i) {
+            card& c = *m_cards[i];
+            if (c.lit() != null_literal) {
+                unwatch_guard(c.lit(), c.index());
+                watch_guard(c.lit(), c.index());
+            }
+            if (is_active(c.lit())) init_watch(c); else clear_watch(c);
+        }
+        for (unsigned i = 0; i < m_pbs.size(); ++i) {
+            pb& p = *m_pbs[i];
+            if (p.lit() != null_literal) {
+                unwatch_guard(p.lit(), p.index());
+                watch_guard(p.lit(), p.index());
+            }
+            if (is_active(p.lit())) init_watch(p); else clear_watch(p);
+        }
+        m_gauss.init_watches();
+    }
+
+    bool_var card_extension::max_var(bool_var v) const {
+        for (unsigned i = 0; i < m_cards.size(); ++i) {
+            card const& c = *m_cards[i];
+            if (c.lit() != null_literal && c.lit().var() > v) v = c.lit().var();
+            for (unsigned j = 0; j < c.size(); ++j) {
+                if (c[j].var() > v) v = c[j].var();
+            }
+        }
+        for (unsigned i = 0; i < m_pbs.size(); ++i) {
+            pb const& p = *m_pbs[i];
+            if (p.lit() != null_literal && p.lit().var() > v) v = p.lit().var();
+            for (unsigned j = 0; j < p.size(); ++j) {
+                if (p[j].second.var() > v) v = p[j].second.var();
+            }
+        }
+        return m_gauss.max_var(v);
+    }
+
+    extension* card_extension::copy(solver* s) {
+        card_extension* result = alloc(card_extension);
+        result->set_solver(s);
+        literal_vector lits;
+        for (unsigned i = 0; i < m_cards.size(); ++i) {
+            card const& c = *m_cards[i];
+            lits.reset();
+            for (unsigned j = 0; j < c.size(); ++j) {
+                lits.push_back(c[j]);
+            }
+            result->add_card(c.lit(), lits, c.k());
+        }
+        svector<wliteral> wlits;
+        for (unsigned i = 0; i < m_pbs.size(); ++i) {
+            pb const& p = *m_pbs[i];
+            wlits.reset();
+            for (unsigned j = 0; j < p.size(); ++j) {
+                wlits.push_back(p[j]);
+            }
+            result->add_pb(p.lit(), wlits, p.k());
+        }
+        result->m_card_lim.reset();
+        result->m_card_lim.append(m_card_lim);
+        result->m_pb_lim.reset();
+        result->m_pb_lim.append(m_pb_lim);
+        result->m_gauss.copy(m_gauss);
+        result->m_gauss.init();
+        return result;
+    }
+
+    void card_extension::collect_statistics(statistics& st) const {
+        st.update("cardinality propagations", m_stats.m_num_propagations);
+        st.update("cardinality conflicts", m_stats.m_num_conflicts);
+        m_gauss.collect_statistics(st);
+    }
+
+    // constraints that are inactive or partially assigned are not checked.
+    bool card_extension::validate(card const& c) const {
+        if (!is_active(c.lit())) return true;
+        unsigned num_true = 0;
+        for (unsigned i = 0; i < c.size(); ++i) {
+            switch (value(c[i])) {
+            case l_true: ++num_true; break;
+            case l_undef: return true;
+            default: break;
+            }
+        }
+        return num_true >= c.k();
+    }
+
+    bool card_extension::validate(pb const& p) const {
+        if (!is_active(p.lit())) return true;
+        uint64 sum = 0;
+        for (unsigned i = 0; i < p.size(); ++i) {
+            switch (value(p[i].second)) {
+            case l_true: sum += p[i].first; break;
+            case l_undef: return true;
+            default: break;
+            }
+        }
+        return sum >= p.k();
+    }
+
+    void card_extension::display(std::ostream& out, card const& c) const {
+        if (c.lit() != null_literal) out << c.lit() << " => ";
+        for (unsigned i = 0; i < c.size(); ++i) {
+            out << c[i] << " ";
+        }
+        out << ">= " << c.k() << "\n";
+    }
+
+    void card_extension::display(std::ostream& out, pb const& p) const {
+        if (p.lit() != null_literal) out << p.lit() << " => ";
+        for (unsigned i = 0; i < p.size(); ++i) {
+            out << p[i].first << "*" << p[i].second << " ";
+        }
+        out << ">= " << p.k() << "\n";
+    }
+
+    std::ostream& card_extension::display(std::ostream& out) const {
+        for (unsigned i = 0; i < m_cards.size(); ++i) {
+            display(out, *m_cards[i]);
+        }
+        for (unsigned i = 0; i < m_pbs.size(); ++i) {
+            display(out, *m_pbs[i]);
+        }
+        return m_gauss.display(out);
+    }
+
+};
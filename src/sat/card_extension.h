@@ -0,0 +1,196 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    card_extension.h
+
+Abstract:
+
+    Extension for cardinality and pseudo-Boolean constraints.
+
+    A constraint has the form
+
+        lit => w_1*l_1 + ... + w_n*l_n >= k
+
+    where lit is either null (the constraint is asserted) or a literal
+    that guards the constraint. Cardinality constraints (all weights 1)
+    are propagated by watching k + 1 literals. Pseudo-Boolean constraints
+    watch enough literals such that the sum of the watched weights (the slack)
+    covers k plus the maximal weight.
+
+    The extension also propagates XOR constraints using Gauss-Jordan
+    elimination, see sat_gauss.h.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#ifndef CARD_EXTENSION_H_
+#define CARD_EXTENSION_H_
+
+#include"sat_extension.h"
+#include"sat_solver.h"
+#include"sat_gauss.h"
+
+namespace sat {
+
+    class card_extension : public extension {
+    public:
+        typedef std::pair<unsigned, literal> wliteral;
+    private:
+        struct stats {
+            unsigned m_num_propagations;
+            unsigned m_num_conflicts;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        // m_lit => m_lits[0] + ... + m_lits[m_size-1] >= m_k
+        // m_lits[0..m_k] are watched.
+        class card {
+            unsigned m_index;
+            literal  m_lit;
+            unsigned m_k;
+            unsigned m_size;
+            literal  m_lits[0];
+        public:
+            static size_t get_obj_size(unsigned num_lits) { return sizeof(card) + num_lits * sizeof(literal); }
+            card(unsigned index, literal lit, literal_vector const& lits, unsigned k);
+            unsigned index() const { return m_index; }
+            literal lit() const { return m_lit; }
+            literal operator[](unsigned i) const { return m_lits[i]; }
+            unsigned k() const { return m_k; }
+            unsigned size() const { return m_size; }
+            void swap(unsigned i, unsigned j) { std::swap(m_lits[i], m_lits[j]); }
+        };
+
+        // m_lit => w_0*l_0 + ... + w_{m_size-1}*l_{m_size-1} >= m_k
+        // m_wlits[0..m_num_watch-1] are watched, m_slack is the sum of their weights.
+        class pb {
+            unsigned m_index;
+            literal  m_lit;
+            unsigned m_k;
+            unsigned m_size;
+            unsigned m_slack;
+            unsigned m_num_watch;
+            unsigned m_max_weight;
+            wliteral m_wlits[0];
+        public:
+            static size_t get_obj_size(unsigned num_lits) { return sizeof(pb) + num_lits * sizeof(wliteral); }
+            pb(unsigned index, literal lit, svector<wliteral> const& wlits, unsigned k);
+            unsigned index() const { return m_index; }
+            literal lit() const { return m_lit; }
+            wliteral operator[](unsigned i) const { return m_wlits[i]; }
+            unsigned k() const { return m_k; }
+            unsigned size() const { return m_size; }
+            unsigned slack() const { return m_slack; }
+            void set_slack(unsigned s) { m_slack = s; }
+            unsigned num_watch() const { return m_num_watch; }
+            void set_num_watch(unsigned n) { m_num_watch = n; }
+            unsigned max_weight() const { return m_max_weight; }
+            void swap(unsigned i, unsigned j) { std::swap(m_wlits[i], m_wlits[j]); }
+        };
+
+        solver*           m_solver;
+        stats             m_stats;
+        ptr_vector<card>  m_cards;
+        ptr_vector<pb>    m_pbs;
+        unsigned_vector   m_card_lim;    // number of cardinality constraints at each user scope.
+        unsigned_vector   m_pb_lim;
+        svector<uint64>   m_stamp;       // order in which the variables were assigned.
+        uint64            m_stamp_counter;
+        svector<wliteral> m_wlits;       // temporary
+        gauss             m_gauss;
+
+        solver& s() const { return *m_solver; }
+        lbool value(literal l) const { return m_solver->value(l); }
+        uint64 stamp(bool_var v) const { return v < m_stamp.size() ? m_stamp[v] : 0; }
+
+        // the two low bits of a constraint or justification index identify its kind.
+        enum index_tag { card_tag = 0, pb_tag = 1, xor_watch_tag = 2, xor_reason_tag = 3 };
+        static const unsigned num_tag_bits = 2;
+        static unsigned get_tag(unsigned idx) { return idx & 3; }
+        static bool is_card(unsigned idx) { return get_tag(idx) == card_tag; }
+        static unsigned card2index(unsigned i) { return (i << num_tag_bits) | card_tag; }
+        static unsigned pb2index(unsigned i) { return (i << num_tag_bits) | pb_tag; }
+        card& index2card(unsigned idx) const { SASSERT(is_card(idx)); return *m_cards[idx >> num_tag_bits]; }
+        pb& index2pb(unsigned idx) const { SASSERT(get_tag(idx) == pb_tag); return *m_pbs[idx >> num_tag_bits]; }
+
+        void watch_literal(literal lit, unsigned idx);
+        void unwatch_literal(literal lit, unsigned idx);
+        void watch_guard(literal guard, unsigned idx);
+        void unwatch_guard(literal guard, unsigned idx);
+        void assign(unsigned idx, literal lit);
+        void set_conflict(unsigned idx, literal lit);
+        bool is_active(literal guard) const { return guard == null_literal || value(guard) == l_true; }
+
+        void init_watch(card& c);
+        void clear_watch(card& c);
+        bool add_assign(card& c, literal alit);
+        void del_card(card* c);
+
+        void init_watch(pb& p);
+        void clear_watch(pb& p);
+        bool add_assign(pb& p, literal alit);
+        void del_pb(pb* p);
+
+        void add_card(literal lit, literal_vector const& lits, unsigned k);
+        void add_pb(literal lit, svector<wliteral> const& wlits, unsigned k);
+        void add_pb_core(literal guard, bool root, svector<wliteral> const& wlits, unsigned k);
+        void add_clause(literal guard, bool root, literal_vector& lits);
+        void init_constraints();
+
+        bool validate(card const& c) const;
+        bool validate(pb const& p) const;
+        void display(std::ostream& out, card const& c) const;
+        void display(std::ostream& out, pb const& p) const;
+
+    public:
+        card_extension();
+        virtual ~card_extension();
+
+        /**
+           \brief Add the constraint lits[0] + ... + lits[n-1] >= k.
+           If v is null_bool_var the constraint is asserted (relative to the current user scope),
+           otherwise v is a fresh variable that is defined to be equivalent to the constraint.
+        */
+        void add_at_least(bool_var v, literal_vector const& lits, unsigned k);
+
+        /**
+           \brief Add the constraint w_1*l_1 + ... + w_n*l_n >= k, see add_at_least.
+        */
+        void add_pb_ge(bool_var v, svector<wliteral> const& wlits, unsigned k);
+
+        /**
+           \brief Add the XOR constraint vars[0] + ... + vars[n-1] = rhs where the variables are sorted.
+           The constraint is redundant, it must be implied by the clauses.
+        */
+        void add_xor(bool_var_vector const& vars, bool rhs);
+
+        bool has_cardinality_constraints() const { return !m_cards.empty() || !m_pbs.empty(); }
+
+        virtual void set_solver(solver* s);
+        virtual void propagate(literal l, ext_constraint_idx idx, bool & keep);
+        virtual void get_antecedents(literal l, ext_justification_idx idx, literal_vector & r);
+        virtual void asserted(literal l);
+        virtual check_result check();
+        virtual void push();
+        virtual void pop(unsigned n);
+        virtual void simplify();
+        virtual void clauses_modifed() {}
+        virtual lbool get_phase(bool_var v) { return l_undef; }
+        virtual void user_push();
+        virtual void user_pop(unsigned num_scopes);
+        virtual bool_var max_var(bool_var v) const;
+        virtual void collect_statistics(statistics& st) const;
+        virtual std::ostream& display(std::ostream& out) const;
+        virtual extension* copy(solver* s);
+    };
+
+};
+
+#endif
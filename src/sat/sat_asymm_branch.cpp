@@ -163,6 +163,11 @@ namespace sat {
         SASSERT(new_sz < sz);
         TRACE("asymm_branch", tout << c << "\nnew_size: " << new_sz << "\n";
               for (unsigned i = 0; i < c.size(); i++) tout << static_cast<int>(s.value(c[i])) << " "; tout << "\n";);
+        bool drat = s.m_drat.enabled();
+        if (drat) {
+            m_drat_lits.reset();
+            m_drat_lits.append(sz, c.begin());
+        }
         // cleanup reduced clause
         unsigned j = 0;
         for (i = 0; i < new_sz; i++) {
@@ -183,23 +188,30 @@ namespace sat {
         m_elim_literals += sz - new_sz;
         switch(new_sz) {
         case 0:
+            if (drat) s.m_drat.add();
             s.set_conflict(justification());
             return false;
         case 1:
             TRACE("asymm_branch", tout << "produced unit clause: " << c[0] << "\n";);
             s.assign(c[0], justification());
             s.propagate_core(false); 
-            s.del_clause(c);
+            if (drat) s.m_drat.del(m_drat_lits);
+            s.del_clause(c, false);
             SASSERT(s.inconsistent() || s.m_qhead == s.m_trail.size());
             return false; // check_missed_propagation() may fail, since m_clauses is not in a consistent state.
         case 2:
             SASSERT(s.value(c[0]) == l_undef && s.value(c[1]) == l_undef);
             s.mk_bin_clause(c[0], c[1], false);
-            s.del_clause(c);
+            if (drat) s.m_drat.del(m_drat_lits);
+            s.del_clause(c, false);
             SASSERT(s.m_qhead == s.m_trail.size());
             return false;
         default:
             c.shrink(new_sz);
+            if (drat) {
+                s.m_drat.add(c);
+                s.m_drat.del(m_drat_lits);
+            }
             s.attach_clause(c);
             SASSERT(s.m_qhead == s.m_trail.size());
             return true;
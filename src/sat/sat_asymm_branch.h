@@ -31,6 +31,7 @@ namespace sat {
         
         solver & s;
         int      m_counter;
+        literal_vector m_drat_lits; // clause before it is reduced, for DRAT deletions
 
         // config
         bool                   m_asymm_branch;
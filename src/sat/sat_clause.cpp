@@ -32,6 +32,8 @@ namespace sat {
         m_used(false),
         m_frozen(false),
         m_reinit_stack(false),
+        m_vivified(false),
+        m_demoted(false),
         m_inact_rounds(0) {
         memcpy(m_lits, lits, sizeof(literal) * sz);
         mark_strengthened();
@@ -122,82 +124,55 @@ namespace sat {
     }
 
     clause_allocator::clause_allocator():
-        m_allocator("clause-allocator") {
-#if defined(_AMD64_)
-        m_num_segments = 0;
-#endif
+        m_allocator("clause-allocator"),
+        m_arena(0),
+        m_size(0),
+        m_capacity(0),
+        m_wasted(0),
+        m_heap_words(0),
+        m_new_arena(0),
+        m_new_size(0),
+        m_new_capacity(0) {
     }
 
-    clause * clause_allocator::get_clause(clause_offset cls_off) const {
-#if defined(_AMD64_)
-#if defined (Z3DEBUG)
-        clause const* result;
-        if (((cls_off & c_alignment_mask) == c_last_segment)) {
-            unsigned id = cls_off >> c_cls_alignment;
-            bool check = m_last_seg_id2cls.find(id, result);
-            SASSERT(check);
-            return const_cast<clause*>(result);
-        }
-#endif
-        return reinterpret_cast<clause *>(m_segments[cls_off & c_alignment_mask] + (static_cast<size_t>(cls_off) & ~c_alignment_mask));
-#else
-        return reinterpret_cast<clause *>(cls_off);
-#endif
+    clause_allocator::~clause_allocator() {
+        // the clauses are deleted by the owner, only the arena is released.
+        if (m_arena) dealloc_svect(m_arena);
+        if (m_new_arena) dealloc_svect(m_new_arena);
     }
 
-#if defined(_AMD64_)
-    unsigned clause_allocator::get_segment(clause const* cls) {
+    bool clause_allocator::in_arena(clause const * cls) const {
         size_t ptr = reinterpret_cast<size_t>(cls);
-
-        SASSERT((ptr & c_alignment_mask) == 0);
-        ptr &= 0xFFFFFFFF00000000ull; // Keep only high part
-        unsigned i = 0;
-        for (i = 0; i < m_num_segments; ++i)
-            if (m_segments[i] == ptr)
-                return i;
-        i = m_num_segments;
-        SASSERT(i <= c_last_segment);
-#if defined(Z3DEBUG)
-        if (i == c_last_segment) {
-            if (!m_last_seg_id2cls.contains(cls->id()))
-                m_last_seg_id2cls.insert(cls->id(), cls);
-        }
-        else {
-            ++m_num_segments;
-            m_segments[i] = ptr;
-        }
-#else
-        if (i == c_last_segment) {
-            throw default_exception("segment out of range");
-        }
-        m_segments[i] = ptr;
-        ++m_num_segments;
-#endif
-
-        return i;
+        return m_arena != 0 && reinterpret_cast<size_t>(m_arena) <= ptr && ptr < reinterpret_cast<size_t>(m_arena + m_size);
     }
-#endif
 
     clause_offset clause_allocator::get_offset(clause const * cls) const {
-#if defined(_AMD64_)
-        unsigned segment = const_cast<clause_allocator*>(this)->get_segment(cls);
-#if defined(Z3DEBUG)
-        SASSERT(segment <= c_last_segment);
-        if (segment == c_last_segment) {
-            SASSERT(m_last_seg_id2cls.contains(cls->id()));
-            return (cls->id() << c_cls_alignment) | c_last_segment;
+        if (in_arena(cls)) {
+            return static_cast<clause_offset>(reinterpret_cast<unsigned const *>(cls) - m_arena);
         }
-#endif
-        return static_cast<unsigned>(reinterpret_cast<size_t>(cls)) + segment;
-#else
-        return reinterpret_cast<size_t>(cls);
-#endif
+        SASSERT(cls->id() < m_heap.size() && m_heap[cls->id()] == cls);
+        return cls->id() | c_heap_bit;
     }
 
     clause * clause_allocator::mk_clause(unsigned num_lits, literal const * lits, bool learned) {
-        size_t size = clause::get_obj_size(num_lits);
-        void * mem = m_allocator.allocate(size);
-        clause * cls = new (mem) clause(m_id_gen.mk(), num_lits, lits, learned);
+        SASSERT(m_new_arena == 0);
+        unsigned num_words = get_num_words(num_lits);
+        unsigned id = m_id_gen.mk();
+        void * mem;
+        if (m_capacity - m_size >= num_words) {
+            mem = m_arena + m_size;
+            m_size += num_words;
+        }
+        else {
+            if (id >= c_heap_bit) {
+                throw default_exception("too many clauses");
+            }
+            mem = m_allocator.allocate(num_words * sizeof(unsigned));
+            m_heap.reserve(id + 1, 0);
+            m_heap_words += num_words;
+        }
+        clause * cls = new (mem) clause(id, num_lits, lits, learned);
+        if (!in_arena(cls)) m_heap[id] = cls;
         TRACE("sat", tout << "alloc: " << cls->id() << " " << *cls << " " << (learned?"l":"a") << "\n";);
         SASSERT(!learned || cls->is_learned());
         return cls;
@@ -206,14 +181,68 @@ namespace sat {
     void clause_allocator::del_clause(clause * cls) {
         TRACE("sat", tout << "delete: " << cls->id() << " " << *cls << "\n";);
         m_id_gen.recycle(cls->id());
-#if defined(_AMD64_)
-#if defined(Z3DEBUG)
-        m_last_seg_id2cls.remove(cls->id());
-#endif
-#endif
-        size_t size = clause::get_obj_size(cls->m_capacity);
-        cls->~clause();
-        m_allocator.deallocate(size, cls);
+        unsigned num_words = get_num_words(cls->m_capacity);
+        if (in_arena(cls)) {
+            m_wasted += num_words;
+            cls->~clause();
+        }
+        else {
+            m_heap[cls->id()] = 0;
+            m_heap_words -= num_words;
+            cls->~clause();
+            m_allocator.deallocate(num_words * sizeof(unsigned), cls);
+        }
+    }
+
+    bool clause_allocator::should_relocate() const {
+        return m_heap_words > 0 || m_wasted > (m_size - m_wasted) / 2;
+    }
+
+    void clause_allocator::start_relocation(unsigned num_words) {
+        SASSERT(m_new_arena == 0);
+        // leave room for the clauses that are created until the next relocation.
+        unsigned capacity = num_words + std::max(num_words / 2, 1024u);
+        if (capacity < num_words || capacity >= c_heap_bit) {
+            throw default_exception("clause arena overflow");
+        }
+        m_new_arena = alloc_svect(unsigned, capacity);
+        m_new_size = 0;
+        m_new_capacity = capacity;
+        m_forward.reset();
+    }
+
+    void clause_allocator::relocate(clause const & c) {
+        SASSERT(m_new_arena != 0);
+        SASSERT(!is_relocated(c));
+        unsigned num_words = get_num_words(c.size());
+        SASSERT(m_new_size + num_words <= m_new_capacity);
+        memcpy(m_new_arena + m_new_size, &c, clause::get_obj_size(c.size()));
+        reinterpret_cast<clause *>(m_new_arena + m_new_size)->m_capacity = c.size();
+        m_forward.reserve(c.id() + 1, UINT_MAX);
+        m_forward[c.id()] = m_new_size;
+        m_new_size += num_words;
+    }
+
+    void clause_allocator::end_relocation() {
+        SASSERT(m_new_arena != 0);
+        for (unsigned id = 0; id < m_heap.size(); ++id) {
+            clause * cls = m_heap[id];
+            if (cls) {
+                SASSERT(is_relocated(*cls));
+                m_allocator.deallocate(get_num_words(cls->m_capacity) * sizeof(unsigned), cls);
+            }
+        }
+        m_heap.reset();
+        m_heap_words = 0;
+        if (m_arena) dealloc_svect(m_arena);
+        m_arena = m_new_arena;
+        m_size = m_new_size;
+        m_capacity = m_new_capacity;
+        m_wasted = 0;
+        m_new_arena = 0;
+        m_new_size = 0;
+        m_new_capacity = 0;
+        m_forward.finalize();
     }
 
     std::ostream & operator<<(std::ostream & out, clause const & c) {
@@ -46,6 +46,8 @@ namespace sat {
         unsigned           m_used:1;
         unsigned           m_frozen:1;
         unsigned           m_reinit_stack:1;
+        unsigned           m_vivified:1;
+        unsigned           m_demoted:1;
         unsigned           m_inact_rounds:8;
         unsigned           m_glue:8;
         unsigned           m_psm:8;  // transient field used during gc
@@ -73,6 +75,8 @@ namespace sat {
         bool check_approx() const; // for debugging
         literal * begin() { return m_lits; }
         literal * end() { return m_lits + m_size; }
+        literal const * begin() const { return m_lits; }
+        literal const * end() const { return m_lits + m_size; }
         bool contains(literal l) const;
         bool contains(bool_var v) const;
         bool satisfied_by(model const & m) const;
@@ -93,6 +97,11 @@ namespace sat {
 
         bool on_reinit_stack() const { return m_reinit_stack; }
         void set_reinit_stack(bool f) { m_reinit_stack = f; }
+
+        bool was_vivified() const { return m_vivified; }
+        void set_vivified(bool f) { m_vivified = f; }
+        bool demoted() const { return m_demoted; }
+        void set_demoted(bool f) { m_demoted = f; }
     };
 
     std::ostream & operator<<(std::ostream & out, clause const & c);
@@ -124,28 +133,63 @@ namespace sat {
     };
 
     /**
-       \brief Simple clause allocator that allows uint (32bit integers) to be used to reference clauses (even in 64bit machines).
+       \brief Clause allocator that allows uint (32bit integers) to be used to reference clauses (even in 64bit machines).
+
+       Clauses are allocated in a contiguous arena of 32bit words and the offset of a clause
+       is its position in the arena. The arena is not resized while clauses are referenced by pointers,
+       when it is full clauses are allocated in the heap and their offsets are their ids tagged with c_heap_bit.
+
+       The memory of deleted clauses is reclaimed by relocating the remaining clauses
+       into a new arena (see start_relocation), the client is responsible for updating
+       the pointers and offsets of the relocated clauses.
     */
     class clause_allocator {
-        small_object_allocator m_allocator;
+        static const unsigned  c_heap_bit = 0x80000000;
+        small_object_allocator m_allocator;      // clauses that don't fit in the arena.
         id_gen                 m_id_gen;
-#if defined(_AMD64_)
-        unsigned get_segment(clause const* cls);
-        static const unsigned  c_cls_alignment = 3;
-        static const unsigned  c_last_segment  = (1ull << c_cls_alignment) - 1ull;
-        static const size_t    c_alignment_mask = (1ull << c_cls_alignment) - 1ull;
-        unsigned               m_num_segments;
-        size_t                 m_segments[c_last_segment];
-#if defined(Z3DEBUG)
-        u_map<clause const*>   m_last_seg_id2cls;
-#endif
-#endif
+        unsigned *             m_arena;
+        unsigned               m_size;           // number of words in use.
+        unsigned               m_capacity;
+        unsigned               m_wasted;         // words of deleted clauses in the arena.
+        unsigned               m_heap_words;     // words of the clauses in the heap.
+        ptr_vector<clause>     m_heap;           // clause id to clause allocated in the heap.
+        // relocation
+        unsigned *             m_new_arena;
+        unsigned               m_new_size;
+        unsigned               m_new_capacity;
+        unsigned_vector        m_forward;        // clause id to offset in the new arena.
+
+        static unsigned get_num_words(unsigned num_lits) { return static_cast<unsigned>((clause::get_obj_size(num_lits) + sizeof(unsigned) - 1) / sizeof(unsigned)); }
+        bool in_arena(clause const * cls) const;
     public:
         clause_allocator();
-        clause *      get_clause(clause_offset cls_off) const;
+        ~clause_allocator();
+        clause * get_clause(clause_offset cls_off) const {
+            if (cls_off & c_heap_bit) return m_heap[cls_off & ~c_heap_bit];
+            return reinterpret_cast<clause *>(m_arena + cls_off);
+        }
         clause_offset get_offset(clause const * ptr) const;
         clause *      mk_clause(unsigned num_lits, literal const * lits, bool learned);
         void          del_clause(clause * cls);
+
+        /**
+           \brief Return true if enough memory is wasted by deleted clauses
+           or clauses in the heap to make relocation worthwhile.
+        */
+        bool should_relocate() const;
+
+        /**
+           \brief Start relocating the clauses into a new arena that has room for num_words of clauses.
+           Every clause that remains in use must be moved using relocate, the other clauses
+           are released by end_relocation.
+        */
+        void start_relocation(unsigned num_words);
+        unsigned get_relocated_words(clause const & c) const { return get_num_words(c.size()); }
+        void relocate(clause const & c);
+        bool is_relocated(clause const & c) const { return c.id() < m_forward.size() && m_forward[c.id()] != UINT_MAX; }
+        clause_offset get_relocated(clause_offset cls_off) const { return m_forward[get_clause(cls_off)->id()]; }
+        clause * get_relocated(clause const * c) const { return reinterpret_cast<clause *>(m_new_arena + m_forward[c->id()]); }
+        void end_relocation();
     };
 
     /**
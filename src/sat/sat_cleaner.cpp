@@ -89,7 +89,12 @@ namespace sat {
             unsigned sz = c.size();
             unsigned i = 0, j = 0;
             bool sat = false;
+            bool drat = s.m_drat.enabled();
             m_cleanup_counter += sz;
+            if (drat) {
+                m_old.reset();
+                m_old.append(sz, c.begin());
+            }
             for (; i < sz; i++) {
                 switch (s.value(c[i])) {
                 case l_true:
@@ -110,7 +115,8 @@ namespace sat {
                    tout << mk_lits_pp(j, c.begin()) << "\n";);
             if (sat) {
                 m_elim_clauses++;
-                s.del_clause(c);
+                if (drat) s.m_drat.del(m_old);
+                s.del_clause(c, false);
             }
             else {
                 unsigned new_sz = j;
@@ -122,24 +128,31 @@ namespace sat {
                     // active clauses would have signed the conflict.
                     SASSERT(c.frozen());
                     s.set_conflict(justification());
-                    s.del_clause(c);
+                    if (drat) s.m_drat.del(m_old);
+                    s.del_clause(c, false);
                 }
                 else if (new_sz == 1) {
                     // It can only happen with frozen clauses.
                     // active clauses would have propagated the literal
                     SASSERT(c.frozen());
                     s.assign(c[0], justification());
-                    s.del_clause(c);
+                    if (drat) s.m_drat.del(m_old);
+                    s.del_clause(c, false);
                 }
                 else {
                     SASSERT(s.value(c[0]) == l_undef && s.value(c[1]) == l_undef);
                     if (new_sz == 2) {
                         TRACE("cleanup_bug", tout << "clause became binary: " << c[0] << " " << c[1] << "\n";);
                         s.mk_bin_clause(c[0], c[1], c.is_learned());
-                        s.del_clause(c);
+                        if (drat) s.m_drat.del(m_old);
+                        s.del_clause(c, false);
                     }
                     else {
                         c.shrink(new_sz);
+                        if (drat && new_sz < sz) {
+                            s.m_drat.add(c);
+                            s.m_drat.del(m_old);
+                        }
                         *it2 = *it;
                         it2++;
                         if (!c.frozen()) {
@@ -30,6 +30,7 @@ namespace sat {
         solver & s;
         unsigned m_last_num_units;
         int      m_cleanup_counter;
+        literal_vector m_old;  // copy of the clause being cleaned, used for DRAT deletions
 
         // stats
         unsigned m_elim_clauses;
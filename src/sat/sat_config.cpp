@@ -28,13 +28,21 @@ namespace sat {
         m_always_false("always_false"),
         m_caching("caching"),
         m_random("random"),
+        m_vsids("vsids"),
+        m_vmtf("vmtf"),
+        m_chb("chb"),
         m_geometric("geometric"),
         m_luby("luby"),
+        m_ema("ema"),
+        m_glucose("glucose"),
+        m_portfolio("portfolio"),
+        m_cube("cube"),
         m_dyn_psm("dyn_psm"),
         m_psm("psm"),
         m_glue("glue"),
         m_glue_psm("glue_psm"),
-        m_psm_glue("psm_glue") {
+        m_psm_glue("psm_glue"),
+        m_tiered("tiered") {
         m_num_parallel = 1;
         updt_params(p); 
     }
@@ -48,6 +56,8 @@ namespace sat {
             m_restart = RS_LUBY;
         else if (s == m_geometric)
             m_restart = RS_GEOMETRIC;
+        else if (s == m_ema || s == m_glucose)
+            m_restart = RS_EMA;
         else
             throw sat_param_exception("invalid restart strategy");
 
@@ -63,12 +73,30 @@ namespace sat {
         else
             throw sat_param_exception("invalid phase selection strategy");
 
+        s = p.branching_heuristic();
+        if (s == m_vsids)
+            m_branching_heuristic = BH_VSIDS;
+        else if (s == m_vmtf)
+            m_branching_heuristic = BH_VMTF;
+        else if (s == m_chb)
+            m_branching_heuristic = BH_CHB;
+        else
+            throw sat_param_exception("invalid branching heuristic");
+        m_branching_switch = p.branching_switch();
+
         m_phase_caching_on  = p.phase_caching_on();
         m_phase_caching_off = p.phase_caching_off();
 
         m_restart_initial = p.restart_initial();
         m_restart_factor  = p.restart_factor();
         m_restart_max     = p.restart_max();
+        m_restart_margin  = p.restart_margin();
+        m_restart_fast_glue = p.restart_emafastglue();
+        m_restart_slow_glue = p.restart_emaslowglue();
+        m_restart_blocking  = p.restart_blocking();
+        m_restart_blocking_margin = p.restart_blocking_margin();
+        m_restart_blocking_delay  = p.restart_blocking_delay();
+        m_restart_partial   = p.restart_partial();
 
         m_random_freq     = p.random_freq();
         m_random_seed     = p.random_seed();
@@ -79,6 +107,17 @@ namespace sat {
         
         m_max_conflicts   = p.max_conflicts();
         m_num_parallel    = p.parallel_threads();
+        m_par_share_glue  = p.parallel_share_glue();
+        m_par_share_size  = p.parallel_share_size();
+        m_par_diversify   = p.parallel_diversify();
+        m_par_cube_depth  = p.parallel_cube_depth();
+        s = p.parallel_strategy();
+        if (s == m_portfolio)
+            m_par_strategy = PAR_PORTFOLIO;
+        else if (s == m_cube)
+            m_par_strategy = PAR_CUBE;
+        else
+            throw sat_param_exception("invalid parallel strategy");
         
         // These parameters are not exposed
         m_simplify_mult1  = _p.get_uint("simplify_mult1", 300);
@@ -96,6 +135,12 @@ namespace sat {
             if (m_gc_k > 255)
                 m_gc_k = 255;
         }
+        else if (s == m_tiered) {
+            // the local tier is reduced at a fixed interval.
+            m_gc_strategy     = GC_TIERED;
+            m_gc_initial      = p.gc_local();
+            m_gc_increment    = 0;
+        }
         else {
             if (s == m_glue_psm)
                 m_gc_strategy = GC_GLUE_PSM;
@@ -110,10 +155,26 @@ namespace sat {
             m_gc_initial      = p.gc_initial();
             m_gc_increment    = p.gc_increment();
         }
+        m_gc_tier1            = p.gc_tier1();
+        m_gc_tier2            = p.gc_tier2();
+        m_gc_tier2_interval   = p.gc_mid();
         m_minimize_lemmas = p.minimize_lemmas();
         m_core_minimize   = p.core_minimize();
         m_core_minimize_partial   = p.core_minimize_partial();
         m_dyn_sub_res     = p.dyn_sub_res();
+        m_drat_file       = p.drat_file();
+        m_drat            = m_drat_file != symbol::null && m_drat_file != symbol("");
+        m_drat_binary     = p.drat_binary();
+        m_local_search    = p.local_search();
+        m_local_search_interval = p.local_search_interval();
+        m_local_search_flips = p.local_search_flips();
+        m_local_search_cb = p.local_search_cb();
+        if (m_local_search_cb <= 0)
+            throw sat_param_exception("local_search.cb must be positive");
+        m_inprocess_adaptive = p.inprocess_adaptive();
+        // XOR reasoning is not justified by DRAT proofs.
+        m_xor_solver      = p.xor_solver() && !m_drat;
+        m_xor_max_size    = std::min(p.xor_max_size(), 6u);
     }
 
     void config::collect_param_descrs(param_descrs & r) {
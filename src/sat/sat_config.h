@@ -31,9 +31,21 @@ namespace sat {
         PS_RANDOM
     };
 
+    enum branching_heuristic {
+        BH_VSIDS,
+        BH_VMTF,
+        BH_CHB
+    };
+
     enum restart_strategy {
         RS_GEOMETRIC,
-        RS_LUBY
+        RS_LUBY,
+        RS_EMA
+    };
+
+    enum par_strategy {
+        PAR_PORTFOLIO,
+        PAR_CUBE
     };
 
     enum gc_strategy {
@@ -41,23 +53,38 @@ namespace sat {
         GC_PSM,
         GC_GLUE,
         GC_GLUE_PSM,
-        GC_PSM_GLUE
+        GC_PSM_GLUE,
+        GC_TIERED
     };
 
     struct config {
         unsigned long long m_max_memory;
         phase_selection    m_phase;
+        branching_heuristic m_branching_heuristic;
+        unsigned           m_branching_switch;
         unsigned           m_phase_caching_on;
         unsigned           m_phase_caching_off;
         restart_strategy   m_restart;
         unsigned           m_restart_initial;
         double             m_restart_factor; // for geometric case
         unsigned           m_restart_max;
+        double             m_restart_margin; // for ema case
+        double             m_restart_fast_glue;
+        double             m_restart_slow_glue;
+        bool               m_restart_blocking;
+        double             m_restart_blocking_margin;
+        unsigned           m_restart_blocking_delay;
+        bool               m_restart_partial;
         double             m_random_freq;
         unsigned           m_random_seed;
         unsigned           m_burst_search;
         unsigned           m_max_conflicts;
         unsigned           m_num_parallel;
+        unsigned           m_par_share_glue;
+        unsigned           m_par_share_size;
+        bool               m_par_diversify;
+        par_strategy       m_par_strategy;
+        unsigned           m_par_cube_depth;
 
         unsigned           m_simplify_mult1;
         double             m_simplify_mult2;
@@ -68,25 +95,45 @@ namespace sat {
         unsigned           m_gc_increment;
         unsigned           m_gc_small_lbd;
         unsigned           m_gc_k;
+        unsigned           m_gc_tier1;
+        unsigned           m_gc_tier2;
+        unsigned           m_gc_tier2_interval;
 
         bool               m_minimize_lemmas;
         bool               m_dyn_sub_res;
         bool               m_core_minimize;
         bool               m_core_minimize_partial;
-
+        bool               m_drat;
+        symbol             m_drat_file;
+        bool               m_drat_binary;
+        bool               m_local_search;
+        unsigned           m_local_search_interval;
+        unsigned           m_local_search_flips;
+        double             m_local_search_cb;
+        bool               m_inprocess_adaptive;
+        bool               m_xor_solver;
+        unsigned           m_xor_max_size;
 
         symbol             m_always_true;
         symbol             m_always_false;
         symbol             m_caching;
         symbol             m_random;
+        symbol             m_vsids;
+        symbol             m_vmtf;
+        symbol             m_chb;
         symbol             m_geometric;
         symbol             m_luby;
+        symbol             m_ema;
+        symbol             m_glucose;
+        symbol             m_portfolio;
+        symbol             m_cube;
         
         symbol             m_dyn_psm;
         symbol             m_psm;        
         symbol             m_glue;        
         symbol             m_glue_psm;        
         symbol             m_psm_glue;        
+        symbol             m_tiered;
         
         config(params_ref const & p);
         void updt_params(params_ref const & p);
@@ -0,0 +1,144 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_drat.cpp
+
+Abstract:
+
+    Produce DRAT proofs.
+
+Author:
+
+
+
+Notes:
+
+--*/
+#include"sat_drat.h"
+#include"sat_clause.h"
+
+namespace sat {
+
+    drat::drat():
+        m_out(0),
+        m_binary(true),
+        m_buffer(0),
+        m_pos(0),
+        m_num_add(0),
+        m_num_del(0) {
+    }
+
+    drat::~drat() {
+        close();
+    }
+
+    void drat::open(symbol const& file, bool binary) {
+        if (m_out && file == m_file && binary == m_binary) {
+            return;
+        }
+        close();
+        m_binary = binary;
+        if (file == symbol::null || file.str().empty()) {
+            return;
+        }
+        std::ios_base::openmode mode = std::ios_base::out | std::ios_base::trunc;
+        if (binary) mode |= std::ios_base::binary;
+        m_out = alloc(std::ofstream, file.str().c_str(), mode);
+        if (m_out->bad() || m_out->fail()) {
+            dealloc(m_out);
+            m_out = 0;
+            throw default_exception("could not open file for DRAT proof");
+        }
+        m_buffer = alloc_svect(char, s_buffer_size);
+        m_pos = 0;
+        m_file = file;
+    }
+
+    void drat::close() {
+        if (m_out) {
+            flush();
+            dealloc(m_out);
+            m_out = 0;
+            m_file = symbol::null;
+        }
+        if (m_buffer) {
+            dealloc_svect(m_buffer);
+            m_buffer = 0;
+        }
+    }
+
+    void drat::flush() {
+        if (m_out && m_pos > 0) {
+            m_out->write(m_buffer, m_pos);
+            m_out->flush();
+        }
+        m_pos = 0;
+    }
+
+    void drat::put_lit(literal l) {
+        if (m_binary) {
+            // variable length encoding of 2*v + sign.
+            unsigned u = 2 * l.var() + (l.sign() ? 1 : 0);
+            while (u > 127) {
+                put(static_cast<char>(128 | (u & 127)));
+                u >>= 7;
+            }
+            put(static_cast<char>(u));
+        }
+        else {
+            char digits[16];
+            unsigned n = 0;
+            unsigned v = l.var();
+            do {
+                digits[n++] = static_cast<char>('0' + (v % 10));
+                v /= 10;
+            }
+            while (v > 0);
+            if (l.sign()) put('-');
+            while (n > 0) put(digits[--n]);
+            put(' ');
+        }
+    }
+
+    void drat::dump(unsigned n, literal const* lits, bool is_del) {
+        if (!m_out) {
+            return;
+        }
+        if (is_del) ++m_num_del; else ++m_num_add;
+        if (m_binary) {
+            put(is_del ? 'd' : 'a');
+        }
+        else if (is_del) {
+            put('d');
+            put(' ');
+        }
+        for (unsigned i = 0; i < n; ++i) {
+            put_lit(lits[i]);
+        }
+        if (m_binary) {
+            put(0);
+        }
+        else {
+            put('0');
+            put('\n');
+        }
+    }
+
+    void drat::add(clause const& c) {
+        dump(c.size(), c.begin(), false);
+    }
+
+    void drat::del(clause const& c) {
+        dump(c.size(), c.begin(), true);
+    }
+
+    void drat::collect_statistics(statistics & st) const {
+        if (m_out) {
+            st.update("drat added", m_num_add);
+            st.update("drat deleted", m_num_del);
+        }
+    }
+
+};
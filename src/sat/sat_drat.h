@@ -0,0 +1,89 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_drat.h
+
+Abstract:
+
+    Produce DRAT proofs.
+
+    Clauses derived by the solver (learned clauses, units at the base level,
+    clauses strengthened by the simplifiers) are added to the proof,
+    and clauses deleted by garbage collection or simplification are
+    recorded as deletions. The proof is written in either the textual
+    or the binary DRAT format through a private output buffer.
+
+    Variables are written using their index in the solver, which
+    coincides with the numbering of a DIMACS input.
+
+Author:
+
+
+
+Notes:
+
+    Proofs are not produced for solvers that use an extension
+    or that run in parallel mode.
+
+--*/
+#ifndef SAT_DRAT_H_
+#define SAT_DRAT_H_
+
+#include"sat_types.h"
+#include"symbol.h"
+#include"statistics.h"
+#include<fstream>
+
+namespace sat {
+    class clause;
+
+    class drat {
+        std::ofstream* m_out;
+        symbol         m_file;
+        bool           m_binary;
+        char*          m_buffer;
+        unsigned       m_pos;
+        unsigned       m_num_add;
+        unsigned       m_num_del;
+
+        void put(char c) { 
+            if (m_pos == s_buffer_size) flush(); 
+            m_buffer[m_pos++] = c; 
+        }
+        void put_lit(literal l);
+        void dump(unsigned n, literal const* lits, bool is_del);
+        void close();
+        static const unsigned s_buffer_size = 1 << 16;
+    public:
+        drat();
+        ~drat();
+
+        /**
+           \brief start writing a proof to the given file, 
+           or stop producing proofs if the file name is empty.
+           Nothing happens if the proof is already written to the given file.
+        */
+        void open(symbol const& file, bool binary);
+        bool enabled() const { return m_out != 0; }
+
+        void add() { dump(0, 0, false); }
+        void add(literal l) { dump(1, &l, false); }
+        void add(literal l1, literal l2) { literal ls[2] = { l1, l2 }; dump(2, ls, false); }
+        void add(clause const& c);
+        void add(unsigned n, literal const* lits) { dump(n, lits, false); }
+        void add(literal_vector const& c) { dump(c.size(), c.c_ptr(), false); }
+
+        void del(literal l1, literal l2) { literal ls[2] = { l1, l2 }; dump(2, ls, true); }
+        void del(clause const& c);
+        void del(literal_vector const& c) { dump(c.size(), c.c_ptr(), true); }
+
+        void flush();
+
+        void collect_statistics(statistics & st) const;
+    };
+
+};
+
+#endif
@@ -33,7 +33,32 @@ namespace sat {
             return roots[l.var()];
     }
 
+    /**
+       \brief Record a clause that is deleted from the DRAT proof.
+       Deletions are postponed until all substituted clauses were added,
+       because the substitutions are justified by the binary clauses that are being rewritten.
+    */
+    void elim_eqs::drat_del(unsigned n, literal const * lits) {
+        m_drat_lits.append(n, lits);
+        m_drat_lits.push_back(null_literal);
+    }
+
+    void elim_eqs::drat_flush() {
+        literal_vector lits;
+        for (unsigned i = 0; i < m_drat_lits.size(); ++i) {
+            if (m_drat_lits[i] == null_literal) {
+                m_solver.m_drat.del(lits);
+                lits.reset();
+            }
+            else {
+                lits.push_back(m_drat_lits[i]);
+            }
+        }
+        m_drat_lits.reset();
+    }
+
     void elim_eqs::cleanup_bin_watches(literal_vector const & roots) {
+        bool drat = m_solver.m_drat.enabled();
         vector<watch_list>::iterator it  = m_solver.m_watches.begin();
         vector<watch_list>::iterator end = m_solver.m_watches.end();
         for (unsigned l_idx = 0; it != end; ++it, ++l_idx) {
@@ -47,6 +72,15 @@ namespace sat {
                 if (it2->is_binary_clause()) {
                     literal l2 = it2->get_literal();
                     literal r2 = norm(roots, l2);
+                    if (drat && l1.index() < l2.index() && (l1 != r1 || l2 != r2)) {
+                        // each binary clause occurs in two watch lists, log it only once.
+                        if (r1 == r2) 
+                            m_solver.m_drat.add(r1);
+                        else if (r1 != ~r2)
+                            m_solver.m_drat.add(r1, r2);
+                        literal ls[2] = { l1, l2 };
+                        drat_del(2, ls);
+                    }
                     if (r1 == r2) {
                         m_solver.assign(r1, justification());
                         if (m_solver.inconsistent())
@@ -95,6 +129,9 @@ namespace sat {
             }
             if (!c.frozen())
                 m_solver.dettach_clause(c);
+            bool drat = m_solver.m_drat.enabled();
+            if (drat) 
+                drat_del(sz, c.begin());
             // apply substitution
             for (i = 0; i < sz; i++) {
                 SASSERT(!m_solver.was_eliminated(c[i].var()));
@@ -122,11 +159,13 @@ namespace sat {
             }
             if (i < sz) {
                 // clause is a tautology or was simplified
-                m_solver.del_clause(c);
+                m_solver.del_clause(c, false);
                 continue; 
             }
             if (j == 0) {
                 // empty clause
+                if (drat) 
+                    m_solver.m_drat.add();
                 m_solver.set_conflict(justification());
                 for (; it != end; ++it) {
                     *it2 = *it;
@@ -150,13 +189,15 @@ namespace sat {
             switch (j) {
             case 1:
                 m_solver.assign(c[0], justification());
-                m_solver.del_clause(c);
+                m_solver.del_clause(c, false);
                 break;
             case 2:
                 m_solver.mk_bin_clause(c[0], c[1], c.is_learned());
-                m_solver.del_clause(c);
+                m_solver.del_clause(c, false);
                 break;
             default:
+                if (drat) 
+                    m_solver.m_drat.add(c);
                 SASSERT(*it == &c);
                 *it2 = *it;
                 it2++;
@@ -215,10 +256,12 @@ namespace sat {
         cleanup_bin_watches(roots);
         TRACE("elim_eqs", tout << "after bin cleanup\n"; m_solver.display(tout););
         cleanup_clauses(roots, m_solver.m_clauses);
+        if (!m_solver.inconsistent()) 
+            cleanup_clauses(roots, m_solver.m_learned);
+        if (!m_solver.inconsistent()) 
+            save_elim(roots, to_elim);
+        drat_flush();
         if (m_solver.inconsistent()) return;
-        cleanup_clauses(roots, m_solver.m_learned);
-        if (m_solver.inconsistent()) return;
-        save_elim(roots, to_elim);
         m_solver.propagate(false);
         SASSERT(check_clauses(roots));
     }
@@ -26,6 +26,9 @@ namespace sat {
     
     class elim_eqs {
         solver & m_solver;
+        literal_vector m_drat_lits; // clauses to be deleted from the DRAT proof, separated by null_literal
+        void drat_del(unsigned n, literal const * lits);
+        void drat_flush();
         void save_elim(literal_vector const & roots, bool_var_vector const & to_elim);
         void cleanup_clauses(literal_vector const & roots, clause_vector & cs);
         void cleanup_bin_watches(literal_vector const & roots);
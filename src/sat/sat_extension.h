@@ -21,15 +21,20 @@ Revision History:
 
 #include"sat_types.h"
 #include"params.h"
+#include"statistics.h"
 
 namespace sat {
 
+    class solver;
+
     enum check_result {
         CR_DONE, CR_CONTINUE, CR_GIVEUP
     };
 
     class extension {
     public:
+        virtual ~extension() {}
+        virtual void set_solver(solver* s) = 0;
         virtual void propagate(literal l, ext_constraint_idx idx, bool & keep) = 0;
         virtual void get_antecedents(literal l, ext_justification_idx idx, literal_vector & r) = 0;
         virtual void asserted(literal l) = 0;
@@ -39,6 +44,19 @@ namespace sat {
         virtual void simplify() = 0;
         virtual void clauses_modifed() = 0;
         virtual lbool get_phase(bool_var v) = 0;
+        virtual void user_push() = 0;
+        virtual void user_pop(unsigned num_scopes) = 0;
+        /**
+           \brief Return the maximum of v and the variables used by the extension.
+        */
+        virtual bool_var max_var(bool_var v) const = 0;
+        virtual void collect_statistics(statistics& st) const = 0;
+        virtual std::ostream& display(std::ostream& out) const = 0;
+        /**
+           \brief Create a copy of the extension for the solver s.
+           The variables and the root assignment of s are copied from the original solver.
+        */
+        virtual extension* copy(solver* s) = 0;
     };
 
 };
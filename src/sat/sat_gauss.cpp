@@ -0,0 +1,518 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_gauss.cpp
+
+Abstract:
+
+    Gauss-Jordan elimination for XOR constraints.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include<algorithm>
+#include"sat_gauss.h"
+#include"sat_solver.h"
+#include"bit_util.h"
+
+namespace sat {
+
+    // systems with more cells are not handled by elimination.
+    static const unsigned max_matrix_cells = 1 << 26;
+
+    static unsigned ntz64(uint64 w) {
+        SASSERT(w != 0);
+        unsigned lo = static_cast<unsigned>(w);
+        return lo != 0 ? ntz_core(lo) : 32 + ntz_core(static_cast<unsigned>(w >> 32));
+    }
+
+    gauss::matrix::matrix(bool_var_vector const& vars, unsigned num_rows):
+        m_num_cols(vars.size()),
+        m_num_words((vars.size() + 64) / 64),
+        m_num_rows(num_rows),
+        m_bits(num_rows * ((vars.size() + 64) / 64), 0ull),
+        m_col_watch(vars.size()),
+        m_col2var(vars),
+        m_row_mark(num_rows, 0u),
+        m_mark(0) {
+    }
+
+    /**
+       \brief Return the first column of row r at or after column c, or m_num_cols if there is none.
+    */
+    unsigned gauss::matrix::next_col(unsigned r, unsigned c) const {
+        uint64 const* bits = row(r);
+        unsigned i = c / 64;
+        if (i >= m_num_words) return m_num_cols;
+        uint64 w = bits[i] & (~0ull << (c % 64));
+        while (w == 0) {
+            if (++i == m_num_words) return m_num_cols;
+            w = bits[i];
+        }
+        return std::min(i * 64 + ntz64(w), m_num_cols);
+    }
+
+    void gauss::matrix::add_row(unsigned dst, unsigned src) {
+        uint64* d = row(dst);
+        uint64 const* s = row(src);
+        for (unsigned i = 0; i < m_num_words; ++i) {
+            d[i] ^= s[i];
+        }
+    }
+
+    void gauss::matrix::copy_row(unsigned dst, unsigned src) {
+        uint64* d = row(dst);
+        uint64 const* s = row(src);
+        for (unsigned i = 0; i < m_num_words; ++i) {
+            d[i] = s[i];
+        }
+    }
+
+    gauss::gauss(unsigned num_tag_bits, unsigned watch_tag, unsigned reason_tag):
+        m_solver(0),
+        m_num_tag_bits(num_tag_bits),
+        m_watch_tag(watch_tag),
+        m_reason_tag(reason_tag),
+        m_dirty(false) {
+    }
+
+    gauss::~gauss() {
+        std::for_each(m_matrices.begin(), m_matrices.end(), delete_proc<matrix>());
+    }
+
+    lbool gauss::value(matrix const& m, unsigned c) const {
+        return s().value(m.m_col2var[c]);
+    }
+
+    literal gauss::true_literal(matrix const& m, unsigned c) const {
+        SASSERT(value(m, c) != l_undef);
+        return literal(m.m_col2var[c], value(m, c) == l_false);
+    }
+
+    unsigned gauss::hash(bool_var_vector const& vars, bool rhs) {
+        unsigned h = rhs ? 17 : 31;
+        for (unsigned i = 0; i < vars.size(); ++i) {
+            h = combine_hash(h, vars[i]);
+        }
+        return h;
+    }
+
+    void gauss::add_xor(bool_var_vector const& vars, bool rhs) {
+        unsigned_vector& same = m_xor_table.insert_if_not_there2(hash(vars, rhs), unsigned_vector())->get_data().m_value;
+        for (unsigned i = 0; i < same.size(); ++i) {
+            unsigned j = same[i];
+            if (m_rhs[j] == rhs && m_xors[j].size() == vars.size() &&
+                std::equal(vars.begin(), vars.end(), m_xors[j].begin())) {
+                return;
+            }
+        }
+        same.push_back(m_xors.size());
+        m_xors.push_back(vars);
+        m_rhs.push_back(rhs);
+        m_stats.m_num_xors++;
+        m_dirty = true;
+    }
+
+    void gauss::watch_column(bool_var v, unsigned idx) {
+        s().get_wlist(literal(v, false)).push_back(watched(idx));
+        s().get_wlist(literal(v, true)).push_back(watched(idx));
+    }
+
+    void gauss::unwatch_column(bool_var v, unsigned idx) {
+        s().get_wlist(literal(v, false)).erase(watched(idx));
+        s().get_wlist(literal(v, true)).erase(watched(idx));
+    }
+
+    void gauss::reset_matrices() {
+        for (unsigned g = 0; g < m_col2matrix.size(); ++g) {
+            unwatch_column(m_matrices[m_col2matrix[g]]->m_col2var[m_col2local[g]], col2index(g));
+        }
+        std::for_each(m_matrices.begin(), m_matrices.end(), delete_proc<matrix>());
+        m_matrices.reset();
+        m_col2matrix.reset();
+        m_col2local.reset();
+    }
+
+    void gauss::init() {
+        if (!m_dirty || s().inconsistent()) return;
+        SASSERT(s().scope_lvl() == 0);
+        m_dirty = false;
+        reset_matrices();
+        init_matrices();
+    }
+
+    void gauss::init_watches() {
+        for (unsigned g = 0; g < m_col2matrix.size(); ++g) {
+            bool_var v = m_matrices[m_col2matrix[g]]->m_col2var[m_col2local[g]];
+            unwatch_column(v, col2index(g));
+            watch_column(v, col2index(g));
+        }
+    }
+
+    /**
+       \brief Split the XOR constraints into systems that do not share variables,
+       the variables that are assigned at the base level are replaced by their values.
+    */
+    void gauss::init_matrices() {
+        unsigned num_vars = s().num_vars();
+        unsigned_vector parent;
+        for (bool_var v = 0; v < num_vars; ++v) parent.push_back(v);
+        vector<bool_var_vector> xors;
+        svector<bool> rhs;
+        for (unsigned i = 0; i < m_xors.size(); ++i) {
+            bool_var_vector const& vars = m_xors[i];
+            bool_var_vector unassigned;
+            bool r = m_rhs[i];
+            for (unsigned j = 0; j < vars.size(); ++j) {
+                switch (s().value(vars[j])) {
+                case l_true: r = !r; break;
+                case l_false: break;
+                default: unassigned.push_back(vars[j]); break;
+                }
+            }
+            if (unassigned.empty()) {
+                if (r) {
+                    TRACE("sat", tout << "xor is false at the base level\n";);
+                    s().set_conflict(justification());
+                    return;
+                }
+                continue;
+            }
+            for (unsigned j = 1; j < unassigned.size(); ++j) {
+                unsigned a = unassigned[0], b = unassigned[j];
+                while (parent[a] != a) a = parent[a] = parent[parent[a]];
+                while (parent[b] != b) b = parent[b] = parent[parent[b]];
+                parent[b] = a;
+            }
+            xors.push_back(unassigned);
+            rhs.push_back(r);
+        }
+
+        // collect the rows and columns of each system.
+        unsigned_vector root2system(num_vars, UINT_MAX);
+        vector<unsigned_vector> system_rows;
+        vector<bool_var_vector> system_vars;
+        unsigned_vector var2col(num_vars, UINT_MAX);
+        for (unsigned i = 0; i < xors.size(); ++i) {
+            bool_var r = xors[i][0];
+            while (parent[r] != r) r = parent[r];
+            if (root2system[r] == UINT_MAX) {
+                root2system[r] = system_rows.size();
+                system_rows.push_back(unsigned_vector());
+                system_vars.push_back(bool_var_vector());
+            }
+            unsigned k = root2system[r];
+            system_rows[k].push_back(i);
+            for (unsigned j = 0; j < xors[i].size(); ++j) {
+                bool_var v = xors[i][j];
+                if (var2col[v] == UINT_MAX) {
+                    var2col[v] = system_vars[k].size();
+                    system_vars[k].push_back(v);
+                }
+            }
+        }
+
+        for (unsigned k = 0; k < system_rows.size() && !s().inconsistent(); ++k) {
+            unsigned_vector const& rows = system_rows[k];
+            bool_var_vector const& vars = system_vars[k];
+            if (static_cast<uint64>(rows.size()) * vars.size() > max_matrix_cells) {
+                IF_VERBOSE(2, verbose_stream() << "(sat.gauss skipping system with " << rows.size() << " rows and " << vars.size() << " columns)\n";);
+                continue;
+            }
+            matrix* m = alloc(matrix, vars, rows.size());
+            for (unsigned i = 0; i < rows.size(); ++i) {
+                bool_var_vector const& x = xors[rows[i]];
+                for (unsigned j = 0; j < x.size(); ++j) {
+                    m->flip(i, var2col[x[j]]);
+                }
+                if (rhs[rows[i]]) m->flip(i, m->m_num_cols);
+            }
+            eliminate(*m);
+            if (s().inconsistent() || m->m_num_rows == 0) {
+                dealloc(m);
+                continue;
+            }
+            unsigned idx = m_matrices.size();
+            m_matrices.push_back(m);
+            for (unsigned c = 0; c < m->m_num_cols; ++c) {
+                unsigned g = m_col2matrix.size();
+                m_col2matrix.push_back(idx);
+                m_col2local.push_back(c);
+                watch_column(m->m_col2var[c], col2index(g));
+            }
+            for (unsigned r = 0; r < m->m_num_rows; ++r) {
+                m->m_col_watch[m->m_basic[r]].push_back(r);
+                m->m_watch.push_back(UINT_MAX);
+            }
+            for (unsigned r = 0; r < m->m_num_rows && !s().inconsistent(); ++r) {
+                check_row(*m, r);
+                propagate_queue(*m);
+            }
+        }
+        IF_VERBOSE(2, verbose_stream() << "(sat.gauss :xors " << m_xors.size() << " :systems " << m_matrices.size() << ")\n";);
+    }
+
+    /**
+       \brief Bring m into reduced row echelon form and remove the zero rows.
+    */
+    void gauss::eliminate(matrix& m) {
+        unsigned num_rows = m.m_num_rows;
+        unsigned j = 0;
+        m.m_basic.reset();
+        for (unsigned i = 0; i < num_rows; ++i) {
+            // row i is reduced with respect to the basic columns of the rows before j.
+            unsigned c = m.next_col(i, 0);
+            if (c == m.m_num_cols) {
+                if (m.rhs(i)) {
+                    TRACE("sat", tout << "inconsistent xor system\n";);
+                    s().set_conflict(justification());
+                    return;
+                }
+                continue;
+            }
+            if (i != j) m.copy_row(j, i);
+            for (unsigned k = 0; k < num_rows; ++k) {
+                if (k != j && (k < j || k > i) && m.get(k, c)) {
+                    m.add_row(k, j);
+                }
+            }
+            m.m_basic.push_back(c);
+            ++j;
+        }
+        m.m_num_rows = j;
+        m.m_bits.shrink(j * m.m_num_words);
+        m.m_row_mark.shrink(j);
+    }
+
+    /**
+       \brief Return an unassigned column of row r other than c, or UINT_MAX if there is none.
+    */
+    unsigned gauss::find_unassigned(matrix const& m, unsigned r, unsigned c) const {
+        for (unsigned d = m.next_col(r, 0); d < m.m_num_cols; d = m.next_col(r, d + 1)) {
+            if (d != c && value(m, d) == l_undef) {
+                return d;
+            }
+        }
+        return UINT_MAX;
+    }
+
+    /**
+       \brief Return the column of row r other than c that was assigned at the highest level, or UINT_MAX.
+    */
+    unsigned gauss::find_latest(matrix const& m, unsigned r, unsigned c) const {
+        unsigned result = UINT_MAX, lvl = 0;
+        for (unsigned d = m.next_col(r, 0); d < m.m_num_cols; d = m.next_col(r, d + 1)) {
+            if (d != c && (result == UINT_MAX || s().lvl(m.m_col2var[d]) > lvl)) {
+                result = d;
+                lvl = s().lvl(m.m_col2var[d]);
+            }
+        }
+        return result;
+    }
+
+    /**
+       \brief Make c the basic column of row r by eliminating it from the other rows.
+       The modified rows are queued so that their watches are updated.
+    */
+    void gauss::pivot(matrix& m, unsigned r, unsigned c) {
+        SASSERT(m.get(r, c));
+        m_stats.m_num_pivots++;
+        for (unsigned k = 0; k < m.m_num_rows; ++k) {
+            if (k != r && m.get(k, c)) {
+                m.add_row(k, r);
+                m_queue.push_back(k);
+            }
+        }
+        m.m_basic[r] = c;
+        m.m_col_watch[c].push_back(r);
+        if (m.m_watch[r] == c) {
+            m.m_watch[r] = UINT_MAX;
+        }
+    }
+
+    void gauss::set_watch(matrix& m, unsigned r, unsigned c) {
+        if (m.m_watch[r] != c) {
+            m.m_watch[r] = c;
+            if (c != UINT_MAX) m.m_col_watch[c].push_back(r);
+        }
+    }
+
+    /**
+       \brief Update the watches of row r and propagate it.
+       Unless the row is unit or in conflict, the basic column and the other watched
+       column are unassigned. Otherwise they are the columns that were assigned last.
+    */
+    void gauss::check_row(matrix& m, unsigned r) {
+        unsigned b = m.m_basic[r];
+        if (value(m, b) != l_undef) {
+            unsigned c = find_unassigned(m, r, b);
+            if (c == UINT_MAX) {
+                // all columns are assigned.
+                c = find_latest(m, r, UINT_MAX);
+                if (c != b && s().lvl(m.m_col2var[c]) > s().lvl(m.m_col2var[b])) {
+                    pivot(m, r, c);
+                    b = c;
+                }
+                set_watch(m, r, find_latest(m, r, b));
+                bool parity = m.rhs(r);
+                for (unsigned d = m.next_col(r, 0); d < m.m_num_cols; d = m.next_col(r, d + 1)) {
+                    if (value(m, d) == l_true) parity = !parity;
+                }
+                if (parity) {
+                    set_conflict(m, r);
+                }
+                return;
+            }
+            pivot(m, r, c);
+            b = c;
+        }
+        unsigned w = m.m_watch[r];
+        if (w != UINT_MAX && w != b && m.get(r, w) && value(m, w) == l_undef) {
+            return;
+        }
+        w = find_unassigned(m, r, b);
+        if (w != UINT_MAX) {
+            set_watch(m, r, w);
+        }
+        else {
+            set_watch(m, r, find_latest(m, r, b));
+            propagate(m, r, b);
+        }
+    }
+
+    void gauss::propagate_queue(matrix& m) {
+        while (!m_queue.empty() && !s().inconsistent()) {
+            unsigned r = m_queue.back();
+            m_queue.pop_back();
+            check_row(m, r);
+        }
+        m_queue.reset();
+    }
+
+    /**
+       \brief Store the true literals of the columns of row r other than c.
+    */
+    unsigned gauss::mk_reason(matrix const& m, unsigned r, unsigned c) {
+        unsigned idx = m_reason_begin.size();
+        m_reason_begin.push_back(m_reason_lits.size());
+        for (unsigned d = m.next_col(r, 0); d < m.m_num_cols; d = m.next_col(r, d + 1)) {
+            if (d != c) {
+                m_reason_lits.push_back(true_literal(m, d));
+            }
+        }
+        return idx;
+    }
+
+    void gauss::propagate(matrix& m, unsigned r, unsigned c) {
+        SASSERT(value(m, c) == l_undef);
+        bool parity = m.rhs(r);
+        for (unsigned d = m.next_col(r, 0); d < m.m_num_cols; d = m.next_col(r, d + 1)) {
+            if (d != c && value(m, d) == l_true) parity = !parity;
+        }
+        literal lit(m.m_col2var[c], !parity);
+        TRACE("sat", tout << "xor propagates " << lit << "\n";);
+        m_stats.m_num_propagations++;
+        s().assign(lit, justification::mk_ext_justification(reason2index(mk_reason(m, r, c))));
+    }
+
+    void gauss::set_conflict(matrix& m, unsigned r) {
+        unsigned c = m.next_col(r, 0);
+        SASSERT(c < m.m_num_cols);
+        TRACE("sat", tout << "xor conflict\n";);
+        m_stats.m_num_conflicts++;
+        s().set_conflict(justification::mk_ext_justification(reason2index(mk_reason(m, r, UINT_MAX))), true_literal(m, c));
+    }
+
+    void gauss::propagate(literal l, unsigned idx) {
+        unsigned g = idx >> m_num_tag_bits;
+        matrix& m = *m_matrices[m_col2matrix[g]];
+        unsigned col = m_col2local[g];
+        if (++m.m_mark == 0) {
+            m.m_row_mark.fill(0);
+            m.m_mark = 1;
+        }
+        unsigned_vector& rows = m.m_col_watch[col];
+        unsigned sz = rows.size(), j = 0;
+        for (unsigned i = 0; i < sz; ++i) {
+            unsigned r = rows[i];
+            if (m.m_row_mark[r] == m.m_mark || !m.watches(r, col)) {
+                // duplicate or stale entry.
+                continue;
+            }
+            m.m_row_mark[r] = m.m_mark;
+            if (!s().inconsistent()) {
+                check_row(m, r);
+                propagate_queue(m);
+            }
+            if (m.watches(r, col)) {
+                rows[j++] = r;
+            }
+        }
+        // check_row may have added watches of col, they are appended after sz.
+        for (unsigned i = sz; i < rows.size(); ++i) {
+            rows[j++] = rows[i];
+        }
+        rows.shrink(j);
+    }
+
+    void gauss::get_antecedents(unsigned idx, literal_vector& r) const {
+        unsigned i = idx >> m_num_tag_bits;
+        unsigned end = i + 1 < m_reason_begin.size() ? m_reason_begin[i + 1] : m_reason_lits.size();
+        for (unsigned j = m_reason_begin[i]; j < end; ++j) {
+            r.push_back(m_reason_lits[j]);
+        }
+    }
+
+    void gauss::push() {
+        m_reason_lim.push_back(m_reason_begin.size());
+    }
+
+    void gauss::pop(unsigned n) {
+        unsigned new_lim = m_reason_lim.size() - n;
+        unsigned num_reasons = m_reason_lim[new_lim];
+        m_reason_lim.shrink(new_lim);
+        if (num_reasons < m_reason_begin.size()) {
+            m_reason_lits.shrink(m_reason_begin[num_reasons]);
+            m_reason_begin.shrink(num_reasons);
+        }
+    }
+
+    bool_var gauss::max_var(bool_var v) const {
+        for (unsigned i = 0; i < m_xors.size(); ++i) {
+            bool_var_vector const& vars = m_xors[i];
+            if (!vars.empty() && vars.back() > v) v = vars.back();
+        }
+        return v;
+    }
+
+    void gauss::copy(gauss const& other) {
+        for (unsigned i = 0; i < other.m_xors.size(); ++i) {
+            add_xor(other.m_xors[i], other.m_rhs[i]);
+        }
+    }
+
+    void gauss::collect_statistics(statistics& st) const {
+        st.update("xor constraints", m_stats.m_num_xors);
+        st.update("xor propagations", m_stats.m_num_propagations);
+        st.update("xor conflicts", m_stats.m_num_conflicts);
+        st.update("xor pivots", m_stats.m_num_pivots);
+    }
+
+    std::ostream& gauss::display(std::ostream& out) const {
+        for (unsigned i = 0; i < m_xors.size(); ++i) {
+            bool_var_vector const& vars = m_xors[i];
+            for (unsigned j = 0; j < vars.size(); ++j) {
+                out << (j > 0 ? " ^ " : "") << vars[j];
+            }
+            out << " = " << (m_rhs[i] ? "1" : "0") << "\n";
+        }
+        return out;
+    }
+
+};
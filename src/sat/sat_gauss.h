@@ -0,0 +1,158 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_gauss.h
+
+Abstract:
+
+    Gauss-Jordan elimination for XOR constraints.
+
+    The XOR constraints are partitioned into independent systems
+    (no two systems share a variable). Each system is a bit-matrix
+    in reduced row echelon form: every row has a basic column that
+    does not occur in the other rows. Rows are packed into 64-bit
+    words, the last column of a row is the right hand side, so
+    adding rows is a word-wise xor.
+
+    A row watches its basic column and one other unassigned column.
+    When the basic column is assigned the row is pivoted on an unassigned
+    column, when the other watched column is assigned a new one is searched.
+    If there is no unassigned column left the remaining column is
+    propagated, or the row is in conflict.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#ifndef SAT_GAUSS_H_
+#define SAT_GAUSS_H_
+
+#include"sat_types.h"
+#include"map.h"
+#include"statistics.h"
+
+namespace sat {
+
+    class solver;
+
+    class gauss {
+        struct stats {
+            unsigned m_num_xors;
+            unsigned m_num_propagations;
+            unsigned m_num_conflicts;
+            unsigned m_num_pivots;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        // A system of XOR constraints in reduced row echelon form.
+        struct matrix {
+            unsigned                m_num_cols;
+            unsigned                m_num_words;   // words per row, including the right hand side.
+            unsigned                m_num_rows;
+            svector<uint64>         m_bits;
+            unsigned_vector         m_basic;       // basic column of a row.
+            unsigned_vector         m_watch;       // watched non-basic column of a row, UINT_MAX if there is none.
+            vector<unsigned_vector> m_col_watch;   // rows that watch a column, entries are removed lazily.
+            bool_var_vector         m_col2var;
+            unsigned_vector         m_row_mark;
+            unsigned                m_mark;
+            matrix(bool_var_vector const& vars, unsigned num_rows);
+            uint64* row(unsigned r) { return m_bits.c_ptr() + r * m_num_words; }
+            uint64 const* row(unsigned r) const { return m_bits.c_ptr() + r * m_num_words; }
+            bool get(unsigned r, unsigned c) const { return 0 != (row(r)[c / 64] & (1ull << (c % 64))); }
+            void flip(unsigned r, unsigned c) { row(r)[c / 64] ^= (1ull << (c % 64)); }
+            bool rhs(unsigned r) const { return get(r, m_num_cols); }
+            unsigned next_col(unsigned r, unsigned c) const;
+            void add_row(unsigned dst, unsigned src);
+            void copy_row(unsigned dst, unsigned src);
+            bool watches(unsigned r, unsigned c) const { return m_basic[r] == c || m_watch[r] == c; }
+        };
+
+        solver*                 m_solver;
+        unsigned                m_num_tag_bits;
+        unsigned                m_watch_tag;
+        unsigned                m_reason_tag;
+        stats                   m_stats;
+        // XOR constraints x_1 + ... + x_n = rhs
+        vector<bool_var_vector> m_xors;
+        svector<bool>           m_rhs;
+        u_map<unsigned_vector>  m_xor_table;    // hash of an XOR constraint to the XOR constraints with the same hash.
+        bool                    m_dirty;        // XOR constraints were added since the matrices were created.
+        ptr_vector<matrix>      m_matrices;
+        unsigned_vector         m_col2matrix;   // global column to matrix.
+        unsigned_vector         m_col2local;    // global column to column of the matrix.
+        unsigned_vector         m_queue;        // rows of the current matrix that were modified by pivoting.
+        literal_vector          m_reason_lits;  // explanations of propagations and conflicts.
+        unsigned_vector         m_reason_begin;
+        unsigned_vector         m_reason_lim;
+
+        solver& s() const { return *m_solver; }
+        lbool value(matrix const& m, unsigned c) const;
+        literal true_literal(matrix const& m, unsigned c) const;
+        unsigned col2index(unsigned col) const { return (col << m_num_tag_bits) | m_watch_tag; }
+        unsigned reason2index(unsigned r) const { return (r << m_num_tag_bits) | m_reason_tag; }
+        static unsigned hash(bool_var_vector const& vars, bool rhs);
+
+        void reset_matrices();
+        void init_matrices();
+        void eliminate(matrix& m);
+        void watch_column(bool_var v, unsigned idx);
+        void unwatch_column(bool_var v, unsigned idx);
+        unsigned find_unassigned(matrix const& m, unsigned r, unsigned c) const;
+        unsigned find_latest(matrix const& m, unsigned r, unsigned c) const;
+        void set_watch(matrix& m, unsigned r, unsigned c);
+        void pivot(matrix& m, unsigned r, unsigned c);
+        void check_row(matrix& m, unsigned r);
+        void propagate_queue(matrix& m);
+        unsigned mk_reason(matrix const& m, unsigned r, unsigned c);
+        void propagate(matrix& m, unsigned r, unsigned c);
+        void set_conflict(matrix& m, unsigned r);
+
+    public:
+        /**
+           \brief The column watches are registered as the extension constraint index (col << num_tag_bits) | watch_tag,
+           explanations use the extension justification index (reason << num_tag_bits) | reason_tag.
+        */
+        gauss(unsigned num_tag_bits, unsigned watch_tag, unsigned reason_tag);
+        ~gauss();
+
+        void set_solver(solver* s) { m_solver = s; }
+
+        /**
+           \brief Add the XOR constraint vars[0] + ... + vars[n-1] = rhs.
+           It is used after the next call to init.
+        */
+        void add_xor(bool_var_vector const& vars, bool rhs);
+
+        unsigned num_xors() const { return m_xors.size(); }
+
+        /**
+           \brief Create the matrices and propagate the XOR constraints at the base level.
+        */
+        void init();
+
+        /**
+           \brief Register the column watches again, the solver releases the watch lists
+           of literals assigned at the base level.
+        */
+        void init_watches();
+
+        void propagate(literal l, unsigned idx);
+        void get_antecedents(unsigned idx, literal_vector& r) const;
+        void push();
+        void pop(unsigned n);
+        bool_var max_var(bool_var v) const;
+        void copy(gauss const& other);
+        void collect_statistics(statistics& st) const;
+        std::ostream& display(std::ostream& out) const;
+    };
+
+};
+
+#endif
@@ -0,0 +1,98 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_inprocess.cpp
+
+Abstract:
+
+    Effort allocation for inprocessing techniques.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include"sat_inprocess.h"
+#include"trace.h"
+
+namespace sat {
+
+    static const double min_weight = 1.0 / 16;
+    static const double max_weight = 16;
+
+    static char const* technique_names[inprocess_scheduler::NUM_TECHNIQUES] = { "vivify", "subsume", "elim-vars" };
+
+    inprocess_scheduler::inprocess_scheduler():
+        m_adaptive(true) {
+        reset();
+    }
+
+    void inprocess_scheduler::reset() {
+        for (unsigned t = 0; t < NUM_TECHNIQUES; ++t) {
+            technique_state & st = m_states[t];
+            st.m_weight     = 1.0;
+            st.m_efficiency = 0;
+            st.m_rounds     = 0;
+            st.m_gain       = 0;
+            st.m_cost       = 0;
+        }
+    }
+
+    void inprocess_scheduler::update(technique t, unsigned gain, uint64 cost) {
+        technique_state & st = m_states[t];
+        st.m_rounds++;
+        st.m_gain += gain;
+        st.m_cost += cost;
+        if (!m_adaptive || cost == 0)
+            return;
+        double efficiency = static_cast<double>(gain) / cost;
+        if (gain == 0)
+            st.m_weight /= 2;
+        else if (efficiency >= st.m_efficiency)
+            st.m_weight *= 2;
+        st.m_efficiency = st.m_rounds == 1 ? efficiency : (st.m_efficiency + efficiency) / 2;
+        normalize();
+        TRACE("sat_inprocess", display(tout););
+    }
+
+    void inprocess_scheduler::update(technique t, unsigned gain_before, unsigned gain_after, uint64 cost_before, uint64 cost_after) {
+        unsigned gain = gain_after >= gain_before ? gain_after - gain_before : gain_after;
+        uint64   cost = cost_after >= cost_before ? cost_after - cost_before : cost_after;
+        update(t, gain, cost);
+    }
+
+    /**
+       \brief Scale the weights to average 1, such that the total effort stays the same.
+    */
+    void inprocess_scheduler::normalize() {
+        double sum = 0;
+        for (unsigned t = 0; t < NUM_TECHNIQUES; ++t)
+            sum += m_states[t].m_weight;
+        for (unsigned t = 0; t < NUM_TECHNIQUES; ++t) {
+            double & w = m_states[t].m_weight;
+            w = w * NUM_TECHNIQUES / sum;
+            if (w < min_weight) w = min_weight;
+            if (w > max_weight) w = max_weight;
+        }
+    }
+
+    void inprocess_scheduler::collect_statistics(statistics & st) const {
+        st.update("inprocess vivify effort", m_states[VIVIFY].m_weight);
+        st.update("inprocess subsume effort", m_states[SUBSUME].m_weight);
+        st.update("inprocess elim-vars effort", m_states[ELIM_VARS].m_weight);
+    }
+
+    std::ostream& inprocess_scheduler::display(std::ostream& out) const {
+        for (unsigned t = 0; t < NUM_TECHNIQUES; ++t) {
+            technique_state const & st = m_states[t];
+            out << technique_names[t] << " :weight " << st.m_weight << " :rounds " << st.m_rounds
+                << " :gain " << st.m_gain << " :cost " << st.m_cost << "\n";
+        }
+        return out;
+    }
+
+};
@@ -0,0 +1,76 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_inprocess.h
+
+Abstract:
+
+    Effort allocation for inprocessing techniques.
+
+    Every simplification round reports, for each technique, its gain
+    (removed literals, clauses or variables) and its cost (propagations
+    or visited literals). A technique whose gain per cost improves over
+    its own history gets twice the effort in the next round, one without
+    gain gets half. The weights are normalized to keep the total effort
+    constant, so effort moves to the techniques that pay off.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#ifndef SAT_INPROCESS_H_
+#define SAT_INPROCESS_H_
+
+#include"sat_types.h"
+#include"statistics.h"
+
+namespace sat {
+
+    class inprocess_scheduler {
+    public:
+        enum technique { VIVIFY, SUBSUME, ELIM_VARS, NUM_TECHNIQUES };
+    private:
+        struct technique_state {
+            double   m_weight;      // effort relative to the configured limits.
+            double   m_efficiency;  // moving average of gain per cost.
+            unsigned m_rounds;
+            unsigned m_gain;
+            uint64   m_cost;
+        };
+        technique_state m_states[NUM_TECHNIQUES];
+        bool            m_adaptive;
+
+        void normalize();
+    public:
+        inprocess_scheduler();
+
+        void set_adaptive(bool f) { m_adaptive = f; }
+
+        void reset();
+
+        double weight(technique t) const { return m_states[t].m_weight; }
+
+        /**
+           \brief Record the gain and cost of technique t in the last round.
+        */
+        void update(technique t, unsigned gain, uint64 cost);
+
+        /**
+           \brief Record the last round of technique t from the values of its gain and cost
+           counters before and after the round. A counter that was reset in between
+           only contributes its value after the round.
+        */
+        void update(technique t, unsigned gain_before, unsigned gain_after, uint64 cost_before, uint64 cost_after);
+
+        void collect_statistics(statistics & st) const;
+        std::ostream& display(std::ostream& out) const;
+    };
+
+};
+
+#endif
@@ -0,0 +1,225 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_local_search.cpp
+
+Abstract:
+
+    ProbSAT local search on the irredundant clauses of the solver.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include<cmath>
+#include"sat_local_search.h"
+#include"sat_solver.h"
+#include"trace.h"
+
+namespace sat {
+
+    // break counts above this value have the same probability.
+    static const unsigned max_break = 64;
+
+    local_search::local_search(solver & _s):
+        s(_s) {
+    }
+
+    unsigned local_search::random(unsigned n) {
+        // random_gen produces 15 bits.
+        unsigned r = (static_cast<unsigned>(m_rand()) << 15) | static_cast<unsigned>(m_rand());
+        return r % n;
+    }
+
+    void local_search::reset() {
+        m_lits.reset();
+        m_clause_begin.reset();
+        m_clause_begin.push_back(0);
+        m_true_count.reset();
+        m_unsat.reset();
+        m_unsat_index.reset();
+        m_use_list.reset();
+        m_use_list.resize(2 * s.num_vars());
+    }
+
+    /**
+       \brief Add a clause without the literals that are false at the base level,
+       clauses satisfied at the base level are skipped.
+    */
+    void local_search::add_clause(unsigned sz, literal const* lits) {
+        unsigned begin = m_lits.size();
+        for (unsigned i = 0; i < sz; ++i) {
+            literal l = lits[i];
+            if (s.value(l) != l_undef && s.lvl(l) == 0) {
+                if (s.value(l) == l_true) {
+                    m_lits.shrink(begin);
+                    return;
+                }
+                continue;
+            }
+            m_lits.push_back(l);
+        }
+        if (m_lits.size() == begin)
+            return;
+        unsigned c = num_clauses();
+        for (unsigned i = begin; i < m_lits.size(); ++i)
+            m_use_list[m_lits[i].index()].push_back(c);
+        m_clause_begin.push_back(m_lits.size());
+    }
+
+    void local_search::init_clauses() {
+        reset();
+        for (unsigned i = 0; i < s.m_clauses.size(); ++i) {
+            clause const& c = *s.m_clauses[i];
+            add_clause(c.size(), c.begin());
+        }
+        literal lits[2];
+        for (unsigned l_idx = 0; l_idx < s.m_watches.size(); ++l_idx) {
+            lits[0] = ~to_literal(l_idx);
+            watch_list const& wlist = s.m_watches[l_idx];
+            watch_list::const_iterator it  = wlist.begin();
+            watch_list::const_iterator end = wlist.end();
+            for (; it != end; ++it) {
+                if (!it->is_binary_non_learned_clause())
+                    continue;
+                lits[1] = it->get_literal();
+                // each binary clause occurs in two watch lists.
+                if (lits[0].index() < lits[1].index())
+                    add_clause(2, lits);
+            }
+        }
+    }
+
+    /**
+       \brief Start from the saved phases, variables fixed at the base level keep their value.
+    */
+    void local_search::init_assignment() {
+        m_value.reset();
+        for (bool_var v = 0; v < s.num_vars(); ++v) {
+            if (s.value(v) != l_undef && s.lvl(v) == 0)
+                m_value.push_back(s.value(v) == l_true);
+            else
+                m_value.push_back(s.m_phase[v] == POS_PHASE);
+        }
+        m_true_count.resize(num_clauses(), 0);
+        m_unsat_index.resize(num_clauses(), UINT_MAX);
+        for (unsigned c = 0; c < num_clauses(); ++c) {
+            unsigned n = 0;
+            for (unsigned i = m_clause_begin[c]; i < m_clause_begin[c + 1]; ++i)
+                n += is_true(m_lits[i]);
+            m_true_count[c] = n;
+            if (n == 0)
+                set_unsat(c);
+        }
+        m_best = m_value;
+    }
+
+    void local_search::set_unsat(unsigned c) {
+        SASSERT(m_unsat_index[c] == UINT_MAX);
+        m_unsat_index[c] = m_unsat.size();
+        m_unsat.push_back(c);
+    }
+
+    void local_search::set_sat(unsigned c) {
+        unsigned idx = m_unsat_index[c];
+        SASSERT(idx != UINT_MAX);
+        unsigned last = m_unsat.back();
+        m_unsat[idx] = last;
+        m_unsat_index[last] = idx;
+        m_unsat.pop_back();
+        m_unsat_index[c] = UINT_MAX;
+    }
+
+    /**
+       \brief Number of clauses that become false when v is flipped.
+    */
+    unsigned local_search::break_count(bool_var v) const {
+        literal l(v, !m_value[v]);
+        SASSERT(is_true(l));
+        unsigned_vector const& cs = m_use_list[l.index()];
+        unsigned r = 0;
+        for (unsigned i = 0; i < cs.size(); ++i)
+            r += m_true_count[cs[i]] == 1;
+        return r;
+    }
+
+    bool_var local_search::pick_var(unsigned c) {
+        unsigned begin = m_clause_begin[c], end = m_clause_begin[c + 1];
+        m_probs.reset();
+        double sum = 0;
+        for (unsigned i = begin; i < end; ++i) {
+            unsigned b = break_count(m_lits[i].var());
+            double p = m_prob_break[std::min(b, max_break)];
+            m_probs.push_back(p);
+            sum += p;
+        }
+        double r = sum * m_rand() / (random_gen::max_value() + 1.0);
+        for (unsigned i = begin; i < end; ++i) {
+            r -= m_probs[i - begin];
+            if (r < 0)
+                return m_lits[i].var();
+        }
+        return m_lits[end - 1].var();
+    }
+
+    void local_search::flip(bool_var v) {
+        literal l(v, !m_value[v]); // the literal that becomes false.
+        m_value[v] = !m_value[v];
+        unsigned_vector const& falsified = m_use_list[l.index()];
+        for (unsigned i = 0; i < falsified.size(); ++i) {
+            unsigned c = falsified[i];
+            if (--m_true_count[c] == 0)
+                set_unsat(c);
+        }
+        unsigned_vector const& satisfied = m_use_list[(~l).index()];
+        for (unsigned i = 0; i < satisfied.size(); ++i) {
+            unsigned c = satisfied[i];
+            if (m_true_count[c]++ == 0)
+                set_sat(c);
+        }
+    }
+
+    lbool local_search::operator()(unsigned max_flips, double cb) {
+        m_stats.m_num_rounds++;
+        m_rand.set_seed(s.m_rand());
+        m_prob_break.reset();
+        for (unsigned b = 0; b <= max_break; ++b)
+            m_prob_break.push_back(std::pow(1.0 + b, -cb));
+        init_clauses();
+        init_assignment();
+        unsigned best_unsat = m_unsat.size();
+        unsigned flips = 0;
+        for (; flips < max_flips && !m_unsat.empty(); ++flips) {
+            if ((flips & 0xFFF) == 0)
+                s.checkpoint();
+            flip(pick_var(m_unsat[random(m_unsat.size())]));
+            if (m_unsat.size() < best_unsat) {
+                best_unsat = m_unsat.size();
+                m_best = m_value;
+            }
+        }
+        m_stats.m_num_flips += flips;
+        for (bool_var v = 0; v < s.num_vars(); ++v) {
+            if (!s.was_eliminated(v) && (s.value(v) == l_undef || s.lvl(v) > 0))
+                s.m_phase[v] = m_best[v] ? POS_PHASE : NEG_PHASE;
+        }
+        IF_VERBOSE(SAT_VB_LVL, verbose_stream() << " (sat-local-search :flips " << flips
+                   << " :clauses " << num_clauses() << " :unsat " << best_unsat << ")\n";);
+        if (best_unsat > 0)
+            return l_undef;
+        m_stats.m_num_models++;
+        return l_true;
+    }
+
+    void local_search::collect_statistics(statistics & st) const {
+        st.update("local search rounds", m_stats.m_num_rounds);
+        st.update("local search flips", m_stats.m_num_flips);
+        st.update("local search models", m_stats.m_num_models);
+    }
+
+};
@@ -0,0 +1,88 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_local_search.h
+
+Abstract:
+
+    ProbSAT local search on the irredundant clauses of the solver.
+
+    The search starts from the saved phases of the solver, repeatedly
+    picks a random falsified clause and flips one of its variables,
+    a variable with break count b is chosen with probability
+    proportional to (1 + b)^-cb. The best assignment found replaces the saved
+    phases (rephasing), such that CDCL continues the search near it.
+    Extension constraints are not taken into account.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#ifndef SAT_LOCAL_SEARCH_H_
+#define SAT_LOCAL_SEARCH_H_
+
+#include"sat_types.h"
+#include"statistics.h"
+
+namespace sat {
+
+    class solver;
+
+    class local_search {
+        struct stats {
+            unsigned m_num_rounds;
+            unsigned m_num_flips;
+            unsigned m_num_models;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+
+        solver &                s;
+        random_gen              m_rand;
+        stats                   m_stats;
+        // clause i consists of m_lits[m_clause_begin[i]], ..., m_lits[m_clause_begin[i+1]-1].
+        literal_vector          m_lits;
+        unsigned_vector         m_clause_begin;
+        unsigned_vector         m_true_count;   // number of true literals in a clause.
+        vector<unsigned_vector> m_use_list;     // literal to clauses that contain it.
+        unsigned_vector         m_unsat;        // falsified clauses.
+        unsigned_vector         m_unsat_index;  // position of a clause in m_unsat.
+        svector<bool>           m_value;
+        svector<bool>           m_best;
+        svector<double>         m_prob_break;   // (1 + b)^-cb
+        svector<double>         m_probs;
+
+        unsigned num_clauses() const { return m_clause_begin.size() - 1; }
+        unsigned random(unsigned n);
+        bool is_true(literal l) const { return m_value[l.var()] != l.sign(); }
+        void reset();
+        void add_clause(unsigned sz, literal const* lits);
+        void init_clauses();
+        void init_assignment();
+        void set_unsat(unsigned c);
+        void set_sat(unsigned c);
+        unsigned break_count(bool_var v) const;
+        bool_var pick_var(unsigned c);
+        void flip(bool_var v);
+
+    public:
+        local_search(solver & s);
+
+        /**
+           \brief Run at most max_flips flips and store the best assignment as the
+           saved phases of the solver. Return l_true if all clauses are satisfied.
+        */
+        lbool operator()(unsigned max_flips, double cb);
+
+        void collect_statistics(statistics & st) const;
+        void reset_statistics() { m_stats.reset(); }
+    };
+
+};
+
+#endif
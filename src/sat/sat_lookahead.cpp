@@ -0,0 +1,174 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_lookahead.cpp
+
+Abstract:
+
+    Lookahead based splitting of the search space into cubes
+    for cube-and-conquer parallel solving.
+
+    Candidate variables are selected by activity and occurrences.
+    Each candidate v is scored by propagating v and ~v and 
+    counting the number of implied literals (n(v), n(~v)).
+    The variable maximizing n(v)*n(~v) + n(v) + n(~v) is used to split.
+    Failed literals are asserted under the current cube.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include"sat_lookahead.h"
+#include"sat_solver.h"
+
+namespace sat {
+
+    lookahead::lookahead(solver & _s, unsigned num_candidates):
+        s(_s),
+        m_num_candidates(num_candidates),
+        m_num_failed(0),
+        m_num_refuted(0) {
+    }
+
+    struct lookahead_candidate_lt {
+        svector<unsigned> const& m_score;
+        lookahead_candidate_lt(svector<unsigned> const& score): m_score(score) {}
+        bool operator()(bool_var v1, bool_var v2) const {
+            return m_score[v1] > m_score[v2];
+        }
+    };
+
+    /**
+       \brief collect the unassigned decision variables with the
+       highest score. The score is the activity, or the number
+       of watches if activities are not yet available.
+    */
+    void lookahead::select_candidates() {
+        m_candidates.reset();
+        svector<unsigned> score;
+        unsigned num = s.num_vars();
+        score.resize(num, 0);
+        for (bool_var v = 0; v < num; ++v) {
+            if (s.value(v) != l_undef || s.was_eliminated(v) || !s.m_decision[v])
+                continue;
+            score[v] = s.m_activity[v];
+            if (score[v] == 0) {
+                score[v] = s.get_wlist(literal(v, false)).size() + s.get_wlist(literal(v, true)).size();
+            }
+            m_candidates.push_back(v);
+        }
+        lookahead_candidate_lt lt(score);
+        if (m_candidates.size() > m_num_candidates) {
+            std::partial_sort(m_candidates.begin(), m_candidates.begin() + m_num_candidates, m_candidates.end(), lt);
+            m_candidates.shrink(m_num_candidates);
+        }
+    }
+
+    /**
+       \brief return the number of literals implied by l.
+       failed is set to true if l propagates to a conflict.
+    */
+    unsigned lookahead::try_lit(literal l, bool& failed) {
+        SASSERT(s.value(l) == l_undef);
+        unsigned old_sz = s.m_trail.size();
+        s.push();
+        s.assign(l, justification());
+        s.propagate(false);
+        failed = s.inconsistent();
+        unsigned r = s.m_trail.size() - old_sz;
+        s.pop(1);
+        return r;
+    }
+
+    /**
+       \brief select a literal to split on, or null_literal if
+       there are no unassigned variables left or the current 
+       assignment is inconsistent.
+    */
+    literal lookahead::select_lit() {
+        while (!s.inconsistent()) {
+            select_candidates();
+            literal best = null_literal;
+            unsigned best_score = 0;
+            bool progress = false;
+            for (unsigned i = 0; !s.inconsistent() && i < m_candidates.size(); ++i) {
+                bool_var v = m_candidates[i];
+                if (s.value(v) != l_undef) 
+                    continue;
+                literal l(v, false);
+                bool failed1 = false, failed2 = false;
+                unsigned n1 = try_lit(l, failed1);
+                if (!failed1) {
+                    unsigned n2 = try_lit(~l, failed2);
+                    if (!failed2) {
+                        unsigned score = n1*n2 + n1 + n2;
+                        if (best == null_literal || score > best_score) {
+                            best = n1 >= n2 ? l : ~l;
+                            best_score = score;
+                        }
+                        continue;
+                    }
+                }
+                // failed literal, assert its negation under the current cube.
+                ++m_num_failed;
+                s.assign(failed1 ? ~l : l, justification());
+                s.propagate(false);
+                progress = true;
+            }
+            if (!progress || s.inconsistent()) 
+                return s.inconsistent() ? null_literal : best;
+            // failed literals were asserted, re-evaluate the candidates.
+        }
+        return null_literal;
+    }
+
+    void lookahead::split(unsigned depth, vector<literal_vector>& cubes) {
+        s.checkpoint();
+        if (depth == 0) {
+            cubes.push_back(m_cube);
+            return;
+        }
+        literal l = select_lit();
+        if (s.inconsistent()) {
+            ++m_num_refuted;
+            return;
+        }
+        if (l == null_literal) {
+            // all variables are assigned.
+            cubes.push_back(m_cube);
+            return;
+        }
+        for (unsigned i = 0; i < 2; ++i, l.neg()) {
+            s.push();
+            s.assign(l, justification());
+            s.propagate(false);
+            if (s.inconsistent()) {
+                ++m_num_refuted;
+            }
+            else {
+                m_cube.push_back(l);
+                split(depth - 1, cubes);
+                m_cube.pop_back();
+            }
+            s.pop(1);
+        }
+    }
+
+    void lookahead::operator()(unsigned depth, vector<literal_vector>& cubes) {
+        SASSERT(s.scope_lvl() == 0);
+        cubes.reset();
+        m_cube.reset();
+        s.propagate(false);
+        if (s.inconsistent()) 
+            return;
+        // failed literals found at the base level are permanent.
+        split(depth, cubes);
+        SASSERT(s.scope_lvl() == 0);
+    }
+
+};
@@ -0,0 +1,60 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_lookahead.h
+
+Abstract:
+
+    Lookahead based splitting of the search space into cubes
+    for cube-and-conquer parallel solving.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#ifndef SAT_LOOKAHEAD_H_
+#define SAT_LOOKAHEAD_H_
+
+#include"sat_types.h"
+
+namespace sat {
+
+    class solver;
+
+    class lookahead {
+        solver &        s;
+        unsigned        m_num_candidates;  // number of variables to evaluate per split.
+        bool_var_vector m_candidates;
+        literal_vector  m_cube;
+
+        // stats
+        unsigned        m_num_failed;
+        unsigned        m_num_refuted;
+
+        void select_candidates();
+        unsigned try_lit(literal l, bool& failed);
+        literal select_lit();
+        void split(unsigned depth, vector<literal_vector>& cubes);
+
+    public:
+        lookahead(solver & s, unsigned num_candidates = 16);
+
+        /**
+           \brief Split the search space at the base level into at most 2^depth cubes. 
+           Cubes that are refuted by propagation are omitted. 
+           If the result is empty, then the clauses are unsatisfiable.
+        */
+        void operator()(unsigned depth, vector<literal_vector>& cubes);
+
+        unsigned num_failed() const { return m_num_failed; }
+        unsigned num_refuted() const { return m_num_refuted; }
+    };
+
+};
+
+#endif
@@ -21,7 +21,76 @@ Revision History:
 
 namespace sat {
 
-    par::par() {}
+    par::clause_pool::clause_pool(unsigned capacity):
+        m_tail(0),
+        m_oldest(0) {
+        m_words.resize(capacity, 0);
+    }
+
+    unsigned par::clause_pool::entry_size(uint64 pos) const {
+        unsigned p = phys(pos);
+        if (m_words[p] == UINT_MAX) {
+            return m_words.size() - p;
+        }
+        return 3 + m_words[p + 2];
+    }
+
+    /**
+       \brief Advance m_oldest past every entry that is overwritten
+       when the tail is moved to new_tail.
+    */
+    void par::clause_pool::reclaim(uint64 new_tail) {
+        while (m_oldest < m_tail && m_oldest + m_words.size() < new_tail) {
+            m_oldest += entry_size(m_oldest);
+        }
+        SASSERT(m_oldest + m_words.size() >= new_tail);
+    }
+
+    void par::clause_pool::add(unsigned owner, unsigned glue, unsigned n, unsigned const* lits) {
+        unsigned sz = m_words.size();
+        unsigned p  = phys(m_tail);
+        if (3 + n > sz) {
+            return;
+        }
+        if (p + 3 + n > sz) {
+            // pad the end of the buffer.
+            reclaim(m_tail + (sz - p));
+            m_words[p] = UINT_MAX;
+            m_tail += sz - p;
+            p = 0;
+        }
+        reclaim(m_tail + 3 + n);
+        m_words[p]     = owner;
+        m_words[p + 1] = glue;
+        m_words[p + 2] = n;
+        for (unsigned i = 0; i < n; ++i) {
+            m_words[p + 3 + i] = lits[i];
+        }
+        m_tail += 3 + n;
+    }
+
+    bool par::clause_pool::get(unsigned owner, uint64& head, unsigned_vector& out) const {
+        bool lost = false;
+        if (head < m_oldest) {
+            lost = true;
+            head = m_oldest;
+        }
+        while (head < m_tail) {
+            unsigned p = phys(head);
+            if (m_words[p] != UINT_MAX && m_words[p] != owner) {
+                unsigned n = m_words[p + 2];
+                out.push_back(m_words[p + 1]);
+                out.push_back(n);
+                for (unsigned i = 0; i < n; ++i) {
+                    out.push_back(m_words[p + 3 + i]);
+                }
+            }
+            head += entry_size(head);
+        }
+        return lost;
+    }
+
+    par::par(): m_pool(1 << 20) {}
 
     void par::exchange(literal_vector const& in, unsigned& limit, literal_vector& out) {
         #pragma omp critical (par_solver)
@@ -40,6 +109,31 @@ namespace sat {
             limit = m_units.size();
         }
     }
-    
-};
 
+    bool par::exchange_clauses(unsigned owner, unsigned_vector const& out, uint64& head, unsigned_vector& in) {
+        bool lost = false;
+        #pragma omp critical (par_solver)
+        {
+            lost = m_pool.get(owner, head, in);
+            for (unsigned i = 0; i < out.size(); ) {
+                unsigned glue = out[i];
+                unsigned n    = out[i + 1];
+                m_pool.add(owner, glue, n, out.c_ptr() + i + 2);
+                i += 2 + n;
+            }
+        }
+        return lost;
+    }
+
+    void par::share_clause(unsigned owner, unsigned glue, literal_vector const& lits) {
+        unsigned_vector idxs;
+        for (unsigned i = 0; i < lits.size(); ++i) {
+            idxs.push_back(lits[i].index());
+        }
+        #pragma omp critical (par_solver)
+        {
+            m_pool.add(owner, glue, idxs.size(), idxs.c_ptr());
+        }
+    }
+
+};
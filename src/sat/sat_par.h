@@ -15,6 +15,8 @@ Author:
 
 Revision History:
 
+    Added a shared pool of learned clauses for portfolio mode.
+
 --*/
 #ifndef SAT_PAR_H_
 #define SAT_PAR_H_
@@ -22,16 +24,62 @@ Revision History:
 #include"sat_types.h"
 #include"hashtable.h"
 #include"map.h"
+#include"util.h"
 
 namespace sat {
 
     class par {
         typedef hashtable<unsigned, u_hash, u_eq> index_set;
+
+        /**
+           \brief Bounded circular pool of clauses shared by the portfolio.
+
+           Each entry is stored as [owner, glue, n, lit_1, ..., lit_n].
+           Positions are absolute (monotonically increasing) word offsets,
+           the physical position is obtained modulo the capacity.
+           Entries never wrap around the end of the buffer: the remaining words
+           are skipped using a padding entry whose owner is UINT_MAX.
+           When the writer overwrites entries that were not yet consumed by some reader,
+           the reader jumps to the oldest entry that is still intact.
+        */
+        class clause_pool {
+            unsigned_vector m_words;
+            uint64          m_tail;    // position where the next entry is written.
+            uint64          m_oldest;  // position of the oldest intact entry.
+            unsigned phys(uint64 pos) const { return static_cast<unsigned>(pos % m_words.size()); }
+            unsigned entry_size(uint64 pos) const;
+            void reclaim(uint64 new_tail);
+        public:
+            clause_pool(unsigned capacity);
+            void add(unsigned owner, unsigned glue, unsigned n, unsigned const* lits);
+            // append entries not owned by owner starting at head to out as [glue, n, lits].
+            // return true if some entries were overwritten before they could be read.
+            bool get(unsigned owner, uint64& head, unsigned_vector& out) const;
+        };
+
         literal_vector m_units;
         index_set      m_unit_set;
+        clause_pool    m_pool;
     public:
         par();
+
+        /**
+           \brief Exchange units with other solvers.
+        */
         void exchange(literal_vector const& in, unsigned& limit, literal_vector& out);
+
+        /**
+           \brief Publish the clauses in 'out' and retrieve clauses published by other solvers.
+           Both 'out' and 'in' contain clauses encoded as [glue, n, lit_1, ..., lit_n].
+           Return true if some clauses were dropped from the pool before
+           owner could import them.
+        */
+        bool exchange_clauses(unsigned owner, unsigned_vector const& out, uint64& head, unsigned_vector& in);
+
+        /**
+           \brief Publish a single clause. It is imported by every solver whose id is different from owner.
+        */
+        void share_clause(unsigned owner, unsigned glue, literal_vector const& lits);
     };
 
 };
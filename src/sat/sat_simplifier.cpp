@@ -57,7 +57,9 @@ namespace sat {
 
     simplifier::simplifier(solver & _s, params_ref const & p):
         s(_s),
-        m_num_calls(0) {
+        m_num_calls(0),
+        m_sub_effort(1.0),
+        m_elim_effort(1.0) {
         updt_params(p);
         reset_statistics();
     }
@@ -182,23 +184,30 @@ namespace sat {
         if (!learned)
             m_num_calls++;
 
-        m_sub_counter  = m_subsumption_limit;
-        m_elim_counter = m_res_limit;
+        int sub_limit  = scale_limit(m_subsumption_limit, m_sub_effort);
+        int elim_limit = scale_limit(m_res_limit, m_elim_effort);
+        m_sub_counter  = sub_limit;
+        m_elim_counter = elim_limit;
         unsigned old_num_elim_vars = m_num_elim_vars;
 
         do {
             if (m_subsumption)
                 subsume();
-            if (s.inconsistent())
+            if (s.inconsistent()) {
+                update_costs(sub_limit, elim_limit);
                 return;
+            }
             if (!learned && m_resolution)
                 elim_vars();
-            if (s.inconsistent())
+            if (s.inconsistent()) {
+                update_costs(sub_limit, elim_limit);
                 return;
+            }
             if (!m_subsumption || m_sub_counter < 0)
                 break;
         }
         while (!m_sub_todo.empty());
+        update_costs(sub_limit, elim_limit);
 
         bool vars_eliminated = m_num_elim_vars > old_num_elim_vars;
 
@@ -220,6 +229,16 @@ namespace sat {
         finalize();
     }
 
+    int simplifier::scale_limit(unsigned limit, double effort) {
+        double r = limit * effort;
+        return r >= INT_MAX ? INT_MAX : static_cast<int>(r);
+    }
+
+    void simplifier::update_costs(int sub_limit, int elim_limit) {
+        m_sub_cost  += static_cast<int64>(sub_limit) - m_sub_counter;
+        m_elim_cost += static_cast<int64>(elim_limit) - m_elim_counter;
+    }
+
     /**
        \brief Eliminate all ternary and clause watches.
     */
@@ -550,6 +569,11 @@ namespace sat {
         bool r = false;
         unsigned sz = c.size();
         unsigned j  = 0;
+        bool drat   = s.m_drat.enabled();
+        if (drat) {
+            m_drat_lits.reset();
+            m_drat_lits.append(sz, c.begin());
+        }
         for (unsigned i = 0; i < sz; i++) {
             literal l = c[i];
             switch (value(l)) {
@@ -573,6 +597,10 @@ namespace sat {
             }
         }
         c.shrink(j);
+        if (drat && j < sz) {
+            s.m_drat.add(c);
+            s.m_drat.del(m_drat_lits);
+        }
         return r;
     }
 
@@ -641,7 +669,16 @@ namespace sat {
         m_need_cleanup = true;
         m_num_elim_lits++;
         insert_elim_todo(l.var());
-        c.elim(l);
+        if (s.m_drat.enabled()) {
+            m_drat_lits.reset();
+            m_drat_lits.append(c.size(), c.begin());
+            c.elim(l);
+            s.m_drat.add(c);
+            s.m_drat.del(m_drat_lits);
+        }
+        else {
+            c.elim(l);
+        }
         clause_use_list & occurs = m_use_list.get(l);
         occurs.erase_not_removed(c);
         m_sub_counter -= occurs.size()/2;
@@ -1400,6 +1437,8 @@ namespace sat {
                 TRACE("resolution_new_cls", tout << *it1 << "\n" << *it2 << "\n-->\n" << m_new_cls << "\n";);
                 if (cleanup_clause(m_new_cls))
                     continue; // clause is already satisfied.
+                if (s.m_drat.enabled() && m_new_cls.size() != 1)
+                    s.m_drat.add(m_new_cls);
                 switch (m_new_cls.size()) {
                 case 0:
                     s.set_conflict(justification());
@@ -1431,9 +1470,24 @@ namespace sat {
             }
         }
 
+        if (s.m_drat.enabled()) {
+            // the other clauses are deleted from the proof when they are garbage collected.
+            drat_del_bin_clauses(m_pos_cls);
+            drat_del_bin_clauses(m_neg_cls);
+        }
+
         return true;
     }
 
+    void simplifier::drat_del_bin_clauses(clause_wrapper_vector const & cs) {
+        clause_wrapper_vector::const_iterator it  = cs.begin();
+        clause_wrapper_vector::const_iterator end = cs.end();
+        for (; it != end; ++it) {
+            if (it->is_binary())
+                s.m_drat.del((*it)[0], (*it)[1]);
+        }
+    }
+
     struct simplifier::elim_var_report {
         simplifier & m_simplifier;
         stopwatch    m_watch;
@@ -1517,5 +1571,7 @@ namespace sat {
         m_num_sub_res = 0;
         m_num_elim_lits = 0;
         m_num_elim_vars = 0;
+        m_sub_cost = 0;
+        m_elim_cost = 0;
     }
 };
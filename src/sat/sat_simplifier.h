@@ -63,6 +63,8 @@ namespace sat {
         // counters
         int                    m_sub_counter;
         int                    m_elim_counter;
+        double                 m_sub_effort;   // limits of the next call relative to the configured limits.
+        double                 m_elim_effort;
 
         // config
         bool                   m_elim_blocked_clauses;
@@ -90,6 +92,8 @@ namespace sat {
         unsigned               m_num_elim_vars;
         unsigned               m_num_sub_res;
         unsigned               m_num_elim_lits;
+        uint64                 m_sub_cost;
+        uint64                 m_elim_cost;
 
         struct size_lt {
             bool operator()(clause const * c1, clause const * c2) const { return c1->size() > c2->size(); }
@@ -97,6 +101,9 @@ namespace sat {
 
         void checkpoint();
 
+        static int scale_limit(unsigned limit, double effort);
+        void update_costs(int sub_limit, int elim_limit);
+
         void initialize();
 
         void init_visited();
@@ -128,6 +135,7 @@ namespace sat {
         void collect_subsumed0(clause const & c1, clause_vector & out);
         void back_subsumption0(clause & c1);
 
+        literal_vector m_drat_lits; // literals of a clause before it is strengthened, for DRAT deletions
         bool cleanup_clause(clause & c, bool in_use_list);
         bool cleanup_clause(literal_vector & c);
         void propagate_unit(literal l);
@@ -160,6 +168,7 @@ namespace sat {
         literal_vector m_new_cls;
         bool resolve(clause_wrapper const & c1, clause_wrapper const & c2, literal l, literal_vector & r);
         void save_clauses(model_converter::entry & mc_entry, clause_wrapper_vector const & cs);
+        void drat_del_bin_clauses(clause_wrapper_vector const & cs);
         void add_non_learned_binary_clause(literal l1, literal l2);
         void remove_bin_clauses(literal l);
         void remove_clauses(clause_use_list const & cs, literal l);
@@ -184,6 +193,19 @@ namespace sat {
 
         void operator()(bool learned);
 
+        /**
+           \brief Scale the subsumption and variable elimination limits of the next calls.
+        */
+        void set_effort(double sub_effort, double elim_effort) { m_sub_effort = sub_effort; m_elim_effort = elim_effort; }
+
+        /**
+           \brief Removed clauses and eliminated variables, and the literals visited to obtain them.
+        */
+        unsigned sub_gain() const { return m_num_subsumed + m_num_sub_res; }
+        uint64 sub_cost() const { return m_sub_cost; }
+        unsigned elim_gain() const { return m_num_elim_vars; }
+        uint64 elim_cost() const { return m_elim_cost; }
+
         void updt_params(params_ref const & p);
         static void collect_param_descrs(param_descrs & d);
 
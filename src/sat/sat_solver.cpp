@@ -18,6 +18,9 @@ Revision History:
 --*/
 #include"sat_solver.h"
 #include"sat_integrity_checker.h"
+#include"sat_lookahead.h"
+#include"sat_xor_finder.h"
+#include"card_extension.h"
 #include"luby.h"
 #include"trace.h"
 #include"max_cliques.h"
@@ -41,11 +44,17 @@ namespace sat {
         m_scc(*this, p),
         m_asymm_branch(*this, p),
         m_probing(*this, p),
+        m_vivify(*this, p),
+        m_local_search(*this),
         m_mus(*this),
         m_inconsistent(false),
         m_num_frozen(0),
         m_activity_inc(128),
         m_case_split_queue(m_activity),
+        m_branching(BH_VSIDS),
+        m_next_branching_switch(0),
+        m_chb_alpha(0.4),
+        m_chb_queue(m_chb_q),
         m_qhead(0),
         m_scope_lvl(0),
         m_params(p) {
@@ -54,6 +63,10 @@ namespace sat {
         m_conflicts               = 0;
         m_next_simplify           = 0;
         m_num_checkpoints         = 0;
+        m_par_id                  = 0;
+        m_par_clause_head         = 0;
+        if (m_ext)
+            m_ext->set_solver(this);
     }
 
     solver::~solver() {
@@ -62,6 +75,16 @@ namespace sat {
         del_clauses(m_clauses.begin(), m_clauses.end());
         TRACE("sat", tout << "Delete learned\n";);
         del_clauses(m_learned.begin(), m_learned.end());
+        dealloc(m_ext);
+    }
+
+    void solver::set_extension(extension* ext) {
+        if (m_ext == ext)
+            return;
+        dealloc(m_ext);
+        m_ext = ext;
+        if (m_ext)
+            m_ext->set_solver(this);
     }
 
     void solver::del_clauses(clause * const * begin, clause * const * end) {
@@ -123,6 +146,11 @@ namespace sat {
 
         m_user_scope_literals.reset();
         m_user_scope_literals.append(src.m_user_scope_literals);
+
+        if (src.m_ext) {
+            SASSERT(!m_ext);
+            set_extension(src.m_ext->copy(this));
+        }
     }
 
     // -----------------------
@@ -152,6 +180,10 @@ namespace sat {
         m_prev_phase.push_back(PHASE_NOT_AVAILABLE);
         m_assigned_since_gc.push_back(false);
         m_case_split_queue.mk_var_eh(v);
+        m_chb_q.push_back(0);
+        m_chb_last_conflict.push_back(0);
+        m_chb_queue.mk_var_eh(v);
+        m_vmtf.mk_var_eh(v);
         m_simplifier.insert_elim_todo(v);
         SASSERT(!was_eliminated(v));
         return v;
@@ -185,8 +217,9 @@ namespace sat {
         mk_clause(3, ls);
     }
 
-    void solver::del_clause(clause& c) {
+    void solver::del_clause(clause& c, bool enable_drat) {
         if (!c.is_learned()) m_stats.m_non_learned_generation++;
+        if (enable_drat && m_drat.enabled()) m_drat.del(c);
         m_cls_allocator.del_clause(&c);
         m_stats.m_del_clause++;
     }
@@ -194,12 +227,19 @@ namespace sat {
     clause * solver::mk_clause_core(unsigned num_lits, literal * lits, bool learned) {
         TRACE("sat", tout << "mk_clause: " << mk_lits_pp(num_lits, lits) << (learned?" learned":" aux") << "\n";);
         if (!learned) {
+            unsigned old_sz = num_lits;
             bool keep = simplify_clause(num_lits, lits);
             TRACE("sat_mk_clause", tout << "mk_clause (after simp), keep: " << keep << "\n" << mk_lits_pp(num_lits, lits) << "\n";);
             if (!keep) {
                 return 0; // clause is equivalent to true.
             }
             ++m_stats.m_non_learned_generation;
+            // units and binary clauses are added to the proof when they are created.
+            if (m_drat.enabled() && num_lits > 2 && num_lits < old_sz) 
+                m_drat.add(num_lits, lits);
+        }
+        else if (m_drat.enabled() && num_lits > 2) {
+            m_drat.add(num_lits, lits);
         }
 
         switch (num_lits) {
@@ -220,6 +260,8 @@ namespace sat {
     }
 
     void solver::mk_bin_clause(literal l1, literal l2, bool learned) {
+        if (m_drat.enabled()) 
+            m_drat.add(l1, l2);
         if (propagate_bin_clause(l1, l2)) {
             if (scope_lvl() == 0)
                 return;
@@ -503,8 +545,11 @@ namespace sat {
     void solver::assign_core(literal l, justification j) {
         SASSERT(value(l) == l_undef);
         TRACE("sat_assign_core", tout << l << " " << j << " level: " << scope_lvl() << "\n";);
-        if (scope_lvl() == 0)
+        if (scope_lvl() == 0) {
             j = justification(); // erase justification for level 0
+            if (m_drat.enabled()) 
+                m_drat.add(l);
+        }
         m_assignment[l.index()]    = l_true;
         m_assignment[(~l).index()] = l_false;
         bool_var v = l.var();
@@ -686,14 +731,17 @@ namespace sat {
                 case watched::EXT_CONSTRAINT:
                     SASSERT(m_ext);
                     m_ext->propagate(l, it->get_ext_constraint_idx(), keep);
-                    if (keep) {
-                        *it2 = *it;
-                        it2++;
-                    }
                     if (m_inconsistent) {
+                        // CONFLICT_CLEANUP copies the remaining watches starting with the current one.
+                        if (!keep) 
+                            ++it;
                         CONFLICT_CLEANUP();
                         return false;
                     }
+                    if (keep) {
+                        *it2 = *it;
+                        it2++;
+                    }
                     break;
                 default:
                     UNREACHABLE();
@@ -708,7 +756,10 @@ namespace sat {
     }
 
     bool solver::propagate(bool update) {
+        unsigned qhead = m_qhead;
         bool r = propagate_core(update);
+        if (m_branching == BH_CHB)
+            update_chb(qhead);
         CASSERT("sat_propagate", check_invariant());
         CASSERT("sat_missed_prop", check_missed_propagation());
         return r;
@@ -723,7 +774,12 @@ namespace sat {
         pop_to_base_level();
         IF_VERBOSE(2, verbose_stream() << "(sat.sat-solver)\n";);
         SASSERT(scope_lvl() == 0);
-        if (m_config.m_num_parallel > 1 && !m_par) {
+        if (m_config.m_num_parallel > 1 && !m_par && m_drat.enabled()) {
+            IF_VERBOSE(1, verbose_stream() << "(sat.sat-solver DRAT proofs are not produced in parallel mode, using a single thread)\n";);
+        }
+        else if (m_config.m_num_parallel > 1 && !m_par) {
+            if (m_config.m_par_strategy == PAR_CUBE && num_lits == 0) 
+                return check_cube();
             return check_par(num_lits, lits);
         }
 #ifdef CLONE_BEFORE_SOLVING
@@ -733,10 +789,17 @@ namespace sat {
         }
 #endif
         try {
-            if (inconsistent()) return l_false;
+            if (inconsistent()) {
+                m_core.reset();
+                if (m_drat.enabled()) m_drat.add();
+                return l_false;
+            }
             init_search();
             propagate(false);
-            if (inconsistent()) return l_false;
+            if (inconsistent()) {
+                if (m_drat.enabled()) m_drat.add();
+                return l_false;
+            }
             init_assumptions(num_lits, lits);
             propagate(false);
             if (check_inconsistent()) return l_false;
@@ -801,19 +864,36 @@ namespace sat {
         vector<reslimit> rlims(num_extra_solvers);
         ptr_vector<sat::solver> solvers(num_extra_solvers);
         sat::par par;
-        symbol saved_phase = m_params.get_sym("phase", symbol("caching"));
         for (int i = 0; i < num_extra_solvers; ++i) {
-            m_params.set_uint("random_seed", m_rand());
-            if (i == 1 + num_threads/2) {
-                m_params.set_sym("phase", symbol("random"));
-            }                        
-            solvers[i] = alloc(sat::solver, m_params, rlims[i], 0);
+            params_ref p(m_params);
+            p.set_uint("random_seed", m_rand());
+            if (i > num_threads/2) {
+                p.set_sym("phase", symbol("random"));
+            }
+            if (m_config.m_par_diversify) {
+                // the main solver keeps its configuration, 
+                // the other solvers cycle through restart, gc and branching strategies.
+                static char const* restarts[3] = { "geometric", "luby", "ema" };
+                static char const* gcs[3] = { "glue", "psm", "glue_psm" };
+                static char const* branchings[3] = { "vmtf", "vsids", "chb" };
+                p.set_sym("restart", symbol(restarts[i % 3]));
+                p.set_sym("gc", symbol(gcs[i % 3]));
+                p.set_sym("branching.heuristic", symbol(branchings[i % 3]));
+                if (i % 4 == 3) {
+                    p.set_sym("phase", symbol("always_false"));
+                }
+                // local search replaces the saved phases, which only the solvers with phase caching use.
+                // It ignores the constraints of extensions.
+                if (i % 2 == 1 && !m_ext && config(p).m_phase == PS_CACHING) {
+                    p.set_bool("local_search", true);
+                }
+            }
+            solvers[i] = alloc(sat::solver, p, rlims[i], 0);
             solvers[i]->copy(*this);
-            solvers[i]->set_par(&par);
+            solvers[i]->set_par(&par, i);
             scoped_rlimit.push_child(&solvers[i]->rlimit());            
         }
-        set_par(&par);
-        m_params.set_sym("phase", saved_phase);
+        set_par(&par, num_extra_solvers);
         int finished_id = -1;
         std::string        ex_msg;
         par_exception_kind ex_kind;
@@ -866,10 +946,23 @@ namespace sat {
                 }
             }
         }
-        set_par(0);
+        set_par(0, 0);
+        unsigned par_exported = m_stats.m_par_exported, par_imported = m_stats.m_par_imported;
+        unsigned par_rejected = m_stats.m_par_rejected, par_overflow = m_stats.m_par_overflow;
+        for (int i = 0; i < num_extra_solvers; ++i) {
+            stats const& st = solvers[i]->m_stats;
+            par_exported += st.m_par_exported;
+            par_imported += st.m_par_imported;
+            par_rejected += st.m_par_rejected;
+            par_overflow += st.m_par_overflow;
+        }
         if (finished_id != -1 && finished_id < num_extra_solvers) {
             m_stats = solvers[finished_id]->m_stats;
         }
+        m_stats.m_par_exported = par_exported;
+        m_stats.m_par_imported = par_imported;
+        m_stats.m_par_rejected = par_rejected;
+        m_stats.m_par_overflow = par_overflow;
 
         for (int i = 0; i < num_extra_solvers; ++i) {            
             dealloc(solvers[i]);
@@ -884,6 +977,155 @@ namespace sat {
 
     }
 
+    /**
+       \brief Cube-and-conquer: split the search space using lookahead and 
+       solve the resulting cubes as assumptions on a pool of solvers.
+       Each solver takes the next unsolved cube from the shared queue and
+       keeps its learned clauses between cubes. Units, short learned clauses and the 
+       negations of the cores of refuted cubes are shared through sat::par.
+    */
+    lbool solver::check_cube() {
+        int num_threads = static_cast<int>(m_config.m_num_parallel);
+        unsigned depth = m_config.m_par_cube_depth;
+        if (depth == 0) {
+            // aim for 4 cubes per thread.
+            depth = log2(4 * num_threads - 1) + 1;
+        }
+        vector<literal_vector> cubes;
+        lookahead la(*this);
+        la(depth, cubes);
+        m_stats.m_cubes += cubes.size();
+        m_stats.m_cubes_refuted += la.num_refuted();
+        IF_VERBOSE(1, verbose_stream() << "(sat-cube :depth " << depth << " :cubes " << cubes.size() 
+                   << " :refuted " << la.num_refuted() << " :failed-literals " << la.num_failed() << ")\n";);
+        if (inconsistent() || cubes.empty()) {
+            m_core.reset();
+            return l_false;
+        }
+
+        scoped_limits scoped_rlimit(rlimit());
+        vector<reslimit> rlims(num_threads);
+        ptr_vector<sat::solver> solvers(num_threads);
+        sat::par par;
+        for (int i = 0; i < num_threads; ++i) {
+            params_ref p(m_params);
+            p.set_uint("random_seed", m_rand());
+            solvers[i] = alloc(sat::solver, p, rlims[i], 0);
+            solvers[i]->copy(*this);
+            solvers[i]->set_par(&par, i);
+            // cube literals are used as assumptions, they must not be eliminated.
+            for (unsigned j = 0; j < cubes.size(); ++j) {
+                for (unsigned k = 0; k < cubes[j].size(); ++k) {
+                    solvers[i]->m_external[cubes[j][k].var()] = true;
+                }
+            }
+            scoped_rlimit.push_child(&solvers[i]->rlimit());
+        }
+
+        unsigned next_cube = 0;
+        int finished_id = -1;
+        lbool result = l_false;
+        std::string        ex_msg;
+        par_exception_kind ex_kind = DEFAULT_EX;
+        unsigned error_code = 0;
+        bool has_ex = false;
+        bool has_real_ex = false; // the exception was not caused by canceling the worker.
+        #pragma omp parallel for
+        for (int i = 0; i < num_threads; ++i) {
+            try {
+                solver& s = *solvers[i];
+                while (true) {
+                    unsigned idx = 0;
+                    bool done = false;
+                    #pragma omp critical (par_cube)
+                    {
+                        done = finished_id != -1 || next_cube >= cubes.size();
+                        if (!done) 
+                            idx = next_cube++;
+                    }
+                    if (done) 
+                        break;
+                    literal_vector const& cube = cubes[idx];
+                    lbool r = s.check(cube.size(), cube.c_ptr());
+                    if (r == l_false && !s.get_core().empty()) {
+                        // the cube is refuted, the negation of its core holds globally.
+                        literal_vector lemma;
+                        for (unsigned j = 0; j < s.get_core().size(); ++j) 
+                            lemma.push_back(~s.get_core()[j]);
+                        par.share_clause(num_threads, lemma.size(), lemma);
+                        continue;
+                    }
+                    // sat, unsat independently of the cube, or canceled.
+                    bool first = false;
+                    #pragma omp critical (par_cube)
+                    {
+                        if (finished_id == -1) {
+                            finished_id = i;
+                            first = true;
+                            result = r;
+                        }
+                    }
+                    if (first) {
+                        for (int j = 0; j < num_threads; ++j) {
+                            if (i != j) {
+                                rlims[j].cancel();
+                            }
+                        }
+                    }
+                    break;
+                }
+            }
+            catch (z3_exception & ex) {
+                bool real_ex = !rlims[i].get_cancel_flag();
+                #pragma omp critical (par_cube)
+                {
+                    // the first real exception takes precedence over exceptions of canceled workers.
+                    if (!has_ex || (real_ex && !has_real_ex)) {
+                        has_ex = true;
+                        has_real_ex = real_ex;
+                        if (ex.has_error_code()) {
+                            error_code = ex.error_code();
+                            ex_kind = ERROR_EX;
+                        }
+                        else {
+                            ex_msg = ex.msg();
+                            ex_kind = DEFAULT_EX;
+                        }
+                    }
+                }
+                for (int j = 0; j < num_threads; ++j) {
+                    if (i != j) {
+                        rlims[j].cancel();
+                    }
+                }
+            }
+        }
+        if (finished_id != -1 && result == l_true) {
+            set_model(solvers[finished_id]->get_model());
+        }
+        m_core.reset();
+        for (int i = 0; i < num_threads; ++i) {
+            stats const& st = solvers[i]->m_stats;
+            m_stats.m_conflict     += st.m_conflict;
+            m_stats.m_decision     += st.m_decision;
+            m_stats.m_propagate    += st.m_propagate;
+            m_stats.m_restart      += st.m_restart;
+            m_stats.m_par_exported += st.m_par_exported;
+            m_stats.m_par_imported += st.m_par_imported;
+            m_stats.m_par_rejected += st.m_par_rejected;
+            m_stats.m_par_overflow += st.m_par_overflow;
+            dealloc(solvers[i]);
+        }
+        // a worker canceled because of a real exception may have finished first with l_undef.
+        if (has_ex && (finished_id == -1 || (has_real_ex && result == l_undef))) {
+            switch (ex_kind) {
+            case ERROR_EX: throw z3_error(error_code);
+            default: throw default_exception(ex_msg.c_str());
+            }
+        }
+        return result;
+    }
+
     /*
       \brief import lemmas/units from parallel sat solvers.
      */
@@ -912,14 +1154,86 @@ namespace sat {
             if (num_in > 0 || num_out > 0) {
                 IF_VERBOSE(1, verbose_stream() << "(sat-sync out: " << num_out << " in: " << num_in << ")\n";);
             }
+            import_par_clauses();
+        }
+    }
+
+    /**
+       \brief publish the learned clauses collected since the last exchange and 
+       add the clauses learned by other solvers as learned clauses.
+       Clauses that contain variables eliminated in this solver are ignored.
+    */
+    void solver::import_par_clauses() {
+        SASSERT(m_par && scope_lvl() == 0);
+        if (m_config.m_par_share_size == 0) 
+            return;
+        m_par_in.reset();
+        if (m_par->exchange_clauses(m_par_id, m_par_out, m_par_clause_head, m_par_in)) {
+            m_stats.m_par_overflow++;
+        }
+        m_par_out.reset();
+        unsigned num_in = 0;
+        for (unsigned i = 0; i < m_par_in.size(); ) {
+            unsigned glue = m_par_in[i];
+            unsigned n    = m_par_in[i + 1];
+            unsigned const* lits = m_par_in.c_ptr() + i + 2;
+            i += 2 + n;
+            if (inconsistent()) 
+                continue;
+            m_par_lits.reset();
+            bool ok = true;
+            for (unsigned j = 0; ok && j < n; ++j) {
+                literal lit = to_literal(lits[j]);
+                ok = lit.var() < m_par_num_vars && !was_eliminated(lit.var());
+                m_par_lits.push_back(lit);
+            }
+            unsigned sz = m_par_lits.size();
+            if (!ok || !simplify_clause(sz, m_par_lits.c_ptr())) {
+                m_stats.m_par_rejected++;
+                continue;
+            }
+            ++num_in;
+            m_stats.m_par_imported++;
+            clause* c = mk_clause_core(sz, m_par_lits.c_ptr(), true);
+            if (c) c->set_glue(std::min(glue, sz));
+        }
+        if (num_in > 0) {
+            IF_VERBOSE(2, verbose_stream() << "(sat-sync :imported-clauses " << num_in << ")\n";);
+        }
+    }
+
+    /**
+       \brief queue the current lemma for sharing if it passes the export filter.
+    */
+    void solver::export_par_clause(unsigned glue) {
+        export_par_clause(glue, m_lemma.size(), m_lemma.c_ptr());
+    }
+
+    void solver::export_par_clause(unsigned glue, unsigned sz, literal const * lits) {
+        if (!m_par || sz <= 1 || sz > m_config.m_par_share_size)
+            return;
+        if (sz > 3 && glue > m_config.m_par_share_glue) 
+            return;
+        for (unsigned i = 0; i < sz; ++i) {
+            if (lits[i].var() >= m_par_num_vars)
+                return;
+        }
+        m_stats.m_par_exported++;
+        m_par_out.push_back(glue);
+        m_par_out.push_back(sz);
+        for (unsigned i = 0; i < sz; ++i) {
+            m_par_out.push_back(lits[i].index());
         }
     }
 
-    void solver::set_par(par* p) {
+    void solver::set_par(par* p, unsigned id) {
         m_par = p;
         m_par_num_vars = num_vars();
         m_par_limit_in = 0;
         m_par_limit_out = 0;
+        m_par_id = id;
+        m_par_clause_head = 0;
+        m_par_out.reset();
     }
 
     bool_var solver::next_var() {
@@ -934,15 +1248,119 @@ namespace sat {
                 return next;
         }
 
-        while (!m_case_split_queue.empty()) {
-            next = m_case_split_queue.next_var();
-            if (value(next) == l_undef && !was_eliminated(next))
-                return next;
+        switch (m_branching) {
+        case BH_VMTF:
+            // the variables after the search position are assigned.
+            for (next = m_vmtf.search(); next != null_bool_var; next = m_vmtf.prev(next)) {
+                if (value(next) == l_undef && !was_eliminated(next)) {
+                    m_vmtf.set_search(next);
+                    return next;
+                }
+            }
+            break;
+        case BH_CHB:
+            while (!m_chb_queue.empty()) {
+                next = m_chb_queue.next_var();
+                if (value(next) == l_undef && !was_eliminated(next))
+                    return next;
+            }
+            break;
+        default:
+            while (!m_case_split_queue.empty()) {
+                next = m_case_split_queue.next_var();
+                if (value(next) == l_undef && !was_eliminated(next))
+                    return next;
+            }
+            break;
         }
 
         return null_bool_var;
     }
 
+    bool solver::is_more_active(bool_var v1, bool_var v2) const {
+        switch (m_branching) {
+        case BH_VMTF: return m_vmtf.stamp(v1) > m_vmtf.stamp(v2);
+        case BH_CHB:  return m_chb_q[v1] > m_chb_q[v2];
+        default:      return m_activity[v1] > m_activity[v2];
+        }
+    }
+
+    /**
+       \brief Use heuristic h for the next decisions.
+       The queues of the inactive heuristics are not updated when variables get unassigned,
+       so the queue of h is filled with the unassigned variables.
+    */
+    void solver::set_branching(branching_heuristic h) {
+        if (h == m_branching)
+            return;
+        TRACE("sat", tout << "branching heuristic " << h << "\n";);
+        m_branching = h;
+        m_vmtf_bumped.reset();
+        if (h == BH_VMTF) {
+            m_vmtf.reset_search();
+            return;
+        }
+        for (bool_var v = 0; v < num_vars(); ++v) {
+            if (value(v) != l_undef || was_eliminated(v))
+                continue;
+            if (h == BH_CHB)
+                m_chb_queue.unassign_var_eh(v);
+            else
+                m_case_split_queue.unassign_var_eh(v);
+        }
+    }
+
+    /**
+       \brief Alternate between the configured heuristic and VSIDS every branching.switch conflicts.
+    */
+    void solver::update_branching() {
+        if (m_config.m_branching_switch == 0 || m_conflicts < m_next_branching_switch)
+            return;
+        m_next_branching_switch = m_conflicts + m_config.m_branching_switch;
+        if (m_config.m_branching_heuristic == BH_VSIDS)
+            return;
+        set_branching(m_branching == BH_VSIDS ? m_config.m_branching_heuristic : BH_VSIDS);
+        IF_VERBOSE(2, verbose_stream() << "(sat.branching " << (m_branching == BH_VSIDS ? "vsids" : m_branching == BH_VMTF ? "vmtf" : "chb") << ")\n";);
+    }
+
+    /**
+       \brief Reward the variables assigned since qhead.
+       The reward is higher for variables that occurred in recent conflicts, and
+       assignments that lead to a conflict are rewarded more.
+    */
+    void solver::update_chb(unsigned qhead) {
+        double multiplier = m_inconsistent ? 1.0 : 0.9;
+        for (unsigned i = qhead; i < m_trail.size(); ++i) {
+            bool_var v = m_trail[i].var();
+            double reward = multiplier / (m_conflicts - m_chb_last_conflict[v] + 1);
+            double & q = m_chb_q[v];
+            double old_q = q;
+            q = (1 - m_chb_alpha) * q + m_chb_alpha * reward;
+            if (q > old_q)
+                m_chb_queue.activity_increased_eh(v);
+            else
+                m_chb_queue.activity_decreased_eh(v);
+        }
+    }
+
+    /**
+       \brief Move the variables bumped in the last conflict to the front of the VMTF queue,
+       preserving their relative order.
+    */
+    void solver::bump_vmtf() {
+        struct stamp_lt {
+            vmtf_queue const& m_vmtf;
+            stamp_lt(vmtf_queue const& q):m_vmtf(q) {}
+            bool operator()(bool_var v1, bool_var v2) const { return m_vmtf.stamp(v1) < m_vmtf.stamp(v2); }
+        };
+        std::sort(m_vmtf_bumped.begin(), m_vmtf_bumped.end(), stamp_lt(m_vmtf));
+        for (unsigned i = 0; i < m_vmtf_bumped.size(); ++i) {
+            bool_var v = m_vmtf_bumped[i];
+            m_vmtf.move_to_front(v, value(v) == l_undef && !was_eliminated(v));
+        }
+        m_vmtf_bumped.reset();
+    }
+
     bool solver::decide() {
         bool_var next = next_var();
         if (next == null_bool_var)
@@ -1011,7 +1429,7 @@ namespace sat {
             return l_false;
         if (m_conflicts > m_config.m_max_conflicts)
             return l_undef;
-        if (m_conflicts_since_restart > m_restart_threshold)
+        if (should_restart())
             return l_undef;
         if (scope_lvl() == 0) {
             cleanup(); // cleaner may propagate frozen clauses
@@ -1049,6 +1467,8 @@ namespace sat {
         if (inconsistent()) {
             if (tracking_assumptions())
                 resolve_conflict();
+            else if (m_drat.enabled())
+                m_drat.add();
             return true;
         }
         else {
@@ -1165,7 +1585,15 @@ namespace sat {
         m_conflicts_since_restart = 0;
         m_restart_threshold       = m_config.m_restart_initial;
         m_luby_idx                = 1;
+        m_fast_glue_avg.set_alpha(m_config.m_restart_fast_glue);
+        m_slow_glue_avg.set_alpha(m_config.m_restart_slow_glue);
+        m_trail_avg.set_alpha(1.0 / 5000);
+        m_fast_glue_avg.reset();
+        m_slow_glue_avg.reset();
+        m_trail_avg.reset();
         m_gc_threshold            = m_config.m_gc_initial;
+        m_next_tier2_gc           = m_config.m_gc_tier2_interval;
+        m_next_local_search       = 0;
         m_restarts                = 0;
         m_min_d_tk                = 1.0;
         m_stopwatch.reset();
@@ -1176,6 +1604,34 @@ namespace sat {
         TRACE("sat", display(tout););
     }
 
+    /**
+       \brief Recover XOR constraints from the clauses and hand them to the
+       card_extension, which is created if there is no extension.
+       The clauses of the XOR constraints are retained.
+    */
+    void solver::find_xors() {
+        // the clauses of a user scope are removed by user_pop.
+        if (!m_user_scope_literals.empty() || inconsistent()) {
+            return;
+        }
+        vector<bool_var_vector> xors;
+        svector<bool> rhs;
+        xor_finder(*this)(m_config.m_xor_max_size, xors, rhs);
+        if (xors.empty()) {
+            return;
+        }
+        if (!m_ext) {
+            set_extension(alloc(card_extension));
+        }
+        card_extension* ext = dynamic_cast<card_extension*>(m_ext);
+        if (!ext) {
+            return;
+        }
+        for (unsigned i = 0; i < xors.size(); ++i) {
+            ext->add_xor(xors[i], rhs[i]);
+        }
+    }
+
     /**
        \brief Apply all simplifications.
 
@@ -1200,6 +1656,11 @@ namespace sat {
         m_scc();
         CASSERT("sat_simplify_bug", check_invariant());
 
+        unsigned sub_gain  = m_simplifier.sub_gain();
+        unsigned elim_gain = m_simplifier.elim_gain();
+        uint64   sub_cost  = m_simplifier.sub_cost();
+        uint64   elim_cost = m_simplifier.elim_cost();
+        m_simplifier.set_effort(m_inprocess.weight(inprocess_scheduler::SUBSUME), m_inprocess.weight(inprocess_scheduler::ELIM_VARS));
         m_simplifier(false);
         CASSERT("sat_simplify_bug", check_invariant());
         CASSERT("sat_missed_prop", check_missed_propagation());
@@ -1209,6 +1670,8 @@ namespace sat {
             CASSERT("sat_missed_prop", check_missed_propagation());
             CASSERT("sat_simplify_bug", check_invariant());
         }
+        m_inprocess.update(inprocess_scheduler::SUBSUME, sub_gain, m_simplifier.sub_gain(), sub_cost, m_simplifier.sub_cost());
+        m_inprocess.update(inprocess_scheduler::ELIM_VARS, elim_gain, m_simplifier.elim_gain(), elim_cost, m_simplifier.elim_cost());
 
         sort_watch_lits();
         CASSERT("sat_simplify_bug", check_invariant());
@@ -1221,11 +1684,24 @@ namespace sat {
         CASSERT("sat_missed_prop", check_missed_propagation());
         CASSERT("sat_simplify_bug", check_invariant());
 
+        unsigned viv_gain = m_vivify.gain();
+        uint64   viv_cost = m_vivify.cost();
+        m_vivify(m_inprocess.weight(inprocess_scheduler::VIVIFY));
+        m_inprocess.update(inprocess_scheduler::VIVIFY, viv_gain, m_vivify.gain(), viv_cost, m_vivify.cost());
+        CASSERT("sat_missed_prop", check_missed_propagation());
+        CASSERT("sat_simplify_bug", check_invariant());
+
+        if (m_config.m_xor_solver) {
+            find_xors();
+        }
+
         if (m_ext) {
             m_ext->clauses_modifed();
             m_ext->simplify();
         }
 
+        compact_clauses();
+
         TRACE("sat", display(tout << "consistent: " << (!inconsistent()) << "\n"););
 
         reinit_assumptions();
@@ -1339,6 +1815,81 @@ namespace sat {
         return ok;
     }
 
+    bool solver::should_restart() const {
+        if (m_conflicts_since_restart <= m_restart_threshold)
+            return false;
+        if (m_config.m_restart != RS_EMA)
+            return true;
+        return m_fast_glue_avg > m_config.m_restart_margin * m_slow_glue_avg;
+    }
+
+    /**
+       \brief Postpone the next restart if the current assignment is much larger than usual,
+       the solver may be close to a model (as in glucose).
+    */
+    void solver::block_restart() {
+        if (m_conflicts > m_config.m_restart_blocking_delay &&
+            m_conflicts_since_restart > m_restart_threshold &&
+            m_trail.size() > m_config.m_restart_blocking_margin * m_trail_avg) {
+            m_conflicts_since_restart = 0;
+            m_stats.m_blocked_restart++;
+        }
+        m_trail_avg.update(m_trail.size());
+    }
+
+    /**
+       \brief Return the number of scopes kept by a restart.
+       For partial restarts the decisions that are more active than the next 
+       decision variable are kept, they would be taken again after a full restart.
+    */
+    unsigned solver::restart_level() {
+        if (!m_config.m_restart_partial)
+            return 0;
+        // the scope of the assumptions is kept.
+        unsigned lvl = (tracking_assumptions() && scope_lvl() > 0) ? 1 : 0;
+        bool_var next = null_bool_var;
+        switch (m_branching) {
+        case BH_VMTF:
+            for (bool_var v = m_vmtf.search(); v != null_bool_var; v = m_vmtf.prev(v)) {
+                if (value(v) == l_undef && !was_eliminated(v)) {
+                    next = v;
+                    break;
+                }
+            }
+            break;
+        case BH_CHB:
+            while (!m_chb_queue.empty()) {
+                bool_var v = m_chb_queue.min_var();
+                if (value(v) == l_undef && !was_eliminated(v)) {
+                    next = v;
+                    break;
+                }
+                m_chb_queue.next_var();
+            }
+            break;
+        default:
+            while (!m_case_split_queue.empty()) {
+                bool_var v = m_case_split_queue.min_var();
+                if (value(v) == l_undef && !was_eliminated(v)) {
+                    next = v;
+                    break;
+                }
+                // assigned variables are reinserted when they get unassigned.
+                m_case_split_queue.next_var();
+            }
+            break;
+        }
+        if (next == null_bool_var)
+            return lvl;
+        while (lvl < scope_lvl()) {
+            unsigned lim = m_scopes[lvl].m_trail_lim;
+            if (lim >= m_trail.size() || !is_more_active(m_trail[lim].var(), next))
+                break;
+            ++lvl;
+        }
+        return lvl;
+    }
+
     void solver::restart() {
         m_stats.m_restart++;
         m_restarts++;
@@ -1347,8 +1898,19 @@ namespace sat {
                    << " :restarts " << m_stats.m_restart << mk_stat(*this)
                    << " :time " << std::fixed << std::setprecision(2) << m_stopwatch.get_current_seconds() << ")\n";);
         IF_VERBOSE(30, display_status(verbose_stream()););
-        pop_reinit(scope_lvl());
+        unsigned lvl = restart_level();
+        if (lvl > 0 && lvl > (tracking_assumptions() ? 1u : 0u)) {
+            m_stats.m_partial_restart++;
+            unsigned base = m_scopes[0].m_trail_lim;
+            unsigned lim  = lvl < scope_lvl() ? m_scopes[lvl].m_trail_lim : m_trail.size();
+            m_stats.m_reused_trail += lim - base;
+            TRACE("sat", tout << "partial restart keeps " << lvl << " of " << scope_lvl() << " scopes\n";);
+        }
+        pop_reinit(scope_lvl() - lvl);
         m_conflicts_since_restart = 0;
+        update_branching();
+        if (m_config.m_local_search && !m_ext && m_conflicts >= m_next_local_search)
+            rephase();
         switch (m_config.m_restart) {
         case RS_GEOMETRIC:
             m_restart_threshold = static_cast<unsigned>(m_restart_threshold * m_config.m_restart_factor);
@@ -1357,6 +1919,9 @@ namespace sat {
             m_luby_idx++;
             m_restart_threshold = m_config.m_restart_initial * get_luby(m_luby_idx);
             break;
+        case RS_EMA:
+            m_restart_threshold = m_config.m_restart_initial;
+            break;
         default:
             UNREACHABLE();
             break;
@@ -1364,6 +1929,20 @@ namespace sat {
         CASSERT("sat_restart", check_invariant());
     }
 
+    /**
+       \brief Replace the saved phases by the best assignment of a local search round.
+       Phase caching is switched on, so the next decisions follow that assignment,
+       if it is a model the search ends without further conflicts.
+    */
+    void solver::rephase() {
+        m_next_local_search = m_conflicts + m_config.m_local_search_interval;
+        if (m_local_search(m_config.m_local_search_flips, m_config.m_local_search_cb) == l_true) {
+            IF_VERBOSE(2, verbose_stream() << "(sat.local-search model found)\n";);
+        }
+        m_phase_cache_on = true;
+        m_phase_counter  = 0;
+    }
+
     // -----------------------
     //
     // GC
@@ -1392,15 +1971,99 @@ namespace sat {
                 return;
             gc_dyn_psm();
             break;
+        case GC_TIERED:
+            gc_tiered();
+            break;
         default:
             UNREACHABLE();
             break;
         }
         m_conflicts_since_gc = 0;
         m_gc_threshold += m_config.m_gc_increment;
+        compact_clauses();
         CASSERT("sat_gc_bug", check_invariant());
     }
 
+    struct activity_gt {
+        svector<unsigned> const & m_activity;
+        activity_gt(svector<unsigned> const & act): m_activity(act) {}
+        bool operator()(bool_var v1, bool_var v2) const { return m_activity[v1] > m_activity[v2]; }
+    };
+
+    /**
+       \brief Move the clauses into a new arena, ordered by the watch lists of the variables
+       with the highest activity. The clauses visited when propagating a literal are then adjacent.
+       The pointers and offsets held by the solver are updated.
+       The conflict may refer to a clause that is no longer attached, the arena is
+       left alone until it is resolved.
+    */
+    void solver::compact_clauses() {
+        if (inconsistent() || !m_cls_allocator.should_relocate())
+            return;
+        m_stats.m_compact++;
+        unsigned num_words = 0;
+        for (unsigned i = 0; i < m_clauses.size(); ++i)
+            num_words += m_cls_allocator.get_relocated_words(*m_clauses[i]);
+        for (unsigned i = 0; i < m_learned.size(); ++i)
+            num_words += m_cls_allocator.get_relocated_words(*m_learned[i]);
+        TRACE("sat", tout << "compact clauses: " << num_words << " words\n";);
+        m_cls_allocator.start_relocation(num_words);
+
+        bool_var_vector vars;
+        for (bool_var v = 0; v < num_vars(); ++v)
+            vars.push_back(v);
+        std::stable_sort(vars.begin(), vars.end(), activity_gt(m_activity));
+        for (unsigned i = 0; i < vars.size(); ++i) {
+            for (unsigned sign = 0; sign < 2; ++sign) {
+                watch_list const & wlist = get_wlist(literal(vars[i], sign != 0));
+                watch_list::const_iterator it  = wlist.begin();
+                watch_list::const_iterator end = wlist.end();
+                for (; it != end; ++it) {
+                    if (!it->is_clause())
+                        continue;
+                    clause & c = *(m_cls_allocator.get_clause(it->get_clause_offset()));
+                    if (!m_cls_allocator.is_relocated(c))
+                        m_cls_allocator.relocate(c);
+                }
+            }
+        }
+        // detached and ternary clauses.
+        for (unsigned i = 0; i < m_clauses.size(); ++i)
+            if (!m_cls_allocator.is_relocated(*m_clauses[i]))
+                m_cls_allocator.relocate(*m_clauses[i]);
+        for (unsigned i = 0; i < m_learned.size(); ++i)
+            if (!m_cls_allocator.is_relocated(*m_learned[i]))
+                m_cls_allocator.relocate(*m_learned[i]);
+
+        // update the references.
+        vector<watch_list>::iterator wit  = m_watches.begin();
+        vector<watch_list>::iterator wend = m_watches.end();
+        for (; wit != wend; ++wit) {
+            watch_list::iterator it  = wit->begin();
+            watch_list::iterator end = wit->end();
+            for (; it != end; ++it) {
+                if (it->is_clause())
+                    it->set_clause_offset(m_cls_allocator.get_relocated(it->get_clause_offset()));
+            }
+        }
+        for (unsigned i = 0; i < m_trail.size(); ++i) {
+            bool_var v = m_trail[i].var();
+            justification js = m_justification[v];
+            if (js.is_clause())
+                m_justification[v] = justification(m_cls_allocator.get_relocated(js.get_clause_offset()));
+        }
+        for (unsigned i = 0; i < m_clauses_to_reinit.size(); ++i) {
+            clause_wrapper const & cw = m_clauses_to_reinit[i];
+            if (!cw.is_binary())
+                m_clauses_to_reinit[i] = clause_wrapper(*m_cls_allocator.get_relocated(cw.get_clause()));
+        }
+        for (unsigned i = 0; i < m_clauses.size(); ++i)
+            m_clauses[i] = m_cls_allocator.get_relocated(m_clauses[i]);
+        for (unsigned i = 0; i < m_learned.size(); ++i)
+            m_learned[i] = m_cls_allocator.get_relocated(m_learned[i]);
+        m_cls_allocator.end_relocation();
+    }
+
     /**
        \brief Lex on (glue, size)
     */
@@ -1507,6 +2170,98 @@ namespace sat {
         IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "(sat-gc :strategy " << st_name << " :deleted " << (sz - new_sz) << ")\n";);
     }
 
+    /**
+       \brief A learned clause participates in conflict analysis.
+       Its glue is recomputed, a clause whose glue decreased can move to a higher tier.
+       Clauses that enter the core tier are shared with the other parallel solvers.
+    */
+    void solver::update_tier(clause & c) {
+        c.reset_inact_rounds();
+        clause_tier t = tier(c);
+        if (t == TIER_CORE)
+            return;
+        unsigned glue = num_diff_levels(c.size(), c.begin());
+        if (glue >= c.glue())
+            return;
+        c.set_glue(glue);
+        if (glue <= m_config.m_gc_tier2)
+            c.set_demoted(false);
+        clause_tier new_t = tier(c);
+        if (new_t == t)
+            return;
+        TRACE("sat_gc", tout << "promote " << c << " glue: " << glue << "\n";);
+        m_stats.m_gc_promoted++;
+        if (new_t == TIER_CORE)
+            export_par_clause(glue, c.size(), c.begin());
+    }
+
+    /**
+       \brief Tiered gc. Core clauses are kept, clauses of the middle tier that
+       were not used in conflicts since the last demotion round move to the local tier.
+       The local clauses that were not used since the last reduction are candidates,
+       the half with the highest glue is deleted. The candidates are partitioned
+       with nth_element, the database is not sorted.
+    */
+    void solver::gc_tiered() {
+        TRACE("sat", tout << "gc\n";);
+        bool demote = m_conflicts >= m_next_tier2_gc;
+        if (demote)
+            m_next_tier2_gc = m_conflicts + m_config.m_gc_tier2_interval;
+        unsigned demoted = 0;
+        clause_vector candidates;
+        clause_vector::iterator it  = m_learned.begin();
+        clause_vector::iterator end = m_learned.end();
+        for (; it != end; ++it) {
+            clause & c = *(*it);
+            switch (tier(c)) {
+            case TIER_CORE:
+                break;
+            case TIER_MID:
+                if (!demote)
+                    break;
+                if (c.inact_rounds() == 0) {
+                    c.inc_inact_rounds();
+                }
+                else {
+                    // the clause gets a round in the local tier before it can be deleted.
+                    c.set_demoted(true);
+                    c.reset_inact_rounds();
+                    demoted++;
+                }
+                break;
+            case TIER_LOCAL:
+                if (c.inact_rounds() == 0)
+                    c.inc_inact_rounds();
+                else if (can_delete(c))
+                    candidates.push_back(&c);
+                break;
+            }
+        }
+        unsigned keep = candidates.size() / 2;
+        std::nth_element(candidates.begin(), candidates.begin() + keep, candidates.end(), glue_lt());
+        for (unsigned i = keep; i < candidates.size(); ++i) {
+            clause & c = *candidates[i];
+            dettach_clause(c);
+            c.set_removed(true);
+        }
+        unsigned deleted = candidates.size() - keep;
+        if (deleted > 0) {
+            unsigned j = 0;
+            for (unsigned i = 0; i < m_learned.size(); ++i) {
+                clause & c = *m_learned[i];
+                if (c.was_removed())
+                    del_clause(c);
+                else
+                    m_learned[j++] = &c;
+            }
+            m_learned.shrink(j);
+        }
+        m_stats.m_gc_clause += deleted;
+        m_stats.m_gc_demoted += demoted;
+        IF_VERBOSE(SAT_VB_LVL, verbose_stream() << "(sat-gc :strategy tiered :deleted " << deleted
+                   << " :demoted " << demoted << " :learned " << m_learned.size() << ")\n";);
+    }
+
     /**
        \brief Use gc based on dynamic psm. Clauses are initially frozen.
     */
@@ -1579,7 +2334,8 @@ namespace sat {
                     activated++;
                     if (!activate_frozen_clause(c)) {
                         // clause was satisfied, reduced to a conflict, unit or binary clause.
-                        del_clause(c);
+                        if (m_drat.enabled()) m_drat.del(m_frozen_lits);
+                        del_clause(c, false);
                         continue;
                     }
                 }
@@ -1609,6 +2365,10 @@ namespace sat {
         // do some cleanup
         unsigned sz = c.size();
         unsigned j  = 0;
+        if (m_drat.enabled()) {
+            m_frozen_lits.reset();
+            m_frozen_lits.append(sz, c.begin());
+        }
         for (unsigned i = 0; i < sz; i++) {
             literal l = c[i];
             switch (value(l)) {
@@ -1636,6 +2396,10 @@ namespace sat {
             return false;
         default:
             c.shrink(new_sz);
+            if (m_drat.enabled() && new_sz < sz) {
+                m_drat.add(c);
+                m_drat.del(m_frozen_lits);
+            }
             attach_clause(c);
             return true;
         }
@@ -1686,11 +2450,18 @@ namespace sat {
         m_conflicts_since_restart++;
         m_conflicts_since_gc++;
 
+        if (m_config.m_restart_blocking)
+            block_restart();
+
         m_conflict_lvl = get_max_lvl(m_not_l, m_conflict);
         TRACE("sat", tout << "conflict detected at level " << m_conflict_lvl << " for ";
               if (m_not_l == literal()) tout << "null literal\n";
               else tout << m_not_l << "\n";);
 
+        if (m_conflict_lvl == 0 && m_drat.enabled()) {
+            m_drat.add();
+        }
+
         if (m_conflict_lvl <= 1 && tracking_assumptions()) {
             resolve_conflict_for_unsat_core();
             return false;
@@ -1732,6 +2503,8 @@ namespace sat {
                 break;
             case justification::CLAUSE: {
                 clause & c = *(m_cls_allocator.get_clause(js.get_clause_offset()));
+                if (c.is_learned() && m_config.m_gc_strategy == GC_TIERED)
+                    update_tier(c);
                 unsigned i   = 0;
                 if (consequent != null_literal) {
                     SASSERT(c[0] == consequent || c[1] == consequent);
@@ -1802,6 +2575,9 @@ namespace sat {
         }
 
         unsigned glue = num_diff_levels(m_lemma.size(), m_lemma.c_ptr());
+        m_fast_glue_avg.update(glue);
+        m_slow_glue_avg.update(glue);
+        export_par_clause(glue);
 
         pop_reinit(m_scope_lvl - new_scope_lvl);
         TRACE("sat_conflict_detail", display(tout); tout << "assignment:\n"; display_assignment(tout););
@@ -2452,8 +3228,10 @@ namespace sat {
                     break;
                 }
             }
-            // try to use cached implication if available
-            literal_vector * implied_lits = m_probing.cached_implied_lits(~l);
+            // try to use cached implication if available.
+            // cached implications are not in the clause database, so they
+            // cannot be used when producing DRAT proofs.
+            literal_vector * implied_lits = m_drat.enabled() ? 0 : m_probing.cached_implied_lits(~l);
             if (implied_lits) {
                 literal_vector::iterator it  = implied_lits->begin();
                 literal_vector::iterator end = implied_lits->end();
@@ -2571,7 +3349,11 @@ namespace sat {
             m_assignment[(~l).index()] = l_undef;
             bool_var v = l.var();
             SASSERT(value(v) == l_undef);
-            m_case_split_queue.unassign_var_eh(v);
+            switch (m_branching) {
+            case BH_VMTF: m_vmtf.unassign_var_eh(v); break;
+            case BH_CHB:  m_chb_queue.unassign_var_eh(v); break;
+            default:      m_case_split_queue.unassign_var_eh(v); break;
+            }
         }
         m_trail.shrink(old_sz);
         m_qhead = old_sz;
@@ -2620,6 +3402,8 @@ namespace sat {
         bool_var new_v = mk_var(true, false);
         lit = literal(new_v, false);
         m_user_scope_literals.push_back(lit);
+        if (m_ext)
+            m_ext->user_push();
         TRACE("sat", tout << "user_push: " << lit << "\n";);
     }
 
@@ -2683,6 +3467,8 @@ namespace sat {
             w = max_var(m_clauses, w);
             w = max_var(true, w);
             w = max_var(false, w);
+            if (m_ext)
+                w = m_ext->max_var(w);
             for (unsigned i = 0; i < m_trail.size(); ++i) {
                 if (m_trail[i].var() > w) w = m_trail[i].var();
             }
@@ -2692,7 +3478,12 @@ namespace sat {
         if (v < m_level.size()) {
             for (bool_var i = v; i < m_level.size(); ++i) {
                 m_case_split_queue.del_var_eh(i);
+                m_chb_queue.del_var_eh(i);
             }
+            m_vmtf.shrink(v);
+            m_vmtf_bumped.reset();
+            m_chb_q.shrink(v);
+            m_chb_last_conflict.shrink(v);
             m_watches.shrink(2*v);
             m_assignment.shrink(2*v);
             m_justification.shrink(v);
@@ -2731,6 +3522,8 @@ namespace sat {
                     break;
                 }
             }
+            if (m_ext)
+                m_ext->user_pop(1);
             gc_var(lit.var());
         }
     }
@@ -2749,11 +3542,15 @@ namespace sat {
     void solver::updt_params(params_ref const & p) {
         m_params = p;
         m_config.updt_params(p);
+        set_branching(m_config.m_branching_heuristic);
         m_simplifier.updt_params(p);
         m_asymm_branch.updt_params(p);
         m_probing.updt_params(p);
+        m_vivify.updt_params(p);
+        m_inprocess.set_adaptive(m_config.m_inprocess_adaptive);
         m_scc.updt_params(p);
         m_rand.set_seed(m_config.m_random_seed);
+        m_drat.open(m_config.m_drat_file, m_config.m_drat_binary);
     }
 
     void solver::collect_param_descrs(param_descrs & d) {
@@ -2761,6 +3558,7 @@ namespace sat {
         simplifier::collect_param_descrs(d);
         asymm_branch::collect_param_descrs(d);
         probing::collect_param_descrs(d);
+        vivify::collect_param_descrs(d);
         scc::collect_param_descrs(d);
     }
 
@@ -2771,6 +3569,11 @@ namespace sat {
         m_scc.collect_statistics(st);
         m_asymm_branch.collect_statistics(st);
         m_probing.collect_statistics(st);
+        m_vivify.collect_statistics(st);
+        m_local_search.collect_statistics(st);
+        m_inprocess.collect_statistics(st);
+        m_drat.collect_statistics(st);
+        if (m_ext) m_ext->collect_statistics(st);
     }
 
     void solver::reset_statistics() {
@@ -2779,6 +3582,8 @@ namespace sat {
         m_simplifier.reset_statistics();
         m_asymm_branch.reset_statistics();
         m_probing.reset_statistics();
+        m_vivify.reset_statistics();
+        m_local_search.reset_statistics();
     }
 
     // -----------------------
@@ -2875,6 +3680,7 @@ namespace sat {
         display_units(out);
         display_binary(out);
         out << m_clauses << m_learned;
+        if (m_ext) m_ext->display(out);
         out << ")\n";
     }
 
@@ -3563,6 +4369,18 @@ namespace sat {
         st.update("minimized lits", m_minimized_lits);
         st.update("dyn subsumption resolution", m_dyn_sub_res);
         st.update("blocked correction sets", m_blocked_corr_sets);
+        st.update("par clauses exported", m_par_exported);
+        st.update("par clauses imported", m_par_imported);
+        st.update("par clauses rejected", m_par_rejected);
+        st.update("par clause pool overflows", m_par_overflow);
+        st.update("cubes", m_cubes);
+        st.update("cubes refuted", m_cubes_refuted);
+        st.update("blocked restarts", m_blocked_restart);
+        st.update("partial restarts", m_partial_restart);
+        st.update("partial restart reused trail", m_reused_trail);
+        st.update("promoted clauses", m_gc_promoted);
+        st.update("demoted clauses", m_gc_demoted);
+        st.update("compactions", m_compact);
     }
 
     void stats::reset() {
@@ -3582,6 +4400,18 @@ namespace sat {
         m_dyn_sub_res = 0;
         m_non_learned_generation = 0;
         m_blocked_corr_sets = 0;
+        m_par_exported = 0;
+        m_par_imported = 0;
+        m_par_rejected = 0;
+        m_par_overflow = 0;
+        m_cubes = 0;
+        m_cubes_refuted = 0;
+        m_blocked_restart = 0;
+        m_partial_restart = 0;
+        m_reused_trail = 0;
+        m_gc_promoted = 0;
+        m_gc_demoted = 0;
+        m_compact = 0;
     }
 
     void mk_stat::display(std::ostream & out) const {
@@ -32,11 +32,16 @@ Revision History:
 #include"sat_asymm_branch.h"
 #include"sat_iff3_finder.h"
 #include"sat_probing.h"
+#include"sat_vivify.h"
+#include"sat_inprocess.h"
+#include"sat_local_search.h"
 #include"sat_mus.h"
 #include"sat_par.h"
+#include"sat_drat.h"
 #include"params.h"
 #include"statistics.h"
 #include"stopwatch.h"
+#include"ema.h"
 #include"trace.h"
 #include"rlimit.h"
 
@@ -62,6 +67,18 @@ namespace sat {
         unsigned m_dyn_sub_res;
         unsigned m_non_learned_generation;
         unsigned m_blocked_corr_sets;
+        unsigned m_par_exported;
+        unsigned m_par_imported;
+        unsigned m_par_rejected;
+        unsigned m_par_overflow;
+        unsigned m_cubes;
+        unsigned m_cubes_refuted;
+        unsigned m_blocked_restart;
+        unsigned m_partial_restart;
+        unsigned m_reused_trail;
+        unsigned m_gc_promoted;
+        unsigned m_gc_demoted;
+        unsigned m_compact;
         stats() { reset(); }
         void reset();
         void collect_statistics(statistics & st) const;
@@ -86,7 +103,11 @@ namespace sat {
         scc                     m_scc;
         asymm_branch            m_asymm_branch;
         probing                 m_probing;
+        vivify                  m_vivify;
+        inprocess_scheduler     m_inprocess;
+        local_search            m_local_search;
         mus                     m_mus;           // MUS for minimal core extraction
+        drat                    m_drat;          // DRAT proof output
         bool                    m_inconsistent;
         // A conflict is usually a single justification. That is, a justification
         // for false. If m_not_l is not null_literal, then m_conflict is a
@@ -113,6 +134,14 @@ namespace sat {
         bool                    m_phase_cache_on;
         unsigned                m_phase_counter; 
         var_queue               m_case_split_queue;
+        branching_heuristic     m_branching;          // heuristic used for the next decisions.
+        unsigned                m_next_branching_switch;
+        vmtf_queue              m_vmtf;
+        bool_var_vector         m_vmtf_bumped;        // variables bumped in the current conflict.
+        svector<double>         m_chb_q;              // conflict history based scores.
+        svector<unsigned>       m_chb_last_conflict;  // last conflict a variable participated in.
+        double                  m_chb_alpha;
+        var_queue_tpl<double>   m_chb_queue;
         unsigned                m_qhead;
         unsigned                m_scope_lvl;
         literal_vector          m_trail;
@@ -133,6 +162,11 @@ namespace sat {
         unsigned                m_par_limit_in;
         unsigned                m_par_limit_out;
         unsigned                m_par_num_vars;
+        unsigned                m_par_id;
+        uint64                  m_par_clause_head;
+        unsigned_vector         m_par_out;          // learned clauses to be shared: [glue, n, lits]
+        unsigned_vector         m_par_in;
+        literal_vector          m_par_lits;
 
         void del_clauses(clause * const * begin, clause * const * end);
 
@@ -143,8 +177,14 @@ namespace sat {
         friend class elim_eqs;
         friend class asymm_branch;
         friend class probing;
+        friend class vivify;
+        friend class local_search;
+        friend class lookahead;
         friend class iff3_finder;
         friend class mus;
+        friend class card_extension;
+        friend class gauss;
+        friend class xor_finder;
         friend struct mk_stat;
     public:
         solver(params_ref const & p, reslimit& l, extension * ext);
@@ -169,6 +209,12 @@ namespace sat {
            \pre the model converter of src and this must be empty
         */
         void copy(solver const & src);
+
+        /**
+           \brief Install an extension, the solver takes ownership of ext.
+        */
+        void set_extension(extension* ext);
+        extension* get_extension() const { return m_ext; }
         
         // -----------------------
         //
@@ -182,7 +228,7 @@ namespace sat {
         void mk_clause(literal l1, literal l2, literal l3);
 
     protected:
-        void del_clause(clause & c);
+        void del_clause(clause & c, bool enable_drat = true);
         clause * mk_clause_core(unsigned num_lits, literal * lits, bool learned);
         void mk_clause_core(literal_vector const& lits) { mk_clause_core(lits.size(), lits.c_ptr()); }
         void mk_clause_core(unsigned num_lits, literal * lits) { mk_clause_core(num_lits, lits, false); }
@@ -217,6 +263,7 @@ namespace sat {
         unsigned num_clauses() const;
         unsigned num_restarts() const { return m_restarts; }
         bool is_external(bool_var v) const { return m_external[v] != 0; }
+        void set_external(bool_var v) { SASSERT(!was_eliminated(v)); m_external[v] = true; }
         bool was_eliminated(bool_var v) const { return m_eliminated[v] != 0; }
         unsigned scope_lvl() const { return m_scope_lvl; }
         lbool value(literal l) const { return static_cast<lbool>(m_assignment[l.index()]); }
@@ -248,7 +295,7 @@ namespace sat {
             m_num_checkpoints = 0;
             if (memory::get_allocation_size() > m_config.m_max_memory) throw solver_exception(Z3_MAX_MEMORY_MSG);
         }
-        void set_par(par* p);
+        void set_par(par* p, unsigned id);
         bool canceled() { return !m_rlimit.inc(); }
         config const& get_config() { return m_config; }
         typedef std::pair<literal, literal> bin_clause;
@@ -297,13 +344,23 @@ namespace sat {
         unsigned m_conflicts_since_restart;
         unsigned m_restart_threshold;
         unsigned m_luby_idx;
+        ema      m_fast_glue_avg;
+        ema      m_slow_glue_avg;
+        ema      m_trail_avg;
         unsigned m_conflicts_since_gc;
         unsigned m_gc_threshold;
+        unsigned m_next_tier2_gc;
+        unsigned m_next_local_search;
         unsigned m_num_checkpoints;
         double   m_min_d_tk;
         unsigned m_next_simplify;
         bool decide();
         bool_var next_var();
+        bool is_more_active(bool_var v1, bool_var v2) const;
+        void set_branching(branching_heuristic h);
+        void update_branching();
+        void update_chb(unsigned qhead);
+        void bump_vmtf();
         lbool bounded_search();
         lbool final_check();
         lbool propagate_and_backjump_step(bool& done);
@@ -322,12 +379,21 @@ namespace sat {
         bool tracking_assumptions() const;
         bool is_assumption(literal l) const;
         void simplify_problem();
+        void find_xors();
         void mk_model();
         bool check_model(model const & m) const;
+        bool should_restart() const;
+        void block_restart();
+        unsigned restart_level();
         void restart();
+        void rephase();
         void sort_watch_lits();
         void exchange_par();
+        void import_par_clauses();
+        void export_par_clause(unsigned glue);
+        void export_par_clause(unsigned glue, unsigned sz, literal const * lits);
         lbool check_par(unsigned num_lits, literal const* lits);
+        lbool check_cube();
 
         // -----------------------
         //
@@ -336,6 +402,7 @@ namespace sat {
         // -----------------------
     protected:
         void gc();
+        void compact_clauses();
         void gc_glue();
         void gc_psm();
         void gc_glue_psm();
@@ -343,6 +410,16 @@ namespace sat {
         void save_psm();
         void gc_half(char const * st_name);
         void gc_dyn_psm();
+        // tiers of the learned clauses used by the tiered gc.
+        enum clause_tier { TIER_CORE, TIER_MID, TIER_LOCAL };
+        clause_tier tier(clause const & c) const {
+            if (c.glue() <= m_config.m_gc_tier1) return TIER_CORE;
+            if (c.glue() <= m_config.m_gc_tier2 && !c.demoted()) return TIER_MID;
+            return TIER_LOCAL;
+        }
+        void gc_tiered();
+        void update_tier(clause & c);
+        literal_vector m_frozen_lits; // original literals of a reactivated clause, for DRAT deletions
         bool activate_frozen_clause(clause & c);
         unsigned psm(clause const & c) const;
         bool can_delete(clause const & c) const {
@@ -478,16 +555,39 @@ namespace sat {
         // -----------------------
     public:
         void inc_activity(bool_var v) {
-            unsigned & act = m_activity[v];
-            act += m_activity_inc;
-            m_case_split_queue.activity_increased_eh(v);
-            if (act > (1 << 24))
-                rescale_activity();
+            switch (m_branching) {
+            case BH_VMTF:
+                m_vmtf_bumped.push_back(v);
+                break;
+            case BH_CHB:
+                m_chb_last_conflict[v] = m_conflicts;
+                break;
+            default: {
+                unsigned & act = m_activity[v];
+                act += m_activity_inc;
+                m_case_split_queue.activity_increased_eh(v);
+                if (act > (1 << 24))
+                    rescale_activity();
+                break;
+            }
+            }
         }
 
         void decay_activity() {
-            m_activity_inc *= 11;
-            m_activity_inc /= 10;
+            switch (m_branching) {
+            case BH_VMTF:
+                bump_vmtf();
+                break;
+            case BH_CHB:
+                // the learning rate decreases from 0.4 to 0.06.
+                if (m_chb_alpha > 0.06)
+                    m_chb_alpha -= 1e-6;
+                break;
+            default:
+                m_activity_inc *= 11;
+                m_activity_inc /= 10;
+                break;
+            }
         }
 
     private:
@@ -7,7 +7,7 @@ Module Name:
 
 Abstract:
 
-    SAT variable priority queue.
+    SAT variable priority queues.
 
 Author:
 
@@ -24,21 +24,30 @@ Revision History:
 
 namespace sat {
     
-    class var_queue {
+    /**
+       \brief Heap of variables ordered by decreasing score.
+    */
+    template<typename Score>
+    class var_queue_tpl {
         struct lt {
-            svector<unsigned> & m_activity;
-            lt(svector<unsigned> & act):m_activity(act) {}
+            svector<Score> & m_activity;
+            lt(svector<Score> & act):m_activity(act) {}
             bool operator()(bool_var v1, bool_var v2) const { return m_activity[v1] > m_activity[v2]; }
         };
         heap<lt>  m_queue;
     public:
-        var_queue(svector<unsigned> & act):m_queue(128, lt(act)) {}
+        var_queue_tpl(svector<Score> & act):m_queue(128, lt(act)) {}
         
         void activity_increased_eh(bool_var v) {
             if (m_queue.contains(v))
                 m_queue.decreased(v);
         }
 
+        void activity_decreased_eh(bool_var v) {
+            if (m_queue.contains(v))
+                m_queue.increased(v);
+        }
+
         void mk_var_eh(bool_var v) {
             m_queue.reserve(v+1);
             m_queue.insert(v);
@@ -61,6 +70,97 @@ namespace sat {
         bool empty() const { return m_queue.empty(); }
 
         bool_var next_var() { SASSERT(!empty()); return m_queue.erase_min(); }
+
+        bool_var min_var() const { SASSERT(!empty()); return m_queue.min_value(); }
+    };
+
+    typedef var_queue_tpl<unsigned> var_queue;
+
+    /**
+       \brief Variable move-to-front queue.
+
+       The variables are kept in a doubly linked list ordered by the time stamp
+       of their last bump, bumping a variable moves it to the end of the list.
+       All variables after the search position are assigned, so the next decision
+       is found by walking backwards from the search position.
+    */
+    class vmtf_queue {
+        struct link {
+            bool_var m_prev;
+            bool_var m_next;
+            uint64   m_stamp;
+        };
+        svector<link> m_links;
+        bool_var      m_first;
+        bool_var      m_last;
+        bool_var      m_search;
+        uint64        m_stamp;
+
+        void unlink(bool_var v) {
+            link & l = m_links[v];
+            if (l.m_prev != null_bool_var) m_links[l.m_prev].m_next = l.m_next; else m_first = l.m_next;
+            if (l.m_next != null_bool_var) m_links[l.m_next].m_prev = l.m_prev; else m_last = l.m_prev;
+            if (m_search == v) m_search = l.m_prev != null_bool_var ? l.m_prev : l.m_next;
+        }
+
+        void append(bool_var v) {
+            link & l = m_links[v];
+            l.m_prev  = m_last;
+            l.m_next  = null_bool_var;
+            l.m_stamp = ++m_stamp;
+            if (m_last != null_bool_var) m_links[m_last].m_next = v; else m_first = v;
+            m_last = v;
+        }
+
+    public:
+        vmtf_queue():m_first(null_bool_var), m_last(null_bool_var), m_search(null_bool_var), m_stamp(0) {}
+
+        void mk_var_eh(bool_var v) {
+            SASSERT(v == m_links.size());
+            m_links.push_back(link());
+            append(v);
+            m_search = v;
+        }
+
+        /**
+           \brief Remove the variables v, v + 1, ...
+        */
+        void shrink(bool_var v) {
+            for (bool_var w = v; w < m_links.size(); ++w)
+                unlink(w);
+            m_links.shrink(v);
+            m_search = m_last;
+        }
+
+        /**
+           \brief Move v to the end of the list, if v is unassigned it becomes the search position.
+        */
+        void move_to_front(bool_var v, bool unassigned) {
+            if (v != m_last) {
+                unlink(v);
+                append(v);
+            }
+            else {
+                m_links[v].m_stamp = ++m_stamp;
+            }
+            if (unassigned)
+                m_search = v;
+        }
+
+        void unassign_var_eh(bool_var v) {
+            if (m_search == null_bool_var || m_links[v].m_stamp > m_links[m_search].m_stamp)
+                m_search = v;
+        }
+
+        void reset_search() { m_search = m_last; }
+
+        bool_var search() const { return m_search; }
+
+        void set_search(bool_var v) { m_search = v; }
+
+        bool_var prev(bool_var v) const { return m_links[v].m_prev; }
+
+        uint64 stamp(bool_var v) const { return m_links[v].m_stamp; }
     };
 };
 
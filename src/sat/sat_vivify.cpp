@@ -0,0 +1,248 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_vivify.cpp
+
+Abstract:
+
+    Vivification of learned clauses.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include"sat_vivify.h"
+#include"sat_vivify_params.hpp"
+#include"sat_solver.h"
+#include"stopwatch.h"
+#include"trace.h"
+
+namespace sat {
+
+    // propagations used by a call when the search did not propagate since the last call.
+    static const unsigned min_vivify_budget = 10000;
+
+    vivify::vivify(solver & _s, params_ref const & p):
+        s(_s),
+        m_limit(0),
+        m_last_propagations(0) {
+        updt_params(p);
+        reset_statistics();
+    }
+
+    struct vivify::report {
+        vivify &  m_vivify;
+        stopwatch m_watch;
+        unsigned  m_num_vivified;
+        unsigned  m_num_elim_lits;
+        uint64    m_num_propagations;
+        report(vivify & v):
+            m_vivify(v),
+            m_num_vivified(v.m_num_vivified),
+            m_num_elim_lits(v.m_num_elim_lits),
+            m_num_propagations(v.propagations()) {
+            m_watch.start();
+        }
+
+        ~report() {
+            m_watch.stop();
+            IF_VERBOSE(SAT_VB_LVL,
+                       verbose_stream() << " (sat-vivify :vivified " << (m_vivify.m_num_vivified - m_num_vivified)
+                       << " :elim-literals " << (m_vivify.m_num_elim_lits - m_num_elim_lits)
+                       << " :propagations " << (m_vivify.propagations() - m_num_propagations)
+                       << mem_stat()
+                       << " :time " << std::fixed << std::setprecision(2) << m_watch.get_seconds() << ")\n";);
+        }
+    };
+
+    uint64 vivify::propagations() const {
+        return static_cast<uint64>(s.m_stats.m_propagate) + s.m_stats.m_bin_propagate + s.m_stats.m_ter_propagate;
+    }
+
+    void vivify::operator()(double weight) {
+        if (!m_vivify)
+            return;
+        s.propagate(false); // must propagate, since it uses s.push()
+        if (s.m_inconsistent)
+            return;
+        uint64 start  = propagations();
+        uint64 budget = (start - m_last_propagations) * m_effort / 1000;
+        if (budget < min_vivify_budget)
+            budget = min_vivify_budget;
+        budget = static_cast<uint64>(budget * weight);
+        m_limit = start + budget;
+        CASSERT("vivify", s.check_invariant());
+        {
+            report rpt(*this);
+            svector<char> saved_phase(s.m_phase);
+            vivify_tier(m_tier1);
+            if (!s.inconsistent() && m_tier2 > m_tier1)
+                vivify_tier(m_tier2);
+            s.m_phase = saved_phase;
+        }
+        m_last_propagations = propagations();
+        m_num_propagations += m_last_propagations - start;
+        CASSERT("vivify", s.check_invariant());
+    }
+
+    /**
+       \brief Vivify the learned clauses with glue at most max_glue that were not vivified before.
+    */
+    void vivify::vivify_tier(unsigned max_glue) {
+        SASSERT(s.m_qhead == s.m_trail.size());
+        clause_vector::iterator it  = s.m_learned.begin();
+        clause_vector::iterator it2 = it;
+        clause_vector::iterator end = s.m_learned.end();
+        try {
+            for (; it != end; ++it) {
+                clause & c = *(*it);
+                if (s.inconsistent() || propagations() >= m_limit ||
+                    c.frozen() || c.was_vivified() || c.glue() > max_glue) {
+                    *it2 = *it;
+                    ++it2;
+                    continue;
+                }
+                s.checkpoint();
+                if (!process(c))
+                    continue; // clause was removed
+                *it2 = *it;
+                ++it2;
+            }
+            s.m_learned.set_end(it2);
+        }
+        catch (solver_exception & ex) {
+            // put m_learned in a consistent state...
+            for (; it != end; ++it, ++it2) {
+                *it2 = *it;
+            }
+            s.m_learned.set_end(it2);
+            throw ex;
+        }
+    }
+
+    bool vivify::process(clause & c) {
+        TRACE("vivify_detail", tout << "processing: " << c << "\n";);
+        SASSERT(s.scope_lvl() == 0);
+        SASSERT(s.m_qhead == s.m_trail.size());
+        SASSERT(!s.inconsistent());
+        c.set_vivified(true);
+        unsigned sz = c.size();
+        unsigned i;
+        for (i = 0; i < sz; i++) {
+            if (s.value(c[i]) == l_true) {
+                s.dettach_clause(c);
+                s.del_clause(c);
+                m_num_deleted++;
+                return false;
+            }
+        }
+        // clause must not be used for propagation
+        s.dettach_clause(c);
+        s.push();
+        bool reduced = false;
+        m_lits.reset();
+        for (i = 0; i < sz; i++) {
+            literal l = c[i];
+            lbool val = s.value(l);
+            if (val == l_false) {
+                // implied by the negation of the previous literals.
+                reduced = true;
+                continue;
+            }
+            m_lits.push_back(l);
+            if (val == l_true) {
+                reduced = i + 1 < sz;
+                break;
+            }
+            if (i + 1 == sz)
+                break;
+            TRACE("vivify_detail", tout << "assigning: " << ~l << "\n";);
+            s.assign(~l, justification());
+            s.propagate_core(false); // must not use propagate(), since check_missed_propagation may fail for c
+            if (s.inconsistent()) {
+                reduced = true;
+                break;
+            }
+        }
+        s.pop(1);
+        SASSERT(!s.inconsistent());
+        SASSERT(s.m_qhead == s.m_trail.size());
+        if (!reduced) {
+            s.attach_clause(c);
+            return true;
+        }
+        unsigned new_sz = m_lits.size();
+        SASSERT(new_sz < sz);
+        TRACE("vivify", tout << c << "\nvivified: " << m_lits << "\n";);
+        m_num_vivified++;
+        m_num_elim_lits += sz - new_sz;
+        bool drat = s.m_drat.enabled();
+        if (drat) {
+            m_drat_lits.reset();
+            m_drat_lits.append(sz, c.begin());
+        }
+        switch (new_sz) {
+        case 0:
+            if (drat) s.m_drat.add();
+            s.set_conflict(justification());
+            return false;
+        case 1:
+            TRACE("vivify", tout << "produced unit clause: " << m_lits[0] << "\n";);
+            s.assign(m_lits[0], justification());
+            s.propagate_core(false);
+            if (drat) s.m_drat.del(m_drat_lits);
+            s.del_clause(c, false);
+            return false;
+        case 2:
+            s.mk_bin_clause(m_lits[0], m_lits[1], true);
+            if (drat) s.m_drat.del(m_drat_lits);
+            s.del_clause(c, false);
+            SASSERT(s.m_qhead == s.m_trail.size());
+            return false;
+        default:
+            for (i = 0; i < new_sz; i++)
+                c[i] = m_lits[i];
+            c.shrink(new_sz);
+            if (c.glue() > new_sz)
+                c.set_glue(new_sz);
+            if (drat) {
+                s.m_drat.add(c);
+                s.m_drat.del(m_drat_lits);
+            }
+            s.attach_clause(c);
+            SASSERT(s.m_qhead == s.m_trail.size());
+            return true;
+        }
+    }
+
+    void vivify::updt_params(params_ref const & _p) {
+        sat_vivify_params p(_p);
+        m_vivify = p.vivify();
+        m_effort = p.vivify_effort();
+        m_tier1  = p.vivify_tier1();
+        m_tier2  = p.vivify_tier2();
+    }
+
+    void vivify::collect_param_descrs(param_descrs & d) {
+        sat_vivify_params::collect_param_descrs(d);
+    }
+
+    void vivify::collect_statistics(statistics & st) const {
+        st.update("vivified clauses", m_num_vivified);
+        st.update("vivify elim literals", m_num_elim_lits);
+        st.update("vivify deleted clauses", m_num_deleted);
+    }
+
+    void vivify::reset_statistics() {
+        m_num_vivified = 0;
+        m_num_elim_lits = 0;
+        m_num_deleted = 0;
+        m_num_propagations = 0;
+    }
+
+};
@@ -0,0 +1,86 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_vivify.h
+
+Abstract:
+
+    Vivification of learned clauses.
+
+    The negations of the literals of a clause are assigned one by one.
+    If propagation produces a conflict, or makes a later literal of the
+    clause true, the clause is shortened to the literals assigned so far
+    (plus the true literal). Literals that become false are removed.
+
+    Learned clauses are processed in tiers by glue: clauses of the first
+    tier are vivified first, the second tier gets the remaining budget.
+    The budget is measured in propagations.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#ifndef SAT_VIVIFY_H_
+#define SAT_VIVIFY_H_
+
+#include"sat_types.h"
+#include"statistics.h"
+#include"params.h"
+
+namespace sat {
+    class solver;
+
+    class vivify {
+        struct report;
+
+        solver &       s;
+        uint64         m_limit;             // propagation count at which vivification stops.
+        uint64         m_last_propagations; // propagations at the end of the last call.
+        literal_vector m_lits;
+        literal_vector m_drat_lits;         // clause before it is vivified, for DRAT deletions
+
+        // config
+        bool           m_vivify;
+        unsigned       m_effort;
+        unsigned       m_tier1;
+        unsigned       m_tier2;
+
+        // stats
+        unsigned       m_num_vivified;
+        unsigned       m_num_elim_lits;
+        unsigned       m_num_deleted;
+        uint64         m_num_propagations;
+
+        uint64 propagations() const;
+        void vivify_tier(unsigned max_glue);
+        bool process(clause & c);
+    public:
+        vivify(solver & s, params_ref const & p);
+
+        /**
+           \brief Vivify learned clauses using effort/1000 of the propagations of the search
+           since the last call, scaled by weight.
+        */
+        void operator()(double weight = 1.0);
+
+        /**
+           \brief Number of removed literals and clauses, and the propagations spent to remove them.
+        */
+        unsigned gain() const { return m_num_elim_lits + m_num_deleted; }
+        uint64 cost() const { return m_num_propagations; }
+
+        void updt_params(params_ref const & p);
+        static void collect_param_descrs(param_descrs & d);
+
+        void collect_statistics(statistics & st) const;
+        void reset_statistics();
+    };
+
+};
+
+#endif
@@ -0,0 +1,112 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_finder.cpp
+
+Abstract:
+
+    Recover XOR constraints from clauses.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include<algorithm>
+#include"sat_xor_finder.h"
+#include"sat_solver.h"
+
+namespace sat {
+
+    struct xor_finder::entry_lt {
+        unsigned_vector const& m_vars;
+        entry_lt(unsigned_vector const& vars): m_vars(vars) {}
+        bool operator()(entry const& e1, entry const& e2) const {
+            if (e1.m_size != e2.m_size) return e1.m_size < e2.m_size;
+            for (unsigned i = 0; i < e1.m_size; ++i) {
+                unsigned v1 = m_vars[e1.m_offset + i], v2 = m_vars[e2.m_offset + i];
+                if (v1 != v2) return v1 < v2;
+            }
+            return e1.m_signs < e2.m_signs;
+        }
+    };
+
+    struct lit_var_lt {
+        bool operator()(literal l1, literal l2) const { return l1.var() < l2.var(); }
+    };
+
+    xor_finder::xor_finder(solver & _s):
+        s(_s) {
+    }
+
+    bool xor_finder::same_vars(entry const& e1, entry const& e2) const {
+        if (e1.m_size != e2.m_size) return false;
+        for (unsigned i = 0; i < e1.m_size; ++i) {
+            if (m_vars[e1.m_offset + i] != m_vars[e2.m_offset + i]) return false;
+        }
+        return true;
+    }
+
+    void xor_finder::operator()(unsigned max_size, vector<bool_var_vector>& xors, svector<bool>& rhs) {
+        SASSERT(max_size <= 6);
+        literal_vector lits;
+        for (unsigned i = 0; i < s.m_clauses.size(); ++i) {
+            clause const& c = *s.m_clauses[i];
+            if (c.size() < 3 || c.size() > max_size || c.was_removed()) continue;
+            lits.reset();
+            lits.append(c.size(), c.begin());
+            std::sort(lits.begin(), lits.end(), lit_var_lt());
+            bool ok = true;
+            for (unsigned j = 0; ok && j < lits.size(); ++j) {
+                ok = !s.was_eliminated(lits[j].var()) && (j == 0 || lits[j - 1].var() != lits[j].var());
+            }
+            if (!ok) continue;
+            entry e;
+            e.m_offset = m_vars.size();
+            e.m_size = lits.size();
+            e.m_signs = 0;
+            for (unsigned j = 0; j < lits.size(); ++j) {
+                m_vars.push_back(lits[j].var());
+                if (lits[j].sign()) e.m_signs |= (1u << j);
+            }
+            m_entries.push_back(e);
+        }
+        std::sort(m_entries.begin(), m_entries.end(), entry_lt(m_vars));
+
+        unsigned sz = m_entries.size();
+        for (unsigned i = 0, j = 0; i < sz; i = j) {
+            entry const& e = m_entries[i];
+            uint64 patterns = 0;
+            for (j = i; j < sz && same_vars(e, m_entries[j]); ++j) {
+                patterns |= (1ull << m_entries[j].m_signs);
+            }
+            unsigned n = e.m_size;
+            if (j - i < (1u << (n - 1))) continue;
+            uint64 even = 0;
+            for (unsigned p = 0; p < (1u << n); ++p) {
+                if (get_num_1bits(p) % 2 == 0) even |= (1ull << p);
+            }
+            uint64 odd = (n == 6 ? ~0ull : ((1ull << (1u << n)) - 1)) & ~even;
+            // the clauses with an even number of negations exclude the assignments with even parity.
+            bool found_even = (patterns & even) == even;
+            bool found_odd  = (patterns & odd) == odd;
+            if (found_even && found_odd) {
+                // the clauses are inconsistent, the solver finds the conflict.
+                continue;
+            }
+            if (found_even || found_odd) {
+                xors.push_back(bool_var_vector(n, m_vars.c_ptr() + e.m_offset));
+                rhs.push_back(found_even);
+            }
+        }
+        TRACE("sat", tout << "xors: " << xors.size() << "\n";);
+        IF_VERBOSE(10, verbose_stream() << "(sat.xor-finder :xors " << xors.size() << ")\n";);
+        m_vars.reset();
+        m_entries.reset();
+    }
+
+};
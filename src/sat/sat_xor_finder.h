@@ -0,0 +1,57 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_xor_finder.h
+
+Abstract:
+
+    Recover XOR constraints from clauses.
+
+    The constraint x_1 + ... + x_n = rhs is encoded by the 2^(n-1)
+    clauses over x_1, ..., x_n whose number of negated literals
+    has the parity of rhs + 1. For example x + y + z = 1 is
+      x \/ y \/ z,  x \/ ~y \/ ~z,  ~x \/ y \/ ~z,  ~x \/ ~y \/ z
+
+    The clauses are sorted by their variables, such that the
+    clauses over the same variables are adjacent.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#ifndef SAT_XOR_FINDER_H_
+#define SAT_XOR_FINDER_H_
+
+#include"sat_types.h"
+
+namespace sat {
+
+    class xor_finder {
+        struct entry {
+            unsigned m_offset;   // variables of the clause in m_vars.
+            unsigned m_size;
+            unsigned m_signs;    // bit i is set if the literal over the i'th variable is negated.
+        };
+        struct entry_lt;
+        solver &         s;
+        unsigned_vector  m_vars;
+        svector<entry>   m_entries;
+        bool same_vars(entry const& e1, entry const& e2) const;
+    public:
+        xor_finder(solver & s);
+
+        /**
+           \brief Collect the XOR constraints with at most max_size (<= 6) variables
+           that are encoded by non-learned clauses.
+        */
+        void operator()(unsigned max_size, vector<bool_var_vector>& xors, svector<bool>& rhs);
+    };
+
+};
+
+#endif
@@ -36,6 +36,9 @@ Notes:
 #include"model_v2_pp.h"
 #include"tactic.h"
 #include"ast_pp.h"
+#include"pb_decl_plugin.h"
+#include"card_extension.h"
+#include"sat_params.hpp"
 #include<sstream>
 
 struct goal2sat::imp {
@@ -61,6 +64,11 @@ struct goal2sat::imp {
     expr_ref_vector             m_trail;
     expr_ref_vector             m_interpreted_atoms;
     bool                        m_default_external;
+    pb_util                     m_pb;
+    sat::card_extension*        m_ext;
+    bool                        m_cardinality_solver;
+    sat::literal_vector         m_lits;
+    vector<rational>            m_coeffs;
     
     imp(ast_manager & _m, params_ref const & p, sat::solver & s, atom2bool_var & map, dep2asm_map& dep2asm, bool default_external):
         m(_m),
@@ -69,7 +77,9 @@ struct goal2sat::imp {
         m_dep2asm(dep2asm),
         m_trail(m),
         m_interpreted_atoms(m),
-        m_default_external(default_external) {
+        m_default_external(default_external),
+        m_pb(m),
+        m_ext(0) {
         updt_params(p);
         m_true = sat::null_bool_var;
     }
@@ -77,6 +87,8 @@ struct goal2sat::imp {
     void updt_params(params_ref const & p) {
         m_ite_extra       = p.get_bool("ite_extra", true);
         m_max_memory      = megabytes_to_bytes(p.get_uint("max_memory", UINT_MAX));
+        sat_params sp(p);
+        m_cardinality_solver = sp.cardinality_solver();
     }
 
     void throw_op_not_handled(std::string const& s) {
@@ -167,6 +179,10 @@ struct goal2sat::imp {
         }
         if (process_cached(to_app(t), root, sign))
             return true;
+        if (to_app(t)->get_family_id() == m_pb.get_family_id() && is_native_pb(to_app(t))) {
+            m_frame_stack.push_back(frame(to_app(t), root, sign, 0));
+            return false;
+        }
         if (to_app(t)->get_family_id() != m.get_basic_family_id()) {
             convert_atom(t, root, sign);
             return true;
@@ -352,7 +368,131 @@ struct goal2sat::imp {
         }
     }
 
+    /**
+       \brief Return true if t is a cardinality or pseudo-Boolean constraint
+       that is handled by the cardinality extension of the SAT solver.
+       The coefficients and the bound must be integers that fit in 31 bits after normalization.
+    */
+    bool is_native_pb(app * t) {
+        if (!m_cardinality_solver) {
+            return false;
+        }
+        switch (t->get_decl_kind()) {
+        case OP_AT_MOST_K:
+        case OP_AT_LEAST_K:
+        case OP_PB_LE:
+        case OP_PB_GE:
+        case OP_PB_EQ:
+            break;
+        default:
+            return false;
+        }
+        rational k = m_pb.get_k(t);
+        if (!k.is_int()) {
+            return false;
+        }
+        rational sum = abs(k);
+        for (unsigned i = 0; i < t->get_num_args(); ++i) {
+            rational c = m_pb.get_coeff(t, i);
+            if (!c.is_int()) {
+                return false;
+            }
+            sum += abs(c);
+        }
+        return sum < rational(INT_MAX);
+    }
+
+    void ensure_extension() {
+        if (m_ext) {
+            return;
+        }
+        sat::extension * ext = m_solver.get_extension();
+        if (ext) {
+            m_ext = dynamic_cast<sat::card_extension*>(ext);
+            if (!m_ext) {
+                throw default_exception("cardinality constraints cannot be combined with the current SAT solver extension");
+            }
+        }
+        else {
+            m_ext = alloc(sat::card_extension);
+            m_solver.set_extension(m_ext);
+        }
+    }
+
+    /**
+       \brief Add v => sum m_coeffs[i]*m_lits[i] >= k (or <= k if is_le).
+       If v is null_bool_var the constraint is asserted.
+    */
+    void add_pb_ge(sat::bool_var v, bool is_le, rational const & k) {
+        svector<sat::card_extension::wliteral> wlits;
+        rational k1 = is_le ? -k : k;
+        for (unsigned i = 0; i < m_lits.size(); ++i) {
+            rational c = is_le ? -m_coeffs[i] : m_coeffs[i];
+            sat::literal l = m_lits[i];
+            if (c.is_neg()) {
+                // c*l = c + |c|*~l
+                c.neg();
+                l.neg();
+                k1 += c;
+            }
+            wlits.push_back(sat::card_extension::wliteral(c.get_unsigned(), l));
+        }
+        m_ext->add_pb_ge(v, wlits, k1.is_pos() ? k1.get_unsigned() : 0);
+    }
+
+    void convert_pb(app * t, bool root, bool sign) {
+        TRACE("goal2sat", tout << "convert_pb " << root << " " << sign << "\n" << mk_ismt2_pp(t, m) << "\n";);
+        ensure_extension();
+        unsigned num = t->get_num_args();
+        SASSERT(num <= m_result_stack.size());
+        rational k = m_pb.get_k(t);
+        m_lits.reset();
+        m_coeffs.reset();
+        m_lits.append(num, m_result_stack.end() - num);
+        for (unsigned i = 0; i < num; ++i) {
+            m_coeffs.push_back(m_pb.get_coeff(t, i));
+        }
+        m_result_stack.shrink(m_result_stack.size() - num);
+        bool is_eq = m_pb.is_eq(t);
+        bool is_le = m_pb.is_at_most_k(t) || m_pb.is_le(t);
+        if (root && !sign) {
+            if (is_eq) {
+                add_pb_ge(sat::null_bool_var, false, k);
+                add_pb_ge(sat::null_bool_var, true, k);
+            }
+            else {
+                add_pb_ge(sat::null_bool_var, is_le, k);
+            }
+            return;
+        }
+        sat::bool_var v = m_solver.mk_var(true);
+        sat::literal  l(v, false);
+        if (is_eq) {
+            sat::literal l1(m_solver.mk_var(true), false);
+            sat::literal l2(m_solver.mk_var(true), false);
+            add_pb_ge(l1.var(), false, k);
+            add_pb_ge(l2.var(), true, k);
+            mk_clause(~l, l1);
+            mk_clause(~l, l2);
+            mk_clause(l, ~l1, ~l2);
+        }
+        else {
+            add_pb_ge(v, is_le, k);
+        }
+        m_cache.insert(t, l);
+        if (sign)
+            l.neg();
+        if (root)
+            mk_clause(l);
+        else
+            m_result_stack.push_back(l);
+    }
+
     void convert(app * t, bool root, bool sign) {
+        if (t->get_family_id() == m_pb.get_family_id()) {
+            convert_pb(t, root, sign);
+            return;
+        }
         SASSERT(t->get_family_id() == m.get_basic_family_id());
         switch (to_app(t)->get_decl_kind()) {
         case OP_OR:
@@ -737,6 +877,11 @@ struct sat2goal::imp {
     }
 
     void operator()(sat::solver const & s, atom2bool_var const & map, goal & r, model_converter_ref & mc) {
+        sat::card_extension* ext = dynamic_cast<sat::card_extension*>(s.get_extension());
+        // XOR constraints are implied by the clauses, they don't have to be converted.
+        if (s.get_extension() && (!ext || ext->has_cardinality_constraints())) {
+            throw tactic_exception("cannot convert the constraints of a SAT solver extension into a goal");
+        }
         if (s.inconsistent()) {
             r.assert_expr(m.mk_false());
             return;
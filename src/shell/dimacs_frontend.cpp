@@ -152,7 +152,9 @@ unsigned read_dimacs(char const * file_name) {
     
     lbool r;
     vector<sat::literal_vector> tracking_clauses;
-    sat::solver solver2(p, limit, 0);
+    params_ref p2(p);
+    p2.set_sym("drat.file", symbol(""));  // the core is extracted by a copy of the input, it does not write to the proof
+    sat::solver solver2(p2, limit, 0);
     if (p.get_bool("dimacs.core", false)) {
         g_solver = &solver2;        
         sat::literal_vector assumptions;
@@ -194,6 +194,7 @@ void asserted_formulas::push_scope() {
     s.m_inconsistent_old         = m_inconsistent;
     m_defined_names.push();
     m_bv_sharing.push_scope();
+    m_pre_simplifier.push_scope();
     commit();
 }
  
@@ -210,6 +211,7 @@ void asserted_formulas::pop_scope(unsigned num_scopes) {
         m_asserted_formula_prs.shrink(s.m_asserted_formulas_lim);
     m_asserted_qhead    = s.m_asserted_formulas_lim;
     m_scopes.shrink(new_lvl);
+    m_pre_simplifier.pop_scope(num_scopes);
     flush_cache();
     TRACE("asserted_formulas_scopes", tout << "after pop " << num_scopes << "\n"; display(tout););
 }
@@ -221,6 +223,7 @@ void asserted_formulas::reset() {
     m_asserted_formula_prs.reset();
     m_macro_manager.reset();
     m_bv_sharing.reset();
+    m_pre_simplifier.reset();
     m_inconsistent = false;
 }
 
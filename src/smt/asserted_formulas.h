@@ -73,7 +73,10 @@ class asserted_formulas {
     void infer_patterns();
     void eliminate_term_ite();
     void reduce_and_solve();
-    void flush_cache() { m_pre_simplifier.reset(); m_simplifier.reset(); }
+    // The cache of m_pre_simplifier only depends on the asserted formulas, it is preserved
+    // across calls to reduce and its entries are removed when the scope that created them is popped.
+    // m_simplifier is also used to propagate values and booleans, so its cache is flushed.
+    void flush_cache() { m_simplifier.reset(); }
     void set_eliminate_and(bool flag);
     void propagate_values();
     void propagate_booleans();
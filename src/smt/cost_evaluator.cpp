@@ -18,6 +18,7 @@ Revision History:
 --*/
 #include"cost_evaluator.h"
 #include"warning.h"
+#include"ast_pp.h"
 
 cost_evaluator::cost_evaluator(ast_manager & m):
     m_manager(m), 
@@ -68,10 +69,28 @@ float cost_evaluator::eval(expr * f) const {
             case OP_GE:       return E(0) >= E(1) ? 1.0f : 0.0f;
             case OP_LT:       return E(0) <  E(1) ? 1.0f : 0.0f;
             case OP_GT:       return E(0) >  E(1) ? 1.0f : 0.0f;
-            case OP_ADD:      return E(0) + E(1);
-            case OP_SUB:      return E(0) - E(1);
+            case OP_ADD: {
+                float r = E(0);
+                num_args = to_app(f)->get_num_args();
+                for (unsigned i = 1; i < num_args; i++)
+                    r += E(i);
+                return r;
+            }
+            case OP_SUB: {
+                float r = E(0);
+                num_args = to_app(f)->get_num_args();
+                for (unsigned i = 1; i < num_args; i++)
+                    r -= E(i);
+                return r;
+            }
             case OP_UMINUS:   return - E(0);
-            case OP_MUL:      return E(0) * E(1);
+            case OP_MUL: {
+                float r = E(0);
+                num_args = to_app(f)->get_num_args();
+                for (unsigned i = 1; i < num_args; i++)
+                    r *= E(i);
+                return r;
+            }
             case OP_DIV: {     
                 float q = E(1);
                 if (q == 0.0f) {
@@ -100,5 +119,204 @@ float cost_evaluator::operator()(expr * f, unsigned num_args, float const * args
     return eval(f);
 }
 
+void cost_evaluator::program::emit(opcode op, unsigned arg, float val, int delta) {
+    m_code.push_back(instr(op, arg, val));
+    m_depth += delta;
+    if (m_depth > m_max_depth)
+        m_max_depth = m_depth;
+}
+
+void cost_evaluator::program::display(std::ostream & out) const {
+    static char const * names[] = { 
+        "push", "var", "not", "and", "or", "eq", "ne", "implies", "le", "ge", "lt", "gt",
+        "add", "sub", "neg", "mul", "div", "jmp", "jmpz" 
+    };
+    for (unsigned i = 0; i < m_code.size(); i++) {
+        instr const & c = m_code[i];
+        out << i << ": " << names[c.m_op];
+        switch (c.m_op) {
+        case PUSH_CONST: out << " " << c.m_val; break;
+        case PUSH_VAR: case AND: case OR: case JMP: case JMP_IF_ZERO: out << " " << c.m_arg; break;
+        default: break;
+        }
+        out << "\n";
+    }
+}
+
+void cost_evaluator::compile_core(expr * f, program & p) {
+    typedef program P;
+#define C(IDX) compile_core(to_app(f)->get_arg(IDX), p)
+#define FOLD(OP)                                        \
+    C(0);                                               \
+    for (unsigned i = 1; i < num_args; i++) {           \
+        C(i);                                           \
+        p.emit(OP, 0, 0.0f, -1);                        \
+    }                                                   \
+    return;
+    if (is_app(f)) {
+        unsigned num_args = to_app(f)->get_num_args();
+        family_id fid     = to_app(f)->get_family_id();
+        if (fid == m_manager.get_basic_family_id()) {
+            switch (to_app(f)->get_decl_kind()) {
+            case OP_TRUE:     p.emit(P::PUSH_CONST, 0, 1.0f, 1); return;
+            case OP_FALSE:    p.emit(P::PUSH_CONST, 0, 0.0f, 1); return;
+            case OP_NOT:      C(0); p.emit(P::NOT, 0, 0.0f, 0); return;
+            case OP_AND:
+            case OP_OR:
+                for (unsigned i = 0; i < num_args; i++) 
+                    C(i);
+                p.emit(to_app(f)->get_decl_kind() == OP_AND ? P::AND : P::OR, num_args, 0.0f, 1 - static_cast<int>(num_args));
+                return;
+            case OP_ITE: {
+                C(0);
+                unsigned jmp_else = p.m_code.size();
+                p.emit(P::JMP_IF_ZERO, 0, 0.0f, -1);
+                C(1);
+                unsigned jmp_end = p.m_code.size();
+                p.emit(P::JMP, 0, 0.0f, -1);
+                p.m_code[jmp_else].m_arg = p.m_code.size();
+                C(2);
+                p.m_code[jmp_end].m_arg = p.m_code.size();
+                return;
+            }
+            case OP_EQ:
+            case OP_IFF:      C(0); C(1); p.emit(P::EQ, 0, 0.0f, -1); return;
+            case OP_XOR:      C(0); C(1); p.emit(P::NE, 0, 0.0f, -1); return;
+            case OP_IMPLIES:  C(0); C(1); p.emit(P::IMPLIES, 0, 0.0f, -1); return;
+            default:
+                ;
+            }
+        }
+        else if (fid == m_util.get_family_id()) {
+            switch (to_app(f)->get_decl_kind()) {
+            case OP_NUM: {
+                rational r = to_app(f)->get_decl()->get_parameter(0).get_rational();
+                p.emit(P::PUSH_CONST, 0, static_cast<float>(numerator(r).get_int64())/static_cast<float>(denominator(r).get_int64()), 1);
+                return;
+            } 
+            case OP_LE:       C(0); C(1); p.emit(P::LE, 0, 0.0f, -1); return;
+            case OP_GE:       C(0); C(1); p.emit(P::GE, 0, 0.0f, -1); return;
+            case OP_LT:       C(0); C(1); p.emit(P::LT, 0, 0.0f, -1); return;
+            case OP_GT:       C(0); C(1); p.emit(P::GT, 0, 0.0f, -1); return;
+            case OP_ADD:      FOLD(P::ADD);
+            case OP_SUB:      FOLD(P::SUB);
+            case OP_UMINUS:   C(0); p.emit(P::NEG, 0, 0.0f, 0); return;
+            case OP_MUL:      FOLD(P::MUL);
+            case OP_DIV:      C(0); C(1); p.emit(P::DIV, 0, 0.0f, -1); return;
+            default:
+                ;
+            }
+        }
+    }
+    else if (is_var(f)) {
+        unsigned idx = to_var(f)->get_idx();
+        if (idx < m_num_args) {
+            p.emit(P::PUSH_VAR, m_num_args - idx - 1, 0.0f, 1);
+            return;
+        }
+    }
+    warning_msg("cost function evaluation error");
+    p.emit(P::PUSH_CONST, 0, 1.0f, 1);
+#undef C
+#undef FOLD
+}
 
+void cost_evaluator::compile(expr * f, unsigned num_args, program & p) {
+    typedef program P;
+    p.m_code.reset();
+    p.m_depth     = 0;
+    p.m_max_depth = 0;
+    m_num_args    = num_args;
+    compile_core(f, p);
+    SASSERT(p.m_depth == 1);
+    svector<P::instr> const & code = p.m_code;
+    if (code.size() == 1 && code[0].m_op == P::PUSH_CONST) {
+        p.m_kind = P::K_CONST;
+        p.m_val  = code[0].m_val;
+    }
+    else if (code.size() == 1 && code[0].m_op == P::PUSH_VAR) {
+        p.m_kind = P::K_VAR;
+        p.m_pos1 = code[0].m_arg;
+    }
+    else if (code.size() == 3 && code[0].m_op == P::PUSH_VAR && code[1].m_op == P::PUSH_VAR && code[2].m_op == P::ADD) {
+        // the default cost function (+ weight generation)
+        p.m_kind = P::K_ADD_VARS;
+        p.m_pos1 = code[0].m_arg;
+        p.m_pos2 = code[1].m_arg;
+    }
+    else {
+        p.m_kind = P::K_CODE;
+    }
+    TRACE("cost_evaluator", tout << mk_pp(f, m_manager) << "\n"; p.display(tout););
+}
 
+float cost_evaluator::operator()(program const & p, float const * args) {
+    typedef program P;
+    switch (p.m_kind) {
+    case P::K_CONST:    return p.m_val;
+    case P::K_VAR:      return args[p.m_pos1];
+    case P::K_ADD_VARS: return args[p.m_pos1] + args[p.m_pos2];
+    default:            break;
+    }
+    if (m_stack.size() < p.m_max_depth)
+        m_stack.resize(p.m_max_depth, 0.0f);
+    float * s              = m_stack.c_ptr();
+    unsigned sp            = 0; // number of values on the stack.
+    P::instr const * code  = p.m_code.c_ptr();
+    unsigned sz            = p.m_code.size();
+#define BIN(EXPR) { --sp; float a = s[sp-1], b = s[sp]; s[sp-1] = (EXPR); break; }
+    for (unsigned pc = 0; pc < sz; ) {
+        P::instr const & c = code[pc++];
+        switch (c.m_op) {
+        case P::PUSH_CONST:  s[sp++] = c.m_val; break;
+        case P::PUSH_VAR:    s[sp++] = args[c.m_arg]; break;
+        case P::NOT:         s[sp-1] = s[sp-1] == 0.0f ? 1.0f : 0.0f; break;
+        case P::AND: {
+            float r = 1.0f;
+            for (unsigned i = sp - c.m_arg; i < sp; i++)
+                if (s[i] == 0.0f) r = 0.0f;
+            sp -= c.m_arg;
+            s[sp++] = r;
+            break;
+        }
+        case P::OR: {
+            float r = 0.0f;
+            for (unsigned i = sp - c.m_arg; i < sp; i++)
+                if (s[i] != 0.0f) r = 1.0f;
+            sp -= c.m_arg;
+            s[sp++] = r;
+            break;
+        }
+        case P::EQ:          BIN(a == b ? 1.0f : 0.0f);
+        case P::NE:          BIN(a != b ? 1.0f : 0.0f);
+        case P::IMPLIES:     BIN(a == 0.0f || b != 0.0f ? 1.0f : 0.0f);
+        case P::LE:          BIN(a <= b ? 1.0f : 0.0f);
+        case P::GE:          BIN(a >= b ? 1.0f : 0.0f);
+        case P::LT:          BIN(a <  b ? 1.0f : 0.0f);
+        case P::GT:          BIN(a >  b ? 1.0f : 0.0f);
+        case P::ADD:         BIN(a + b);
+        case P::SUB:         BIN(a - b);
+        case P::NEG:         s[sp-1] = - s[sp-1]; break;
+        case P::MUL:         BIN(a * b);
+        case P::DIV: 
+            --sp;
+            if (s[sp] == 0.0f) {
+                warning_msg("cost function division by zero");
+                s[sp-1] = 1.0f;
+            }
+            else {
+                s[sp-1] = s[sp-1] / s[sp];
+            }
+            break;
+        case P::JMP:         pc = c.m_arg; break;
+        case P::JMP_IF_ZERO: 
+            --sp;
+            if (s[sp] == 0.0f) 
+                pc = c.m_arg; 
+            break;
+        }
+    }
+#undef BIN
+    SASSERT(sp == 1);
+    return s[0];
+}
@@ -9,6 +9,10 @@ Abstract:
 
     Simple evaluator for cost function
 
+    Cost functions are evaluated for every candidate instance of a quantifier.
+    They can be compiled into a program of stack instructions, to avoid 
+    walking the expression for every evaluation. 
+
 Author:
 
     Leonardo de Moura (leonardo) 2008-06-14.
@@ -23,11 +27,42 @@ Revision History:
 #include"arith_decl_plugin.h"
 
 class cost_evaluator {
+public:
+    class program {
+        friend class cost_evaluator;
+        enum opcode {
+            PUSH_CONST, PUSH_VAR, NOT, AND, OR, EQ, NE, IMPLIES, LE, GE, LT, GT,
+            ADD, SUB, NEG, MUL, DIV, JMP, JMP_IF_ZERO
+        };
+        struct instr {
+            opcode   m_op;
+            unsigned m_arg; // position of a variable, number of arguments, or jump target.
+            float    m_val;
+            instr(opcode op, unsigned arg, float val):m_op(op), m_arg(arg), m_val(val) {}
+        };
+        // common shapes of cost functions are evaluated without running the code.
+        enum kind { K_CONST, K_VAR, K_ADD_VARS, K_CODE };
+        kind           m_kind;
+        unsigned       m_pos1;
+        unsigned       m_pos2;
+        float          m_val;
+        svector<instr> m_code;
+        unsigned       m_depth;
+        unsigned       m_max_depth;
+        void emit(opcode op, unsigned arg, float val, int delta);
+    public:
+        program():m_kind(K_CONST), m_pos1(0), m_pos2(0), m_val(1.0f), m_depth(0), m_max_depth(0) {}
+        void display(std::ostream & out) const;
+    };
+
+private:
     ast_manager &   m_manager;
     arith_util      m_util;
     unsigned        m_num_args;
     float const *   m_args;
+    svector<float>  m_stack;
     float eval(expr * f) const;
+    void compile_core(expr * f, program & p);
 public:
     cost_evaluator(ast_manager & m);
     /**
@@ -37,6 +72,16 @@ public:
        (VAR (num_args - 1)) is stored in the first position of the array.
     */
     float operator()(expr * f, unsigned num_args, float const * args);
+
+    /**
+       \brief Compile f into p, variables are mapped to positions in args as above.
+    */
+    void compile(expr * f, unsigned num_args, program & p);
+
+    /**
+       \brief Evaluate a compiled cost function, it produces the same result as (*this)(f, num_args, args).
+    */
+    float operator()(program const & p, float const * args);
 };
 
 #endif /* COST_EVALUATOR_H_ */
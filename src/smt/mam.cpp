@@ -24,6 +24,7 @@ Revision History:
 #include"trail.h"
 #include"stopwatch.h"
 #include"ast_smt2_pp.h"
+#include"obj_pair_hashtable.h"
 #include<algorithm>
 
 // #define _PROFILE_MAM
@@ -1854,12 +1855,14 @@ namespace smt {
         ast_manager &       m_ast_manager;
         mam &               m_mam;
         bool                m_use_filters;
+        bool                m_qi_trace;        // collect the enodes used in matches for qi.trace.
         enode_vector        m_registers;
         enode_vector        m_bindings;
         enode_vector        m_args;
         backtrack_stack     m_backtrack_stack;
         unsigned            m_top;
         const instruction * m_pc;
+        unsigned            m_num_executions; // number of invocations of execute_core.
 
         // auxiliary temporary variables
         unsigned            m_max_generation;  // the maximum generation of an app enode processed.
@@ -1887,10 +1890,14 @@ namespace smt {
             m_pool.recycle(v);
         }
 
+        bool track_used_enodes() const {
+            return m_qi_trace || m_ast_manager.has_trace_stream();
+        }
+
         void update_max_generation(enode * n) {
             m_max_generation = std::max(m_max_generation, n->get_generation());
 
-            if (m_ast_manager.has_trace_stream())
+            if (track_used_enodes())
                 m_used_enodes.push_back(n);
         }
         
@@ -2002,10 +2009,16 @@ namespace smt {
             m_context(ctx),
             m_ast_manager(ctx.get_manager()),
             m_mam(m), 
-            m_use_filters(use_filters) {
+            m_use_filters(use_filters),
+            m_qi_trace(!ctx.get_fparams().m_qi_trace.empty()),
+            m_num_executions(0) {
             m_args.resize(INIT_ARGS_SIZE, 0);
         }
 
+        unsigned get_num_executions() const { return m_num_executions; }
+
+        void reset_statistics() { m_num_executions = 0; }
+
         ~interpreter() {
         }
 
@@ -2293,13 +2306,14 @@ namespace smt {
         // It doesn't make sense to process an irrelevant enode.
         TRACE("mam_execute_core", tout << "EXEC " << t->get_root_lbl()->get_name() << "\n";);
         SASSERT(m_context.is_relevant(n));
+        m_num_executions++;
         m_pattern_instances.reset();
         m_min_top_generation.reset();
         m_max_top_generation.reset();
         m_pattern_instances.push_back(n);
         m_max_generation = n->get_generation();
 
-        if (m_ast_manager.has_trace_stream()) {
+        if (track_used_enodes()) {
             m_used_enodes.reset();
             m_used_enodes.push_back(n);
         }
@@ -2678,7 +2692,7 @@ namespace smt {
         backtrack_point & bp = m_backtrack_stack[m_top - 1];
         m_max_generation     = bp.m_old_max_generation;
 
-        if (m_ast_manager.has_trace_stream())
+        if (track_used_enodes())
             m_used_enodes.shrink(bp.m_old_used_enodes_size);
 
         TRACE("mam_int", tout << "backtrack top: " << bp.m_instr << " " << *(bp.m_instr) << "\n";);
@@ -3105,6 +3119,46 @@ namespace smt {
 
         enode *                     m_r1; // temp field
         enode *                     m_r2; // temp field
+
+        struct stats {
+            unsigned m_num_candidates;
+            unsigned m_num_matches;
+            stats() { reset(); }
+            void reset() { memset(this, 0, sizeof(*this)); }
+        };
+        stats                       m_stats;
+
+        // per pattern profile, maintained when qi.profile is set.
+        // Code trees are shared by the patterns with the same head symbol, so 
+        // executions and time are collected per head symbol.
+        struct lbl_profile {
+            unsigned m_num_executions;
+            double   m_time;
+            lbl_profile():m_num_executions(0), m_time(0) {}
+        };
+        bool                        m_profile;
+        svector<lbl_profile>        m_lbl_profile;
+        obj_pair_map<quantifier, app, unsigned> m_pattern_matches;
+        stopwatch                   m_watch;
+        unsigned                    m_watch_executions;
+
+        void start_profile() {
+            if (m_profile) {
+                m_watch_executions = m_interpreter.get_num_executions();
+                m_watch.reset();
+                m_watch.start();
+            }
+        }
+
+        void stop_profile(func_decl * lbl) {
+            if (m_profile) {
+                m_watch.stop();
+                unsigned lbl_id = lbl->get_decl_id();
+                m_lbl_profile.reserve(lbl_id + 1);
+                m_lbl_profile[lbl_id].m_num_executions += m_interpreter.get_num_executions() - m_watch_executions;
+                m_lbl_profile[lbl_id].m_time           += m_watch.get_seconds();
+            }
+        }
         
         class add_shared_enode_trail;
         friend class add_shared_enode_trail;
@@ -3132,6 +3186,7 @@ namespace smt {
 
         void add_candidate(code_tree * t, enode * app) {
             if (t != 0) {
+                m_stats.m_num_candidates++;
                 TRACE("mam_candidate", tout << "adding candidate:\n" << mk_ll_pp(app->get_owner(), m_ast_manager););
                 if (!t->has_candidates()) 
                     m_to_match.push_back(t);
@@ -3769,6 +3824,7 @@ namespace smt {
                 SASSERT(tmp_tree != 0);
                 SASSERT(m_context.get_num_enodes_of(lbl) > 0);
                 m_interpreter.init(tmp_tree);
+                start_profile();
                 enode_vector::const_iterator it3  = m_context.begin_enodes_of(lbl);
                 enode_vector::const_iterator end3 = m_context.end_enodes_of(lbl);
                 for (; it3 != end3; ++it3) {
@@ -3776,6 +3832,7 @@ namespace smt {
                     if (m_context.is_relevant(app)) 
                         m_interpreter.execute_core(tmp_tree, app);
                 }
+                stop_profile(lbl);
                 m_tmp_trees[lbl_id] = 0;
                 dealloc(tmp_tree);
             }
@@ -3822,7 +3879,9 @@ namespace smt {
             m_trees(m_ast_manager, m_compiler, m_trail_stack),
             m_region(m_trail_stack.get_region()),
             m_r1(0),
-            m_r2(0) {
+            m_r2(0),
+            m_profile(ctx.get_fparams().m_qi_profile),
+            m_watch_executions(0) {
             DEBUG_CODE(m_trees.set_context(&ctx););
             DEBUG_CODE(m_check_missing_instances = false;);
             reset_pp_pc();
@@ -3846,6 +3905,8 @@ namespace smt {
                     return; // ignore multi-pattern containing ground pattern.
             update_filters(qa, mp);
             collect_ground_exprs(qa, mp);
+            if (m_profile && !m_pattern_matches.contains(qa, mp))
+                m_pattern_matches.insert(qa, mp, 0);
             m_new_patterns.push_back(qp_pair(qa, mp));
             // The matching abstract machine implements incremental
             // e-matching. So, for a multi-pattern [ p_1, ..., p_n ],
@@ -3902,7 +3963,9 @@ namespace smt {
             for (; it != end; ++it) {
                 code_tree * t = *it;
                 SASSERT(t->has_candidates());
+                start_profile();
                 m_interpreter.execute(t);
+                stop_profile(t->get_root_lbl());
                 t->reset_candidates();
             }
             m_to_match.reset();
@@ -3921,6 +3984,7 @@ namespace smt {
                 if (t) {
                     m_interpreter.init(t);
                     func_decl * lbl = t->get_root_lbl();
+                    start_profile();
                     enode_vector::const_iterator it2  = m_context.begin_enodes_of(lbl);
                     enode_vector::const_iterator end2 = m_context.end_enodes_of(lbl);
                     for (; it2 != end2; ++it2) {
@@ -3928,6 +3992,7 @@ namespace smt {
                         if (use_irrelevant || m_context.is_relevant(curr)) 
                             m_interpreter.execute_core(t, curr);
                     }
+                    stop_profile(lbl);
                 }
             }
         }
@@ -3959,6 +4024,12 @@ namespace smt {
                 SASSERT(bindings[i]->get_generation() <= max_generation);
             }
 #endif
+            m_stats.m_num_matches++;
+            if (m_profile) {
+                unsigned num_matches;
+                if (m_pattern_matches.find(qa, pat, num_matches))
+                    m_pattern_matches.insert(qa, pat, num_matches + 1);
+            }
             unsigned min_gen, max_gen;
             m_interpreter.get_min_max_top_generation(min_gen, max_gen);
             m_context.add_instance(qa, pat, num_bindings, bindings, max_generation, min_gen, max_gen, used_enodes);
@@ -3967,6 +4038,64 @@ namespace smt {
         virtual bool is_shared(enode * n) const {
             return !m_shared_enodes.empty() && m_shared_enodes.contains(n);
         }
+
+        virtual void collect_statistics(::statistics & st) const {
+            st.update("mam candidates", m_stats.m_num_candidates);
+            st.update("mam executions", m_interpreter.get_num_executions());
+            st.update("mam matches", m_stats.m_num_matches);
+        }
+
+        virtual void reset_statistics() {
+            m_stats.reset();
+            m_interpreter.reset_statistics();
+            m_lbl_profile.reset();
+            ptr_vector<quantifier> qs;
+            ptr_vector<app> pats;
+            obj_pair_map<quantifier, app, unsigned>::iterator it  = m_pattern_matches.begin();
+            obj_pair_map<quantifier, app, unsigned>::iterator end = m_pattern_matches.end();
+            for (; it != end; ++it) {
+                qs.push_back(it->get_key1());
+                pats.push_back(it->get_key2());
+            }
+            for (unsigned i = 0; i < qs.size(); ++i) 
+                m_pattern_matches.insert(qs[i], pats[i], 0);
+        }
+
+        virtual void del(quantifier * q) {
+            unsigned num_patterns = q->get_num_patterns();
+            for (unsigned i = 0; i < num_patterns; i++)
+                m_pattern_matches.erase(q, to_app(q->get_pattern(i)));
+        }
+
+        virtual void display_stats(std::ostream & out, quantifier * q) {
+            unsigned num_patterns = q->get_num_patterns();
+            for (unsigned i = 0; i < num_patterns; i++) {
+                app * mp = to_app(q->get_pattern(i));
+                unsigned num_matches = 0;
+                if (!m_pattern_matches.find(q, mp, num_matches))
+                    continue;
+                unsigned num_executions = 0;
+                double time = 0;
+                for (unsigned j = 0; j < mp->get_num_args(); j++) {
+                    func_decl * lbl = to_app(mp->get_arg(j))->get_decl();
+                    unsigned lbl_id = lbl->get_decl_id();
+                    bool is_new     = true;
+                    for (unsigned k = 0; is_new && k < j; k++) 
+                        is_new = to_app(mp->get_arg(k))->get_decl() != lbl;
+                    if (is_new && lbl_id < m_lbl_profile.size()) {
+                        num_executions += m_lbl_profile[lbl_id].m_num_executions;
+                        time           += m_lbl_profile[lbl_id].m_time;
+                    }
+                }
+                out << "[pattern_instances] ";
+                out.width(10);
+                out << q->get_qid().str().c_str() << " : " << i << " : ";
+                out.width(6);
+                out << num_executions << " : ";
+                out.width(6);
+                out << num_matches << " : " << time << "\n";
+            }
+        }
         
         // This method is invoked when n becomes relevant.
         // If lazy == true, then n is not added to the list of candidate enodes for matching. That is, the method just updates the lbls.
@@ -21,6 +21,7 @@ Revision History:
 
 #include"ast.h"
 #include"smt_types.h"
+#include"statistics.h"
 
 namespace smt {
     /**
@@ -61,6 +62,21 @@ namespace smt {
         
         virtual bool is_shared(enode * n) const = 0;
 
+        virtual void collect_statistics(::statistics & st) const = 0;
+
+        virtual void reset_statistics() = 0;
+
+        /**
+           \brief Erase the profile of the patterns of q, it is invoked when q is deleted.
+        */
+        virtual void del(quantifier * q) = 0;
+
+        /**
+           \brief Display the executions, matches and time of the patterns of q.
+           The profile is only maintained when qi.profile is set.
+        */
+        virtual void display_stats(std::ostream & out, quantifier * q) = 0;
+
 #ifdef Z3DEBUG
         virtual bool check_missing_instances() = 0;
 #endif
@@ -28,8 +28,10 @@ void qi_params::updt_params(params_ref const & _p) {
     m_mbqi_trace = p.mbqi_trace();
     m_mbqi_force_template = p.mbqi_force_template();
     m_mbqi_id = p.mbqi_id();
+    m_mbqi_threads = p.mbqi_threads();
     m_qi_profile = p.qi_profile();
     m_qi_profile_freq = p.qi_profile_freq();
+    m_qi_trace = p.qi_trace();
     m_qi_max_instances = p.qi_max_instances();
     m_qi_eager_threshold = p.qi_eager_threshold();
     m_qi_lazy_threshold = p.qi_lazy_threshold();
@@ -49,6 +51,7 @@ void qi_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_qi_max_lazy_multipattern_matching);
     DISPLAY_PARAM(m_qi_profile);
     DISPLAY_PARAM(m_qi_profile_freq);
+    DISPLAY_PARAM(m_qi_trace);
     DISPLAY_PARAM(m_qi_quick_checker);
     DISPLAY_PARAM(m_qi_lazy_quick_checker);
     DISPLAY_PARAM(m_qi_promote_unsat);
@@ -62,4 +65,5 @@ void qi_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_mbqi_trace);
     DISPLAY_PARAM(m_mbqi_force_template);
     DISPLAY_PARAM(m_mbqi_id);
+    DISPLAY_PARAM(m_mbqi_threads);
 }
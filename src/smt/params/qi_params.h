@@ -38,6 +38,7 @@ struct qi_params {
     unsigned           m_qi_max_lazy_multipattern_matching;
     bool               m_qi_profile;
     unsigned           m_qi_profile_freq;
+    std::string        m_qi_trace;
     quick_checker_mode m_qi_quick_checker;
     bool               m_qi_lazy_quick_checker;
     bool               m_qi_promote_unsat;
@@ -52,6 +53,7 @@ struct qi_params {
     bool               m_mbqi_trace;
     unsigned           m_mbqi_force_template;
     const char *       m_mbqi_id;
+    unsigned           m_mbqi_threads;
 
     qi_params(params_ref const & p = params_ref()):
         /*
@@ -87,6 +89,7 @@ struct qi_params {
         m_qi_max_lazy_multipattern_matching(2),
         m_qi_profile(false),
         m_qi_profile_freq(UINT_MAX),
+        m_qi_trace(""),
         m_qi_quick_checker(MC_NO),
         m_qi_lazy_quick_checker(true),
         m_qi_promote_unsat(true),
@@ -99,7 +102,8 @@ struct qi_params {
         m_mbqi_max_iterations(1000),
         m_mbqi_trace(false),
         m_mbqi_force_template(10),
-        m_mbqi_id(0)  
+        m_mbqi_id(0),
+        m_mbqi_threads(1)
     {
         updt_params(p);
     }
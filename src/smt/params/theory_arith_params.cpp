@@ -35,6 +35,9 @@ void theory_arith_params::updt_params(params_ref const & _p) {
     m_arith_ignore_int = p.arith_ignore_int();
     m_arith_bound_prop = static_cast<bound_prop_mode>(p.arith_propagation_mode());
     m_arith_dump_lemmas = p.arith_dump_lemmas();
+    m_arith_fixnum = p.arith_fixnum();
+    m_arith_fp_simplex = p.arith_fp_simplex();
+    m_arith_fp_simplex_threshold = p.arith_fp_simplex_threshold();
 }
 
 
@@ -76,6 +79,8 @@ void theory_arith_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_arith_lazy_adapter);
     DISPLAY_PARAM(m_arith_fixnum);
     DISPLAY_PARAM(m_arith_int_only);
+    DISPLAY_PARAM(m_arith_fp_simplex);
+    DISPLAY_PARAM(m_arith_fp_simplex_threshold);
     DISPLAY_PARAM(m_nl_arith);
     DISPLAY_PARAM(m_nl_arith_gb);
     DISPLAY_PARAM(m_nl_arith_gb_threshold);
@@ -93,6 +93,10 @@ struct theory_arith_params {
     bool                    m_arith_fixnum;
     bool                    m_arith_int_only;
 
+    // floating point simplex used as a hint for the exact simplex
+    bool                    m_arith_fp_simplex;
+    unsigned                m_arith_fp_simplex_threshold;
+
     // non linear support
     bool                    m_nl_arith;  
     bool                    m_nl_arith_gb;
@@ -143,6 +147,8 @@ struct theory_arith_params {
         m_arith_lazy_adapter(false),
         m_arith_fixnum(false),
         m_arith_int_only(false),
+        m_arith_fp_simplex(false),
+        m_arith_fp_simplex_threshold(100),
         m_nl_arith(true),
         m_nl_arith_gb(true),
         m_nl_arith_gb_threshold(512),
@@ -23,6 +23,8 @@ void theory_bv_params::updt_params(params_ref const & _p) {
     smt_params_helper p(_p);
     m_bv_reflect = p.bv_reflect();
     m_bv_enable_int2bv2int = p.bv_enable_int2bv(); 
+    m_bv_lazy = p.bv_lazy();
+    m_bv_lazy_min_size = p.bv_lazy_min_size();
 }
 
 #define DISPLAY_PARAM(X) out << #X"=" << X << std::endl;
@@ -34,4 +36,6 @@ void theory_bv_params::display(std::ostream & out) const {
     DISPLAY_PARAM(m_bv_cc);
     DISPLAY_PARAM(m_bv_blast_max_size);
     DISPLAY_PARAM(m_bv_enable_int2bv2int);
+    DISPLAY_PARAM(m_bv_lazy);
+    DISPLAY_PARAM(m_bv_lazy_min_size);
 }
\ No newline at end of file
@@ -33,13 +33,17 @@ struct theory_bv_params {
     bool         m_bv_cc;
     unsigned     m_bv_blast_max_size;
     bool         m_bv_enable_int2bv2int;
+    bool         m_bv_lazy;
+    unsigned     m_bv_lazy_min_size;
     theory_bv_params(params_ref const & p = params_ref()):
         m_bv_mode(BS_BLASTER),
         m_bv_reflect(true),
         m_bv_lazy_le(false),
         m_bv_cc(false),
         m_bv_blast_max_size(INT_MAX),
-        m_bv_enable_int2bv2int(true) {
+        m_bv_enable_int2bv2int(true),
+        m_bv_lazy(false),
+        m_bv_lazy_min_size(16) {
         updt_params(p);
     }
     
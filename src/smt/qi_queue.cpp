@@ -62,7 +62,14 @@ namespace smt {
             warning_msg("invalid new_gen function '%s', switching to default one", m_params.m_qi_new_gen.c_str());
             VERIFY(m_parser.parse_string("cost", m_new_gen_function));
         }
+        m_evaluator.compile(m_cost_function, m_vals.size(), m_cost_program);
+        m_evaluator.compile(m_new_gen_function, m_vals.size(), m_new_gen_program);
         m_eager_cost_threshold = m_params.m_qi_eager_threshold;
+        if (!m_params.m_qi_trace.empty() && !m_trace) {
+            m_trace = alloc(qi_trace, m_manager, m_params.m_qi_trace.c_str());
+            if (!m_trace->is_open())
+                m_trace = 0;
+        }
     }
 
     void qi_queue::init_parser_vars() {
@@ -98,56 +105,88 @@ namespace smt {
         m_parser.add_var("cs_factor");
     }
 
-    quantifier_stat * qi_queue::set_values(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation, float cost) {
+    /**
+       \brief Set the values that depend only on the quantifier. 
+       They do not change while new entries are collected, so they are shared by the entries of the same quantifier.
+    */
+    quantifier_stat * qi_queue::set_quantifier_values(quantifier * q) {
         quantifier_stat * stat     = m_qm.get_stat(q);
-        m_vals[COST]               = cost;
-        m_vals[MIN_TOP_GENERATION] = static_cast<float>(min_top_generation);
-        m_vals[MAX_TOP_GENERATION] = static_cast<float>(max_top_generation);
         m_vals[INSTANCES]          = static_cast<float>(stat->get_num_instances_curr_branch());
         m_vals[SIZE]               = static_cast<float>(stat->get_size());
         m_vals[DEPTH]              = static_cast<float>(stat->get_depth());
-        m_vals[GENERATION]         = static_cast<float>(generation);
         m_vals[QUANT_GENERATION]   = static_cast<float>(stat->get_generation()); 
         m_vals[WEIGHT]             = static_cast<float>(q->get_weight());
         m_vals[VARS]               = static_cast<float>(q->get_num_decls());
-        m_vals[PATTERN_WIDTH]      = pat ? static_cast<float>(pat->get_num_args()) : 1.0f;
         m_vals[TOTAL_INSTANCES]    = static_cast<float>(stat->get_num_instances_curr_search());
         m_vals[SCOPE]              = static_cast<float>(m_context.get_scope_level());
         m_vals[NESTED_QUANTIFIERS] = static_cast<float>(stat->get_num_nested_quantifiers());
         m_vals[CS_FACTOR]          = static_cast<float>(stat->get_case_split_factor());
-        TRACE("qi_queue_detail", for (unsigned i = 0; i < m_vals.size(); i++) { tout << m_vals[i] << " "; } tout << "\n";);
         return stat;
     }
-    
-    float qi_queue::get_cost(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation) {
-        quantifier_stat * stat = set_values(q, pat, generation, min_top_generation, max_top_generation, 0);
-        float r = m_evaluator(m_cost_function, m_vals.size(), m_vals.c_ptr());
-        stat->update_max_cost(r);
-        return r;
+
+    void qi_queue::set_instance_values(app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation, float cost) {
+        m_vals[COST]               = cost;
+        m_vals[MIN_TOP_GENERATION] = static_cast<float>(min_top_generation);
+        m_vals[MAX_TOP_GENERATION] = static_cast<float>(max_top_generation);
+        m_vals[GENERATION]         = static_cast<float>(generation);
+        m_vals[PATTERN_WIDTH]      = pat ? static_cast<float>(pat->get_num_args()) : 1.0f;
+        TRACE("qi_queue_detail", for (unsigned i = 0; i < m_vals.size(); i++) { tout << m_vals[i] << " "; } tout << "\n";);
+    }
+
+    quantifier_stat * qi_queue::set_values(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation, float cost) {
+        quantifier_stat * stat = set_quantifier_values(q);
+        set_instance_values(pat, generation, min_top_generation, max_top_generation, cost);
+        return stat;
     }
 
     unsigned qi_queue::get_new_gen(quantifier * q, unsigned generation, float cost) {
         // max_top_generation and min_top_generation are not available for computing inc_gen
         set_values(q, 0, generation, 0, 0, cost);
-        float r = m_evaluator(m_new_gen_function, m_vals.size(), m_vals.c_ptr());
+        float r = m_evaluator(m_new_gen_program, m_vals.c_ptr());
         return static_cast<unsigned>(r);
     }
     
-    void qi_queue::insert(fingerprint * f, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation) {
-        quantifier * q         = static_cast<quantifier*>(f->get_data());
-        float cost             = get_cost(q, pat, generation, min_top_generation, max_top_generation);
-        TRACE("qi_queue_detail", 
-              tout << "new instance of " << q->get_qid() << ", weight " << q->get_weight()
-              << ", generation: " << generation << ", scope_level: " << m_context.get_scope_level() << ", cost: " << cost << "\n";
-              for (unsigned i = 0; i < f->get_num_args(); i++) {
-                  tout << "#" << f->get_arg(i)->get_owner_id() << " ";
-              }
-              tout << "\n";);
+    void qi_queue::insert(fingerprint * f, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation,
+                          ptr_vector<enode> const & used_enodes) {
         TRACE("new_entries_bug", tout << "[qi:insert]\n";);
-        m_new_entries.push_back(entry(f, cost, generation));
+        if (m_trace)
+            m_trace->on_match(f, used_enodes.size(), used_enodes.c_ptr());
+        m_new_entries.push_back(entry(f, 0.0f, generation));
+        m_new_entries_info.push_back(new_entry_info(pat, min_top_generation, max_top_generation));
+    }
+
+    /**
+       \brief Compute the costs of the new entries. 
+       The statistics of quantifiers and the scope level do not change between insert() and instantiate().
+    */
+    void qi_queue::set_new_entries_costs() {
+        SASSERT(m_new_entries.size() == m_new_entries_info.size());
+        quantifier * last_q    = 0;
+        quantifier_stat * stat = 0;
+        for (unsigned i = 0; i < m_new_entries.size(); ++i) {
+            entry & e                    = m_new_entries[i];
+            new_entry_info const & info  = m_new_entries_info[i];
+            quantifier * q               = static_cast<quantifier*>(e.m_qb->get_data());
+            if (q != last_q) {
+                stat   = set_quantifier_values(q);
+                last_q = q;
+            }
+            set_instance_values(info.m_pat, e.m_generation, info.m_min_top_generation, info.m_max_top_generation, 0.0f);
+            e.m_cost = m_evaluator(m_cost_program, m_vals.c_ptr());
+            stat->update_max_cost(e.m_cost);
+            TRACE("qi_queue_detail", 
+                  tout << "new instance of " << q->get_qid() << ", weight " << q->get_weight()
+                  << ", generation: " << e.m_generation << ", scope_level: " << m_context.get_scope_level() << ", cost: " << e.m_cost << "\n";
+                  for (unsigned j = 0; j < e.m_qb->get_num_args(); j++) {
+                      tout << "#" << e.m_qb->get_arg(j)->get_owner_id() << " ";
+                  }
+                  tout << "\n";);
+        }
+        m_new_entries_info.reset();
     }
 
     void qi_queue::instantiate() {
+        set_new_entries_costs();
         svector<entry>::iterator it               = m_new_entries.begin();
         svector<entry>::iterator end              = m_new_entries.end();
         unsigned                 since_last_check = 0;
@@ -291,7 +330,12 @@ namespace smt {
         m_stats.m_num_instances++;
         unsigned gen = get_new_gen(q, generation, ent.m_cost);
         display_instance_profile(f, q, num_bindings, bindings, proof_id, gen);
+        unsigned num_enodes = m_context.end_enodes() - m_context.begin_enodes();
         m_context.internalize_instance(lemma, pr1, gen);
+        if (m_trace) {
+            unsigned new_num_enodes = m_context.end_enodes() - m_context.begin_enodes();
+            m_trace->on_instance(f, generation, gen, ent.m_cost, new_num_enodes - num_enodes, m_context.begin_enodes() + num_enodes);
+        }
         TRACE_CODE({
             static unsigned num_useless = 0;
             if (m_manager.is_or(lemma)) {
@@ -330,6 +374,8 @@ namespace smt {
         s.m_delayed_entries_lim    = m_delayed_entries.size();
         s.m_instances_lim          = m_instances.size();
         s.m_instantiated_trail_lim = m_instantiated_trail.size();
+        if (m_trace)
+            m_trace->push_scope();
     }
      
     void qi_queue::pop_scope(unsigned num_scopes) {
@@ -343,12 +389,16 @@ namespace smt {
         m_delayed_entries.shrink(s.m_delayed_entries_lim);
         m_instances.shrink(s.m_instances_lim);
         m_new_entries.reset();
+        m_new_entries_info.reset();
         m_scopes.shrink(new_lvl);
+        if (m_trace)
+            m_trace->pop_scope(num_scopes);
         TRACE("new_entries_bug", tout << "[qi:pop-scope]\n";);
     }
 
     void qi_queue::reset() {
         m_new_entries.reset();
+        m_new_entries_info.reset();
         m_delayed_entries.reset();
         m_instances.reset();
         m_scopes.reset();
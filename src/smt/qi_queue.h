@@ -28,6 +28,7 @@ Revision History:
 #include"cost_parser.h"
 #include"cost_evaluator.h"
 #include"cached_var_subst.h"
+#include"qi_trace.h"
 #include"statistics.h"
 
 namespace smt {
@@ -50,9 +51,12 @@ namespace smt {
         expr_ref                      m_new_gen_function;
         cost_parser                   m_parser;
         cost_evaluator                m_evaluator;
+        cost_evaluator::program       m_cost_program;
+        cost_evaluator::program       m_new_gen_program;
         cached_var_subst              m_subst;
         svector<float>                m_vals;
         double                        m_eager_cost_threshold;
+        scoped_ptr<qi_trace>          m_trace;
         struct entry {
             fingerprint * m_qb;
             float         m_cost;
@@ -61,6 +65,14 @@ namespace smt {
             entry(fingerprint * f, float c, unsigned g):m_qb(f), m_cost(c), m_generation(g), m_instantiated(false) {}
         };
         svector<entry>                m_new_entries;
+        // pattern and top generations of m_new_entries, their costs are computed in batch by instantiate().
+        struct new_entry_info {
+            app *    m_pat;
+            unsigned m_min_top_generation;
+            unsigned m_max_top_generation;
+            new_entry_info(app * pat, unsigned min_gen, unsigned max_gen):m_pat(pat), m_min_top_generation(min_gen), m_max_top_generation(max_gen) {}
+        };
+        svector<new_entry_info>       m_new_entries_info;
         svector<entry>                m_delayed_entries;
         expr_ref_vector               m_instances;
         unsigned_vector               m_instantiated_trail;
@@ -72,8 +84,10 @@ namespace smt {
         svector<scope>                m_scopes;
 
         void init_parser_vars();
+        quantifier_stat * set_quantifier_values(quantifier * q);
+        void set_instance_values(app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation, float cost);
         quantifier_stat * set_values(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation, float cost);
-        float get_cost(quantifier * q, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation);
+        void set_new_entries_costs();
         unsigned get_new_gen(quantifier * q, unsigned generation, float cost);
         void instantiate(entry & ent);
         void get_min_max_costs(float & min, float & max) const;
@@ -85,9 +99,10 @@ namespace smt {
         void setup();
         /**
            \brief Insert a new quantifier in the queue, f contains the quantifier and bindings.
-           f->get_data() is the quantifier.
+           f->get_data() is the quantifier, used_enodes are the enodes that were used to match pat.
         */
-        void insert(fingerprint * f, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation);
+        void insert(fingerprint * f, app * pat, unsigned generation, unsigned min_top_generation, unsigned max_top_generation,
+                    ptr_vector<enode> const & used_enodes);
         void instantiate();
         bool has_work() const { return !m_new_entries.empty(); }
         void init_search_eh();
@@ -97,6 +112,7 @@ namespace smt {
         void reset();
         void display_delayed_instances_stats(std::ostream & out) const;
         void collect_statistics(::statistics & st) const;
+        void reset_statistics() { m_stats.reset(); }
     };
 };
 
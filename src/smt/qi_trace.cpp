@@ -0,0 +1,267 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    qi_trace.cpp
+
+Abstract:
+
+    Trace of quantifier instantiation (qi.trace).
+
+Author:
+
+
+
+Notes:
+
+--*/
+#include<algorithm>
+#include"qi_trace.h"
+#include"warning.h"
+
+namespace smt {
+
+    qi_trace::qi_trace(ast_manager & m, char const * file_name):
+        m(m),
+        m_out(file_name, std::ios::out | std::ios::app),
+        m_started(false),
+        m_num_total_instances(0),
+        m_pinned(m) {
+        if (!m_out.is_open()) 
+            warning_msg("could not open file '%s' for the quantifier instantiation trace", file_name);
+    }
+
+    qi_trace::~qi_trace() {
+        if (!m_out.is_open() || !m_started)
+            return;
+        vector<unsigned_vector> cycles;
+        collect_cycles(cycles);
+        for (unsigned i = 0; i < cycles.size(); ++i) {
+            unsigned num_instances = 0;
+            m_out << "{\"type\":\"cycle\",\"qids\":[";
+            for (unsigned j = 0; j < cycles[i].size(); ++j) {
+                if (j > 0) m_out << ",";
+                display_qid(m_out, cycles[i][j]);
+                num_instances += m_num_instances[cycles[i][j]];
+            }
+            m_out << "],\"instances\":" << num_instances << "}\n";
+        }
+        display_summary(verbose_stream());
+    }
+
+    /**
+       \brief Auxiliary contexts that never match anything do not leave a record in the trace.
+    */
+    std::ostream & qi_trace::out() {
+        if (!m_started) {
+            m_started = true;
+            m_out << "{\"type\":\"start\"}\n";
+        }
+        return m_out;
+    }
+
+    unsigned qi_trace::get_idx(quantifier * q) {
+        unsigned idx;
+        if (m_q2idx.find(q, idx))
+            return idx;
+        idx = m_qids.size();
+        m_pinned.push_back(q);
+        m_q2idx.insert(q, idx);
+        m_qids.push_back(q->get_qid());
+        m_num_instances.push_back(0);
+        m_edges.push_back(u_map<unsigned>());
+        return idx;
+    }
+
+    /**
+       \brief Return the latest of parent and the instance that created n.
+    */
+    unsigned qi_trace::get_parent(enode * n, unsigned parent) const {
+        unsigned inst;
+        if (m_expr2instance.find(n->get_owner(), inst) && (parent == null_instance || inst > parent))
+            return inst;
+        return parent;
+    }
+
+    void qi_trace::display_qid(std::ostream & out, unsigned idx) const {
+        out << "\"";
+        std::string s = m_qids[idx].str();
+        for (unsigned i = 0; i < s.size(); ++i) {
+            char c = s[i];
+            if (c == '"' || c == '\\')
+                out << '\\';
+            out << c;
+        }
+        out << "\"";
+    }
+
+    void qi_trace::display_parent(std::ostream & out, unsigned parent) const {
+        if (parent == null_instance)
+            out << -1;
+        else
+            out << parent;
+    }
+
+    void qi_trace::push_scope() {
+        m_matches_lim.push_back(m_matches_trail.size());
+    }
+
+    /**
+       \brief The fingerprints of the scopes are deleted, the ids of their matches remain in the trace.
+    */
+    void qi_trace::pop_scope(unsigned num_scopes) {
+        unsigned new_lvl = m_matches_lim.size() - num_scopes;
+        unsigned old_sz  = m_matches_lim[new_lvl];
+        for (unsigned i = old_sz; i < m_matches_trail.size(); ++i)
+            m_matches.erase(m_matches_trail[i]);
+        m_matches_trail.shrink(old_sz);
+        m_matches_lim.shrink(new_lvl);
+    }
+
+    void qi_trace::on_match(fingerprint * f, unsigned num_used, enode * const * used) {
+        quantifier * q  = static_cast<quantifier*>(f->get_data());
+        unsigned match  = m_match_parent.size();
+        unsigned parent = null_instance;
+        for (unsigned i = 0; i < f->get_num_args(); ++i)
+            parent = get_parent(f->get_arg(i), parent);
+        for (unsigned i = 0; i < num_used; ++i)
+            parent = get_parent(used[i], parent);
+        m_match_parent.push_back(parent);
+        m_matches.insert(f, match);
+        m_matches_trail.push_back(f);
+        out() << "{\"type\":\"match\",\"match\":" << match << ",\"qid\":";
+        display_qid(m_out, get_idx(q));
+        m_out << ",\"bindings\":[";
+        for (unsigned i = 0; i < f->get_num_args(); ++i)
+            m_out << (i > 0 ? "," : "") << f->get_arg(i)->get_owner_id();
+        m_out << "],\"triggers\":[";
+        for (unsigned i = 0; i < num_used; ++i)
+            m_out << (i > 0 ? "," : "") << used[i]->get_owner_id();
+        m_out << "],\"parent\":";
+        display_parent(m_out, parent);
+        m_out << "}\n";
+    }
+
+    void qi_trace::on_instance(fingerprint * f, unsigned generation, unsigned new_generation, float cost,
+                               unsigned num_enodes, enode * const * enodes) {
+        quantifier * q  = static_cast<quantifier*>(f->get_data());
+        unsigned idx    = get_idx(q);
+        unsigned match  = UINT_MAX;
+        unsigned parent = null_instance;
+        if (m_matches.find(f, match))
+            parent = m_match_parent[match];
+        unsigned inst   = m_num_total_instances++;
+        m_num_instances[idx]++;
+        if (parent != null_instance) {
+            unsigned num_edges = 0;
+            u_map<unsigned> & edges = m_edges[m_instance2quantifier[parent]];
+            edges.find(idx, num_edges);
+            edges.insert(idx, num_edges + 1);
+        }
+        m_instance2quantifier.push_back(idx);
+        for (unsigned i = 0; i < num_enodes; ++i) {
+            expr * e = enodes[i]->get_owner();
+            if (!m_expr2instance.contains(e)) 
+                m_pinned.push_back(e);
+            m_expr2instance.insert(e, inst);
+        }
+        out() << "{\"type\":\"instance\",\"id\":" << inst << ",\"match\":";
+        display_parent(m_out, match);
+        m_out << ",\"qid\":";
+        display_qid(m_out, idx);
+        m_out << ",\"gen\":" << generation << ",\"new_gen\":" << new_generation << ",\"cost\":" << cost << ",\"parent\":";
+        display_parent(m_out, parent);
+        m_out << ",\"enodes\":" << num_enodes << "}\n";
+    }
+
+    struct cycle_lt {
+        unsigned_vector const & m_num_instances;
+        cycle_lt(unsigned_vector const & n):m_num_instances(n) {}
+        unsigned weight(unsigned_vector const & c) const {
+            unsigned r = 0;
+            for (unsigned i = 0; i < c.size(); ++i) r += m_num_instances[c[i]];
+            return r;
+        }
+        bool operator()(unsigned_vector const & c1, unsigned_vector const & c2) const {
+            return weight(c1) > weight(c2);
+        }
+    };
+
+    /**
+       \brief Collect the strongly connected components of the quantifier graph that contain a cycle.
+       Tarjan's algorithm, with an explicit stack to avoid deep recursion.
+    */
+    void qi_trace::collect_cycles(vector<unsigned_vector> & cycles) const {
+        unsigned n = m_qids.size();
+        unsigned_vector index(n, UINT_MAX), lowlink(n, 0u), stack;
+        svector<bool> on_stack(n, false);
+        svector<std::pair<unsigned, u_map<unsigned>::iterator> > todo;
+        unsigned next_index = 0;
+        for (unsigned root = 0; root < n; ++root) {
+            if (index[root] != UINT_MAX)
+                continue;
+            index[root] = lowlink[root] = next_index++;
+            stack.push_back(root);
+            on_stack[root] = true;
+            todo.push_back(std::make_pair(root, m_edges[root].begin()));
+            while (!todo.empty()) {
+                unsigned v = todo.back().first;
+                u_map<unsigned>::iterator & it = todo.back().second;
+                if (it != m_edges[v].end()) {
+                    unsigned w = it->m_key;
+                    ++it;
+                    if (index[w] == UINT_MAX) {
+                        index[w] = lowlink[w] = next_index++;
+                        stack.push_back(w);
+                        on_stack[w] = true;
+                        todo.push_back(std::make_pair(w, m_edges[w].begin()));
+                    }
+                    else if (on_stack[w]) {
+                        lowlink[v] = std::min(lowlink[v], index[w]);
+                    }
+                    continue;
+                }
+                todo.pop_back();
+                if (!todo.empty()) {
+                    unsigned u = todo.back().first;
+                    lowlink[u] = std::min(lowlink[u], lowlink[v]);
+                }
+                if (lowlink[v] != index[v])
+                    continue;
+                unsigned_vector scc;
+                unsigned w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    on_stack[w] = false;
+                    scc.push_back(w);
+                }
+                while (w != v);
+                if (scc.size() > 1 || m_edges[v].contains(v))
+                    cycles.push_back(scc);
+            }
+        }
+        std::sort(cycles.begin(), cycles.end(), cycle_lt(m_num_instances));
+    }
+
+    void qi_trace::display_summary(std::ostream & out) const {
+        for (unsigned i = 0; i < m_edges.size(); ++i) {
+            u_map<unsigned>::iterator it  = m_edges[i].begin();
+            u_map<unsigned>::iterator end = m_edges[i].end();
+            for (; it != end; ++it) {
+                out << "[qi_graph] " << m_qids[i] << " -> " << m_qids[it->m_key] << " : " << it->m_value << "\n";
+            }
+        }
+        vector<unsigned_vector> cycles;
+        collect_cycles(cycles);
+        cycle_lt lt(m_num_instances);
+        for (unsigned i = 0; i < cycles.size(); ++i) {
+            out << "[qi_cycle] " << lt.weight(cycles[i]) << " :";
+            for (unsigned j = 0; j < cycles[i].size(); ++j)
+                out << " " << m_qids[cycles[i][j]];
+            out << "\n";
+        }
+    }
+
+};
@@ -0,0 +1,96 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    qi_trace.h
+
+Abstract:
+
+    Trace of quantifier instantiation (qi.trace).
+
+    - Every match and instance is written as a JSON object on a separate line:
+
+      {"type":"match","match":3,"qid":"ax1","bindings":[12,40],"triggers":[41],"parent":1}
+      {"type":"instance","id":2,"match":3,"qid":"ax1","gen":1,"new_gen":2,"cost":3,"parent":1,"enodes":4}
+
+      Bindings and triggers are the ids of the expressions of the enodes.
+      The parent of a match is the latest instance that created one of its
+      bindings or triggers, -1 if they all come from the input.
+      The expressions created by instances and the quantifiers are kept alive by the
+      trace, so that their ids remain valid after backtracking.
+
+    - The parent relation induces a graph on quantifiers: there is an edge q1 -> q2
+      if an instance of q1 enabled an instance of q2. Cycles in this graph are
+      matching loops. A summary of the edges and cycles is displayed when the
+      trace is closed.
+
+Author:
+
+
+
+Notes:
+
+--*/
+#ifndef QI_TRACE_H_
+#define QI_TRACE_H_
+
+#include<fstream>
+#include"ast.h"
+#include"map.h"
+#include"fingerprints.h"
+
+namespace smt {
+
+    class qi_trace {
+        static const unsigned null_instance = UINT_MAX;
+        ast_manager &                  m;
+        std::ofstream                  m_out;
+        bool                           m_started;
+        obj_map<quantifier, unsigned>  m_q2idx;
+        svector<symbol>                m_qids;
+        unsigned_vector                m_num_instances;  // per quantifier
+        vector<u_map<unsigned> >       m_edges;          // quantifier -> quantifier -> number of instances
+        ptr_addr_map<fingerprint, unsigned> m_matches;   // fingerprint -> match
+        ptr_vector<fingerprint>        m_matches_trail;  // fingerprints of m_matches, they are deleted on backtracking
+        unsigned_vector                m_matches_lim;
+        unsigned_vector                m_match_parent;
+        unsigned                       m_num_total_instances;
+        unsigned_vector                m_instance2quantifier;
+        obj_map<expr, unsigned>        m_expr2instance;  // owner of enode -> instance that created the enode
+        expr_ref_vector                m_pinned;
+
+        std::ostream & out();
+        unsigned get_idx(quantifier * q);
+        unsigned get_parent(enode * n, unsigned parent) const;
+        void display_qid(std::ostream & out, unsigned idx) const;
+        void display_parent(std::ostream & out, unsigned parent) const;
+        void collect_cycles(vector<unsigned_vector> & cycles) const;
+
+    public:
+        qi_trace(ast_manager & m, char const * file_name);
+        ~qi_trace();
+
+        bool is_open() const { return m_out.is_open(); }
+
+        void push_scope();
+
+        void pop_scope(unsigned num_scopes);
+
+        void on_match(fingerprint * f, unsigned num_used, enode * const * used);
+
+        /**
+           \brief Record an instance of the match f, enodes are the enodes created by the instance.
+        */
+        void on_instance(fingerprint * f, unsigned generation, unsigned new_generation, float cost, 
+                         unsigned num_enodes, enode * const * enodes);
+
+        /**
+           \brief Display the edges of the quantifier graph, and its cycles ordered by the number of instances.
+        */
+        void display_summary(std::ostream & out) const;
+    };
+
+};
+
+#endif
@@ -244,7 +244,11 @@ namespace smt {
     }
 
     context * context::mk_fresh(symbol const * l, smt_params * p) {
-        context * new_ctx = alloc(context, m_manager, p == 0 ? m_fparams : *p);
+        return mk_fresh(m_manager, l, p);
+    }
+
+    context * context::mk_fresh(ast_manager & m, symbol const * l, smt_params * p) {
+        context * new_ctx = alloc(context, m, p == 0 ? m_fparams : *p);
         new_ctx->set_logic(l == 0 ? m_setup.get_logic() : *l);
         copy_plugins(*this, *new_ctx);        
         return new_ctx;
@@ -3141,6 +3145,8 @@ namespace smt {
     lbool context::setup_and_check(bool reset_cancel) {
         if (!check_preamble(reset_cancel))
             return l_undef;
+        if (use_parallel())
+            return check_finalize(check_parallel(0, 0));
         SASSERT(m_scope_lvl == 0);
         SASSERT(!m_setup.already_configured());
         setup_context(m_fparams.m_auto_config);
@@ -3218,6 +3224,8 @@ namespace smt {
             return l_undef;
         if (!validate_assumptions(num_assumptions, assumptions))
             return l_undef;
+        if (use_parallel())
+            return check_finalize(check_parallel(num_assumptions, assumptions));
         TRACE("check_bug", tout << "inconsistent: " << inconsistent() << ", m_unsat_core.empty(): " << m_unsat_core.empty() << "\n";);
         TRACE("unsat_core_bug", for (unsigned i = 0; i < num_assumptions; i++) { tout << mk_pp(assumptions[i], m_manager) << "\n";});
         pop_to_base_lvl();
@@ -1063,6 +1063,20 @@ namespace smt {
 
         void validate_unsat_core();
 
+        // -----------------------------------
+        //
+        // Parallel search (smt_parallel.cpp)
+        //
+        // -----------------------------------
+
+        bool use_parallel() const;
+
+        lbool check_parallel(unsigned num_assumptions, expr * const * assumptions);
+
+        void get_parallel_cube(unsigned idx, unsigned depth, expr_ref_vector & cube);
+
+        void get_parallel_units(unsigned & lim, expr_ref_vector & units);
+
         void init_search();
 
         void end_search();
@@ -1421,6 +1435,12 @@ namespace smt {
         */
         context * mk_fresh(symbol const * l = 0,  smt_params * p = 0);
 
+        /**
+           \brief Similar to mk_fresh, but the new context uses the manager m. 
+           The theory plugins are created in m.
+        */
+        context * mk_fresh(ast_manager & m, symbol const * l = 0, smt_params * p = 0);
+
         static void copy(context& src, context& dst);
 
         /**
@@ -1431,6 +1451,14 @@ namespace smt {
 
         bool set_logic(symbol const& logic) { return m_setup.set_logic(logic); }
 
+        /**
+           \brief Allow the arithmetic solver over 64-bit numerals (smt.arith.fixnum).
+           Only the owner of the context can recover from their overflow, so it is off by default.
+        */
+        void allow_fixnum_arith(bool f) { m_setup.allow_fixnum_arith(f); }
+
+        bool uses_fixnum_arith() const { return m_setup.uses_fixnum_arith(); }
+
         void register_plugin(simplifier_plugin * s);
 
         void register_plugin(theory * th);
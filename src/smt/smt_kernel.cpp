@@ -20,20 +20,75 @@ Revision History:
 #include"smt_context.h" 
 #include"ast_smt2_pp.h"
 #include"smt_params_helper.hpp"
+#include"ast_translation.h"
+#include"s_rational.h"
 
 namespace smt {
 
     struct kernel::imp {
-        smt::context m_kernel;
-        params_ref   m_params;
+        smt::context        m_kernel;
+        params_ref          m_params;
+        // if the fixnum arithmetic may be used, the assertions and scopes are recorded,
+        // they are replayed into a new context that uses rationals when the numerals overflow.
+        bool                m_fixnum;
+        expr_ref_vector     m_assertions;
+        unsigned_vector     m_assertions_lim;
+        symbol              m_logic;
+        progress_callback * m_callback;
         
-        imp(ast_manager & m, smt_params & fp, params_ref const & p):
+        imp(ast_manager & m, smt_params & fp, params_ref const & p, bool allow_fixnum = true):
             m_kernel(m, fp, p),
-            m_params(p) {
+            m_params(p),
+            m_fixnum(allow_fixnum && fp.m_arith_fixnum && !m.proofs_enabled()),
+            m_assertions(m),
+            m_callback(0) {
+            m_kernel.allow_fixnum_arith(m_fixnum);
         }
 
         static void copy(imp& src, imp& dst) {
             context::copy(src.m_kernel, dst.m_kernel);
+            if (!src.m_fixnum) {
+                dst.disable_fixnum();
+            }
+            else if (dst.m_fixnum) {
+                ast_translation tr(src.m(), dst.m(), false);
+                for (unsigned i = 0; i < src.m_assertions.size(); ++i) {
+                    dst.m_assertions.push_back(tr(src.m_assertions.get(i)));
+                }
+            }
+            dst.m_logic = src.m_logic;
+        }
+
+        /**
+           \brief Stop recording, the context does not use the fixnum arithmetic.
+        */
+        void disable_fixnum() {
+            SASSERT(!m_kernel.uses_fixnum_arith());
+            m_fixnum = false;
+            m_kernel.allow_fixnum_arith(false);
+            m_assertions.reset();
+            m_assertions_lim.reset();
+        }
+
+        /**
+           \brief Assert the assertions of src into this, which has a fresh context.
+        */
+        void replay(imp const & src) {
+            if (src.m_logic != symbol::null) {
+                set_logic(src.m_logic);
+            }
+            set_progress_callback(src.m_callback);
+            unsigned lim_idx = 0;
+            for (unsigned i = 0; i < src.m_assertions.size(); ++i) {
+                while (lim_idx < src.m_assertions_lim.size() && src.m_assertions_lim[lim_idx] == i) {
+                    push();
+                    ++lim_idx;
+                }
+                assert_expr(src.m_assertions.get(i));
+            }
+            for (; lim_idx < src.m_assertions_lim.size(); ++lim_idx) {
+                push();
+            }
         }
 
         smt_params & fparams() {
@@ -49,10 +104,12 @@ namespace smt {
         }
 
         bool set_logic(symbol logic) {
+            m_logic = logic;
             return m_kernel.set_logic(logic);
         }
         
         void set_progress_callback(progress_callback * callback) {
+            m_callback = callback;
             return m_kernel.set_progress_callback(callback);
         }
 
@@ -70,10 +127,13 @@ namespace smt {
         
         void assert_expr(expr * e) {
             TRACE("smt_kernel", tout << "assert:\n" << mk_ismt2_pp(e, m()) << "\n";);
+            if (m_fixnum) m_assertions.push_back(e);
             m_kernel.assert_expr(e);
         }
         
         void assert_expr(expr * e, proof * pr) {
+            // the fixnum arithmetic is not used when proofs are enabled, so the proof need not be replayed.
+            if (m_fixnum) m_assertions.push_back(e);
             m_kernel.assert_expr(e, pr);
         }
 
@@ -87,12 +147,18 @@ namespace smt {
         
         void push() {
             TRACE("smt_kernel", tout << "push()\n";);
+            if (m_fixnum) m_assertions_lim.push_back(m_assertions.size());
             m_kernel.push();
         }
 
         void pop(unsigned num_scopes) {
             TRACE("smt_kernel", tout << "pop()\n";);
             m_kernel.pop(num_scopes);
+            if (m_fixnum) {
+                unsigned new_lvl = m_assertions_lim.size() - num_scopes;
+                m_assertions.shrink(m_assertions_lim[new_lvl]);
+                m_assertions_lim.shrink(new_lvl);
+            }
         }
         
         unsigned get_scope_level() const {
@@ -247,7 +313,13 @@ namespace smt {
 
 
     void kernel::push() {
-        m_imp->push();
+        try {
+            m_imp->push();
+        }
+        catch (s_rational::overflow_exception &) {
+            // the scope was recorded, and it is recreated by the replay.
+            fallback_to_rationals();
+        }
     }
 
     void kernel::pop(unsigned num_scopes) {
@@ -273,26 +345,84 @@ namespace smt {
         return m_imp->inconsistent();
     }
 
+    /**
+       \brief The 64-bit numerals of the arithmetic solver overflowed.
+       Replace the context by a fresh context that uses rationals.
+       The shared smt_params keep smt.arith.fixnum, only the new context does not use it.
+    */
+    void kernel::fallback_to_rationals() {
+        IF_VERBOSE(2, verbose_stream() << "(smt.arith-fixnum-overflow)\n";);
+        SASSERT(m_imp->m_fixnum);
+        ast_manager & _m = m();
+        smt_params & fps = m_imp->fparams();
+        params_ref ps    = m_imp->params();
+        imp * new_imp = alloc(imp, _m, fps, ps, false);
+        new_imp->replay(*m_imp);
+        #pragma omp critical (smt_kernel)
+        {
+            std::swap(m_imp, new_imp);
+        }
+        dealloc(new_imp);
+    }
+
     lbool kernel::setup_and_check() {
-        return m_imp->setup_and_check();
+        try {
+            return m_imp->setup_and_check();
+        }
+        catch (s_rational::overflow_exception &) {
+            fallback_to_rationals();
+            return m_imp->setup_and_check();
+        }
     }
 
     lbool kernel::check(unsigned num_assumptions, expr * const * assumptions) {
-        lbool r = m_imp->check(num_assumptions, assumptions);
+        lbool r;
+        try {
+            r = m_imp->check(num_assumptions, assumptions);
+        }
+        catch (s_rational::overflow_exception &) {
+            fallback_to_rationals();
+            r = m_imp->check(num_assumptions, assumptions);
+        }
         TRACE("smt_kernel", tout << "check result: " << r << "\n";);
         return r;
     }
 
     lbool kernel::get_consequences(expr_ref_vector const& assumptions, expr_ref_vector const& vars, expr_ref_vector& conseq, expr_ref_vector& unfixed) {
-        return m_imp->get_consequences(assumptions, vars, conseq, unfixed);
+        unsigned conseq_sz = conseq.size(), unfixed_sz = unfixed.size();
+        try {
+            return m_imp->get_consequences(assumptions, vars, conseq, unfixed);
+        }
+        catch (s_rational::overflow_exception &) {
+            fallback_to_rationals();
+            conseq.shrink(conseq_sz);
+            unfixed.shrink(unfixed_sz);
+            return m_imp->get_consequences(assumptions, vars, conseq, unfixed);
+        }
     }
 
     lbool kernel::preferred_sat(expr_ref_vector const& asms, vector<expr_ref_vector>& cores) {
-        return m_imp->preferred_sat(asms, cores);
+        unsigned cores_sz = cores.size();
+        try {
+            return m_imp->preferred_sat(asms, cores);
+        }
+        catch (s_rational::overflow_exception &) {
+            fallback_to_rationals();
+            cores.shrink(cores_sz);
+            return m_imp->preferred_sat(asms, cores);
+        }
     }
 
     lbool kernel::find_mutexes(expr_ref_vector const& vars, vector<expr_ref_vector>& mutexes) {
-        return m_imp->find_mutexes(vars, mutexes);
+        unsigned mutexes_sz = mutexes.size();
+        try {
+            return m_imp->find_mutexes(vars, mutexes);
+        }
+        catch (s_rational::overflow_exception &) {
+            fallback_to_rationals();
+            mutexes.shrink(mutexes_sz);
+            return m_imp->find_mutexes(vars, mutexes);
+        }
     }
 
     void kernel::get_model(model_ref & m) const {
@@ -375,7 +505,18 @@ namespace smt {
         smt_params_helper::collect_param_descrs(d);
     }
 
+    /**
+       \brief The caller may keep the context or register plugins with it, so it must not
+       be replaced afterwards: a context with fixnum arithmetic is replaced now, the others
+       do not use it from now on.
+    */
     context & kernel::get_context() {
+        if (m_imp->m_fixnum) {
+            if (m_imp->m_kernel.uses_fixnum_arith())
+                fallback_to_rationals();
+            else
+                m_imp->disable_fixnum();
+        }
         return m_imp->m_kernel;
     }
 
@@ -45,6 +45,7 @@ namespace smt {
     class kernel {
         struct imp;
         imp *  m_imp;
+        void fallback_to_rationals();
     public:
         kernel(ast_manager & m, smt_params & fp, params_ref const & p = params_ref());
 
@@ -27,9 +27,160 @@ Revision History:
 #include"ast_ll_pp.h"
 #include"model_pp.h"
 #include"ast_smt2_pp.h"
+#include"ast_translation.h"
+#include"thread_pool.h"
+#include"rlimit.h"
 
 namespace smt {
 
+    /**
+       \brief Model checking problem of a quantifier q, the formulas of the job are 
+       translated to the manager of the worker that checks q.
+    */
+    struct mbqi_job {
+        quantifier *    m_q;
+        expr_ref_vector m_sks;           // skolem constants of q.
+        expr_ref_vector m_fmls;          // negation of q under the current model, see mk_neg_q_m.
+        expr_ref_vector m_cnstrs;        // restrictions of m_sks to the instantiation sets.
+        lbool           m_result;        // result of the complete model check.
+        expr_ref_vector m_complete_cex;  // values of m_sks in the complete counter-example.
+        expr_ref_vector m_cexs;          // values of m_sks in the restricted counter-examples.
+        mbqi_job(ast_manager & m, quantifier * q):
+            m_q(q), m_sks(m), m_fmls(m), m_cnstrs(m), m_result(l_undef), m_complete_cex(m), m_cexs(m) {}
+    };
+
+    /**
+       \brief Auxiliary context with its own manager. 
+       It executes the jobs assigned to it in order, so the results do not depend on scheduling.
+       The context has the same configuration as the auxiliary context of the model checker.
+    */
+    class mbqi_worker : public task {
+        ast_manager          m_manager;
+        smt_params           m_fparams;
+        context &            m_src;      // context whose theories are used by m_context.
+        scoped_ptr<context>  m_context;
+        ptr_vector<mbqi_job> m_jobs;
+        unsigned             m_max_cexs;
+        uint64               m_count;    // resources used by m_manager before the current round.
+
+        void mk_context() {
+            symbol logic;
+            m_context = m_src.mk_fresh(m_manager, &logic, &m_fparams);
+        }
+
+        bool get_values(model * cex, expr_ref_vector const & sks, expr_ref_vector & values) {
+            bool complete = true;
+            for (unsigned i = 0; i < sks.size(); i++) {
+                func_decl * sk_d = to_app(sks.get(i))->get_decl();
+                expr * sk_value  = cex->get_const_interp(sk_d);
+                if (sk_value == 0) 
+                    sk_value = cex->get_some_value(sk_d->get_range());
+                complete &= sk_value != 0;
+                values.push_back(sk_value);
+            }
+            return complete;
+        }
+
+        void add_blocking_clause(expr_ref_vector const & sks, expr * const * values) {
+            expr_ref_buffer diseqs(m_manager);
+            for (unsigned i = 0; i < sks.size(); i++) 
+                diseqs.push_back(m_manager.mk_not(m_manager.mk_eq(sks.get(i), values[i])));
+            expr_ref blocking_clause(m_manager.mk_or(diseqs.size(), diseqs.c_ptr()), m_manager);
+            m_context->assert_expr(blocking_clause);
+        }
+
+        /**
+           \brief Same search as model_checker::check(quantifier*), the instances are created by the model checker 
+           from the values of the counter-examples.
+        */
+        void check(mbqi_job & j) {
+            m_context->push();
+            for (unsigned i = 0; i < j.m_fmls.size(); i++) 
+                m_context->assert_expr(j.m_fmls.get(i));
+            j.m_result = m_context->check();
+            if (j.m_result == l_true) {
+                model_ref cex;
+                m_context->get_model(cex);
+                get_values(cex.get(), j.m_sks, j.m_complete_cex);
+                for (unsigned i = 0; i < j.m_cnstrs.size(); i++) 
+                    m_context->assert_expr(j.m_cnstrs.get(i));
+                unsigned num_sks = j.m_sks.size();
+                for (unsigned num_cexs = 0; num_cexs < m_max_cexs && m_context->check() == l_true; ) {
+                    m_context->get_model(cex);
+                    if (!get_values(cex.get(), j.m_sks, j.m_cexs)) 
+                        break;
+                    num_cexs++;
+                    add_blocking_clause(j.m_sks, j.m_cexs.c_ptr() + j.m_cexs.size() - num_sks);
+                }
+            }
+            m_context->pop(1);
+        }
+
+    public:
+        mbqi_worker(context & src, smt_params const & p):
+            m_manager(src.get_manager(), true),
+            m_fparams(p),
+            m_src(src),
+            m_max_cexs(1),
+            m_count(0) {
+            // the trace stream is written by the main thread.
+            m_manager.disable_trace_stream();
+            mk_context();
+        }
+
+        ~mbqi_worker() {
+            m_context = 0; // delete context before fparams
+        }
+
+        ast_manager & get_manager() { return m_manager; }
+
+        void reset(unsigned max_cexs) {
+            m_jobs.reset();
+            m_max_cexs = max_cexs;
+            m_manager.limit().reset_cancel();
+            if (!m_context) 
+                mk_context();
+        }
+
+        /**
+           \brief Limit the resources of the round to budget, UINT64_MAX if there is no limit.
+        */
+        void start(uint64 budget) {
+            m_count = m_manager.limit().count();
+            unsigned delta = 0; 
+            if (budget != UINT64_MAX) 
+                delta = static_cast<unsigned>(std::max(static_cast<uint64>(1), std::min(budget, static_cast<uint64>(UINT_MAX))));
+            m_manager.limit().push(delta);
+        }
+
+        /**
+           \brief Return the resources used in the round.
+        */
+        uint64 stop() {
+            m_manager.limit().pop();
+            return m_manager.limit().count() - m_count;
+        }
+
+        void add_job(mbqi_job * j) { m_jobs.push_back(j); }
+
+        bool empty() const { return m_jobs.empty(); }
+
+        virtual void operator()() {
+            unsigned i = 0;
+            try {
+                for (; i < m_jobs.size(); i++) 
+                    check(*m_jobs[i]);
+            }
+            catch (z3_exception & ex) {
+                IF_VERBOSE(2, verbose_stream() << "(smt.mbqi \"" << ex.msg() << "\")\n";);
+                // the state of the context is unknown, the context is recreated by the main thread for the next round.
+                for (; i < m_jobs.size(); i++) 
+                    m_jobs[i]->m_result = l_undef;
+                m_context = 0;
+            }
+        }
+    };
+
     model_checker::model_checker(ast_manager & m, qi_params const & p, model_finder & mf):
         m(m),
         m_params(p),
@@ -46,6 +197,7 @@ namespace smt {
     model_checker::~model_checker() {
         m_aux_context = 0; // delete aux context before fparams
         m_fparams = 0;
+        m_workers.reset();
     }
 
     quantifier * model_checker::get_flat_quantifier(quantifier * q) {
@@ -80,13 +232,13 @@ namespace smt {
     }
 
     /**
-       \brief Assert in m_aux_context, the constraint
+       \brief Return the constraint
 
          sk = e_1 OR ... OR sk = e_n
 
          where {e_1, ..., e_n} is the universe.
      */
-    void model_checker::restrict_to_universe(expr * sk, obj_hashtable<expr> const & universe) {
+    expr * model_checker::mk_universe_restriction(expr * sk, obj_hashtable<expr> const & universe) {
         SASSERT(!universe.empty());
         ptr_buffer<expr> eqs;
         obj_hashtable<expr>::iterator it  = universe.begin();
@@ -95,22 +247,22 @@ namespace smt {
             expr * e = *it;
             eqs.push_back(m.mk_eq(sk, e));
         }
-        expr_ref fml(m.mk_or(eqs.size(), eqs.c_ptr()), m);
-        m_aux_context->assert_expr(fml);
+        return m.mk_or(eqs.size(), eqs.c_ptr());
     }
 
 #define PP_DEPTH 8
 
     /**
-       \brief Assert the negation of q after applying the interpretation in m_curr_model to the uninterpreted symbols in q.
+       \brief Collect in fmls the negation of q after applying the interpretation in m_curr_model to the uninterpreted symbols in q,
+       preceded by the restrictions of the skolem constants of finite sorts to their universe.
 
        The variables are replaced by skolem constants. These constants are stored in sks.
+       Return false if q could not be evaluated in m_curr_model.
     */
-
-    void model_checker::assert_neg_q_m(quantifier * q, expr_ref_vector & sks) {
+    bool model_checker::mk_neg_q_m(quantifier * q, expr_ref_vector & sks, expr_ref_vector & fmls) {
         expr_ref tmp(m);
         if (!m_curr_model->eval(q->get_expr(), tmp, true)) {
-            return;
+            return false;
         }
         TRACE("model_checker", tout << "q after applying interpretation:\n" << mk_ismt2_pp(tmp, m) << "\n";);        
         ptr_buffer<expr> subst_args;
@@ -123,7 +275,7 @@ namespace smt {
             sks[num_decls - i - 1]        = sk;
             subst_args[num_decls - i - 1] = sk;
             if (m_curr_model->is_finite(s)) {
-                restrict_to_universe(sk, m_curr_model->get_known_universe(s));
+                fmls.push_back(mk_universe_restriction(sk, m_curr_model->get_known_universe(s)));
             }
         }
 
@@ -133,7 +285,18 @@ namespace smt {
         expr_ref r(m);
         r = m.mk_not(sk_body);
         TRACE("model_checker", tout << "mk_neg_q_m:\n" << mk_ismt2_pp(r, m) << "\n";);
-        m_aux_context->assert_expr(r);
+        fmls.push_back(r);
+        return true;
+    }
+
+    /**
+       \brief Assert in m_aux_context the formulas produced by mk_neg_q_m.
+    */
+    void model_checker::assert_neg_q_m(quantifier * q, expr_ref_vector & sks) {
+        expr_ref_vector fmls(m);
+        mk_neg_q_m(q, sks, fmls);
+        for (unsigned i = 0; i < fmls.size(); ++i) 
+            m_aux_context->assert_expr(fmls.get(i));
     }
 
     bool model_checker::add_instance(quantifier * q, model * cex, expr_ref_vector & sks, bool use_inv) {
@@ -144,21 +307,34 @@ namespace smt {
         unsigned num_decls = q->get_num_decls();
         // Remark: sks were created for the flat version of q.
         SASSERT(sks.size() >= num_decls);
+        expr_ref_vector sk_values(m);
+        for (unsigned i = 0; i < num_decls; i++) {
+            func_decl * sk_d = to_app(sks.get(i))->get_decl();
+            expr * sk_value  = cex->get_const_interp(sk_d);
+            if (sk_value == 0) {
+                sk_value = cex->get_some_value(sk_d->get_range());
+                TRACE("model_checker", if (sk_value) tout << "Got some value " << mk_pp(sk_value, m) << "\n";);
+            }
+            sk_values.push_back(sk_value);
+        }
+        return add_value_instance(q, sk_values, use_inv);
+    }
+
+    /**
+       \brief Add an instance of q using the values sk_values of the skolem constants of q,
+       a missing value is represented by 0.
+    */
+    bool model_checker::add_value_instance(quantifier * q, expr_ref_vector const & sk_values, bool use_inv) {
+        unsigned num_decls = q->get_num_decls();
+        SASSERT(sk_values.size() >= num_decls);
         expr_ref_vector bindings(m);
         bindings.resize(num_decls);
         unsigned max_generation = 0;
         for (unsigned i = 0; i < num_decls; i++) {
-            expr * sk = sks.get(num_decls - i - 1);
-            func_decl * sk_d = to_app(sk)->get_decl();
-            expr_ref sk_value(m);
-            sk_value  = cex->get_const_interp(sk_d);
+            expr_ref sk_value(sk_values.get(num_decls - i - 1), m);
             if (sk_value == 0) {
-                sk_value = cex->get_some_value(sk_d->get_range());
-                if (sk_value == 0) {
-                    TRACE("model_checker", tout << "Could not get value for " << sk_d->get_name() << "\n";);
-                    return false; // get_some_value failed... giving up
-                }
-                TRACE("model_checker", tout << "Got some value " << sk_value << "\n";);
+                TRACE("model_checker", tout << "Could not get value for variable " << i << "\n";);
+                return false; // get_some_value failed... giving up
             }
             if (use_inv) {
                 unsigned sk_term_gen;
@@ -363,6 +539,127 @@ namespace smt {
         }
     }
 
+    bool model_checker::use_parallel_check(unsigned num_quantifiers) const {
+        return m_params.m_mbqi_threads > 1 && thread_pool::get_max_threads() > 1 && num_quantifiers > 1;
+    }
+
+    /**
+       \brief Check the quantifiers qs concurrently using the workers in m_workers.
+
+       The negated quantifiers and the restrictions to the instantiation sets are created in the main thread 
+       and translated to the managers of the workers. The workers only search for counter-examples,
+       the instances are created from their values in the order of qs, as in the sequential check.
+       Return the number of quantifiers that are not satisfied by m_curr_model.
+    */
+    unsigned model_checker::check_parallel(ptr_vector<quantifier> const & qs) {
+        unsigned num_workers = std::min(m_params.m_mbqi_threads, thread_pool::get_max_threads());
+        while (m_workers.size() < num_workers) 
+            m_workers.push_back(alloc(mbqi_worker, *m_context, *m_fparams));
+        for (unsigned i = 0; i < num_workers; i++) 
+            m_workers[i]->reset(m_max_cexs);
+
+        scoped_ptr_vector<mbqi_job> jobs;
+        ptr_vector<mbqi_job> q2job;
+        {
+            scoped_ptr_vector<ast_translation> trs;
+            for (unsigned i = 0; i < num_workers; i++) 
+                trs.push_back(alloc(ast_translation, m, m_workers[i]->get_manager()));
+            for (unsigned i = 0; i < qs.size(); i++) {
+                quantifier * q = qs[i];
+                expr_ref_vector sks(m), fmls(m), cnstrs(m);
+                if (m.is_rec_fun_def(q) || !mk_neg_q_m(get_flat_quantifier(q), sks, fmls)) {
+                    q2job.push_back(0);
+                    continue;
+                }
+                m_model_finder.restrict_sks_to_inst_set(q, sks, cnstrs);
+                unsigned w = jobs.size() % num_workers;
+                ast_translation & tr = *trs[w];
+                mbqi_job * j = alloc(mbqi_job, m_workers[w]->get_manager(), q);
+                for (unsigned k = 0; k < sks.size(); k++) j->m_sks.push_back(tr(sks.get(k)));
+                for (unsigned k = 0; k < fmls.size(); k++) j->m_fmls.push_back(tr(fmls.get(k)));
+                for (unsigned k = 0; k < cnstrs.size(); k++) j->m_cnstrs.push_back(tr(cnstrs.get(k)));
+                jobs.push_back(j);
+                q2job.push_back(j);
+                m_workers[w]->add_job(j);
+            }
+        }
+
+        {
+            // the workers share the resources left to m, and the resources they use are charged to m.
+            unsigned num_active = 0;
+            for (unsigned i = 0; i < num_workers; i++) 
+                num_active += !m_workers[i]->empty();
+            uint64 budget = m.limit().remaining();
+            if (budget != UINT64_MAX && num_active > 0) 
+                budget /= num_active;
+            scoped_limits scl(m.limit());
+            task_group g;
+            for (unsigned i = 0; i < num_workers; i++) {
+                if (!m_workers[i]->empty()) {
+                    scl.push_child(&m_workers[i]->get_manager().limit());
+                    m_workers[i]->start(budget);
+                    g.spawn(*m_workers[i]);
+                }
+            }
+            g.wait();
+            for (unsigned i = 0; i < num_workers; i++) {
+                if (!m_workers[i]->empty()) {
+                    uint64 used = m_workers[i]->stop();
+                    m.limit().inc(static_cast<unsigned>(std::min(used, static_cast<uint64>(UINT_MAX))));
+                }
+            }
+        }
+
+        unsigned num_failures = 0;
+        for (unsigned i = 0; i < qs.size(); i++) {
+            quantifier * q = qs[i];
+            if (m_params.m_mbqi_trace && q->get_qid() != symbol::null) {
+                verbose_stream() << "(smt.mbqi :checking " << q->get_qid() << ")\n";
+            }
+            if (m.is_rec_fun_def(q)) {
+                if (!check_rec_fun(q)) {
+                    TRACE("model_checker", tout << "checking recursive function failed\n";);
+                    num_failures++;
+                }
+                continue;
+            }
+            mbqi_job * j = q2job[i];
+            TRACE("model_checker", tout << "[parallel] model-checker result: " << (j ? to_sat_str(j->m_result) : "undef") << "\n";);
+            if (j && j->m_result == l_false) 
+                continue;
+            if (j && j->m_result == l_true) {
+                ast_translation tr(j->m_sks.get_manager(), m, false);
+                unsigned num_sks = j->m_sks.size();
+                expr_ref_vector values(m);
+                unsigned num_new_instances = 0;
+                for (unsigned k = 0; k < j->m_cexs.size(); k += num_sks) {
+                    values.reset();
+                    for (unsigned l = 0; l < num_sks; l++) {
+                        expr * v = j->m_cexs.get(k + l);
+                        values.push_back(v ? tr(v) : 0);
+                    }
+                    if (!add_value_instance(q, values, true)) 
+                        break;
+                    num_new_instances++;
+                }
+                if (num_new_instances == 0) {
+                    values.reset();
+                    for (unsigned l = 0; l < num_sks; l++) {
+                        expr * v = j->m_complete_cex.get(l);
+                        values.push_back(v ? tr(v) : 0);
+                    }
+                    add_value_instance(q, values, false);
+                }
+            }
+            if (m_params.m_mbqi_trace || get_verbosity_level() >= 5) {
+                verbose_stream() << "(smt.mbqi :failed " << q->get_qid() << ")\n";
+            }
+            TRACE("model_checker", tout << "checking quantifier " << mk_pp(q, m) << " failed\n";);
+            num_failures++;
+        }
+        return num_failures;
+    }
+
     bool model_checker::check(proto_model * md, obj_map<enode, app *> const & root2value) {
         SASSERT(md != 0);
         m_root2value = &root2value;
@@ -390,9 +687,8 @@ namespace smt {
 
         init_aux_context();
 
-        bool found_relevant = false;
-        unsigned num_failures = 0;
-
+        ptr_vector<quantifier> qs;
+        unsigned num_non_rec = 0;
         for (; it != end; ++it) {
             quantifier * q = *it;
 	    if(!m_qm->mbqi_enabled(q)) continue;
@@ -401,10 +697,24 @@ namespace smt {
                   tout << m_context->get_assignment(q) << "\n";);
 
             if (m_context->is_relevant(q) && m_context->get_assignment(q) == l_true) {
+                qs.push_back(q);
+                if (!m.is_rec_fun_def(q))
+                    num_non_rec++;
+            }
+        }
+
+        bool found_relevant = !qs.empty();
+        unsigned num_failures = 0;
+
+        if (use_parallel_check(num_non_rec)) {
+            num_failures = check_parallel(qs);
+        }
+        else {
+            for (unsigned i = 0; i < qs.size(); ++i) {
+                quantifier * q = qs[i];
                 if (m_params.m_mbqi_trace && q->get_qid() != symbol::null) {
                     verbose_stream() << "(smt.mbqi :checking " << q->get_qid() << ")\n";
                 }
-                found_relevant = true;
                 if (m.is_rec_fun_def(q)) {
                     if (!check_rec_fun(q)) {
                         TRACE("model_checker", tout << "checking recursive function failed\n";);
@@ -26,6 +26,7 @@ Revision History:
 #include"qi_params.h"
 #include"smt_params.h"
 #include"region.h"
+#include"scoped_ptr_vector.h"
 
 class proto_model;
 class model;
@@ -35,6 +36,7 @@ namespace smt {
     class enode;
     class model_finder;
     class quantifier_manager;
+    class mbqi_worker;
 
     class model_checker {
         ast_manager &                               m; // _manager;
@@ -51,15 +53,19 @@ namespace smt {
         unsigned                                    m_iteration_idx;
         proto_model *                               m_curr_model;
         obj_map<expr, expr *>                       m_value2expr;
+        scoped_ptr_vector<mbqi_worker>              m_workers; // auxiliary contexts with their own managers for checking quantifiers concurrently.
         friend class instantiation_set;
 
         void init_aux_context();
         expr * get_term_from_ctx(expr * val);
-        void restrict_to_universe(expr * sk, obj_hashtable<expr> const & universe);
+        expr * mk_universe_restriction(expr * sk, obj_hashtable<expr> const & universe);
+        bool mk_neg_q_m(quantifier * q, expr_ref_vector & sks, expr_ref_vector & fmls);
         void assert_neg_q_m(quantifier * q, expr_ref_vector & sks);
         bool add_blocking_clause(model * cex, expr_ref_vector & sks);
         bool check(quantifier * q);
         bool check_rec_fun(quantifier* q);
+        bool use_parallel_check(unsigned num_quantifiers) const;
+        unsigned check_parallel(ptr_vector<quantifier> const & qs);
 
         struct instance {
             quantifier * m_q;
@@ -75,6 +81,7 @@ namespace smt {
         expr_ref_vector                            m_new_instances_bindings;
         ptr_vector<instance>                       m_new_instances;
         bool add_instance(quantifier * q, model * cex, expr_ref_vector & sks, bool use_inv);
+        bool add_value_instance(quantifier * q, expr_ref_vector const & sk_values, bool use_inv);
         void reset_new_instances();
         void assert_new_instances();
 
@@ -3561,6 +3561,17 @@ namespace smt {
        Return true if something was asserted.
     */
     bool model_finder::restrict_sks_to_inst_set(context * aux_ctx, quantifier * q, expr_ref_vector const & sks) {
+        expr_ref_vector cnstrs(m_manager);
+        restrict_sks_to_inst_set(q, sks, cnstrs);
+        for (unsigned i = 0; i < cnstrs.size(); ++i) 
+            aux_ctx->assert_expr(cnstrs.get(i));
+        return !cnstrs.empty();
+    }
+
+    /**
+       \brief Collect the constraints restricting the skolem constants sks of q to their instantiation sets.
+    */
+    bool model_finder::restrict_sks_to_inst_set(quantifier * q, expr_ref_vector const & sks, expr_ref_vector & cnstrs) {
         // Note: we currently add instances of q instead of flat_q.
         // If the user wants instances of flat_q, it should use PULL_NESTED_QUANTIFIERS=true. This option
         // will guarantee that q == flat_q.
@@ -3589,7 +3600,7 @@ namespace smt {
             expr_ref new_cnstr(m_manager);
             new_cnstr = m_manager.mk_or(eqs.size(), eqs.c_ptr());
             TRACE("model_finder", tout << "assert_restriction:\n" << mk_pp(new_cnstr, m_manager) << "\n";);
-            aux_ctx->assert_expr(new_cnstr);
+            cnstrs.push_back(new_cnstr);
             asserted_something = true;
         }
         return asserted_something;
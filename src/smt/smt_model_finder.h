@@ -121,6 +121,7 @@ namespace smt {
         quantifier * get_flat_quantifier(quantifier * q) const;
         expr * get_inv(quantifier * q, unsigned i, expr * val, unsigned & generation) const;
         bool restrict_sks_to_inst_set(context * aux_ctx, quantifier * q, expr_ref_vector const & sks);
+        bool restrict_sks_to_inst_set(quantifier * q, expr_ref_vector const & sks, expr_ref_vector & cnstrs);
 
         void restart_eh();
 
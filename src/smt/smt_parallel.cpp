@@ -0,0 +1,371 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    smt_parallel.cpp
+
+Abstract:
+
+    Parallel search for smt_context.
+
+    The context is copied into one context per thread, each with its own ast_manager.
+    The search proceeds in rounds. In every round each thread selects a cube
+    from the unassigned atoms with the highest activity, and solves the cube
+    with a bounded number of conflicts.
+    The first thread that finds a model, or a core that does not
+    depend on its cube, determines the result.
+    Otherwise, the negations of the refuted cubes, and the units and
+    equalities between constants that the threads learned at
+    base level are exchanged between the threads before the next round.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include"smt_context.h"
+#include"ast_translation.h"
+#include"ast_util.h"
+#include"for_each_expr.h"
+#include"scoped_ptr_vector.h"
+#include"s_rational.h"
+#include"z3_omp.h"
+
+namespace smt {
+
+    namespace {
+        /**
+           \brief State of a thread participating in parallel search.
+           The expressions are owned by the thread's ast_manager.
+        */
+        struct parallel_worker {
+            ast_manager &        m;
+            smt_params           m_params;
+            scoped_ptr<context>  m_ctx;
+            expr_ref_vector      m_asms;   // assumptions of the check, translated to m.
+            expr_ref_vector      m_cube;   // proxies of the current cube.
+            expr_ref_vector      m_pinned;
+            obj_map<expr, expr*> m_atom2proxy;
+            obj_map<expr, expr*> m_proxy2atom;
+            unsigned             m_units_lim;
+            lbool                m_result;
+
+            parallel_worker(ast_manager & m, smt_params const & p):
+                m(m), m_params(p), m_asms(m), m_cube(m), m_pinned(m), m_units_lim(0), m_result(l_undef) {}
+
+            /**
+               \brief Return the proxy assumption for the cube literal lit.
+            */
+            expr * mk_proxy(expr * lit) {
+                expr * atom = lit;
+                bool sign = m.is_not(lit, atom);
+                expr * p = 0;
+                if (!m_atom2proxy.find(atom, p)) {
+                    p = m.mk_fresh_const("cube", m.mk_bool_sort());
+                    m_pinned.push_back(p);
+                    m_pinned.push_back(atom);
+                    m_atom2proxy.insert(atom, p);
+                    m_proxy2atom.insert(p, atom);
+                    m_ctx->assert_expr(m.mk_eq(p, atom));
+                }
+                return sign ? m.mk_not(p) : p;
+            }
+
+            /**
+               \brief If e is a proxy literal, return the cube literal it stands for.
+            */
+            bool is_cube_lit(expr * e, expr_ref & lit) {
+                expr * p = e, * atom = 0;
+                bool sign = m.is_not(e, p);
+                if (!m_proxy2atom.find(p, atom))
+                    return false;
+                lit = sign ? m.mk_not(atom) : atom;
+                return true;
+            }
+
+            bool core_has_cube() {
+                expr_ref lit(m);
+                for (unsigned i = 0; i < m_ctx->get_unsat_core_size(); ++i) {
+                    if (is_cube_lit(m_ctx->get_unsat_core_expr(i), lit))
+                        return true;
+                }
+                return false;
+            }
+        };
+    };
+
+    bool context::use_parallel() const {
+        return
+            m_fparams.m_threads > 1 &&
+            m_base_lvl == 0 &&
+            !m_manager.proofs_enabled();
+    }
+
+    /**
+       \brief Retrieve a cube over the depth unassigned atoms with the highest activity.
+       The polarity of the i'th literal is the cached phase flipped by the i'th bit of idx,
+       so threads that agree on the atoms split the search space between them.
+    */
+    void context::get_parallel_cube(unsigned idx, unsigned depth, expr_ref_vector & cube) {
+        pop_to_base_lvl();
+        if (inconsistent())
+            return;
+        svector<std::pair<double, bool_var> > candidates;
+        for (bool_var v = 0; v < static_cast<bool_var>(get_num_bool_vars()); ++v) {
+            if (v != true_bool_var && get_assignment(v) == l_undef && bool_var2expr(v))
+                candidates.push_back(std::make_pair(-m_activity[v], v));
+        }
+        std::sort(candidates.begin(), candidates.end());
+        for (unsigned i = 0; i < candidates.size() && cube.size() < depth; ++i) {
+            bool_var v = candidates[i].second;
+            expr * e = bool_var2expr(v);
+            // atoms with skolem functions are local to this context.
+            if (has_skolem_functions(e))
+                continue;
+            bool_var_data const & d = get_bdata(v);
+            bool phase = d.m_phase_available && d.m_phase;
+            if ((idx >> cube.size()) & 1)
+                phase = !phase;
+            cube.push_back(phase ? e : m_manager.mk_not(e));
+        }
+    }
+
+    /**
+       \brief Retrieve the literals assigned at base level since position lim of the assignment stack,
+       and the equalities between constants and their roots.
+    */
+    void context::get_parallel_units(unsigned & lim, expr_ref_vector & units) {
+        pop_to_base_lvl();
+        if (inconsistent())
+            return;
+        for (; lim < m_assigned_literals.size(); ++lim) {
+            literal l = m_assigned_literals[lim];
+            expr * e = bool_var2expr(l.var());
+            if (l.var() == true_bool_var || !e || has_skolem_functions(e))
+                continue;
+            units.push_back(l.sign() ? m_manager.mk_not(e) : e);
+        }
+        ptr_vector<enode>::const_iterator it = begin_enodes(), end = end_enodes();
+        for (; it != end; ++it) {
+            enode * n = *it;
+            enode * r = n->get_root();
+            app * e = n->get_owner();
+            app * v = r->get_owner();
+            if (n != r && is_uninterp_const(e) && !m_manager.is_bool(e) &&
+                (is_uninterp_const(v) || m_manager.is_value(v)) &&
+                !e->get_decl()->is_skolem() && !v->get_decl()->is_skolem()) {
+                units.push_back(m_manager.mk_eq(e, v));
+            }
+        }
+    }
+
+    lbool context::check_parallel(unsigned num_assumptions, expr * const * assumptions) {
+        ast_manager & m = m_manager;
+        unsigned num_threads = m_fparams.m_threads;
+        unsigned depth = 0;
+        while ((1u << depth) < num_threads)
+            ++depth;
+        IF_VERBOSE(1, verbose_stream() << "(smt.parallel :threads " << num_threads << " :cube-depth " << depth << ")\n";);
+
+        // the contexts must be deleted before their managers.
+        scoped_ptr_vector<ast_manager>     pms;
+        scoped_ptr_vector<parallel_worker> ws;
+        scoped_limits sl(m.limit());
+        for (unsigned i = 0; i < num_threads; ++i) {
+            ast_manager * pm = alloc(ast_manager, m, true);
+            pms.push_back(pm);
+            parallel_worker * w = alloc(parallel_worker, *pm, m_fparams);
+            ws.push_back(w);
+            w->m_params.m_threads = 1;
+            w->m_params.m_random_seed = m_fparams.m_random_seed + i;
+            w->m_ctx = alloc(context, *pm, w->m_params, m_params);
+            copy(*this, *w->m_ctx);
+            sl.push_child(&pm->limit());
+            ast_translation tr(m, *pm);
+            for (unsigned j = 0; j < num_assumptions; ++j)
+                w->m_asms.push_back(tr(assumptions[j]));
+        }
+
+        obj_hashtable<expr> shared;      // facts that were already exchanged.
+        expr_ref_vector     facts(m);
+        unsigned_vector     fact_src;    // thread that produced the fact, UINT_MAX if all threads need it.
+        unsigned budget          = m_fparams.m_threads_max_conflicts;
+        uint64   total_conflicts = 0;
+        unsigned round           = 0;
+
+        while (true) {
+            ++round;
+            if (get_cancel_flag()) {
+                m_last_search_failure = CANCELED;
+                return l_undef;
+            }
+            for (unsigned i = 0; i < num_threads; ++i) {
+                parallel_worker & w = *ws[i];
+                expr_ref_vector lits(w.m);
+                w.m_cube.reset();
+                w.m_ctx->get_parallel_cube(i, depth, lits);
+                for (unsigned j = 0; j < lits.size(); ++j)
+                    w.m_cube.push_back(w.mk_proxy(lits.get(j)));
+            }
+
+            int finished_id = -1;
+            unsigned error_code = 0;
+            bool overflow = false;
+            std::string ex_msg;
+            int n = num_threads;
+            #pragma omp parallel for
+            for (int i = 0; i < n; ++i) {
+                parallel_worker & w = *ws[i];
+                try {
+                    w.m_params.m_max_conflicts = budget;
+                    expr_ref_vector asms(w.m_asms);
+                    asms.append(w.m_cube);
+                    lbool r = w.m_ctx->check(asms.size(), asms.c_ptr(), false);
+                    w.m_result = r;
+                    bool done =
+                        r == l_true ||
+                        (r == l_false && !w.core_has_cube()) ||
+                        (r == l_undef && w.m_ctx->get_last_search_failure() != NUM_CONFLICTS);
+                    if (done) {
+                        #pragma omp critical (smt_parallel)
+                        {
+                            if (finished_id == -1) {
+                                finished_id = i;
+                                for (int j = 0; j < n; ++j) {
+                                    if (i != j) pms[j]->limit().cancel();
+                                }
+                            }
+                        }
+                    }
+                }
+                catch (z3_error & err) {
+                    #pragma omp critical (smt_parallel)
+                    {
+                        error_code = err.error_code();
+                        for (int j = 0; j < n; ++j) {
+                            if (i != j) pms[j]->limit().cancel();
+                        }
+                    }
+                }
+                catch (s_rational::overflow_exception &) {
+                    #pragma omp critical (smt_parallel)
+                    {
+                        overflow = true;
+                        for (int j = 0; j < n; ++j) {
+                            if (i != j) pms[j]->limit().cancel();
+                        }
+                    }
+                }
+                catch (z3_exception & ex) {
+                    #pragma omp critical (smt_parallel)
+                    {
+                        ex_msg = ex.msg();
+                        for (int j = 0; j < n; ++j) {
+                            if (i != j) pms[j]->limit().cancel();
+                        }
+                    }
+                }
+            }
+            if (error_code != 0)
+                throw z3_error(error_code);
+            if (overflow)
+                throw s_rational::overflow_exception(); // smt::kernel redoes the check with rationals.
+            if (!ex_msg.empty())
+                throw default_exception(ex_msg);
+
+            if (finished_id != -1) {
+                parallel_worker & w = *ws[finished_id];
+                ast_translation tr(w.m, m);
+                IF_VERBOSE(1, verbose_stream() << "(smt.parallel :round " << round << " :thread " << finished_id << " :result " << w.m_result << ")\n";);
+                switch (w.m_result) {
+                case l_true: {
+                    model_ref mdl;
+                    w.m_ctx->get_model(mdl);
+                    if (mdl)
+                        m_model = mdl->translate(tr);
+                    m_last_search_failure = OK;
+                    break;
+                }
+                case l_false:
+                    m_unsat_core.reset();
+                    for (unsigned i = 0; i < w.m_ctx->get_unsat_core_size(); ++i)
+                        m_unsat_core.push_back(tr(w.m_ctx->get_unsat_core_expr(i)));
+                    m_last_search_failure = OK;
+                    break;
+                case l_undef:
+                    m_last_search_failure = w.m_ctx->get_last_search_failure();
+                    if (m_last_search_failure == THEORY || m_last_search_failure == QUANTIFIERS) {
+                        m_unknown = w.m_ctx->last_failure_as_string();
+                        m_last_search_failure = UNKNOWN;
+                    }
+                    else if (m_last_search_failure == UNKNOWN) {
+                        m_unknown = w.m_ctx->m_unknown;
+                    }
+                    break;
+                }
+                return w.m_result;
+            }
+
+            // exchange refuted cubes, units and equalities.
+            unsigned num_cubes = 0, num_units = 0;
+            unsigned max_conflicts = 0;
+            for (unsigned i = 0; i < num_threads; ++i) {
+                parallel_worker & w = *ws[i];
+                ast_translation tr(w.m, m);
+                max_conflicts = std::max(max_conflicts, w.m_ctx->m_num_conflicts);
+                if (w.m_result == l_false) {
+                    expr_ref_vector clause(w.m);
+                    expr_ref lit(w.m);
+                    for (unsigned j = 0; j < w.m_ctx->get_unsat_core_size(); ++j) {
+                        expr * c = w.m_ctx->get_unsat_core_expr(j);
+                        if (w.is_cube_lit(c, lit))
+                            clause.push_back(mk_not(w.m, lit));
+                        else
+                            clause.push_back(w.m.mk_not(c));
+                    }
+                    expr_ref fml(tr(mk_or(w.m, clause.size(), clause.c_ptr())), m);
+                    if (!shared.contains(fml)) {
+                        shared.insert(fml);
+                        facts.push_back(fml);
+                        fact_src.push_back(UINT_MAX);
+                        ++num_cubes;
+                    }
+                }
+                expr_ref_vector units(w.m);
+                w.m_ctx->get_parallel_units(w.m_units_lim, units);
+                for (unsigned j = 0; j < units.size(); ++j) {
+                    expr_ref u(tr(units.get(j)), m);
+                    if (!shared.contains(u)) {
+                        shared.insert(u);
+                        facts.push_back(u);
+                        fact_src.push_back(i);
+                        ++num_units;
+                    }
+                }
+            }
+            unsigned num_facts = facts.size() - num_cubes - num_units;
+            for (unsigned i = 0; i < num_threads; ++i) {
+                parallel_worker & w = *ws[i];
+                ast_translation tr(m, w.m);
+                for (unsigned j = num_facts; j < facts.size(); ++j) {
+                    if (fact_src[j] != i)
+                        w.m_ctx->assert_expr(tr(facts.get(j)));
+                }
+            }
+            IF_VERBOSE(1, verbose_stream() << "(smt.parallel :round " << round << " :conflicts " << budget
+                       << " :refuted-cubes " << num_cubes << " :units " << num_units << ")\n";);
+
+            total_conflicts += max_conflicts;
+            if (total_conflicts > m_fparams.m_max_conflicts) {
+                m_last_search_failure = NUM_CONFLICTS;
+                return l_undef;
+            }
+            if (budget < UINT_MAX / 2)
+                budget += budget / 2;
+        }
+    }
+
+};
@@ -90,7 +90,9 @@ namespace smt {
         void del(quantifier * q) {
             if (m_params.m_qi_profile) {
                 display_stats(verbose_stream(), q);
+                m_plugin->display_stats(verbose_stream(), q);
             }
+            m_plugin->del(q);
             m_quantifiers.pop_back();
             m_quantifier_stat.erase(q);
         }
@@ -132,7 +134,7 @@ namespace smt {
                         out << " #" << (*it)->get_owner_id();
                     out << "\n";
                 }
-                m_qi_queue.insert(f, pat, max_generation, min_top_generation, max_top_generation); // TODO
+                m_qi_queue.insert(f, pat, max_generation, min_top_generation, max_top_generation, used_enodes);
                 m_num_instances++;
             }
             TRACE("quantifier", 
@@ -380,9 +382,12 @@ namespace smt {
 
     void quantifier_manager::collect_statistics(::statistics & st) const {
         m_imp->m_qi_queue.collect_statistics(st);
+        m_imp->m_plugin->collect_statistics(st);
     }
 
     void quantifier_manager::reset_statistics() {
+        m_imp->m_qi_queue.reset_statistics();
+        m_imp->m_plugin->reset_statistics();
     }
 
     void quantifier_manager::display_stats(std::ostream & out, quantifier * q) const {
@@ -460,7 +465,25 @@ namespace smt {
             }
         }
 
-        virtual void del(quantifier * q) { }
+        virtual void del(quantifier * q) {
+            m_mam->del(q);
+            m_lazy_mam->del(q);
+        }
+
+        virtual void collect_statistics(::statistics & st) const {
+            m_mam->collect_statistics(st);
+            m_lazy_mam->collect_statistics(st);
+        }
+
+        virtual void reset_statistics() {
+            m_mam->reset_statistics();
+            m_lazy_mam->reset_statistics();
+        }
+
+        virtual void display_stats(std::ostream & out, quantifier * q) {
+            m_mam->display_stats(out, q);
+            m_lazy_mam->display_stats(out, q);
+        }
 
         virtual void push() {
             m_mam->push_scope();
@@ -165,7 +165,14 @@ namespace smt {
         virtual void push() = 0;
         virtual void pop(unsigned num_scopes) = 0;
 
-        
+        virtual void collect_statistics(::statistics & st) const {}
+
+        virtual void reset_statistics() {}
+
+        /**
+           \brief Display plugin specific statistics of q, it is invoked when q is deleted and qi.profile is set.
+        */
+        virtual void display_stats(std::ostream & out, quantifier * q) {}
 
     };
 };
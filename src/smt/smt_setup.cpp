@@ -40,7 +40,9 @@ namespace smt {
         m_context(c),
         m_manager(c.get_manager()),
         m_params(params),
-        m_already_configured(false) {
+        m_already_configured(false),
+        m_allow_fixnum(false),
+        m_uses_fixnum(false) {
     }
 
     void setup::operator()(config_mode cm) {
@@ -286,14 +288,8 @@ namespace smt {
         else {
             if (m_params.m_arith_auto_config_simplex || st.m_num_uninterpreted_constants > 4 * st.m_num_bool_constants 
                 || st.m_num_ite_terms > 0 /* theory_rdl and theory_frdl do not support ite-terms */) {
-                // if (!st.m_has_rational && !m_params.m_model && st.arith_k_sum_is_small()) {
-                //   TRACE("rdl_bug", tout << "using theory_smi_arith\n";);
-                //    m_context.register_plugin(alloc(smt::theory_smi_arith, m_manager, m_params));
-                // }
-                // else {
                 TRACE("rdl_bug", tout << "using theory_mi_arith\n";);
-                m_context.register_plugin(alloc(smt::theory_mi_arith, m_manager, m_params));
-                // }
+                setup_mi_arith(st);
             }
             else {
                 m_params.m_arith_bound_prop           = BP_NONE;
@@ -365,14 +361,8 @@ namespace smt {
 
         }
         else {
-            // if (st.arith_k_sum_is_small()) {
-            //    TRACE("setup", tout << "using small integer simplex...\n";);
-            //    m_context.register_plugin(alloc(smt::theory_si_arith, m_manager, m_params));
-            // }
-            // else {
-            TRACE("setup", tout << "using big integer simplex...\n";);
-            m_context.register_plugin(alloc(smt::theory_i_arith, m_manager, m_params));
-            // }
+            TRACE("setup", tout << "using simplex...\n";);
+            setup_i_arith(st);
         }
     }
 
@@ -462,7 +452,7 @@ namespace smt {
             m_params.m_restart_adaptive      = false;
         }
         m_params.m_arith_small_lemma_size = 32;
-        setup_mi_arith();
+        setup_mi_arith(st);
     }
 
     void setup::setup_QF_LIA() {
@@ -513,7 +503,7 @@ namespace smt {
             m_params.m_arith_bound_prop      = BP_NONE;
             m_params.m_arith_stronger_lemmas = false;
         }
-        setup_i_arith();
+        setup_i_arith(st);
     }
 
     void setup::setup_QF_UFLIA() {
@@ -717,6 +707,37 @@ namespace smt {
         }
     }
 
+    /**
+       \brief Use the simplex over 64-bit numerals when enabled and the constants are small.
+       smt::kernel falls back to rationals if the numerals overflow during the search,
+       other owners of a context do not allow them.
+    */
+    bool setup::use_fixnum_arith(static_features const & st) const {
+        return m_allow_fixnum && m_params.m_arith_fixnum && st.arith_k_sum_is_small() && !m_manager.proofs_enabled();
+    }
+
+    void setup::setup_i_arith(static_features const & st) {
+        if (use_fixnum_arith(st)) {
+            TRACE("setup", tout << "using fixnum simplex\n";);
+            m_uses_fixnum = true;
+            m_context.register_plugin(alloc(smt::theory_fi_arith, m_manager, m_params));
+        }
+        else {
+            setup_i_arith();
+        }
+    }
+
+    void setup::setup_mi_arith(static_features const & st) {
+        if (m_params.m_arith_mode != AS_OPTINF && use_fixnum_arith(st)) {
+            TRACE("setup", tout << "using fixnum simplex\n";);
+            m_uses_fixnum = true;
+            m_context.register_plugin(alloc(smt::theory_fmi_arith, m_manager, m_params));
+        }
+        else {
+            setup_mi_arith();
+        }
+    }
+
     void setup::setup_arith() {
         static_features    st(m_manager);
         IF_VERBOSE(100, verbose_stream() << "(smt.collecting-features)\n";);
@@ -770,9 +791,9 @@ namespace smt {
             break;
         default:
             if (m_params.m_arith_int_only && int_only)
-                m_context.register_plugin(alloc(smt::theory_i_arith, m_manager, m_params));
+                setup_i_arith(st);
             else
-                m_context.register_plugin(alloc(smt::theory_mi_arith, m_manager, m_params));
+                setup_mi_arith(st);
             break;
         }
     }
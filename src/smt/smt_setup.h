@@ -45,6 +45,8 @@ namespace smt {
         smt_params &       m_params;
         symbol             m_logic;
         bool               m_already_configured;
+        bool               m_allow_fixnum;
+        bool               m_uses_fixnum;
         void setup_auto_config();
         void setup_default();
         //
@@ -97,6 +99,9 @@ namespace smt {
         void setup_card();
         void setup_i_arith();
         void setup_mi_arith();
+        bool use_fixnum_arith(static_features const & st) const;
+        void setup_i_arith(static_features const & st);
+        void setup_mi_arith(static_features const & st);
         void setup_fpa();
 
     public:
@@ -110,6 +115,8 @@ namespace smt {
             return true;
         }
         symbol const & get_logic() const { return m_logic; }
+        void allow_fixnum_arith(bool f) { m_allow_fixnum = f; }
+        bool uses_fixnum_arith() const { return m_uses_fixnum; }
         void operator()(config_mode cm);
     };
 };
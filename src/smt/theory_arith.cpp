@@ -23,6 +23,8 @@ namespace smt {
 
     template class theory_arith<mi_ext>;
     template class theory_arith<i_ext>;
+    template class theory_arith<fi_ext>;
+    template class theory_arith<fmi_ext>;
     // template class theory_arith<si_ext>;
     // template class theory_arith<smi_ext>;
 
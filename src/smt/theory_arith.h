@@ -27,6 +27,7 @@ Revision History:
 #include"inf_rational.h"
 #include"s_integer.h"
 #include"inf_s_integer.h"
+#include"inf_s_rational.h"
 #include"arith_decl_plugin.h"
 #include"theory_arith_params.h"
 #include"arith_eq_adapter.h"
@@ -38,6 +39,7 @@ Revision History:
 #include"arith_eq_solver.h"
 #include"theory_opt.h"
 #include"uint_set.h"
+#include"fp_simplex.h"
 
 namespace smt {
     
@@ -48,6 +50,7 @@ namespace smt {
         unsigned m_max_min; 
         unsigned m_gb_simplify, m_gb_superpose, m_gb_compute_basis, m_gb_num_processed;
         unsigned m_nl_branching, m_nl_linear, m_nl_bounds, m_nl_cross_nested;
+        unsigned m_fp_repairs, m_fp_repair_pivots, m_fp_fallbacks;
 
         void reset() { memset(this, 0, sizeof(theory_arith_stats)); }
         theory_arith_stats() { reset(); }
@@ -456,6 +459,8 @@ namespace smt {
         var_heap                m_to_patch;         // heap containing all variables v s.t. m_value[v] does not satisfy bounds of v.
         nat_set                 m_left_basis;       // temporary: set of variables that already left the basis in make_feasible
         bool                    m_blands_rule;
+        simplex::fp_simplex     m_fp_simplex;       // floating point simplex used to find a feasible basis in make_feasible
+        unsigned                m_fp_threshold;     // number of pivots in make_feasible before m_fp_simplex is used
 
         svector<unsigned>       m_update_trail_stack;    // temporary trail stack used to restore the last feasible assignment.
         nat_set                 m_in_update_trail_stack; // set of variables in m_update_trail_stack
@@ -757,6 +762,8 @@ namespace smt {
         //
         // -----------------------------------
         bool make_var_feasible(theory_var x_i);
+        void fp_make_feasible();
+        double to_double(inf_numeral const & n) const { return n.get_rational().to_rational().get_double(); }
         theory_var select_var_to_fix();
         theory_var select_lg_error_var(bool least);
         theory_var select_greatest_error_var() { return select_lg_error_var(false); }
@@ -1229,6 +1236,49 @@ namespace smt {
         smi_ext() : m_int_epsilon(s_integer(1)), m_real_epsilon(s_integer(0), true) {}
     };
 
+    /**
+       \brief Fixnum counterparts of i_ext and mi_ext.
+       The numerals throw s_rational::overflow_exception when a value does
+       not fit in 64 bits, smt::kernel then redoes the check using rationals.
+    */
+    class fi_ext {
+    public:
+        typedef s_rational numeral;
+        typedef s_rational inf_numeral;
+        numeral m_int_epsilon;
+        numeral m_real_epsilon;
+        static numeral fractional_part(numeral const & n) {
+            return n - floor(n);
+        }
+        static inf_numeral mk_inf_numeral(numeral const& n, numeral const& i) {
+            UNREACHABLE();
+            return inf_numeral(n);
+        }
+        static bool is_infinite(inf_numeral const& ) { return false; }
+
+        fi_ext() : m_int_epsilon(1), m_real_epsilon(1) {}
+    };
+
+    class fmi_ext {
+    public:
+        typedef s_rational     numeral;
+        typedef inf_s_rational inf_numeral;
+        inf_numeral   m_int_epsilon;
+        inf_numeral   m_real_epsilon;
+        numeral fractional_part(inf_numeral const& n) {
+            SASSERT(n.is_rational());
+            return n.get_rational() - floor(n);
+        }
+        static numeral fractional_part(numeral const & n) {
+            return n - floor(n);
+        }
+        static inf_numeral mk_inf_numeral(numeral const & n, numeral const & r) {
+            return inf_numeral(n, r);
+        }
+        static bool is_infinite(inf_numeral const& ) { return false; }
+        fmi_ext() : m_int_epsilon(s_rational(1)), m_real_epsilon(s_rational(0), true) {}
+    };
+
     class inf_ext {
     public:
         typedef rational     numeral;
@@ -1256,6 +1306,8 @@ namespace smt {
     typedef theory_arith<mi_ext> theory_mi_arith;
     typedef theory_arith<i_ext> theory_i_arith;
     typedef smt::theory_arith<inf_ext> theory_inf_arith;
+    typedef theory_arith<fi_ext> theory_fi_arith;
+    typedef theory_arith<fmi_ext> theory_fmi_arith;
     // typedef theory_arith<si_ext> theory_si_arith;
     // typedef theory_arith<smi_ext> theory_smi_arith;
 
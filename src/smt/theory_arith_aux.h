@@ -1047,9 +1047,29 @@ namespace smt {
         return v;
     }
 
+    inline inf_eps_rational<inf_rational> to_inf_eps(rational const & r) {
+        return inf_eps_rational<inf_rational>(r);
+    }
+
+    inline inf_eps_rational<inf_rational> to_inf_eps(inf_rational const & r) {
+        return inf_eps_rational<inf_rational>(r);
+    }
+
+    inline inf_eps_rational<inf_rational> to_inf_eps(inf_eps_rational<inf_rational> const & r) {
+        return r;
+    }
+
+    inline inf_eps_rational<inf_rational> to_inf_eps(s_rational const & r) {
+        return inf_eps_rational<inf_rational>(r.to_rational());
+    }
+
+    inline inf_eps_rational<inf_rational> to_inf_eps(inf_s_rational const & r) {
+        return inf_eps_rational<inf_rational>(inf_rational(r.get_rational().to_rational(), r.get_infinitesimal().to_rational()));
+    }
+
     template<typename Ext>
     inf_eps_rational<inf_rational> theory_arith<Ext>::value(theory_var v) {
-        return inf_eps_rational<inf_rational>(get_value(v));
+        return to_inf_eps(get_value(v));
     }
 
     template<typename Ext>
@@ -1059,7 +1079,7 @@ namespace smt {
         if (!m_nl_monomials.empty()) {
             has_shared = true;
             blocker = mk_gt(v);
-            return inf_eps_rational<inf_rational>(get_value(v));            
+            return to_inf_eps(get_value(v));            
         }
         max_min_t r = max_min(v, true, true, has_shared); 
         if (r == UNBOUNDED) {
@@ -1069,7 +1089,7 @@ namespace smt {
         }
         else {
             blocker = mk_gt(v);
-            return inf_eps_rational<inf_rational>(get_value(v));
+            return to_inf_eps(get_value(v));
         }
         
     }
@@ -1085,7 +1105,7 @@ namespace smt {
         inf_numeral const& val = get_value(v);
         expr* obj = get_enode(v)->get_owner();
         expr_ref e(m);
-        rational r = val.get_rational();
+        rational r = val.get_rational().to_rational();
         if (m_util.is_int(m.get_sort(obj))) {
             if (r.is_int()) {
                 r += rational::one();
@@ -1267,7 +1287,7 @@ namespace smt {
         if (m_upper_bound < q) {
             m_upper_bound = q;
             if (strict) {
-                m_upper_bound -= get_epsilon(a->get_var());
+                m_upper_bound -= to_inf_eps(get_epsilon(a->get_var()));
             }
             IF_VERBOSE(1, verbose_stream() << "new upper bound: " << m_upper_bound << "\n";);
         }
@@ -1660,6 +1660,7 @@ namespace smt {
         m_row_vars_top(0),
         m_to_patch(1024),
         m_blands_rule(false),
+        m_fp_threshold(params.m_arith_fp_simplex_threshold),
         m_random(params.m_arith_random_seed),
         m_num_conflicts(0),
         m_branch_cut_counter(0),
@@ -2273,7 +2274,17 @@ namespace smt {
         m_left_basis.reset();
         m_blands_rule    = false;
         unsigned num_repeated = 0;
+        unsigned num_pivots   = 0;
         while (!m_to_patch.empty()) {
+            if (m_params.m_arith_fp_simplex && ++num_pivots == m_fp_threshold) {
+                fp_make_feasible();
+                if (m_to_patch.empty()) 
+                    break;
+            }
+            else if (m_params.m_arith_fp_simplex && num_pivots == 2 * m_fp_threshold) {
+                // the floating point basis did not save pivots, try it less often.
+                m_fp_threshold *= 2;
+            }
             theory_var v = select_var_to_fix();
             if (v == null_theory_var) {
                 // all variables were satisfied...
@@ -2310,6 +2321,108 @@ namespace smt {
         return true;
     }
 
+    /**
+       \brief Solve the bounds in floating point, and move the tableau to the
+       basis found by the floating point simplex.
+
+       The floating point solution is only used as a hint: the exact
+       values are obtained by pivoting the exact tableau to the same basis,
+       and assigning the non-base variables to the bounds they have in the
+       floating point solution. Base variables that are not (exactly) within
+       their bounds are added to m_to_patch, and make_feasible continues
+       with exact pivoting from there.
+       Infinitesimals are ignored in the floating point problem, and
+       it is only used for real arithmetic.
+    */
+    template<typename Ext>
+    void theory_arith<Ext>::fp_make_feasible() {
+        int num_vars = get_num_vars();
+        m_fp_simplex.reset(num_vars);
+        for (theory_var v = 0; v < num_vars; ++v) {
+            if (is_quasi_base(v) || is_int(v)) 
+                return;
+            m_fp_simplex.set_value(v, to_double(m_value[v]));
+            if (lower(v)) m_fp_simplex.set_lower(v, to_double(lower(v)->get_value()));
+            if (upper(v)) m_fp_simplex.set_upper(v, to_double(upper(v)->get_value()));
+        }
+        unsigned_vector vars;
+        svector<double> coeffs;
+        unsigned num_entries = 0;
+        typename vector<row>::const_iterator it  = m_rows.begin();
+        typename vector<row>::const_iterator end = m_rows.end();
+        for (; it != end; ++it) {
+            theory_var x_b = it->get_base_var();
+            if (x_b == null_theory_var) 
+                continue;
+            vars.reset();
+            coeffs.reset();
+            typename vector<row_entry>::const_iterator it2  = it->begin_entries();
+            typename vector<row_entry>::const_iterator end2 = it->end_entries();
+            for (; it2 != end2; ++it2) {
+                if (!it2->is_dead() && it2->m_var != x_b) {
+                    // x_b + sum a_k x_k = 0
+                    vars.push_back(it2->m_var);
+                    coeffs.push_back(-it2->m_coeff.to_rational().get_double());
+                }
+            }
+            m_fp_simplex.add_row(x_b, vars.size(), vars.c_ptr(), coeffs.c_ptr());
+            num_entries += vars.size();
+        }
+        // When the floating point simplex finds an infeasible row, the same basis is used,
+        // and the exact simplex produces the conflict.
+        // The exact tableau has (roughly) the same non-zeros as the floating point tableau,
+        // so don't move to a basis that makes the tableau denser.
+        lbool is_sat = m_fp_simplex.make_feasible(10 * m_rows.size() + 1000);
+        if (is_sat == l_undef || m_fp_simplex.get_num_entries() > 2 * num_entries) {
+            m_stats.m_fp_fallbacks++;
+            return;
+        }
+        m_stats.m_fp_repairs++;
+        // pivot the exact tableau to the floating point basis.
+        for (unsigned r_id = 0; r_id < m_rows.size(); ++r_id) {
+            row & r = m_rows[r_id];
+            theory_var x_i = r.get_base_var();
+            if (x_i == null_theory_var || m_fp_simplex.is_base(x_i)) 
+                continue;
+            theory_var x_j = null_theory_var;
+            numeral a_ij;
+            typename vector<row_entry>::const_iterator it2  = r.begin_entries();
+            typename vector<row_entry>::const_iterator end2 = r.end_entries();
+            for (; it2 != end2; ++it2) {
+                if (!it2->is_dead() && is_non_base(it2->m_var) && m_fp_simplex.is_base(it2->m_var)) {
+                    x_j  = it2->m_var;
+                    a_ij = it2->m_coeff;
+                    break;
+                }
+            }
+            if (x_j != null_theory_var) {
+                m_stats.m_fp_repair_pivots++;
+                pivot<true>(x_i, x_j, a_ij, m_eager_gcd);
+            }
+        }
+        // move the non-base variables to the bounds of the floating point solution.
+        for (theory_var v = 0; v < num_vars; ++v) {
+            if (!is_non_base(v)) 
+                continue;
+            bound * b = 0;
+            if (below_lower(v) || m_fp_simplex.at_lower(v)) 
+                b = lower(v);
+            else if (above_upper(v) || m_fp_simplex.at_upper(v)) 
+                b = upper(v);
+            if (b && b->get_value() != m_value[v]) 
+                set_value(v, b->get_value());
+        }
+        m_to_patch.reset();
+        for (theory_var v = 0; v < num_vars; ++v) {
+            if (is_base(v) && (below_lower(v) || above_upper(v))) 
+                m_to_patch.insert(v);
+        }
+        TRACE("arith_fp", tout << "moved to fp basis\n"; display(tout););
+        CASSERT("arith", wf_rows());
+        CASSERT("arith", wf_columns());
+        CASSERT("arith", valid_row_assignment());
+    }
+
     /**
        \brief A row is in a sign inconsistency when it is implying a
        lower (upper) bound on x_i, which is above (below) its known
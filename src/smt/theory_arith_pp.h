@@ -43,6 +43,12 @@ namespace smt {
         st.update("arith pseudo nonlinear", m_stats.m_nl_linear);
         st.update("arith nonlinear bounds", m_stats.m_nl_bounds);
         st.update("arith nonlinear horner", m_stats.m_nl_cross_nested);
+        if (m_params.m_arith_fp_simplex) {
+            st.update("arith fp repairs", m_stats.m_fp_repairs);
+            st.update("arith fp repair pivots", m_stats.m_fp_repair_pivots);
+            st.update("arith fp fallbacks", m_stats.m_fp_fallbacks);
+            m_fp_simplex.collect_statistics(st);
+        }
         m_arith_eq_adapter.collect_statistics(st);
     }
 
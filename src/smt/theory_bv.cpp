@@ -37,6 +37,8 @@ namespace smt {
         m_bits.push_back(literal_vector());
         m_wpos.push_back(0);
         m_zero_one_bits.push_back(zero_one_bits());
+        m_lazy_lemmas.push_back(0);
+        m_lazy_blasted.push_back(false);
         get_context().attach_th_var(n, this, r);
         return r;
     }
@@ -838,12 +840,284 @@ namespace smt {
         find_wpos(v);
     }
 
+    // -----------------------------------
+    //
+    // Lazy bit-blasting
+    //
+    // Multipliers and dividers are internalized as fresh bits, i.e., as uninterpreted
+    // functions of their arguments; congruence takes care of equalities between them.
+    // In final check, the value of the bits of each term is compared with the
+    // value computed from the bits of the arguments. A violated term gets
+    // a lemma that fixes its value for the current values of the arguments,
+    // and the circuit is created after a few of these lemmas.
+    //
+    // -----------------------------------
+
+    bool theory_bv::is_lazy_term(app * n) const {
+        if (!m_params.m_bv_lazy || get_bv_size(n) < m_params.m_bv_lazy_min_size) 
+            return false;
+        switch (n->get_decl_kind()) {
+        case OP_BMUL:
+            // multiplication by a constant is just a sequence of adders.
+            for (unsigned i = 0; i < n->get_num_args(); ++i) {
+                if (m_util.is_numeral(n->get_arg(i))) 
+                    return false;
+            }
+            return true;
+        case OP_BUDIV_I:
+        case OP_BUREM_I:
+        case OP_BSDIV_I:
+        case OP_BSREM_I:
+        case OP_BSMOD_I:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void theory_bv::internalize_lazy(app * n) {
+        SASSERT(!get_context().e_internalized(n));
+        process_args(n);
+        enode * e    = mk_enode(n);
+        theory_var v = e->get_th_var(get_id());
+        for (unsigned i = 0; i < n->get_num_args(); ++i) 
+            get_arg_var(e, i);
+        mk_bits(v);
+        m_lazy_vars.push_back(v);
+        m_trail_stack.push(push_back_trail<theory_bv, theory_var, false>(m_lazy_vars));
+    }
+
+    /**
+       \brief Compute the value of the lazy term v from the values of its arguments.
+       Return false if an argument is not assigned.
+    */
+    bool theory_bv::get_lazy_value(theory_var v, numeral & result) const {
+        context & ctx = get_context();
+        app * n       = get_enode(v)->get_owner();
+        unsigned sz   = get_bv_size(n);
+        numeral pw    = m_bb.power(sz);
+        numeral a, b;
+        if (!get_fixed_value(ctx.get_enode(n->get_arg(0))->get_th_var(get_id()), a)) 
+            return false;
+        if (n->get_decl_kind() == OP_BMUL) {
+            for (unsigned i = 1; i < n->get_num_args(); ++i) {
+                if (!get_fixed_value(ctx.get_enode(n->get_arg(i))->get_th_var(get_id()), b)) 
+                    return false;
+                a = mod(a * b, pw);
+            }
+            result = a;
+            return true;
+        }
+        if (!get_fixed_value(ctx.get_enode(n->get_arg(1))->get_th_var(get_id()), b)) 
+            return false;
+        numeral half = m_bb.power(sz - 1);
+        numeral sa = a >= half ? a - pw : a;
+        numeral sb = b >= half ? b - pw : b;
+        if (b.is_zero()) {
+            // follow the circuits of the bit-blaster: x/0 = -1 (1 if x is negative), x%0 = x.
+            switch (n->get_decl_kind()) {
+            case OP_BUDIV_I: result = pw - numeral(1); break;
+            case OP_BSDIV_I: result = sa.is_neg() ? numeral(1) : pw - numeral(1); break;
+            default:         result = a; break;
+            }
+            return true;
+        }
+        switch (n->get_decl_kind()) {
+        case OP_BUDIV_I:
+            result = div(a, b);
+            break;
+        case OP_BUREM_I:
+            result = mod(a, b);
+            break;
+        case OP_BSDIV_I: {
+            // truncate towards zero
+            result = div(abs(sa), abs(sb));
+            if (sa.is_neg() != sb.is_neg()) 
+                result.neg();
+            break;
+        }
+        case OP_BSREM_I: {
+            // the sign follows the dividend
+            result = mod(abs(sa), abs(sb));
+            if (sa.is_neg()) 
+                result.neg();
+            break;
+        }
+        case OP_BSMOD_I: {
+            // the sign follows the divisor
+            result = mod(abs(sa), abs(sb));
+            if (!result.is_zero() && sa.is_neg() != sb.is_neg()) 
+                result = abs(sb) - result;
+            if (sb.is_neg()) 
+                result.neg();
+            break;
+        }
+        default:
+            UNREACHABLE();
+            return false;
+        }
+        result = mod(result, pw);
+        return true;
+    }
+
+    void theory_bv::mk_lazy_circuit(theory_var v, expr_ref_vector & bits) {
+        ast_manager & m = get_manager();
+        enode * e       = get_enode(v);
+        app * n         = e->get_owner();
+        expr_ref_vector arg1_bits(m), arg2_bits(m);
+        if (n->get_decl_kind() == OP_BMUL) {
+            unsigned i = n->get_num_args() - 1;
+            get_arg_bits(e, i, bits);
+            while (i > 0) {
+                --i;
+                arg1_bits.reset();
+                arg2_bits.reset();
+                get_arg_bits(e, i, arg1_bits);
+                m_bb.mk_multiplier(arg1_bits.size(), arg1_bits.c_ptr(), bits.c_ptr(), arg2_bits);
+                bits.swap(arg2_bits);
+            }
+            return;
+        }
+        get_arg_bits(e, 0, arg1_bits);
+        get_arg_bits(e, 1, arg2_bits);
+        unsigned sz = arg1_bits.size();
+        switch (n->get_decl_kind()) {
+        case OP_BUDIV_I: m_bb.mk_udiv(sz, arg1_bits.c_ptr(), arg2_bits.c_ptr(), bits); break;
+        case OP_BUREM_I: m_bb.mk_urem(sz, arg1_bits.c_ptr(), arg2_bits.c_ptr(), bits); break;
+        case OP_BSDIV_I: m_bb.mk_sdiv(sz, arg1_bits.c_ptr(), arg2_bits.c_ptr(), bits); break;
+        case OP_BSREM_I: m_bb.mk_srem(sz, arg1_bits.c_ptr(), arg2_bits.c_ptr(), bits); break;
+        case OP_BSMOD_I: m_bb.mk_smod(sz, arg1_bits.c_ptr(), arg2_bits.c_ptr(), bits); break;
+        default: UNREACHABLE();
+        }
+    }
+
+    /**
+       \brief Lemmas survive backtracking, the atoms of the circuits are re-internalized when needed.
+       They may be garbage collected, so the lazy terms are checked again in final check.
+    */
+    void theory_bv::mk_lazy_lemma(unsigned num_lits, literal * lits) {
+        context & ctx      = get_context();
+        justification * js = 0;
+        if (get_manager().proofs_enabled()) {
+            js = alloc(theory_lemma_justification, get_id(), ctx, num_lits, lits);
+        }
+        ctx.mk_clause(num_lits, lits, js, CLS_AUX_LEMMA, 0);
+    }
+
+    /**
+       \brief Create the circuit of the lazy term v, and make its outputs equal to the bits of v.
+       The circuit is an axiom of the current scope, it is not garbage collected.
+    */
+    void theory_bv::blast_lazy(theory_var v) {
+        TRACE("bv_lazy", tout << "blast v" << v << " " << mk_bounded_pp(get_enode(v)->get_owner(), get_manager()) << "\n";);
+        m_stats.m_num_lazy_blasts++;
+        m_trail_stack.push(vector_value_trail<theory_bv, bool, false>(m_lazy_blasted, v));
+        m_lazy_blasted[v] = true;
+        context & ctx = get_context();
+        expr_ref_vector bits(get_manager());
+        mk_lazy_circuit(v, bits);
+        literal_vector const & v_bits = m_bits[v];
+        SASSERT(bits.size() == v_bits.size());
+        for (unsigned i = 0; i < bits.size(); ++i) {
+            ctx.internalize(bits.get(i), true);
+            literal l = ctx.get_literal(bits.get(i));
+            ctx.mark_as_relevant(l);
+            ctx.mk_th_axiom(get_id(), ~l, v_bits[i]);
+            ctx.mk_th_axiom(get_id(), l, ~v_bits[i]);
+        }
+    }
+
+    /**
+       \brief Add the lemmas: values of the arguments of v => v[i] = val[i]
+    */
+    void theory_bv::mk_lazy_value_lemma(theory_var v, numeral const & val) {
+        m_stats.m_num_lazy_lemmas++;
+        m_lazy_lemmas[v]++;
+        context & ctx = get_context();
+        app * n       = get_enode(v)->get_owner();
+        literal_vector lits;
+        for (unsigned i = 0; i < n->get_num_args(); ++i) {
+            literal_vector const & bits = m_bits[ctx.get_enode(n->get_arg(i))->get_th_var(get_id())];
+            for (unsigned j = 0; j < bits.size(); ++j) {
+                literal l = bits[j];
+                if (l == true_literal || l == false_literal) 
+                    continue;
+                lits.push_back(ctx.get_assignment(l) == l_true ? ~l : l);
+            }
+        }
+        literal_vector const & v_bits = m_bits[v];
+        numeral bit;
+        for (unsigned i = 0; i < v_bits.size(); ++i) {
+            div(val, m_bb.power(i), bit);
+            lits.push_back(mod(bit, numeral(2)).is_zero() ? ~v_bits[i] : v_bits[i]);
+            mk_lazy_lemma(lits.size(), lits.c_ptr());
+            lits.pop_back();
+        }
+    }
+
+    /**
+       \brief Mark the unassigned bits of the arguments of the lazy term v as relevant,
+       such that the search assigns them. Return true if there are such bits.
+    */
+    bool theory_bv::mark_lazy_args_relevant(theory_var v) {
+        context & ctx = get_context();
+        app * n       = get_enode(v)->get_owner();
+        bool found    = false;
+        for (unsigned i = 0; i < n->get_num_args(); ++i) {
+            literal_vector const & bits = m_bits[ctx.get_enode(n->get_arg(i))->get_th_var(get_id())];
+            for (unsigned j = 0; j < bits.size(); ++j) {
+                if (ctx.get_assignment(bits[j]) == l_undef) {
+                    ctx.mark_as_relevant(bits[j]);
+                    found = true;
+                }
+            }
+        }
+        return found;
+    }
+
+    /**
+       \brief Return true if the values of all relevant lazy terms agree with the values of their arguments.
+       Otherwise, add lemmas or circuits for the violated terms.
+       A term whose arguments are not assigned is checked once the search assigned them.
+       The circuit of a blasted term is removed with the scope of its atoms, so the term is
+       checked again after backtracking.
+    */
+    bool theory_bv::check_lazy_terms() {
+        context & ctx = get_context();
+        bool ok       = true;
+        numeral expected, actual;
+        for (unsigned i = 0; i < m_lazy_vars.size(); ++i) {
+            theory_var v = m_lazy_vars[i];
+            if (m_lazy_blasted[v] || !ctx.is_relevant(get_enode(v))) 
+                continue;
+            if (!get_lazy_value(v, expected)) {
+                if (mark_lazy_args_relevant(v))
+                    ok = false;
+                continue;
+            }
+            if (get_fixed_value(v, actual) && expected == actual) 
+                continue;
+            TRACE("bv_lazy", tout << "v" << v << " " << mk_bounded_pp(get_enode(v)->get_owner(), get_manager()) 
+                  << " expected: " << expected << " actual: " << actual << "\n";);
+            ok = false;
+            if (m_lazy_lemmas[v] < max_lazy_lemmas) 
+                mk_lazy_value_lemma(v, expected);
+            else 
+                blast_lazy(v);
+        }
+        return ok;
+    }
+
     bool theory_bv::internalize_term(app * term) {
         SASSERT(term->get_family_id() == get_family_id());
         TRACE("bv", tout << "internalizing term: " << mk_bounded_pp(term, get_manager()) << "\n";);
         if (approximate_term(term)) {
             return false;
         }
+        if (is_lazy_term(term)) {
+            internalize_lazy(term);
+            return true;
+        }
         switch (term->get_decl_kind()) {
         case OP_BV_NUM:         internalize_num(term); return true;
         case OP_BADD:           internalize_add(term); return true;
@@ -1311,11 +1585,16 @@ namespace smt {
         m_bits.shrink(num_old_vars);
         m_wpos.shrink(num_old_vars);
         m_zero_one_bits.shrink(num_old_vars);
+        m_lazy_lemmas.shrink(num_old_vars);
+        m_lazy_blasted.shrink(num_old_vars);
         theory::pop_scope_eh(num_scopes);
     }
 
     final_check_status theory_bv::final_check_eh() {
         SASSERT(check_invariant());
+        if (!check_lazy_terms()) {
+            return FC_CONTINUE;
+        }
         if (m_approximates_large_bvs) {
             return FC_GIVEUP;
         }
@@ -1326,6 +1605,7 @@ namespace smt {
         pop_scope_eh(m_trail_stack.get_num_scopes());
         m_bool_var2atom.reset();
         m_fixed_var_table.reset();
+        m_lazy_vars.reset();
         theory::reset_eh();
     }
 
@@ -1649,6 +1929,10 @@ namespace smt {
         st.update("bv bit2core", m_stats.m_num_bit2core);
         st.update("bv->core eq", m_stats.m_num_th2core_eq);
         st.update("bv dynamic eqs", m_stats.m_num_eq_dynamic);
+        if (m_params.m_bv_lazy) {
+            st.update("bv lazy lemmas", m_stats.m_num_lazy_lemmas);
+            st.update("bv lazy blasts", m_stats.m_num_lazy_blasts);
+        }
     }
 
 #ifdef Z3DEBUG
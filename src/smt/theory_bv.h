@@ -35,6 +35,7 @@ namespace smt {
     struct theory_bv_stats {
         unsigned   m_num_diseq_static, m_num_diseq_dynamic, m_num_bit2core, m_num_th2core_eq, m_num_conflicts;
         unsigned   m_num_eq_dynamic;
+        unsigned   m_num_lazy_lemmas, m_num_lazy_blasts;
         void reset() { memset(this, 0, sizeof(theory_bv_stats)); }
         theory_bv_stats() { reset(); }
     };
@@ -132,6 +133,12 @@ namespace smt {
         svector<var_pos>         m_prop_queue;
         bool                     m_approximates_large_bvs;
 
+        // lazy bit-blasting of multipliers and dividers (m_params.m_bv_lazy)
+        static const unsigned    max_lazy_lemmas = 4; // value lemmas for a term before its circuit is created.
+        svector<theory_var>      m_lazy_vars;      // variables of terms whose circuit is created on demand.
+        svector<unsigned>        m_lazy_lemmas;    // per var, number of value lemmas added for the term.
+        svector<bool>            m_lazy_blasted;   // per var, the circuit of the term was created.
+
         theory_var find(theory_var v) const { return m_find.find(v); }
         theory_var next(theory_var v) const { return m_find.next(v); }
         bool is_root(theory_var v) const { return m_find.is_root(v); }
@@ -208,6 +215,16 @@ namespace smt {
 
         bool approximate_term(app* n);
 
+        bool is_lazy_term(app * n) const;
+        void internalize_lazy(app * n);
+        bool get_lazy_value(theory_var v, numeral & result) const;
+        void mk_lazy_circuit(theory_var v, expr_ref_vector & bits);
+        void mk_lazy_lemma(unsigned num_lits, literal * lits);
+        void blast_lazy(theory_var v);
+        void mk_lazy_value_lemma(theory_var v, numeral const & val);
+        bool mark_lazy_args_relevant(theory_var v);
+        bool check_lazy_terms();
+
         template<bool Signed>
         void internalize_le(app * atom);
         bool internalize_xor3(app * n, bool gate_ctx);
@@ -21,7 +21,7 @@ Notes:
 #include"cancel_eh.h"
 #include"cooperate.h"
 #include"scoped_ptr_vector.h"
-#include"z3_omp.h"
+#include"thread_pool.h"
 
 class binary_tactical : public tactic {
 protected:
@@ -459,115 +459,161 @@ enum par_exception_kind {
     ERROR_EX
 };
 
-class par_tactical : public or_else_tactical {
-
-
+/**
+   \brief Task executing the i'th branch of a parallel tactical.
+*/
+template<typename S>
+class par_branch_task : public task {
+    S &      m_state;
+    unsigned m_idx;
 public:
-    par_tactical(unsigned num, tactic * const * ts):or_else_tactical(num, ts) {}
-    virtual ~par_tactical() {}
+    par_branch_task(S & s, unsigned i): m_state(s), m_idx(i) {}
+    virtual void operator()() { m_state.run(m_idx); }
+};
 
-    
+/**
+   \brief Execute s.run(0), ..., s.run(n-1) on the shared thread pool.
+*/
+template<typename S>
+static void run_branches(S & s, unsigned n) {
+    scoped_ptr_vector<par_branch_task<S> > tasks;
+    task_group g;
+    for (unsigned i = 0; i < n; i++) {
+        par_branch_task<S> * t = alloc(par_branch_task<S>, s, i);
+        tasks.push_back(t);
+        g.spawn(*t);
+    }
+    g.wait();
+}
 
-    virtual void operator()(goal_ref const & in, 
-                            goal_ref_buffer & result, 
-                            model_converter_ref & mc, 
-                            proof_converter_ref & pc, 
-                            expr_dependency_ref & core) {
-        bool use_seq;
-#ifdef _NO_OMP_
-        use_seq = true;
-#else
-        use_seq = 0 != omp_in_parallel();
-#endif
-        if (use_seq) {
-            // execute tasks sequentially
-            or_else_tactical::operator()(in, result, mc, pc, core);
-            return;
-        }
-        
-        ast_manager & m = in->m();
-        
-        scoped_ptr_vector<ast_manager> managers;
-        scoped_limits scl(m.limit());
-        goal_ref_vector                in_copies;
-        tactic_ref_vector              ts;
-        unsigned sz = m_ts.size();
-        for (unsigned i = 0; i < sz; i++) {
-            ast_manager * new_m = alloc(ast_manager, m, !m.proof_mode());
-            managers.push_back(new_m);
-            ast_translation translator(m, *new_m);
-            in_copies.push_back(in->translate(translator));
-            ts.push_back(m_ts.get(i)->translate(*new_m));
-            scl.push_child(&new_m->limit());
+class par_tactical : public or_else_tactical {
+
+    struct state {
+        ast_manager &                    m;
+        scoped_ptr_vector<ast_manager> & m_managers;
+        goal_ref_vector &                m_in_copies;
+        tactic_ref_vector &              m_ts;
+        goal_ref_buffer &                m_result;
+        model_converter_ref &            m_mc;
+        proof_converter_ref &            m_pc;
+        expr_dependency_ref &            m_core;
+        unsigned                         m_finished_id;
+        par_exception_kind               m_ex_kind;
+        std::string                      m_ex_msg;
+        unsigned                         m_error_code;
+
+        state(ast_manager & m, scoped_ptr_vector<ast_manager> & managers, goal_ref_vector & in_copies, tactic_ref_vector & ts,
+              goal_ref_buffer & result, model_converter_ref & mc, proof_converter_ref & pc, expr_dependency_ref & core):
+            m(m), m_managers(managers), m_in_copies(in_copies), m_ts(ts),
+            m_result(result), m_mc(mc), m_pc(pc), m_core(core),
+            m_finished_id(UINT_MAX), m_ex_kind(DEFAULT_EX), m_error_code(0) {}
+
+        void cancel_others(unsigned i) {
+            for (unsigned j = 0; j < m_managers.size(); j++) {
+                if (i != j) {
+                    m_managers[j]->limit().cancel();
+                }
+            }
         }
 
-        unsigned finished_id       = UINT_MAX;
-        par_exception_kind ex_kind = DEFAULT_EX;
-        std::string        ex_msg;
-        unsigned           error_code = 0;
-        
-        #pragma omp parallel for
-        for (int i = 0; i < static_cast<int>(sz); i++) {
+        void run(unsigned i) {
+            // a branch that did not start before another one finished is skipped.
+            if (m_managers[i]->limit().get_cancel_flag())
+                return;
             goal_ref_buffer     _result;
             model_converter_ref _mc; 
             proof_converter_ref _pc; 
-            expr_dependency_ref _core(*(managers[i]));
+            expr_dependency_ref _core(*(m_managers[i]));
             
-            goal_ref in_copy = in_copies[i];
-            tactic & t = *(ts.get(i));
+            goal_ref in_copy = m_in_copies[i];
+            tactic & t = *(m_ts.get(i));
             
             try {
                 t(in_copy, _result, _mc, _pc, _core);
                 bool first = false;
-                #pragma omp critical (par_tactical)
                 {
-                    if (finished_id == UINT_MAX) {
-                        finished_id = i;
+                    scoped_task_lock lock;
+                    if (m_finished_id == UINT_MAX) {
+                        m_finished_id = i;
                         first = true;
                     }
                 }                
                 if (first) {
-                    for (unsigned j = 0; j < sz; j++) {
-                        if (static_cast<unsigned>(i) != j) {
-                            managers[j]->limit().cancel();
-                        }
-                    }
-                    ast_translation translator(*(managers[i]), m, false);
+                    cancel_others(i);
+                    ast_translation translator(*(m_managers[i]), m, false);
                     for (unsigned k = 0; k < _result.size(); k++) {
-                        result.push_back(_result[k]->translate(translator));
+                        m_result.push_back(_result[k]->translate(translator));
                     }
-                    mc   = _mc ? _mc->translate(translator) : 0;
-                    pc   = _pc ? _pc->translate(translator) : 0;
+                    m_mc   = _mc ? _mc->translate(translator) : 0;
+                    m_pc   = _pc ? _pc->translate(translator) : 0;
                     expr_dependency_translation td(translator);
-                    core = td(_core);
+                    m_core = td(_core);
                 }
             }
             catch (tactic_exception & ex) {
                 if (i == 0) {
-                    ex_kind = TACTIC_EX;
-                    ex_msg = ex.msg();
+                    m_ex_kind = TACTIC_EX;
+                    m_ex_msg = ex.msg();
                 }
             }
             catch (z3_error & err) {
                 if (i == 0) {
-                    ex_kind = ERROR_EX;
-                    error_code = err.error_code();
+                    m_ex_kind = ERROR_EX;
+                    m_error_code = err.error_code();
                 }
             }
             catch (z3_exception & z3_ex) {
                 if (i == 0) {
-                    ex_kind = DEFAULT_EX;
-                    ex_msg = z3_ex.msg();
+                    m_ex_kind = DEFAULT_EX;
+                    m_ex_msg = z3_ex.msg();
                 }
             }
         }
-        if (finished_id == UINT_MAX) {
+    };
+
+public:
+    par_tactical(unsigned num, tactic * const * ts):or_else_tactical(num, ts) {}
+    virtual ~par_tactical() {}
+
+    
+
+    virtual void operator()(goal_ref const & in, 
+                            goal_ref_buffer & result, 
+                            model_converter_ref & mc, 
+                            proof_converter_ref & pc, 
+                            expr_dependency_ref & core) {
+        if (thread_pool::get_max_threads() <= 1) {
+            // execute tasks sequentially
+            or_else_tactical::operator()(in, result, mc, pc, core);
+            return;
+        }
+        
+        ast_manager & m = in->m();
+        
+        scoped_ptr_vector<ast_manager> managers;
+        scoped_limits scl(m.limit());
+        goal_ref_vector                in_copies;
+        tactic_ref_vector              ts;
+        unsigned sz = m_ts.size();
+        for (unsigned i = 0; i < sz; i++) {
+            ast_manager * new_m = alloc(ast_manager, m, !m.proof_mode());
+            managers.push_back(new_m);
+            ast_translation translator(m, *new_m);
+            in_copies.push_back(in->translate(translator));
+            ts.push_back(m_ts.get(i)->translate(*new_m));
+            scl.push_child(&new_m->limit());
+        }
+
+        state s(m, managers, in_copies, ts, result, mc, pc, core);
+        run_branches(s, sz);
+
+        if (s.m_finished_id == UINT_MAX) {
             mc = 0;
-            switch (ex_kind) {
-            case ERROR_EX: throw z3_error(error_code);
-            case TACTIC_EX: throw tactic_exception(ex_msg.c_str());
+            switch (s.m_ex_kind) {
+            case ERROR_EX: throw z3_error(s.m_error_code);
+            case TACTIC_EX: throw tactic_exception(s.m_ex_msg.c_str());
             default:
-                throw default_exception(ex_msg.c_str());
+                throw default_exception(s.m_ex_msg.c_str());
             }
         }
     }    
@@ -595,6 +641,163 @@ tactic * par(tactic * t1, tactic * t2, tactic * t3, tactic * t4) {
 }
 
 class par_and_then_tactical : public and_then_tactical {
+
+    struct state {
+        ast_manager &                          m;
+        scoped_ptr_vector<ast_manager> &       m_managers;
+        tactic_ref_vector &                    m_ts2;
+        goal_ref_vector &                      m_g_copies;
+        model_converter_ref &                  m_mc1;
+        goal_ref_buffer &                      m_result;
+        model_converter_ref &                  m_mc;
+        bool                                   m_models_enabled;
+        bool                                   m_proofs_enabled;
+        bool                                   m_cores_enabled;
+        proof_converter_ref_buffer             m_pc_buffer; 
+        model_converter_ref_buffer             m_mc_buffer; 
+        scoped_ptr_vector<expr_dependency_ref> m_core_buffer;
+        scoped_ptr_vector<goal_ref_buffer>     m_goals_vect;
+        bool                                   m_found_solution;
+        bool                                   m_failed;
+        par_exception_kind                     m_ex_kind;
+        unsigned                               m_error_code;
+        std::string                            m_ex_msg;
+
+        state(ast_manager & m, scoped_ptr_vector<ast_manager> & managers, tactic_ref_vector & ts2, goal_ref_vector & g_copies,
+              model_converter_ref & mc1, goal_ref_buffer & result, model_converter_ref & mc, 
+              bool models_enabled, bool proofs_enabled, bool cores_enabled):
+            m(m), m_managers(managers), m_ts2(ts2), m_g_copies(g_copies), 
+            m_mc1(mc1), m_result(result), m_mc(mc), 
+            m_models_enabled(models_enabled), m_proofs_enabled(proofs_enabled), m_cores_enabled(cores_enabled),
+            m_found_solution(false), m_failed(false), m_ex_kind(DEFAULT_EX), m_error_code(0) {
+            unsigned sz = managers.size();
+            m_pc_buffer.resize(sz);
+            m_mc_buffer.resize(sz);
+            m_core_buffer.resize(sz);
+            m_goals_vect.resize(sz);
+        }
+
+        void cancel_others(unsigned i) {
+            for (unsigned j = 0; j < m_managers.size(); j++) {
+                if (i != j) {
+                    m_managers[j]->limit().cancel();
+                }
+            }
+        }
+
+        void run(unsigned i) {
+            ast_manager & new_m = *(m_managers[i]);
+            // the branch is skipped if the result is known before it started.
+            if (new_m.limit().get_cancel_flag())
+                return;
+            goal_ref new_g = m_g_copies[i];
+
+            goal_ref_buffer r2;
+            model_converter_ref mc2;                                                                   
+            proof_converter_ref pc2;                                                                   
+            expr_dependency_ref core2(new_m);                                                              
+                
+            bool curr_failed = false;
+
+            try {
+                m_ts2[i]->operator()(new_g, r2, mc2, pc2, core2);                                              
+            }
+            catch (tactic_exception & ex) {
+                scoped_task_lock lock;
+                if (!m_failed && !m_found_solution) {
+                    curr_failed = true;
+                    m_failed    = true;
+                    m_ex_kind   = TACTIC_EX;
+                    m_ex_msg    = ex.msg();
+                }
+            }
+            catch (z3_error & err) {
+                scoped_task_lock lock;
+                if (!m_failed && !m_found_solution) {
+                    curr_failed  = true;
+                    m_failed     = true;
+                    m_ex_kind    = ERROR_EX;
+                    m_error_code = err.error_code();
+                }
+            }
+            catch (z3_exception & z3_ex) {
+                scoped_task_lock lock;
+                if (!m_failed && !m_found_solution) {
+                    curr_failed = true;
+                    m_failed    = true;
+                    m_ex_kind   = DEFAULT_EX;
+                    m_ex_msg    = z3_ex.msg();
+                }
+            }
+
+            if (curr_failed) {
+                cancel_others(i);
+            }
+            else {
+                if (is_decided(r2)) {
+                    SASSERT(r2.size() == 1);
+                    if (is_decided_sat(r2)) {                                                          
+                        // found solution... 
+                        bool first = false;
+                        {
+                            scoped_task_lock lock;
+                            if (!m_found_solution) {
+                                m_failed         = false;
+                                m_found_solution = true;
+                                first            = true;
+                            }
+                        }
+                        if (first) {
+                            cancel_others(i);
+                            ast_translation translator(new_m, m, false);
+                            SASSERT(r2.size() == 1);
+                            m_result.push_back(r2[0]->translate(translator));
+                            if (m_models_enabled) {
+                                // mc2 contains the actual model                                                    
+                                mc2  = mc2 ? mc2->translate(translator) : 0;
+                                model_ref md;     
+                                md = alloc(model, m);
+                                apply(mc2, md, 0);
+                                apply(m_mc1, md, i);
+                                m_mc = model2model_converter(md.get());
+                            }
+                        }       
+                    }                                                     
+                    else {                                                                                  
+                        SASSERT(is_decided_unsat(r2));                                                 
+                        // the proof and unsat core of a decided_unsat goal are stored in the node itself.
+                        // pc2 and core2 must be 0.
+                        SASSERT(!pc2);
+                        SASSERT(!core2);
+                            
+                        if (m_models_enabled) m_mc_buffer.set(i, 0);
+                        if (m_proofs_enabled) {
+                            proof * pr = r2[0]->pr(0);
+                            m_pc_buffer.set(i, proof2proof_converter(m, pr));
+                        }
+                        if (m_cores_enabled && r2[0]->dep(0) != 0) {
+                            expr_dependency_ref * new_dep = alloc(expr_dependency_ref, new_m);
+                            *new_dep = r2[0]->dep(0);
+                            m_core_buffer.set(i, new_dep);
+                        }
+                    }                                                                 
+                }                                                                                       
+                else {                                                                                      
+                    goal_ref_buffer * new_r2 = alloc(goal_ref_buffer);
+                    m_goals_vect.set(i, new_r2);
+                    new_r2->append(r2.size(), r2.c_ptr());
+                    m_mc_buffer.set(i, mc2.get());
+                    m_pc_buffer.set(i, pc2.get());
+                    if (m_cores_enabled && core2 != 0) {
+                        expr_dependency_ref * new_dep = alloc(expr_dependency_ref, new_m);
+                        *new_dep = core2;
+                        m_core_buffer.set(i, new_dep);
+                    }
+                }
+            }
+        }
+    };
+
 public:
     par_and_then_tactical(tactic * t1, tactic * t2):and_then_tactical(t1, t2) {}
     virtual ~par_and_then_tactical() {}
@@ -604,13 +807,7 @@ public:
                             model_converter_ref & mc, 
                             proof_converter_ref & pc, 
                             expr_dependency_ref & core) {
-        bool use_seq;
-#ifdef _NO_OMP_
-        use_seq = true;
-#else
-        use_seq = 0 != omp_in_parallel();
-#endif
-        if (use_seq) {
+        if (thread_pool::get_max_threads() <= 1) {
             // execute tasks sequentially
             and_then_tactical::operator()(in, result, mc, pc, core);
             return;
@@ -651,6 +848,7 @@ public:
             if (cores_enabled) core = core1;  
 
             scoped_ptr_vector<ast_manager> managers;
+            scoped_limits                  scl(m.limit());
             tactic_ref_vector              ts2;
             goal_ref_vector                g_copies;
 
@@ -660,161 +858,29 @@ public:
                 ast_translation translator(m, *new_m);
                 g_copies.push_back(r1[i]->translate(translator));
                 ts2.push_back(m_t2->translate(*new_m));
+                scl.push_child(&new_m->limit());
             }
 
-            proof_converter_ref_buffer             pc_buffer; 
-            model_converter_ref_buffer             mc_buffer; 
-            scoped_ptr_vector<expr_dependency_ref> core_buffer;
-            scoped_ptr_vector<goal_ref_buffer>     goals_vect;
-
-            pc_buffer.resize(r1_size);
-            mc_buffer.resize(r1_size);
-            core_buffer.resize(r1_size);
-            goals_vect.resize(r1_size);
-
-            bool found_solution = false;
-            bool failed         = false;
-            par_exception_kind ex_kind = DEFAULT_EX;
-            unsigned error_code = 0;
-            std::string  ex_msg;
-
-            #pragma omp parallel for
-            for (int i = 0; i < static_cast<int>(r1_size); i++) { 
-                ast_manager & new_m = *(managers[i]);
-                goal_ref new_g = g_copies[i];
-
-                goal_ref_buffer r2;
-                model_converter_ref mc2;                                                                   
-                proof_converter_ref pc2;                                                                   
-                expr_dependency_ref core2(new_m);                                                              
-                
-                bool curr_failed = false;
-
-                try {
-                    ts2[i]->operator()(new_g, r2, mc2, pc2, core2);                                              
-                }
-                catch (tactic_exception & ex) {
-                    #pragma omp critical (par_and_then_tactical)
-                    {
-                        if (!failed && !found_solution) {
-                            curr_failed = true;
-                            failed      = true;
-                            ex_kind     = TACTIC_EX;
-                            ex_msg      = ex.msg();
-                        }
-                    }
-                }
-                catch (z3_error & err) {
-                    #pragma omp critical (par_and_then_tactical)
-                    {
-                        if (!failed && !found_solution) {
-                            curr_failed = true;
-                            failed      = true;
-                            ex_kind     = ERROR_EX;
-                            error_code  = err.error_code();
-                        }
-                    }                    
-                }
-                catch (z3_exception & z3_ex) {
-                    #pragma omp critical (par_and_then_tactical)
-                    {
-                        if (!failed && !found_solution) {
-                            curr_failed = true;
-                            failed      = true;
-                            ex_kind     = DEFAULT_EX;
-                            ex_msg      = z3_ex.msg();
-                        }
-                    }
-                }
-
-                if (curr_failed) {
-                    for (unsigned j = 0; j < r1_size; j++) {
-                        if (static_cast<unsigned>(i) != j) {
-                            managers[j]->limit().cancel();
-                        }
-                    }
-                }
-                else {
-                    if (is_decided(r2)) {
-                        SASSERT(r2.size() == 1);
-                        if (is_decided_sat(r2)) {                                                          
-                            // found solution... 
-                            bool first = false;
-                            #pragma omp critical (par_and_then_tactical)
-                            {
-                                if (!found_solution) {
-                                    failed         = false;
-                                    found_solution = true;
-                                    first          = true;
-                                }
-                            }
-                            if (first) {
-                                for (unsigned j = 0; j < r1_size; j++) {
-                                    if (static_cast<unsigned>(i) != j) {
-                                        managers[j]->limit().cancel();
-                                    }
-                                }
-                                ast_translation translator(new_m, m, false);
-                                SASSERT(r2.size() == 1);
-                                result.push_back(r2[0]->translate(translator));
-                                if (models_enabled) {
-                                    // mc2 contains the actual model                                                    
-                                    mc2  = mc2 ? mc2->translate(translator) : 0;
-                                    model_ref md;     
-                                    md = alloc(model, m);
-                                    apply(mc2, md, 0);
-                                    apply(mc1, md, i);
-                                    mc   = model2model_converter(md.get());
-                                }
-                                SASSERT(!pc); SASSERT(!core);
-                            }       
-                        }                                                     
-                        else {                                                                                  
-                            SASSERT(is_decided_unsat(r2));                                                 
-                            // the proof and unsat core of a decided_unsat goal are stored in the node itself.
-                            // pc2 and core2 must be 0.
-                            SASSERT(!pc2);
-                            SASSERT(!core2);
-                            
-                            if (models_enabled) mc_buffer.set(i, 0);
-                            if (proofs_enabled) {
-                                proof * pr = r2[0]->pr(0);
-                                pc_buffer.push_back(proof2proof_converter(m, pr));
-                            }
-                            if (cores_enabled && r2[0]->dep(0) != 0) {
-                                expr_dependency_ref * new_dep = alloc(expr_dependency_ref, new_m);
-                                *new_dep = r2[0]->dep(0);
-                                core_buffer.set(i, new_dep);
-                            }
-                        }                                                                 
-                    }                                                                                       
-                    else {                                                                                      
-                        goal_ref_buffer * new_r2 = alloc(goal_ref_buffer);
-                        goals_vect.set(i, new_r2);
-                        new_r2->append(r2.size(), r2.c_ptr());
-                        mc_buffer.set(i, mc2.get());
-                        pc_buffer.set(i, pc2.get());
-                        if (cores_enabled && core2 != 0) {
-                            expr_dependency_ref * new_dep = alloc(expr_dependency_ref, new_m);
-                            *new_dep = core2;
-                            core_buffer.set(i, new_dep);
-                        }
-                    }                                                                                           
-                }
-            }
+            state s(m, managers, ts2, g_copies, mc1, result, mc, models_enabled, proofs_enabled, cores_enabled);
+            run_branches(s, r1_size);
             
-            if (failed) {
-                switch (ex_kind) {
-                case ERROR_EX: throw z3_error(error_code);
-                case TACTIC_EX: throw tactic_exception(ex_msg.c_str());
+            if (s.m_failed) {
+                switch (s.m_ex_kind) {
+                case ERROR_EX: throw z3_error(s.m_error_code);
+                case TACTIC_EX: throw tactic_exception(s.m_ex_msg.c_str());
                 default:
-                    throw default_exception(ex_msg.c_str());
+                    throw default_exception(s.m_ex_msg.c_str());
                 }
             }
 
-            if (found_solution)
+            if (s.m_found_solution)
                 return;
 
+            proof_converter_ref_buffer &             pc_buffer   = s.m_pc_buffer; 
+            model_converter_ref_buffer &             mc_buffer   = s.m_mc_buffer; 
+            scoped_ptr_vector<expr_dependency_ref> & core_buffer = s.m_core_buffer;
+            scoped_ptr_vector<goal_ref_buffer> &     goals_vect  = s.m_goals_vect;
+
             core = 0;
             sbuffer<unsigned> sz_buffer;                                                           
             for (unsigned i = 0; i < r1_size; i++) {
@@ -1139,7 +1205,6 @@ public:
                             expr_dependency_ref & core) {
         cancel_eh<reslimit> eh(in->m().limit());
         { 
-            // Warning: scoped_timer is not thread safe in Linux.
             scoped_timer timer(m_timeout, &eh);
             m_t->operator()(in, result, mc, pc, core);
         }
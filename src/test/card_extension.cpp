@@ -0,0 +1,209 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    card_extension.cpp
+
+Abstract:
+
+    Test propagation, conflicts, cores and user scopes of the
+    cardinality and pseudo-Boolean extension of the SAT solver.
+
+Author:
+
+
+Revision History:
+
+--*/
+#include"card_extension.h"
+#include"goal2sat.h"
+#include"pb_decl_plugin.h"
+#include"reg_decl_plugins.h"
+#include"ast_pp.h"
+#include"statistics.h"
+#include"util.h"
+#include<iostream>
+
+typedef sat::card_extension::wliteral wliteral;
+
+static sat::literal mk_lit(sat::solver & s) {
+    return sat::literal(s.mk_var(true), false);
+}
+
+static bool core_contains(sat::solver const & s, sat::literal l) {
+    return s.get_core().contains(l);
+}
+
+// propagation at the base level: x1 + x2 + x3 >= 2 and ~x1 imply x2 and x3.
+static void tst_propagate() {
+    params_ref p;
+    reslimit rlim;
+    sat::solver s(p, rlim, 0);
+    sat::card_extension * ext = alloc(sat::card_extension);
+    s.set_extension(ext);
+    sat::literal x1 = mk_lit(s), x2 = mk_lit(s), x3 = mk_lit(s), x4 = mk_lit(s);
+    sat::literal_vector lits;
+    lits.push_back(x1); lits.push_back(x2); lits.push_back(x3);
+    ext->add_at_least(sat::null_bool_var, lits, 2);
+    // 3*x2 + 2*x3 + 2*x4 >= 5 and x2 imply x3 or x4, ~x3 implies x4.
+    svector<wliteral> wlits;
+    wlits.push_back(wliteral(3, x2)); wlits.push_back(wliteral(2, x3)); wlits.push_back(wliteral(2, x4));
+    ext->add_pb_ge(sat::null_bool_var, wlits, 5);
+    sat::literal unit = ~x1;
+    s.mk_clause(1, &unit);
+    ENSURE(s.propagate(false));
+    ENSURE(s.value(x1) == l_false);
+    ENSURE(s.value(x2) == l_true);
+    ENSURE(s.value(x3) == l_true);
+    ENSURE(s.value(x4) == l_undef);
+    ENSURE(s.check() == l_true);
+    ENSURE(s.get_model()[x4.var()] == l_true || s.get_model()[x3.var()] == l_true);
+}
+
+// conflicts found by the extension are explained by get_antecedents,
+// the cores only contain the assumptions that the constraints depend on.
+static void tst_conflict() {
+    params_ref p;
+    reslimit rlim;
+    sat::solver s(p, rlim, 0);
+    sat::card_extension * ext = alloc(sat::card_extension);
+    s.set_extension(ext);
+    sat::literal x1 = mk_lit(s), x2 = mk_lit(s), x3 = mk_lit(s), x4 = mk_lit(s), y = mk_lit(s);
+    sat::literal_vector lits;
+    lits.push_back(x1); lits.push_back(x2); lits.push_back(x3); lits.push_back(x4);
+    ext->add_at_least(sat::null_bool_var, lits, 3);
+
+    sat::literal asms1[3] = { ~x1, y, ~x2 };
+    ENSURE(s.check(3, asms1) == l_false);
+    ENSURE(core_contains(s, ~x1));
+    ENSURE(core_contains(s, ~x2));
+    ENSURE(!core_contains(s, y));
+
+    sat::literal asms2[2] = { ~x1, y };
+    ENSURE(s.check(2, asms2) == l_true);
+    ENSURE(s.get_model()[x2.var()] == l_true);
+    ENSURE(s.get_model()[x3.var()] == l_true);
+    ENSURE(s.get_model()[x4.var()] == l_true);
+
+    // guarded pb constraint: g => 3*x1 + 2*x2 + x3 >= 4.
+    sat::bool_var g = s.mk_var(true);
+    svector<wliteral> wlits;
+    wlits.push_back(wliteral(3, x1)); wlits.push_back(wliteral(2, x2)); wlits.push_back(wliteral(1, x3));
+    ext->add_pb_ge(g, wlits, 4);
+    sat::literal asms3[3] = { sat::literal(g, false), y, ~x1 };
+    ENSURE(s.check(3, asms3) == l_false);
+    ENSURE(core_contains(s, sat::literal(g, false)));
+    ENSURE(core_contains(s, ~x1));
+    ENSURE(!core_contains(s, y));
+    // ~g => 3*~x1 + 2*~x2 + ~x3 >= 3, which is violated by x1 and x2.
+    sat::literal asms4[3] = { sat::literal(g, true), x1, x2 };
+    ENSURE(s.check(3, asms4) == l_false);
+    ENSURE(core_contains(s, sat::literal(g, true)));
+    sat::literal asms5[2] = { sat::literal(g, false), ~x2 };
+    ENSURE(s.check(2, asms5) == l_true);
+    ENSURE(s.get_model()[x1.var()] == l_true);
+
+    statistics st;
+    s.collect_statistics(st);
+    st.display(std::cout);
+}
+
+// constraints added in a user scope are removed by user_pop.
+static void tst_user_pop() {
+    params_ref p;
+    reslimit rlim;
+    sat::solver s(p, rlim, 0);
+    sat::card_extension * ext = alloc(sat::card_extension);
+    s.set_extension(ext);
+    sat::literal x1 = mk_lit(s), x2 = mk_lit(s), x3 = mk_lit(s);
+    sat::literal_vector lits;
+    lits.push_back(x1); lits.push_back(x2); lits.push_back(x3);
+    ext->add_at_least(sat::null_bool_var, lits, 1);
+    for (unsigned round = 0; round < 3; ++round) {
+        s.user_push();
+        sat::literal_vector nlits;
+        nlits.push_back(~x1); nlits.push_back(~x2); nlits.push_back(~x3);
+        ext->add_at_least(sat::null_bool_var, nlits, 3);
+        ENSURE(s.check() == l_false);
+        s.user_pop(1);
+        ENSURE(s.check() == l_true);
+        sat::model const & mdl = s.get_model();
+        ENSURE(mdl[x1.var()] == l_true || mdl[x2.var()] == l_true || mdl[x3.var()] == l_true);
+        sat::literal asms[2] = { ~x1, ~x2 };
+        ENSURE(s.check(2, asms) == l_true);
+        ENSURE(s.get_model()[x3.var()] == l_true);
+    }
+}
+
+// goal2sat translates constraints with negative coefficients, <= and = into >= constraints
+// over the extension, compare against the value of the constraint on all assignments.
+static void tst_goal2sat(random_gen & r) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    pb_util pb(m);
+    unsigned const n = 4;
+    expr_ref_vector xs(m);
+    for (unsigned i = 0; i < n; ++i) {
+        xs.push_back(m.mk_fresh_const("x", m.mk_bool_sort()));
+    }
+    for (unsigned iter = 0; iter < 100; ++iter) {
+        vector<rational> coeffs;
+        for (unsigned i = 0; i < n; ++i) {
+            coeffs.push_back(rational(static_cast<int>(r(9)) - 4));
+        }
+        rational k(static_cast<int>(r(9)) - 4);
+        unsigned kind = r(3);
+        expr_ref c(m);
+        switch (kind) {
+        case 0: c = pb.mk_ge(n, coeffs.c_ptr(), xs.c_ptr(), k); break;
+        case 1: c = pb.mk_le(n, coeffs.c_ptr(), xs.c_ptr(), k); break;
+        default: c = pb.mk_eq(n, coeffs.c_ptr(), xs.c_ptr(), k); break;
+        }
+        // the constraint is asserted at the root, or nested below a disjunction with a guard.
+        bool nested = r(2) == 0;
+        expr_ref b(m.mk_fresh_const("b", m.mk_bool_sort()), m);
+        goal_ref g = alloc(goal, m, true, false);
+        g->assert_expr(nested ? m.mk_or(b, c) : c.get());
+
+        params_ref p;
+        p.set_bool("cardinality.solver", true);
+        reslimit rlim;
+        sat::solver s(p, rlim, 0);
+        atom2bool_var a2b(m);
+        goal2sat::dep2asm_map dep2asm;
+        goal2sat g2s;
+        g2s(*g, p, s, a2b, dep2asm, true);
+
+        for (unsigned bits = 0; bits < (1u << n); ++bits) {
+            rational sum(0);
+            sat::literal_vector asms;
+            for (unsigned i = 0; i < n; ++i) {
+                bool val = (bits & (1u << i)) != 0;
+                sat::bool_var v = a2b.to_bool_var(xs.get(i));
+                if (val) sum += coeffs[i];
+                if (v != sat::null_bool_var)
+                    asms.push_back(sat::literal(v, !val));
+            }
+            if (nested) {
+                sat::bool_var v = a2b.to_bool_var(b);
+                ENSURE(v != sat::null_bool_var);
+                asms.push_back(sat::literal(v, true));
+            }
+            bool expected = kind == 0 ? sum >= k : (kind == 1 ? sum <= k : sum == k);
+            lbool res = s.check(asms.size(), asms.c_ptr());
+            if (res != (expected ? l_true : l_false)) {
+                std::cout << mk_pp(c, m) << " bits: " << bits << " result: " << res << "\n";
+            }
+            ENSURE(res == (expected ? l_true : l_false));
+        }
+    }
+}
+
+void tst_card_extension() {
+    tst_propagate();
+    tst_conflict();
+    tst_user_pop();
+    random_gen r(0);
+    tst_goal2sat(r);
+}
@@ -229,6 +229,16 @@ int main(int argc, char ** argv) {
     TST(model_evaluator);
     TST(get_consequences);
     TST(pb2bv);
+    TST(scoped_timer);
+    TST_ARGV(par_parse);
+    TST(thread_pool);
+    TST(s_rational);
+    TST(card_extension);
+    TST(sat_compact);
+    TST(xor_finder);
+    TST(sat_gauss);
+    TST(sat_vivify);
+    TST(theory_bv);
     //TST_ARGV(hs);
 }
 
@@ -0,0 +1,134 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    par_parse.cpp
+
+Abstract:
+
+    Micro-benchmark for parsing SMT-LIB2 files on several threads.
+    Each thread uses its own context, so the threads only share
+    the symbol table.
+
+    Usage: test-z3 par_parse [file_1 ... file_n]
+
+    Synthetic benchmarks are generated when no file is given.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include"cmd_context.h"
+#include"smt2parser.h"
+#include"symbol.h"
+#include"stopwatch.h"
+#include"z3_omp.h"
+#include<fstream>
+#include<sstream>
+#include<iostream>
+#include<vector>
+
+// elapsed wall clock time since construction.
+// Without OpenMP the threads run sequentially, so the stopwatch is used as a fallback.
+class wall_timer {
+#ifndef _NO_OMP_
+    double    m_start;
+public:
+    wall_timer(): m_start(omp_get_wtime()) {}
+    double get_seconds() const { return omp_get_wtime() - m_start; }
+#else
+    stopwatch m_watch;
+public:
+    wall_timer() { m_watch.start(); }
+    double get_seconds() const { return m_watch.get_seconds(); }
+#endif
+};
+
+static std::string mk_benchmark(unsigned id, unsigned num_decls) {
+    std::ostringstream strm;
+    strm << "(set-logic QF_LIA)\n";
+    for (unsigned j = 0; j < num_decls; ++j) {
+        // mix symbols that are private to the file with symbols shared by all files.
+        strm << "(declare-const x_" << id << "_" << j << " Int)\n";
+        strm << "(declare-const shared_" << j << " Int)\n";
+        strm << "(assert (<= x_" << id << "_" << j << " (+ shared_" << j << " " << j << ")))\n";
+    }
+    return strm.str();
+}
+
+static bool parse(std::string const & content) {
+    cmd_context ctx;
+    ctx.set_ignore_check(true);
+    std::istringstream is(content);
+    return parse_smt2_commands(ctx, is);
+}
+
+static double parse_all(std::vector<std::string> const & contents, bool par) {
+    wall_timer timer;
+    int n = static_cast<int>(contents.size());
+    bool ok = true;
+    if (par) {
+        #pragma omp parallel for
+        for (int i = 0; i < n; ++i) {
+            if (!parse(contents[i])) {
+                #pragma omp critical (par_parse)
+                ok = false;
+            }
+        }
+    }
+    else {
+        for (int i = 0; i < n; ++i) {
+            ok = parse(contents[i]) && ok;
+        }
+    }
+    ENSURE(ok);
+    return timer.get_seconds();
+}
+
+// symbols created concurrently from the same string must be identical.
+static void tst_identity(unsigned num_threads) {
+    unsigned num_syms = 10000;
+    vector<ptr_vector<char const> > ptrs;
+    ptrs.resize(num_threads);
+    int n = num_threads;
+    #pragma omp parallel for
+    for (int i = 0; i < n; ++i) {
+        for (unsigned j = 0; j < num_syms; ++j) {
+            std::ostringstream strm;
+            strm << "identity_" << ((j + i * 7919) % num_syms);
+            symbol s(strm.str().c_str());
+            ptrs[i].push_back(s.bare_str());
+        }
+    }
+    for (unsigned i = 1; i < num_threads; ++i) {
+        for (unsigned j = 0; j < num_syms; ++j) {
+            ENSURE(ptrs[i][(j + (num_syms - (i * 7919) % num_syms)) % num_syms] == ptrs[0][j]);
+        }
+    }
+}
+
+void tst_par_parse(char ** argv, int argc, int& i) {
+    std::vector<std::string> contents;
+    while (i + 1 < argc && argv[i + 1][0] != '/' && argv[i + 1][0] != '-') {
+        std::ifstream in(argv[i + 1]);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        contents.push_back(buffer.str());
+        ++i;
+    }
+    unsigned num_threads = omp_get_num_procs();
+    if (contents.empty()) {
+        for (unsigned j = 0; j < num_threads; ++j) {
+            contents.push_back(mk_benchmark(j, 20000));
+        }
+    }
+    tst_identity(num_threads);
+    double seq = parse_all(contents, false);
+    double par = parse_all(contents, true);
+    std::cout << "files: " << contents.size() << " threads: " << num_threads 
+              << " sequential: " << seq << "s parallel: " << par << "s\n";
+}
@@ -0,0 +1,90 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    s_rational.cpp
+
+Abstract:
+
+    Compare s_rational against rational and test overflow detection.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include"s_rational.h"
+#include"inf_s_rational.h"
+#include"debug.h"
+#include"util.h"
+#include<iostream>
+
+static void tst_ops(random_gen & r) {
+    for (unsigned i = 0; i < 10000; ++i) {
+        int n1 = static_cast<int>(r(2001)) - 1000, d1 = static_cast<int>(r(20)) + 1;
+        int n2 = static_cast<int>(r(2001)) - 1000, d2 = static_cast<int>(r(20)) + 1;
+        rational a(n1, d1), b(n2, d2);
+        s_rational sa(n1, d1), sb(n2, d2);
+        VERIFY((sa + sb).to_rational() == a + b);
+        VERIFY((sa - sb).to_rational() == a - b);
+        VERIFY((sa * sb).to_rational() == a * b);
+        if (!b.is_zero()) {
+            VERIFY((sa / sb).to_rational() == a / b);
+        }
+        VERIFY((sa < sb) == (a < b));
+        VERIFY((sa == sb) == (a == b));
+        VERIFY(floor(sa).to_rational() == floor(a));
+        VERIFY(ceil(sa).to_rational() == ceil(a));
+        VERIFY(s_rational(a) == sa);
+        s_rational ia = floor(sa), ib = floor(sb);
+        if (!ib.is_zero()) {
+            VERIFY(div(ia, ib).to_rational() == div(floor(a), floor(b)));
+            VERIFY(mod(ia, ib).to_rational() == mod(floor(a), floor(b)));
+        }
+        s_rational c(sa);
+        c.addmul(sb, sa);
+        VERIFY(c.to_rational() == a + b * a);
+    }
+}
+
+static void tst_inf() {
+    inf_s_rational x(s_rational(1, 2), true);
+    inf_s_rational y(s_rational(1, 2));
+    VERIFY(y < x);
+    VERIFY(floor(x) == s_rational(0));
+    VERIFY(ceil(x) == s_rational(1));
+    inf_s_rational z(s_rational(2), false);
+    VERIFY(floor(z) == s_rational(1));
+    VERIFY(ceil(z) == s_rational(2));
+}
+
+static void tst_overflow() {
+    s_rational big(INT64_MAX / 2, s_rational::i64());
+    bool overflow = false;
+    try {
+        big *= s_rational(4);
+    }
+    catch (s_rational::overflow_exception &) {
+        overflow = true;
+    }
+    VERIFY(overflow);
+    overflow = false;
+    try {
+        s_rational r(rational::power_of_two(70));
+    }
+    catch (s_rational::overflow_exception &) {
+        overflow = true;
+    }
+    VERIFY(overflow);
+}
+
+void tst_s_rational() {
+    random_gen r(0);
+    tst_ops(r);
+    tst_inf();
+    tst_overflow();
+    std::cout << "ok\n";
+}
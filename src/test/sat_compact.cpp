@@ -0,0 +1,108 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_compact.cpp
+
+Abstract:
+
+    Test the compaction of the clause arena during search.
+
+Author:
+
+
+Revision History:
+
+--*/
+#include"sat_solver.h"
+#include"statistics.h"
+#include"util.h"
+#include<iostream>
+
+typedef vector<sat::literal_vector> clauses_t;
+
+static void mk_random_3sat(random_gen & r, unsigned num_vars, unsigned num_clauses, clauses_t & clauses) {
+    for (unsigned i = 0; i < num_clauses; ++i) {
+        sat::literal_vector c;
+        while (c.size() < 3) {
+            sat::literal l(r(num_vars), r(2) == 0);
+            if (!c.contains(l) && !c.contains(~l)) c.push_back(l);
+        }
+        clauses.push_back(c);
+    }
+}
+
+static void add_clauses(sat::solver & s, unsigned num_vars, clauses_t const & clauses) {
+    for (unsigned i = 0; i < num_vars; ++i) {
+        s.mk_var(true);
+    }
+    for (unsigned i = 0; i < clauses.size(); ++i) {
+        s.mk_clause(clauses[i]);
+    }
+}
+
+static bool is_model(sat::model const & mdl, clauses_t const & clauses) {
+    for (unsigned i = 0; i < clauses.size(); ++i) {
+        bool sat = false;
+        for (unsigned j = 0; !sat && j < clauses[i].size(); ++j) {
+            sat::literal l = clauses[i][j];
+            sat = mdl[l.var()] == (l.sign() ? l_false : l_true);
+        }
+        if (!sat) return false;
+    }
+    return true;
+}
+
+static unsigned get_stat(sat::solver const & s, char const * key) {
+    statistics st;
+    s.collect_statistics(st);
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (std::string(key) == st.get_key(i)) {
+            return st.get_uint_value(i);
+        }
+    }
+    return 0;
+}
+
+// collect garbage every few conflicts, the deleted learned clauses make the arena
+// compact while there are justifications and watches of clauses on the trail.
+// The results are compared with a solver that does not collect garbage during search.
+void tst_sat_compact() {
+    random_gen r(0);
+    unsigned const num_vars = 80, num_clauses = 340;
+    unsigned num_compact = 0;
+    params_ref p1, p2;
+    p1.set_uint("gc.initial", 20);
+    p1.set_uint("gc.increment", 5);
+    p2.set_uint("gc.initial", UINT_MAX / 2);
+    for (unsigned iter = 0; iter < 30; ++iter) {
+        clauses_t clauses;
+        mk_random_3sat(r, num_vars, num_clauses, clauses);
+        for (unsigned k = 0; k < 3; ++k) {
+            sat::literal_vector asms;
+            for (unsigned i = 0; i < k; ++i) {
+                asms.push_back(sat::literal(r(num_vars), r(2) == 0));
+            }
+            reslimit rlim1, rlim2;
+            sat::solver s1(p1, rlim1, 0), s2(p2, rlim2, 0);
+            add_clauses(s1, num_vars, clauses);
+            add_clauses(s2, num_vars, clauses);
+            lbool r1 = s1.check(asms.size(), asms.c_ptr());
+            lbool r2 = s2.check(asms.size(), asms.c_ptr());
+            ENSURE(r1 == r2);
+            if (r1 == l_true) {
+                ENSURE(is_model(s1.get_model(), clauses));
+                for (unsigned i = 0; i < asms.size(); ++i) {
+                    ENSURE(s1.get_model()[asms[i].var()] == (asms[i].sign() ? l_false : l_true));
+                }
+            }
+            // the arena is compacted by the first simplification, the others happen during search.
+            if (get_stat(s1, "compactions") > 1) {
+                num_compact += get_stat(s1, "compactions") - 1;
+            }
+        }
+    }
+    std::cout << "compactions: " << num_compact << "\n";
+    ENSURE(num_compact > 0);
+}
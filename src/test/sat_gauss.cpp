@@ -0,0 +1,183 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_gauss.cpp
+
+Abstract:
+
+    Test the recovery of XOR constraints from clauses and their
+    propagation by Gauss-Jordan elimination.
+
+Author:
+
+
+Revision History:
+
+--*/
+#include"sat_solver.h"
+#include"sat_xor_finder.h"
+#include"card_extension.h"
+#include"statistics.h"
+#include"util.h"
+#include<iostream>
+
+typedef sat::bool_var_vector xor_t;
+
+// add the clauses that encode vars[0] + ... + vars[n-1] = rhs.
+// If skip < 2^n, then the clause with the sign pattern skip is not added.
+static void add_xor_clauses(sat::solver & s, xor_t const & vars, bool rhs, unsigned skip = UINT_MAX) {
+    unsigned n = vars.size();
+    sat::literal_vector lits;
+    for (unsigned signs = 0; signs < (1u << n); ++signs) {
+        unsigned num_neg = 0;
+        for (unsigned i = 0; i < n; ++i) {
+            if (signs & (1u << i)) ++num_neg;
+        }
+        // the clause excludes the assignment that sets the negated literals to true and the others to false.
+        if ((num_neg % 2 == 1) == rhs || signs == skip) {
+            continue;
+        }
+        lits.reset();
+        for (unsigned i = 0; i < n; ++i) {
+            lits.push_back(sat::literal(vars[i], (signs & (1u << i)) != 0));
+        }
+        s.mk_clause(lits);
+    }
+}
+
+static bool eval_xor(sat::model const & mdl, xor_t const & vars, bool rhs) {
+    bool parity = false;
+    for (unsigned i = 0; i < vars.size(); ++i) {
+        if (mdl[vars[i]] == l_true) parity = !parity;
+    }
+    return parity == rhs;
+}
+
+static xor_t mk_xor(sat::bool_var a, sat::bool_var b, sat::bool_var c, sat::bool_var d = sat::null_bool_var) {
+    xor_t r;
+    r.push_back(a); r.push_back(b); r.push_back(c);
+    if (d != sat::null_bool_var) r.push_back(d);
+    return r;
+}
+
+static bool contains_xor(vector<xor_t> const & xors, svector<bool> const & rhs, xor_t const & x, bool r) {
+    for (unsigned i = 0; i < xors.size(); ++i) {
+        if (rhs[i] != r || xors[i].size() != x.size()) continue;
+        bool eq = true;
+        for (unsigned j = 0; eq && j < x.size(); ++j) {
+            eq = xors[i][j] == x[j];
+        }
+        if (eq) return true;
+    }
+    return false;
+}
+
+void tst_xor_finder() {
+    params_ref p;
+    reslimit rlim;
+    sat::solver s(p, rlim, 0);
+    for (unsigned i = 0; i < 12; ++i) {
+        s.mk_var(true);
+    }
+    xor_t x1 = mk_xor(0, 1, 2), x2 = mk_xor(3, 4, 5, 6), x3 = mk_xor(7, 8, 9), x4 = mk_xor(9, 10, 11);
+    add_xor_clauses(s, x1, true);
+    add_xor_clauses(s, x2, false);
+    // x3 misses one of its clauses, it is not an XOR constraint.
+    add_xor_clauses(s, x3, true, 0);
+    // x4 is encoded together with an unrelated clause over the same variables.
+    add_xor_clauses(s, x4, false);
+    sat::literal_vector lits;
+    lits.push_back(sat::literal(9, false)); lits.push_back(sat::literal(10, false)); lits.push_back(sat::literal(11, false));
+    s.mk_clause(lits);
+
+    vector<xor_t> xors;
+    svector<bool> rhs;
+    sat::xor_finder xf(s);
+    xf(5, xors, rhs);
+    ENSURE(xors.size() == 3);
+    ENSURE(contains_xor(xors, rhs, x1, true));
+    ENSURE(contains_xor(xors, rhs, x2, false));
+    ENSURE(contains_xor(xors, rhs, x4, false));
+
+    // XOR constraints above the size bound are ignored.
+    xors.reset();
+    rhs.reset();
+    xf(3, xors, rhs);
+    ENSURE(xors.size() == 2);
+    ENSURE(!contains_xor(xors, rhs, x2, false));
+}
+
+static void add_xors(sat::solver & s, unsigned num_vars, vector<xor_t> const & xors, svector<bool> const & rhs) {
+    for (unsigned i = 0; i < num_vars; ++i) {
+        s.mk_var(true);
+    }
+    for (unsigned i = 0; i < xors.size(); ++i) {
+        add_xor_clauses(s, xors[i], rhs[i]);
+    }
+}
+
+static unsigned num_xor_propagations(sat::solver const & s) {
+    statistics st;
+    s.collect_statistics(st);
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (std::string("xor propagations") == st.get_key(i)) {
+            return st.get_uint_value(i);
+        }
+    }
+    return 0;
+}
+
+// compare the solver with Gauss-Jordan elimination against the solver without it
+// on random systems of XOR constraints under random assumptions.
+void tst_sat_gauss() {
+    random_gen r(0);
+    unsigned const num_vars = 12, num_xors = 8;
+    unsigned num_propagations = 0;
+    // XOR constraints are recovered by the first simplification, which burst search would skip.
+    params_ref p1, p2;
+    p1.set_uint("burst_search", 0);
+    p2.set_uint("burst_search", 0);
+    p2.set_bool("xor.solver", false);
+    for (unsigned iter = 0; iter < 40; ++iter) {
+        vector<xor_t> xors;
+        svector<bool> rhs;
+        for (unsigned i = 0; i < num_xors; ++i) {
+            unsigned sz = 3 + r(2);
+            xor_t x;
+            while (x.size() < sz) {
+                sat::bool_var v = r(num_vars);
+                if (!x.contains(v)) x.push_back(v);
+            }
+            std::sort(x.begin(), x.end());
+            xors.push_back(x);
+            rhs.push_back(r(2) == 0);
+        }
+        for (unsigned k = 0; k < 20; ++k) {
+            sat::literal_vector asms;
+            unsigned num_asms = 1 + r(5);
+            for (unsigned i = 0; i < num_asms; ++i) {
+                asms.push_back(sat::literal(r(num_vars), r(2) == 0));
+            }
+            reslimit rlim1, rlim2;
+            sat::solver s1(p1, rlim1, 0), s2(p2, rlim2, 0);
+            add_xors(s1, num_vars, xors, rhs);
+            add_xors(s2, num_vars, xors, rhs);
+            lbool r1 = s1.check(asms.size(), asms.c_ptr());
+            lbool r2 = s2.check(asms.size(), asms.c_ptr());
+            ENSURE(r1 == r2);
+            if (r1 == l_true) {
+                for (unsigned i = 0; i < xors.size(); ++i) {
+                    ENSURE(eval_xor(s1.get_model(), xors[i], rhs[i]));
+                }
+                for (unsigned i = 0; i < asms.size(); ++i) {
+                    ENSURE(s1.get_model()[asms[i].var()] == (asms[i].sign() ? l_false : l_true));
+                }
+            }
+            num_propagations += num_xor_propagations(s1);
+        }
+    }
+    std::cout << "xor propagations: " << num_propagations << "\n";
+    ENSURE(num_propagations > 0);
+}
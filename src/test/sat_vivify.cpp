@@ -0,0 +1,120 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    sat_vivify.cpp
+
+Abstract:
+
+    Test vivification of learned clauses and the effort allocation
+    of the inprocessing techniques.
+
+Author:
+
+
+Revision History:
+
+--*/
+#include"sat_solver.h"
+#include"sat_inprocess.h"
+#include"statistics.h"
+#include"util.h"
+#include<iostream>
+
+typedef vector<sat::literal_vector> clauses_t;
+
+static void mk_random_3sat(random_gen & r, unsigned num_vars, unsigned num_clauses, clauses_t & clauses) {
+    for (unsigned i = 0; i < num_clauses; ++i) {
+        sat::literal_vector c;
+        while (c.size() < 3) {
+            sat::literal l(r(num_vars), r(2) == 0);
+            if (!c.contains(l) && !c.contains(~l)) c.push_back(l);
+        }
+        clauses.push_back(c);
+    }
+}
+
+static void add_clauses(sat::solver & s, unsigned num_vars, clauses_t const & clauses) {
+    for (unsigned i = 0; i < num_vars; ++i) {
+        s.mk_var(true);
+    }
+    for (unsigned i = 0; i < clauses.size(); ++i) {
+        s.mk_clause(clauses[i]);
+    }
+}
+
+static bool is_model(sat::model const & mdl, clauses_t const & clauses) {
+    for (unsigned i = 0; i < clauses.size(); ++i) {
+        bool sat = false;
+        for (unsigned j = 0; !sat && j < clauses[i].size(); ++j) {
+            sat::literal l = clauses[i][j];
+            sat = mdl[l.var()] == (l.sign() ? l_false : l_true);
+        }
+        if (!sat) return false;
+    }
+    return true;
+}
+
+static unsigned get_stat(sat::solver const & s, char const * key) {
+    statistics st;
+    s.collect_statistics(st);
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (std::string(key) == st.get_key(i)) {
+            return st.get_uint_value(i);
+        }
+    }
+    return 0;
+}
+
+// compare the solver that vivifies learned clauses with one that does not.
+static void tst_vivify_search() {
+    random_gen r(0);
+    unsigned const num_vars = 150, num_clauses = 640;
+    unsigned num_elim = 0;
+    params_ref p1, p2;
+    p1.set_uint("vivify.effort", 1000);
+    p2.set_bool("vivify", false);
+    for (unsigned iter = 0; iter < 10; ++iter) {
+        clauses_t clauses;
+        mk_random_3sat(r, num_vars, num_clauses, clauses);
+        sat::literal_vector asms;
+        for (unsigned i = 0; i < iter % 3; ++i) {
+            asms.push_back(sat::literal(r(num_vars), r(2) == 0));
+        }
+        reslimit rlim1, rlim2;
+        sat::solver s1(p1, rlim1, 0), s2(p2, rlim2, 0);
+        add_clauses(s1, num_vars, clauses);
+        add_clauses(s2, num_vars, clauses);
+        lbool r1 = s1.check(asms.size(), asms.c_ptr());
+        lbool r2 = s2.check(asms.size(), asms.c_ptr());
+        ENSURE(r1 == r2);
+        if (r1 == l_true) {
+            ENSURE(is_model(s1.get_model(), clauses));
+        }
+        ENSURE(get_stat(s2, "vivified clauses") == 0);
+        num_elim += get_stat(s1, "vivify elim literals") + get_stat(s1, "vivify deleted clauses");
+    }
+    std::cout << "vivify elim literals and deleted clauses: " << num_elim << "\n";
+    ENSURE(num_elim > 0);
+}
+
+// a technique without gain loses effort, also when its counters were reset during the round.
+static void tst_inprocess_scheduler() {
+    typedef sat::inprocess_scheduler scheduler;
+    scheduler sch;
+    sch.update(scheduler::SUBSUME, 4, 10);
+    ENSURE(sch.weight(scheduler::SUBSUME) > 1.0);
+    sch.reset();
+    sch.update(scheduler::VIVIFY, 10, 0, 100, 5);
+    ENSURE(sch.weight(scheduler::VIVIFY) < 1.0);
+    sch.reset();
+    sch.update(scheduler::VIVIFY, 10, 2, 100, 5);
+    ENSURE(sch.weight(scheduler::VIVIFY) > 1.0);
+    ENSURE(sch.weight(scheduler::SUBSUME) < 1.0);
+}
+
+void tst_sat_vivify() {
+    tst_inprocess_scheduler();
+    tst_vivify_search();
+}
@@ -0,0 +1,82 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    scoped_timer.cpp
+
+Abstract:
+
+    Test timers sharing the timer service.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include"scoped_timer.h"
+#include"stopwatch.h"
+#include"debug.h"
+#include"util.h"
+#include<iostream>
+
+class counting_eh : public event_handler {
+public:
+    volatile unsigned m_count;
+    counting_eh(): m_count(0) {}
+    virtual void operator()() { m_count++; }
+};
+
+// busy wait until the handler fired or max_secs elapsed.
+static void wait_for(counting_eh & eh, double max_secs) {
+    stopwatch sw;
+    sw.start();
+    while (eh.m_count == 0 && sw.get_current_seconds() < max_secs) {}
+}
+
+static void tst_fire() {
+    counting_eh eh1, eh2, eh3;
+    {
+        scoped_timer t1(10000, &eh1);
+        scoped_timer t2(5, &eh2);
+        scoped_timer t3(1, &eh3);
+        wait_for(eh2, 10.0);
+        wait_for(eh3, 10.0);
+    }
+    ENSURE(eh1.m_count == 0);
+    ENSURE(eh2.m_count == 1);
+    ENSURE(eh3.m_count == 1);
+}
+
+static void tst_cancel() {
+    counting_eh eh;
+    stopwatch sw;
+    sw.start();
+    for (unsigned i = 0; i < 100000; ++i) {
+        scoped_timer t(1000 + i % 3000, &eh);
+    }
+    sw.stop();
+    std::cout << "registered and canceled 100000 timers in " << sw.get_seconds() << " secs\n";
+    ENSURE(eh.m_count == 0);
+}
+
+static void tst_wrap() {
+    // timers that are further away than a full turn of the wheel.
+    counting_eh eh1, eh2;
+    {
+        scoped_timer t1(1500, &eh1);
+        scoped_timer t2(3000, &eh2);
+        wait_for(eh1, 30.0);
+        ENSURE(eh1.m_count == 1);
+        ENSURE(eh2.m_count == 0);
+    }
+    ENSURE(eh2.m_count == 0);
+}
+
+void tst_scoped_timer() {
+    tst_fire();
+    tst_cancel();
+    tst_wrap();
+}
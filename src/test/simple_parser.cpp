@@ -24,6 +24,15 @@ Revision History:
 #include"warning.h"
 #include"reg_decl_plugins.h"
 
+static void check_compiled(cost_evaluator & eval, expr * f, unsigned num_vals, float const * vals) {
+    cost_evaluator::program p;
+    eval.compile(f, num_vals, p);
+    float v1 = eval(f, num_vals, vals);
+    float v2 = eval(p, vals);
+    TRACE("simple_parser", tout << "val: " << v1 << " compiled: " << v2 << "\n"; p.display(tout););
+    ENSURE(v1 == v2);
+}
+
 void tst_simple_parser() {
     ast_manager    m;
     reg_decl_plugins(m);
@@ -58,5 +67,16 @@ void tst_simple_parser() {
     TRACE("simple_parser", 
           tout << mk_pp(r, m) << "\n";
           tout << "val: " << eval(r, 2, vals) << "\n";);
-}
 
+    char const * fmls[] = {
+        "(+ x y)", "x", "7", "(+ x (* y x) x)", "(- x y 1)", "(/ x (- y 3))",
+        "(ite (and (> x 3) (<= y 4))  2 10)", "(ite (or (> x 3) (<= y 4))  2 10)",
+        "(ite (implies (< x y) (not (= x 2))) (* 2 (- x)) (ite (xor (>= x y) true) y 5))"
+    };
+    for (unsigned i = 0; i < sizeof(fmls)/sizeof(*fmls); ++i) {
+        VERIFY(p.parse_string(fmls[i], r));
+        check_compiled(eval, r, 2, vals);
+        float vals2[2] = { 5.0f, 1.5f };
+        check_compiled(eval, r, 2, vals2);
+    }
+}
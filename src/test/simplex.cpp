@@ -12,6 +12,7 @@ Copyright (c) 2015 Microsoft Corporation
 #include "vector.h"
 #include "rational.h"
 #include "rlimit.h"
+#include "fp_simplex.h"
 
 #define R rational
 typedef simplex::simplex<simplex::mpz_ext> Simplex;
@@ -132,6 +133,28 @@ static void test4() {
     feas(S);
 }
 
+// s = x + y, s >= 3, 0 <= x <= 1, 0 <= y <= y_upper
+static void test_fp(double y_upper, lbool expected) {
+    simplex::fp_simplex S;
+    S.reset(3);
+    unsigned vars[2] = { 1, 2 };
+    double coeffs[2] = { 1.0, 1.0 };
+    S.add_row(0, 2, vars, coeffs);
+    S.set_lower(0, 3.0);
+    S.set_lower(1, 0.0);
+    S.set_upper(1, 1.0);
+    S.set_lower(2, 0.0);
+    S.set_upper(2, y_upper);
+    lbool is_sat = S.make_feasible(100);
+    std::cout << "fp feasible: " << is_sat << "\n";
+    ENSURE(is_sat == expected);
+    if (is_sat == l_true) {
+        ENSURE(S.get_value(0) >= 3.0 - 1e-6);
+        ENSURE(S.get_value(1) + S.get_value(2) >= 3.0 - 1e-6);
+        ENSURE(S.get_value(2) <= y_upper);
+    }
+}
+
 void tst_simplex() {
     reslimit rl; Simplex S(rl);
 
@@ -167,4 +190,6 @@ void tst_simplex() {
     test2();
     test3();
     test4();
+    test_fp(2.0, l_true);
+    test_fp(1.0, l_false);
 }
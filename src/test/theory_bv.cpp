@@ -0,0 +1,135 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    theory_bv.cpp
+
+Abstract:
+
+    Test lazy bit-blasting of multipliers and dividers against
+    their circuits.
+
+Author:
+
+
+Revision History:
+
+--*/
+#include"smt_context.h"
+#include"bv_decl_plugin.h"
+#include"reg_decl_plugins.h"
+#include"ast_pp.h"
+#include"model.h"
+#include"statistics.h"
+#include<iostream>
+
+static unsigned get_stat(smt::context const & ctx, char const * key) {
+    statistics st;
+    ctx.collect_statistics(st);
+    for (unsigned i = 0; i < st.size(); ++i) {
+        if (std::string(key) == st.get_key(i)) {
+            return st.get_uint_value(i);
+        }
+    }
+    return 0;
+}
+
+static rational get_value(smt::context & ctx, expr * e) {
+    bv_util bv(ctx.get_manager());
+    model_ref mdl;
+    ctx.get_model(mdl);
+    expr_ref val(ctx.get_manager());
+    ENSURE(mdl->eval(e, val, true));
+    rational r;
+    unsigned sz;
+    ENSURE(bv.is_numeral(val, r, sz));
+    return r;
+}
+
+static void mk_params(smt_params & p, bool lazy) {
+    p.m_model = true;
+    p.m_bv_lazy = lazy;
+    p.m_bv_lazy_min_size = 4;
+}
+
+// the value of op(x, y) for fixed arguments, including division by zero,
+// is the value computed by its circuit.
+static void tst_lazy_values(ast_manager & m, decl_kind k, random_gen & r) {
+    bv_util bv(m);
+    unsigned const sz = 6;
+    expr_ref x(m.mk_const(symbol("x"), bv.mk_sort(sz)), m);
+    expr_ref y(m.mk_const(symbol("y"), bv.mk_sort(sz)), m);
+    expr_ref t(m.mk_app(bv.get_fid(), k, x, y), m);
+    expr_ref res(m.mk_const(symbol("res"), bv.mk_sort(sz)), m);
+    smt_params p1, p2;
+    mk_params(p1, true);
+    mk_params(p2, false);
+    smt::context lazy(m, p1), eager(m, p2);
+    lazy.assert_expr(m.mk_eq(res, t));
+    eager.assert_expr(m.mk_eq(res, t));
+    for (unsigned i = 0; i < 40; ++i) {
+        unsigned a = r(1u << sz);
+        // every fourth divisor is zero.
+        unsigned b = i % 4 == 0 ? 0 : r(1u << sz);
+        expr_ref fml(m.mk_and(m.mk_eq(x, bv.mk_numeral(rational(a), sz)), m.mk_eq(y, bv.mk_numeral(rational(b), sz))), m);
+        lazy.push();
+        eager.push();
+        lazy.assert_expr(fml);
+        eager.assert_expr(fml);
+        ENSURE(lazy.check() == l_true);
+        ENSURE(eager.check() == l_true);
+        rational v1 = get_value(lazy, res), v2 = get_value(eager, res);
+        if (v1 != v2) {
+            std::cout << mk_pp(t, m) << " x: " << a << " y: " << b << " lazy: " << v1 << " eager: " << v2 << "\n";
+        }
+        ENSURE(v1 == v2);
+        lazy.pop(1);
+        eager.pop(1);
+    }
+    ENSURE(get_stat(lazy, "bv lazy lemmas") > 0);
+}
+
+// constraints over the results of lazy terms have the same models as with their circuits.
+static void tst_lazy_search(ast_manager & m, decl_kind k, random_gen & r) {
+    bv_util bv(m);
+    unsigned const sz = 6;
+    for (unsigned i = 0; i < 20; ++i) {
+        expr_ref x(m.mk_const(symbol("x"), bv.mk_sort(sz)), m);
+        expr_ref y(m.mk_const(symbol("y"), bv.mk_sort(sz)), m);
+        expr_ref t(m.mk_app(bv.get_fid(), k, x, y), m);
+        expr_ref c(bv.mk_numeral(rational(r(1u << sz)), sz), m);
+        expr_ref_vector fmls(m);
+        fmls.push_back(m.mk_eq(t, c));
+        fmls.push_back(bv.mk_ule(bv.mk_numeral(rational(r(8)), sz), y));
+        fmls.push_back(bv.mk_ule(y, x));
+        smt_params p1, p2;
+        mk_params(p1, true);
+        mk_params(p2, false);
+        smt::context lazy(m, p1), eager(m, p2);
+        for (unsigned j = 0; j < fmls.size(); ++j) {
+            lazy.assert_expr(fmls.get(j));
+            eager.assert_expr(fmls.get(j));
+        }
+        lbool r1 = lazy.check();
+        lbool r2 = eager.check();
+        ENSURE(r1 == r2);
+        if (r1 == l_true) {
+            // the model of the lazy solver is a model of the circuits.
+            eager.assert_expr(m.mk_eq(x, bv.mk_numeral(get_value(lazy, x), sz)));
+            eager.assert_expr(m.mk_eq(y, bv.mk_numeral(get_value(lazy, y), sz)));
+            ENSURE(eager.check() == l_true);
+        }
+    }
+}
+
+void tst_theory_bv() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    random_gen r(0);
+    decl_kind kinds[6] = { OP_BMUL, OP_BUDIV_I, OP_BUREM_I, OP_BSDIV_I, OP_BSREM_I, OP_BSMOD_I };
+    for (unsigned i = 0; i < 6; ++i) {
+        tst_lazy_values(m, kinds[i], r);
+        tst_lazy_search(m, kinds[i], r);
+    }
+}
@@ -0,0 +1,122 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    thread_pool.cpp
+
+Abstract:
+
+    Test nested task groups on the shared thread pool.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include"thread_pool.h"
+#include"scoped_ptr_vector.h"
+#include"z3_exception.h"
+#include"debug.h"
+#include"util.h"
+#include<iostream>
+
+static unsigned fib(unsigned n) {
+    return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+// computes fib(m_n) by spawning a nested group for n - 1 and n - 2.
+class fib_task : public task {
+    unsigned m_n;
+public:
+    unsigned m_result;
+    fib_task(unsigned n): m_n(n), m_result(0) {}
+    virtual void operator()() {
+        if (m_n < 10) {
+            m_result = fib(m_n);
+            return;
+        }
+        fib_task t1(m_n - 1), t2(m_n - 2);
+        task_group g;
+        g.spawn(t1);
+        g.spawn(t2);
+        g.wait();
+        m_result = t1.m_result + t2.m_result;
+    }
+};
+
+class sum_task : public task {
+    unsigned & m_sum;
+    unsigned   m_val;
+public:
+    sum_task(unsigned & sum, unsigned v): m_sum(sum), m_val(v) {}
+    virtual void operator()() {
+        scoped_task_lock lock;
+        m_sum += m_val;
+    }
+};
+
+class failing_task : public task {
+public:
+    virtual void operator()() { throw default_exception("task failed"); }
+};
+
+static void tst_nested() {
+    fib_task t(25);
+    task_group g;
+    g.spawn(t);
+    g.wait();
+    ENSURE(t.m_result == fib(25));
+}
+
+static void tst_sum() {
+    unsigned sum = 0;
+    scoped_ptr_vector<sum_task> ts;
+    task_group g;
+    for (unsigned i = 1; i <= 1000; ++i) {
+        sum_task * t = alloc(sum_task, sum, i);
+        ts.push_back(t);
+        g.spawn(*t);
+    }
+    g.wait();
+    ENSURE(sum == 500500);
+}
+
+static void tst_exception() {
+    unsigned sum = 0;
+    sum_task t1(sum, 1), t2(sum, 2);
+    failing_task t3;
+    task_group g;
+    g.spawn(t1);
+    g.spawn(t3);
+    g.spawn(t2);
+    bool caught = false;
+    try {
+        g.wait();
+    }
+    catch (z3_exception & ex) {
+        caught = true;
+        std::cout << "caught: " << ex.msg() << "\n";
+    }
+    ENSURE(caught);
+    ENSURE(sum == 3);
+    // the group can be reused after the exception was reported.
+    g.spawn(t1);
+    g.wait();
+    ENSURE(sum == 4);
+}
+
+void tst_thread_pool() {
+    std::cout << "max threads: " << thread_pool::get_max_threads() << "\n";
+    tst_nested();
+    tst_sum();
+    tst_exception();
+    thread_pool::set_max_threads(1);
+    tst_nested();
+    thread_pool::set_max_threads(4);
+    tst_nested();
+    tst_sum();
+    thread_pool::set_max_threads(0);
+}
@@ -162,7 +162,12 @@ public:
     }
 
     checked_int64& operator*=(checked_int64 const& other) {
-        if (CHECK) {
+        if (CHECK && INT_MIN <= m_value && m_value <= INT_MAX &&
+            INT_MIN <= other.m_value && other.m_value <= INT_MAX) {
+            // the product of two 32-bit values fits in 64 bits.
+            m_value *= other.m_value;
+        }
+        else if (CHECK) {
             rational r(r64(m_value) * r64(other.m_value));
             if (!r.is_int64()) {
                 throw overflow_exception();
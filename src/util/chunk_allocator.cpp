@@ -0,0 +1,180 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    chunk_allocator.cpp
+
+Abstract:
+
+    Backends used by small_object_allocator and region to
+    obtain the chunks (pages) they carve objects from.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include"chunk_allocator.h"
+#include"memory_manager.h"
+#include"statistics.h"
+#include"debug.h"
+#if defined(_LINUX_)
+#include<sys/mman.h>
+#endif
+
+static bool g_use_arenas = false;
+
+void chunk_allocator::set_use_arenas(bool f) {
+    g_use_arenas = f;
+}
+
+bool chunk_allocator::use_arenas() {
+    return g_use_arenas;
+}
+
+class memory_chunk_allocator : public chunk_allocator {
+public:
+    virtual void * allocate_chunk(size_t sz) { return memory::allocate(sz); }
+    virtual void deallocate_chunk(void * p) { memory::deallocate(p); }
+};
+
+chunk_allocator & default_chunk_allocator() {
+    static memory_chunk_allocator g_default;
+    return g_default;
+}
+
+chunk_allocator * mk_context_chunk_allocator() {
+    if (g_use_arenas)
+        return alloc(arena_chunk_allocator);
+    return 0;
+}
+
+// Every chunk is preceded by a header containing the arena it was carved from,
+// or 0 if it was obtained directly from the memory manager.
+#define CHUNK_HEADER_SZ sizeof(void*)
+#define HUGE_PAGE_SIZE  (2*1024*1024)
+
+inline void * & chunk_header(void * p) { return reinterpret_cast<void**>(p)[-1]; }
+
+arena_chunk_allocator::arena_chunk_allocator(size_t max_chunk_size, size_t arena_size):
+    m_slot_size(max_chunk_size + CHUNK_HEADER_SZ),
+    m_arena_size(arena_size),
+    m_hint(0),
+    m_num_live(0),
+    m_num_direct(0),
+    m_num_reclaimed(0) {
+    // slots must preserve the alignment of the memory manager.
+    m_slot_size = (m_slot_size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+    if (m_arena_size < m_slot_size)
+        m_arena_size = m_slot_size;
+}
+
+arena_chunk_allocator::~arena_chunk_allocator() {
+    for (unsigned i = 0; i < m_arenas.size(); i++) {
+        memory::deallocate(m_arenas[i]->m_mem);
+        dealloc(m_arenas[i]);
+    }
+}
+
+arena_chunk_allocator::arena * arena_chunk_allocator::mk_arena() {
+    arena * a    = alloc(arena);
+    a->m_mem     = static_cast<char*>(memory::allocate(m_arena_size));
+    a->m_curr    = a->m_mem;
+    a->m_end     = a->m_mem + m_arena_size;
+    a->m_free    = 0;
+    a->m_num_live = 0;
+#if defined(_LINUX_) && defined(MADV_HUGEPAGE)
+    // ask for transparent huge pages on the aligned part of the arena.
+    size_t begin = (reinterpret_cast<size_t>(a->m_mem) + HUGE_PAGE_SIZE - 1) & ~static_cast<size_t>(HUGE_PAGE_SIZE - 1);
+    size_t end   = reinterpret_cast<size_t>(a->m_end) & ~static_cast<size_t>(HUGE_PAGE_SIZE - 1);
+    if (begin < end)
+        madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+#endif
+    m_arenas.push_back(a);
+    return a;
+}
+
+void arena_chunk_allocator::del_arena(unsigned idx) {
+    arena * a = m_arenas[idx];
+    SASSERT(a->m_num_live == 0);
+    memory::deallocate(a->m_mem);
+    dealloc(a);
+    m_arenas[idx] = m_arenas.back();
+    m_arenas.pop_back();
+    m_hint = 0;
+    m_num_reclaimed++;
+}
+
+void * arena_chunk_allocator::allocate_slot(arena & a) {
+    char * r;
+    if (a.m_free != 0) {
+        r = static_cast<char*>(a.m_free);
+        a.m_free = *reinterpret_cast<void**>(r);
+    }
+    else {
+        SASSERT(a.m_curr + m_slot_size <= a.m_end);
+        r = a.m_curr;
+        a.m_curr += m_slot_size;
+    }
+    a.m_num_live++;
+    m_num_live++;
+    r += CHUNK_HEADER_SZ;
+    chunk_header(r) = &a;
+    return r;
+}
+
+void * arena_chunk_allocator::allocate_chunk(size_t sz) {
+    if (sz + CHUNK_HEADER_SZ > m_slot_size) {
+        char * r = static_cast<char*>(memory::allocate(sz + CHUNK_HEADER_SZ)) + CHUNK_HEADER_SZ;
+        chunk_header(r) = 0;
+        m_num_direct++;
+        return r;
+    }
+    unsigned num_arenas = m_arenas.size();
+    for (unsigned i = 0; i < num_arenas; i++) {
+        unsigned idx = (m_hint + i) % num_arenas;
+        arena & a = *m_arenas[idx];
+        if (a.m_free != 0 || a.m_curr + m_slot_size <= a.m_end) {
+            m_hint = idx;
+            return allocate_slot(a);
+        }
+    }
+    m_hint = m_arenas.size();
+    return allocate_slot(*mk_arena());
+}
+
+void arena_chunk_allocator::deallocate_chunk(void * p) {
+    arena * a = static_cast<arena*>(chunk_header(p));
+    char * slot = static_cast<char*>(p) - CHUNK_HEADER_SZ;
+    if (a == 0) {
+        SASSERT(m_num_direct > 0);
+        m_num_direct--;
+        memory::deallocate(slot);
+        return;
+    }
+    SASSERT(a->m_num_live > 0);
+    *reinterpret_cast<void**>(slot) = a->m_free;
+    a->m_free = slot;
+    a->m_num_live--;
+    m_num_live--;
+    if (a->m_num_live == 0 && m_arenas.size() > 1) {
+        // the whole arena is free, give it back to the memory manager.
+        // The last arena is kept to avoid allocating and releasing an arena repeatedly.
+        for (unsigned i = 0; i < m_arenas.size(); i++) {
+            if (m_arenas[i] == a) {
+                del_arena(i);
+                break;
+            }
+        }
+    }
+}
+
+void arena_chunk_allocator::collect_statistics(statistics & st) const {
+    st.update("arena count", m_arenas.size());
+    st.update("arena chunks", m_num_live);
+    st.update("arena direct chunks", m_num_direct);
+    st.update("arena reclaimed", m_num_reclaimed);
+}
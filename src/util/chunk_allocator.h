@@ -0,0 +1,91 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    chunk_allocator.h
+
+Abstract:
+
+    Backends used by small_object_allocator and region to
+    obtain the chunks (pages) they carve objects from.
+
+    The default backend forwards every request to the memory manager.
+    The arena backend carves chunks out of large arenas that are backed
+    by transparent huge pages when the platform supports them, and
+    returns an arena to the memory manager as soon as all its chunks are free.
+    An arena backend is meant to be owned by a single context.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#ifndef CHUNK_ALLOCATOR_H_
+#define CHUNK_ALLOCATOR_H_
+
+#include"vector.h"
+
+class statistics;
+
+class chunk_allocator {
+public:
+    virtual ~chunk_allocator() {}
+    virtual void * allocate_chunk(size_t sz) = 0;
+    virtual void deallocate_chunk(void * p) = 0;
+    virtual void collect_statistics(statistics & st) const {}
+
+    /**
+       \brief When enabled, every context (ast_manager) allocates its small objects
+       from its own arena_chunk_allocator. This method is only safe to invoke at
+       initialization time, that is, before the threads are created.
+    */
+    static void set_use_arenas(bool f);
+    static bool use_arenas();
+};
+
+/**
+   \brief Return the shared backend that uses memory::allocate directly.
+*/
+chunk_allocator & default_chunk_allocator();
+
+/**
+   \brief Return a fresh arena backend if arenas are enabled (see chunk_allocator::set_use_arenas),
+   and 0 otherwise.
+*/
+chunk_allocator * mk_context_chunk_allocator();
+
+class arena_chunk_allocator : public chunk_allocator {
+    struct arena {
+        char *   m_mem;        // block obtained from the memory manager.
+        char *   m_curr;       // next slot that was never handed out.
+        char *   m_end;
+        void *   m_free;       // slots that were handed out and returned.
+        unsigned m_num_live;   // slots currently in use.
+    };
+    size_t            m_slot_size;    // chunk size (including header) served from the arenas.
+    size_t            m_arena_size;
+    ptr_vector<arena> m_arenas;
+    unsigned          m_hint;         // index of an arena that probably has free slots.
+    unsigned          m_num_live;     // chunks served from the arenas.
+    unsigned          m_num_direct;   // chunks too large for an arena.
+    unsigned          m_num_reclaimed;
+
+    arena * mk_arena();
+    void del_arena(unsigned idx);
+    void * allocate_slot(arena & a);
+public:
+    /**
+       \brief Chunks of at most max_chunk_size bytes are carved from arenas of arena_size bytes.
+       Larger chunks are obtained directly from the memory manager.
+    */
+    arena_chunk_allocator(size_t max_chunk_size = 8192, size_t arena_size = 4*1024*1024);
+    virtual ~arena_chunk_allocator();
+    virtual void * allocate_chunk(size_t sz);
+    virtual void deallocate_chunk(void * p);
+    virtual void collect_statistics(statistics & st) const;
+};
+
+#endif /* CHUNK_ALLOCATOR_H_ */
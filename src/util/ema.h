@@ -0,0 +1,51 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    ema.h
+
+Abstract:
+
+    Exponential moving average.
+
+    The first samples are averaged uniformly (the smoothing factor is
+    1/n for the n'th sample until it drops below alpha), this removes
+    the bias towards the initial value 0.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#ifndef EMA_H_
+#define EMA_H_
+
+class ema {
+    double   m_alpha;
+    double   m_value;
+    unsigned m_count;
+public:
+    ema(double alpha = 0.03): m_alpha(alpha), m_value(0), m_count(0) {}
+
+    void set_alpha(double alpha) { m_alpha = alpha; }
+
+    void reset() { m_value = 0; m_count = 0; }
+
+    void update(double x) {
+        double beta = m_alpha;
+        if (1.0 / (m_count + 1) > m_alpha) {
+            ++m_count;
+            beta = 1.0 / m_count;
+        }
+        m_value += beta * (x - m_value);
+    }
+
+    double get() const { return m_value; }
+
+    operator double() const { return m_value; }
+};
+
+#endif /* EMA_H_ */
@@ -21,6 +21,8 @@ Notes:
 #include"gparams.h"
 #include"util.h"
 #include"memory_manager.h"
+#include"chunk_allocator.h"
+#include"thread_pool.h"
 
 void env_params::updt_params() {
     params_ref p = gparams::get();
@@ -29,6 +31,8 @@ void env_params::updt_params() {
     memory::set_max_size(megabytes_to_bytes(p.get_uint("memory_max_size", 0)));
     memory::set_max_alloc_count(p.get_uint("memory_max_alloc_count", 0));
     memory::set_high_watermark(p.get_uint("memory_high_watermark", 0));
+    chunk_allocator::set_use_arenas(p.get_bool("memory_arenas", false));
+    thread_pool::set_max_threads(p.get_uint("max_threads", 0));
 }
 
 void env_params::collect_param_descrs(param_descrs & d) {
@@ -37,4 +41,6 @@ void env_params::collect_param_descrs(param_descrs & d) {
     d.insert("memory_max_size", CPK_UINT, "set hard upper limit for memory consumption (in megabytes), if 0 then there is no limit", "0");
     d.insert("memory_max_alloc_count", CPK_UINT, "set hard upper limit for memory allocations, if 0 then there is no limit", "0");
     d.insert("memory_high_watermark", CPK_UINT, "set high watermark for memory consumption (in megabytes), if 0 then there is no limit", "0");
+    d.insert("memory_arenas", CPK_BOOL, "allocate the small objects of each context from arenas owned by the context, the arenas use huge pages when available", "false");
+    d.insert("max_threads", CPK_UINT, "maximal number of threads executing parallel tactics (par-or, par-then), if 0 then the number of processors is used", "0");
 }
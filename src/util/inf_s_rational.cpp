@@ -0,0 +1,30 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    inf_s_rational.cpp
+
+Abstract:
+
+    Numbers of the form r + k*epsilon where r and k are s_rationals.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include<sstream>
+#include"inf_s_rational.h"
+
+inf_s_rational inf_s_rational::m_zero(0);
+inf_s_rational inf_s_rational::m_one(1);
+inf_s_rational inf_s_rational::m_minus_one(-1);
+
+std::string inf_s_rational::to_string() const {
+    std::ostringstream buffer;
+    buffer << *this;
+    return buffer.str();
+}
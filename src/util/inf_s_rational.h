@@ -0,0 +1,369 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    inf_s_rational.h
+
+Abstract:
+
+    Numbers of the form r + k*epsilon where r and k are s_rationals.
+    Counterpart of inf_rational for s_rational.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#ifndef INF_S_RATIONAL_H_
+#define INF_S_RATIONAL_H_
+
+#include"s_rational.h"
+
+class inf_s_rational {
+    static inf_s_rational m_zero;
+    static inf_s_rational m_one;
+    static inf_s_rational m_minus_one;
+    s_rational m_first;
+    s_rational m_second;
+ public:
+
+    unsigned hash() const {
+        return m_first.hash() ^ (m_second.hash() + 1);
+    }
+
+    struct hash_proc {  unsigned operator()(inf_s_rational const& r) const { return r.hash(); }  };
+
+    struct eq_proc { bool operator()(inf_s_rational const& r1, inf_s_rational const& r2) const { return r1 == r2; } };
+
+    void swap(inf_s_rational & n) {
+        m_first.swap(n.m_first);
+        m_second.swap(n.m_second);
+    }
+
+    std::string to_string() const;
+
+    inf_s_rational() {}
+
+    inf_s_rational(const inf_s_rational & r):m_first(r.m_first), m_second(r.m_second) {}
+
+    explicit inf_s_rational(int n):m_first(n) {}
+
+    explicit inf_s_rational(int n, int d):m_first(n, d) {}
+
+    explicit inf_s_rational(s_rational const& r, bool pos_inf):m_first(r), m_second(pos_inf ? s_rational::one() : s_rational::minus_one()) {}
+
+    explicit inf_s_rational(s_rational const& r):m_first(r) {}
+
+    explicit inf_s_rational(rational const& r):m_first(r) {}
+
+    inf_s_rational(s_rational const& r, s_rational const& i):m_first(r), m_second(i) {}
+
+    void reset() {
+        m_first.reset();
+        m_second.reset();
+    }
+
+    bool is_int() const { return m_first.is_int() && m_second.is_zero(); }
+
+    bool is_int64() const { return m_first.is_int64() && m_second.is_zero(); }
+
+    bool is_uint64() const { return m_first.is_uint64() && m_second.is_zero(); }
+
+    bool is_rational() const { return m_second.is_zero(); }
+
+    int64 get_int64() const { SASSERT(is_int64()); return m_first.get_int64(); }
+
+    uint64 get_uint64() const { SASSERT(is_uint64()); return m_first.get_uint64(); }
+
+    s_rational const& get_rational() const { return m_first; }
+
+    s_rational const& get_infinitesimal() const { return m_second; }
+
+    inf_s_rational & operator=(const inf_s_rational & r) {
+        m_first  = r.m_first;
+        m_second = r.m_second;
+        return *this;
+    }
+
+    inf_s_rational & operator=(const rational & r) {
+        m_first  = s_rational(r);
+        m_second.reset();
+        return *this;
+    }
+
+    inf_s_rational & operator=(const s_rational & r) {
+        m_first  = r;
+        m_second.reset();
+        return *this;
+    }
+
+    friend inline inf_s_rational numerator(const inf_s_rational & r) {
+        SASSERT(r.m_second.is_zero());
+        return inf_s_rational(numerator(r.m_first));
+    }
+
+    friend inline inf_s_rational denominator(const inf_s_rational & r) {
+        SASSERT(r.m_second.is_zero());
+        return inf_s_rational(denominator(r.m_first));
+    }
+
+    inf_s_rational & operator+=(const inf_s_rational & r) {
+        m_first  += r.m_first;
+        m_second += r.m_second;
+        return *this;
+    }
+
+    inf_s_rational & operator-=(const inf_s_rational & r) {
+        m_first  -= r.m_first;
+        m_second -= r.m_second;
+        return *this;
+    }
+
+    inf_s_rational & operator+=(const s_rational & r) {
+        m_first  += r;
+        return *this;
+    }
+
+    inf_s_rational & operator-=(const s_rational & r) {
+        m_first  -= r;
+        return *this;
+    }
+
+    inf_s_rational & operator*=(const s_rational & r1) {
+        m_first  *= r1;
+        m_second *= r1;
+        return *this;
+    }
+
+    inf_s_rational & operator/=(const s_rational & r) {
+        m_first  /= r;
+        m_second /= r;
+        return *this;
+    }
+
+    friend inline inf_s_rational operator*(const s_rational & r1, const inf_s_rational & r2);
+    friend inline inf_s_rational operator/(const inf_s_rational & r1, const s_rational & r2);
+
+    inf_s_rational & operator++() {
+        ++m_first;
+        return *this;
+    }
+
+    const inf_s_rational operator++(int) { inf_s_rational tmp(*this); ++(*this); return tmp; }
+
+    inf_s_rational & operator--() {
+        --m_first;
+        return *this;
+    }
+
+    const inf_s_rational operator--(int) { inf_s_rational tmp(*this); --(*this); return tmp; }
+
+    friend inline bool operator==(const inf_s_rational & r1, const inf_s_rational & r2) {
+        return r1.m_first == r2.m_first && r1.m_second == r2.m_second;
+    }
+
+    friend inline bool operator==(const s_rational & r1, const inf_s_rational & r2) {
+        return r1 == r2.m_first && r2.m_second.is_zero();
+    }
+
+    friend inline bool operator==(const inf_s_rational & r1, const s_rational & r2) {
+        return r1.m_first == r2 && r1.m_second.is_zero();
+    }
+
+    friend inline bool operator<(const inf_s_rational & r1, const inf_s_rational & r2) {
+        return
+            (r1.m_first < r2.m_first) ||
+            (r1.m_first == r2.m_first && r1.m_second < r2.m_second);
+    }
+
+    friend inline bool operator<(const s_rational & r1, const inf_s_rational & r2) {
+        return
+            (r1 < r2.m_first) ||
+            (r1 == r2.m_first && r2.m_second.is_pos());
+    }
+
+    friend inline bool operator<(const inf_s_rational & r1, const s_rational & r2) {
+        return
+            (r1.m_first < r2) ||
+            (r1.m_first == r2 && r1.m_second.is_neg());
+    }
+
+    void neg() {
+        m_first.neg();
+        m_second.neg();
+    }
+
+    bool is_zero() const {
+        return m_first.is_zero() && m_second.is_zero();
+    }
+
+    bool is_one() const {
+        return m_first.is_one() && m_second.is_zero();
+    }
+
+    bool is_minus_one() const {
+        return m_first.is_minus_one() && m_second.is_zero();
+    }
+
+    bool is_neg() const {
+        return m_first.is_neg() || (m_first.is_zero() && m_second.is_neg());
+    }
+
+    bool is_pos() const {
+        return m_first.is_pos() || (m_first.is_zero() && m_second.is_pos());
+    }
+
+    bool is_nonneg() const {
+        return m_first.is_pos() || (m_first.is_zero() && m_second.is_nonneg());
+    }
+
+    bool is_nonpos() const {
+        return m_first.is_neg() || (m_first.is_zero() && m_second.is_nonpos());
+    }
+
+    friend inline s_rational floor(const inf_s_rational & r) {
+        if (r.m_first.is_int()) {
+            if (r.m_second.is_nonneg()) {
+                return r.m_first;
+            }
+            return r.m_first - s_rational::one();
+        }
+        return floor(r.m_first);
+    }
+
+    friend inline s_rational ceil(const inf_s_rational & r) {
+        if (r.m_first.is_int()) {
+            if (r.m_second.is_nonpos()) {
+                return r.m_first;
+            }
+            return r.m_first + s_rational::one();
+        }
+        return ceil(r.m_first);
+    }
+
+    static const inf_s_rational & zero() {
+        return m_zero;
+    }
+
+    static const inf_s_rational & one() {
+        return m_one;
+    }
+
+    static const inf_s_rational & minus_one() {
+        return m_minus_one;
+    }
+
+    // Perform: this += c * k
+    void addmul(const s_rational & c, const inf_s_rational & k) {
+        m_first.addmul(c, k.m_first);
+        m_second.addmul(c, k.m_second);
+    }
+
+    // Perform: this -= c * k
+    void submul(const s_rational & c, const inf_s_rational & k) {
+        m_first.submul(c, k.m_first);
+        m_second.submul(c, k.m_second);
+    }
+
+    friend inline std::ostream & operator<<(std::ostream & target, const inf_s_rational & r) {
+        if (r.m_second.is_zero()) {
+            target << r.m_first;
+        }
+        else if (r.m_second.is_neg()) {
+            target << "(" << r.m_first << " -e*" << (-r.m_second) << ")";
+        }
+        else {
+            target << "(" << r.m_first << " +e*" << r.m_second << ")";
+        }
+        return target;
+    }
+};
+
+inline bool operator!=(const inf_s_rational & r1, const inf_s_rational & r2) {
+    return !operator==(r1, r2);
+}
+
+inline bool operator!=(const s_rational & r1, const inf_s_rational & r2) {
+    return !operator==(r1, r2);
+}
+
+inline bool operator!=(const inf_s_rational & r1, const s_rational & r2) {
+    return !operator==(r1, r2);
+}
+
+inline bool operator>(const inf_s_rational & r1, const inf_s_rational & r2) {
+    return operator<(r2, r1);
+}
+
+inline bool operator>(const inf_s_rational & r1, const s_rational & r2) {
+    return operator<(r2, r1);
+}
+
+inline bool operator>(const s_rational & r1, const inf_s_rational & r2) {
+    return operator<(r2, r1);
+}
+
+inline bool operator<=(const inf_s_rational & r1, const inf_s_rational & r2) {
+    return !operator>(r1, r2);
+}
+
+inline bool operator<=(const s_rational & r1, const inf_s_rational & r2) {
+    return !operator>(r1, r2);
+}
+
+inline bool operator<=(const inf_s_rational & r1, const s_rational & r2) {
+    return !operator>(r1, r2);
+}
+
+inline bool operator>=(const inf_s_rational & r1, const inf_s_rational & r2) {
+    return !operator<(r1, r2);
+}
+
+inline bool operator>=(const s_rational & r1, const inf_s_rational & r2) {
+    return !operator<(r1, r2);
+}
+
+inline bool operator>=(const inf_s_rational & r1, const s_rational & r2) {
+    return !operator<(r1, r2);
+}
+
+inline inf_s_rational operator+(const inf_s_rational & r1, const inf_s_rational & r2) {
+    return inf_s_rational(r1) += r2;
+}
+
+inline inf_s_rational operator-(const inf_s_rational & r1, const inf_s_rational & r2) {
+    return inf_s_rational(r1) -= r2;
+}
+
+inline inf_s_rational operator-(const inf_s_rational & r) {
+    inf_s_rational result(r);
+    result.neg();
+    return result;
+}
+
+inline inf_s_rational operator*(const s_rational & r1, const inf_s_rational & r2) {
+    inf_s_rational result(r2);
+    result.m_first  *= r1;
+    result.m_second *= r1;
+    return result;
+}
+
+inline inf_s_rational operator/(const inf_s_rational & r1, const s_rational & r2) {
+    inf_s_rational result(r1);
+    result.m_first  /= r2;
+    result.m_second /= r2;
+    return result;
+}
+
+inline inf_s_rational abs(const inf_s_rational & r) {
+    inf_s_rational result(r);
+    if (result.is_neg()) {
+        result.neg();
+    }
+    return result;
+}
+
+#endif /* INF_S_RATIONAL_H_ */
@@ -11,6 +11,9 @@ Copyright (c) 2015 Microsoft Corporation
 #include"memory_manager.h"
 #include"error_codes.h"
 #include"z3_omp.h"
+#ifdef _WINDOWS
+#include<intrin.h>
+#endif
 // The following two function are automatically generated by the mk_make.py script.
 // The script collects ADD_INITIALIZER and ADD_FINALIZER commands in the .h files.
 // For example, rational.h contains
@@ -36,16 +39,52 @@ out_of_memory_error::out_of_memory_error():z3_error(ERR_MEMOUT) {
 
 static volatile bool g_memory_out_of_memory  = false;
 static bool       g_memory_initialized       = false;
-static long long  g_memory_alloc_size        = 0;
+static volatile long long g_memory_alloc_size    = 0;
 static long long  g_memory_max_size          = 0;
-static long long  g_memory_max_used_size     = 0;
+static volatile long long g_memory_max_used_size = 0;
 static long long  g_memory_watermark         = 0;
-static long long  g_memory_alloc_count       = 0;
+static volatile long long g_memory_alloc_count   = 0;
 static long long  g_memory_max_alloc_count   = 0;
 static bool       g_exit_when_out_of_memory  = false;
 static char const * g_out_of_memory_msg      = "ERROR: out of memory";
 static volatile bool g_memory_fully_initialized = false;
 
+// Atomic operations used to update the global counters without a critical section.
+#ifdef _WINDOWS
+static inline long long atomic_add(volatile long long * p, long long delta) {
+    return _InterlockedExchangeAdd64(p, delta) + delta;
+}
+static inline long long atomic_cas(volatile long long * p, long long old_val, long long new_val) {
+    return _InterlockedCompareExchange64(p, new_val, old_val);
+}
+#else
+static inline long long atomic_add(volatile long long * p, long long delta) {
+    return __sync_add_and_fetch(p, delta);
+}
+static inline long long atomic_cas(volatile long long * p, long long old_val, long long new_val) {
+    return __sync_val_compare_and_swap(p, old_val, new_val);
+}
+#endif
+
+static inline long long atomic_read(volatile long long * p) {
+    return atomic_add(p, 0);
+}
+
+static inline void atomic_max(volatile long long * p, long long val) {
+    long long curr = *p;
+    while (curr < val) {
+        long long prev = atomic_cas(p, curr, val);
+        if (prev == curr)
+            break;
+        curr = prev;
+    }
+}
+
+bool memory_budget::update(long long delta) {
+    long long sz = atomic_add(&m_size, delta);
+    return delta > 0 && m_max_size != 0 && sz > m_max_size;
+}
+
 void memory::exit_when_out_of_memory(bool flag, char const * msg) {
     g_exit_when_out_of_memory = flag;
     if (flag && msg)
@@ -53,10 +92,7 @@ void memory::exit_when_out_of_memory(bool flag, char const * msg) {
 }
 
 static void throw_out_of_memory() {
-    #pragma omp critical (z3_memory_manager) 
-    {
-        g_memory_out_of_memory = true;
-    }
+    g_memory_out_of_memory = true;
     if (g_exit_when_out_of_memory) {
         std::cerr << g_out_of_memory_msg << "\n";
         exit(ERR_MEMOUT);
@@ -113,12 +149,7 @@ void memory::initialize(size_t max_size) {
 }
 
 bool memory::is_out_of_memory() {
-    bool r = false;
-    #pragma omp critical (z3_memory_manager) 
-    {
-        r = g_memory_out_of_memory;
-    }
-    return r;
+    return g_memory_out_of_memory;
 }
 
 void memory::set_high_watermark(size_t watermark) {
@@ -129,12 +160,7 @@ void memory::set_high_watermark(size_t watermark) {
 bool memory::above_high_watermark() {
     if (g_memory_watermark == 0)
         return false;
-    bool r;
-    #pragma omp critical (z3_memory_manager) 
-    {
-        r = g_memory_watermark < g_memory_alloc_size;
-    }
-    return r;
+    return g_memory_watermark < atomic_read(&g_memory_alloc_size);
 }
 
 // The following methods are only safe to invoke at 
@@ -160,27 +186,18 @@ void memory::finalize() {
 }
 
 unsigned long long memory::get_allocation_size() {
-    long long r;
-    #pragma omp critical (z3_memory_manager) 
-    {
-        r = g_memory_alloc_size;
-    }
+    long long r = atomic_read(&g_memory_alloc_size);
     if (r < 0)
         r = 0;
     return r;
 }
 
 unsigned long long memory::get_max_used_memory() {
-    unsigned long long r;
-    #pragma omp critical (z3_memory_manager) 
-    {
-        r = g_memory_max_used_size;
-    }
-    return r;
+    return atomic_read(&g_memory_max_used_size);
 }
 
 unsigned long long memory::get_allocation_count() {
-    return g_memory_alloc_count;
+    return atomic_read(&g_memory_alloc_count);
 }
 
 
@@ -211,7 +228,9 @@ void * memory::allocate(char const* file, int line, char const* obj, size_t s) {
 }
 #endif
 
-#if defined(_WINDOWS) || defined(_USE_THREAD_LOCAL)
+// Thread local counters are used by default on Windows and Linux.
+// Define _NO_THREAD_LOCAL to use a critical section on every allocation instead.
+#if !defined(_NO_THREAD_LOCAL) && (defined(_WINDOWS) || defined(_USE_THREAD_LOCAL) || defined(_LINUX_))
 // ==================================
 // ==================================
 // THREAD LOCAL VERSION
@@ -227,39 +246,82 @@ void * memory::allocate(char const* file, int line, char const* obj, size_t s) {
 // Actually this is VS specific instead of Windows specific.
 __declspec(thread) long long g_memory_thread_alloc_size    = 0;
 __declspec(thread) long long g_memory_thread_alloc_count   = 0;
+__declspec(thread) memory_budget * g_memory_thread_budget  = 0;
 #else
 // GCC style
 __thread long long g_memory_thread_alloc_size    = 0;
 __thread long long g_memory_thread_alloc_count  = 0;
+__thread memory_budget * g_memory_thread_budget = 0;
 #endif
 
-static void synchronize_counters(bool allocating) {
+enum synch_result {
+    SYNCH_OK,
+    SYNCH_OUT_OF_MEMORY,
+    SYNCH_BUDGET_EXCEEDED,
+    SYNCH_COUNTS_EXCEEDED
+};
+
+/**
+   \brief Move the thread local counters to the global counters and to the budget
+   of the current thread. The global counters are updated using atomic operations.
+*/
+static synch_result synchronize_counters() {
 #ifdef PROFILE_MEMORY
     g_synch_counter++;
 #endif
+    long long delta = g_memory_thread_alloc_size;
+    long long count = g_memory_thread_alloc_count;
+    g_memory_thread_alloc_size  = 0;
+    g_memory_thread_alloc_count = 0;
+
+    long long sz = atomic_add(&g_memory_alloc_size, delta);
+    long long c  = atomic_add(&g_memory_alloc_count, count);
+    atomic_max(&g_memory_max_used_size, sz);
+    bool budget_exceeded = g_memory_thread_budget != 0 && g_memory_thread_budget->update(delta);
+    if (g_memory_max_size != 0 && sz > g_memory_max_size)
+        return SYNCH_OUT_OF_MEMORY;
+    if (budget_exceeded)
+        return SYNCH_BUDGET_EXCEEDED;
+    if (g_memory_max_alloc_count != 0 && c > g_memory_max_alloc_count)
+        return SYNCH_COUNTS_EXCEEDED;
+    return SYNCH_OK;
+}
 
-    bool out_of_mem = false;
-    bool counts_exceeded = false;
-    #pragma omp critical (z3_memory_manager) 
-    {
-        g_memory_alloc_size += g_memory_thread_alloc_size;
-        g_memory_alloc_count += g_memory_thread_alloc_count;
-        if (g_memory_alloc_size > g_memory_max_used_size)
-            g_memory_max_used_size = g_memory_alloc_size;
-        if (g_memory_max_size != 0 && g_memory_alloc_size > g_memory_max_size)
-            out_of_mem = true;
-        if (g_memory_max_alloc_count != 0 && g_memory_alloc_count > g_memory_max_alloc_count)
-            counts_exceeded = true;
-    }
-    g_memory_thread_alloc_size = 0;
-    if (out_of_mem && allocating) {
+/**
+   \brief Synchronize the counters after s bytes were charged to the current thread.
+   If a limit is exceeded, the bytes are given back and an exception is thrown.
+*/
+static void synchronize_counters_on_alloc(size_t s) {
+    synch_result r = synchronize_counters();
+    if (r == SYNCH_OK)
+        return;
+    g_memory_thread_alloc_size -= s;
+    switch (r) {
+    case SYNCH_OUT_OF_MEMORY:
         throw_out_of_memory();
-    }
-    if (counts_exceeded && allocating) {
+        break;
+    case SYNCH_BUDGET_EXCEEDED:
+        // only the context owning the budget is affected.
+        throw out_of_memory_error();
+    case SYNCH_COUNTS_EXCEEDED:
         throw_alloc_counts_exceeded();
+        break;
+    default:
+        break;
     }
 }
 
+memory_budget * memory::set_thread_budget(memory_budget * b) {
+    synchronize_counters();
+    memory_budget * old = g_memory_thread_budget;
+    g_memory_thread_budget = b;
+    return old;
+}
+
+memory_budget * memory::get_thread_budget() {
+    return g_memory_thread_budget;
+}
+
 void memory::deallocate(void * p) {
     size_t * sz_p  = reinterpret_cast<size_t*>(p) - 1;
     size_t sz      = *sz_p;
@@ -267,21 +329,23 @@ void memory::deallocate(void * p) {
     g_memory_thread_alloc_size -= sz;
     free(real_p);
     if (g_memory_thread_alloc_size < -SYNCH_THRESHOLD) {
-        synchronize_counters(false);
+        synchronize_counters();
     }
 }
 
 void * memory::allocate(size_t s) {
     s = s + sizeof(size_t); // we allocate an extra field!
-    void * r = malloc(s);
-    if (r == 0) 
-        throw_out_of_memory();
-    *(static_cast<size_t*>(r)) = s;
     g_memory_thread_alloc_size += s;
     g_memory_thread_alloc_count += 1;
     if (g_memory_thread_alloc_size > SYNCH_THRESHOLD) {
-        synchronize_counters(true);
+        synchronize_counters_on_alloc(s);
+    }
+    void * r = malloc(s);
+    if (r == 0) {
+        g_memory_thread_alloc_size -= s;
+        throw_out_of_memory();
     }
+    *(static_cast<size_t*>(r)) = s;
     return static_cast<size_t*>(r) + 1; // we return a pointer to the location after the extra field
 }
 
@@ -294,12 +358,14 @@ void* memory::reallocate(void *p, size_t s) {
     g_memory_thread_alloc_size += s - sz;
     g_memory_thread_alloc_count += 1;
     if (g_memory_thread_alloc_size > SYNCH_THRESHOLD) {
-        synchronize_counters(true);
+        synchronize_counters_on_alloc(s - sz);
     }
 
     void *r = realloc(real_p, s);
-    if (r == 0)
+    if (r == 0) {
+        g_memory_thread_alloc_size -= s - sz;
         throw_out_of_memory();
+    }
     *(static_cast<size_t*>(r)) = s;
     return static_cast<size_t*>(r) + 1; // we return a pointer to the location after the extra field
 }
@@ -312,6 +378,15 @@ void* memory::reallocate(void *p, size_t s) {
 // ==================================
 // allocate & deallocate without using thread local storage
 
+memory_budget * memory::set_thread_budget(memory_budget * b) {
+    // budgets are not supported without thread local storage.
+    return 0;
+}
+
+memory_budget * memory::get_thread_budget() {
+    return 0;
+}
+
 void memory::deallocate(void * p) {
     size_t * sz_p  = reinterpret_cast<size_t*>(p) - 1;
     size_t sz      = *sz_p;
@@ -46,6 +46,35 @@ public:
     out_of_memory_error();
 };
 
+/**
+   \brief Memory budget shared by the threads working on behalf of a context.
+
+   Allocations and deallocations performed by a thread while a budget is installed
+   on it (see scoped_memory_budget) are charged to the budget. When the memory charged to
+   the budget exceeds its maximal size, the allocation throws out_of_memory_error
+   without affecting the other contexts. As the global counters, the budget is
+   synchronized with the thread local counters in batches, so it may be exceeded by
+   a small amount before the exception is thrown.
+
+   Budgets are only enforced when the memory manager uses thread local counters.
+*/
+class memory_budget {
+    volatile long long m_size;
+    long long          m_max_size;
+public:
+    memory_budget(size_t max_size = 0): m_size(0), m_max_size(0) { set_max_size(max_size); }
+    // 0 means unlimited.
+    void set_max_size(size_t max_size) { 
+        m_max_size = static_cast<long long>(max_size); 
+        if (m_max_size < 0) m_max_size = 0; 
+    }
+    unsigned long long get_max_size() const { return m_max_size; }
+    unsigned long long get_size() const { return m_size < 0 ? 0 : m_size; }
+    void reset() { m_size = 0; }
+    // add delta to the memory charged to the budget, return true if the budget is exceeded.
+    bool update(long long delta);
+};
+
 class memory {
 public:
     static bool is_out_of_memory();
@@ -67,10 +96,22 @@ public:
     static unsigned long long get_allocation_size();
     static unsigned long long get_max_used_memory();
     static unsigned long long get_allocation_count();
+    /**
+       \brief Install the budget charged by the current thread, and return the previous one.
+       The pending thread local counters are charged to the previous budget.
+    */
+    static memory_budget * set_thread_budget(memory_budget * b);
+    static memory_budget * get_thread_budget();
     // temporary hack to avoid out-of-memory crash in z3.exe
     static void exit_when_out_of_memory(bool flag, char const * msg);
 };
 
+class scoped_memory_budget {
+    memory_budget * m_old;
+public:
+    scoped_memory_budget(memory_budget & b): m_old(memory::set_thread_budget(&b)) {}
+    ~scoped_memory_budget() { memory::set_thread_budget(m_old); }
+};
 
 #if _DEBUG
 
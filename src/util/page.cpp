@@ -26,43 +26,43 @@ inline void set_page_header(char * page, char * prev, bool default_page) {
     SASSERT(prev_page(page) == prev);
 }
 
-inline char * alloc_page(size_t s) { char * r = alloc_svect(char, s+PAGE_HEADER_SZ); return r + PAGE_HEADER_SZ; }
+inline char * alloc_page(size_t s, chunk_allocator & a) { char * r = static_cast<char*>(a.allocate_chunk(s+PAGE_HEADER_SZ)); return r + PAGE_HEADER_SZ; }
 
-inline void del_page(char * page) { dealloc_svect(page - PAGE_HEADER_SZ); }
+inline void del_page(char * page, chunk_allocator & a) { a.deallocate_chunk(page - PAGE_HEADER_SZ); }
 
-void del_pages(char * page) {
+void del_pages(char * page, chunk_allocator & a) {
     while (page != 0) {
         char * prev = prev_page(page);
-        del_page(page);
+        del_page(page, a);
         page = prev;
     }
 }
 
-char * allocate_default_page(char * prev, char * & free_pages) {
+char * allocate_default_page(char * prev, char * & free_pages, chunk_allocator & a) {
     char * r;
     if (free_pages) {
         r = free_pages;
         free_pages = prev_page(free_pages);
     }
     else {
-        r = alloc_page(DEFAULT_PAGE_SIZE);
+        r = alloc_page(DEFAULT_PAGE_SIZE, a);
     }
     set_page_header(r, prev, true);
     return r;
 }
 
-char * allocate_page(char * prev, size_t sz) {
-    char * r = alloc_page(sz);
+char * allocate_page(char * prev, size_t sz, chunk_allocator & a) {
+    char * r = alloc_page(sz, a);
     set_page_header(r, prev, false);
     return r;
 }
 
-void recycle_page(char * p, char * & free_pages) {
+void recycle_page(char * p, char * & free_pages, chunk_allocator & a) {
     if (is_default_page(p)) {
         set_page_header(p, free_pages, true);
         free_pages = p;
     }
     else {
-        del_page(p);
+        del_page(p, a);
     }
 }
@@ -20,6 +20,7 @@ Revision History:
 #define PAGE_H_
 
 #include"memory_manager.h"
+#include"chunk_allocator.h"
 
 #define PAGE_HEADER_SZ sizeof(size_t)
 #define DEFAULT_PAGE_SIZE (8192 - PAGE_HEADER_SZ)
@@ -34,9 +35,9 @@ inline bool is_default_page(char * page) {
     return static_cast<bool>(tagged_ptr & 1);
 }
 inline char * end_of_default_page(char * p) { return p + DEFAULT_PAGE_SIZE; }
-void del_pages(char * page);
-char * allocate_default_page(char * prev, char * & free_pages);
-char * allocate_page(char * prev, size_t sz);
-void recycle_page(char * p, char * & free_pages);
+void del_pages(char * page, chunk_allocator & a = default_chunk_allocator());
+char * allocate_default_page(char * prev, char * & free_pages, chunk_allocator & a = default_chunk_allocator());
+char * allocate_page(char * prev, size_t sz, chunk_allocator & a = default_chunk_allocator());
+void recycle_page(char * p, char * & free_pages, chunk_allocator & a = default_chunk_allocator());
 
 #endif
@@ -32,12 +32,13 @@ void region::display_mem_stats(std::ostream & out) const {
 #include"page.h"
 
 inline void region::allocate_page() {
-    m_curr_page     = allocate_default_page(m_curr_page, m_free_pages);
+    m_curr_page     = allocate_default_page(m_curr_page, m_free_pages, m_chunk_alloc);
     m_curr_ptr      = m_curr_page;
     m_curr_end_ptr  = end_of_default_page(m_curr_page);
 }
 
-region::region() {
+region::region(chunk_allocator * a):
+    m_chunk_alloc(a ? *a : default_chunk_allocator()) {
     m_curr_page    = 0;
     m_curr_ptr     = 0;
     m_curr_end_ptr = 0;
@@ -47,8 +48,8 @@ region::region() {
 }
 
 region::~region() {
-    del_pages(m_curr_page);
-    del_pages(m_free_pages);
+    del_pages(m_curr_page, m_chunk_alloc);
+    del_pages(m_free_pages, m_chunk_alloc);
 }
 
 void * region::allocate(size_t size) {
@@ -67,7 +68,7 @@ void * region::allocate(size_t size) {
     }
     else {
         // big page
-        m_curr_page = ::allocate_page(m_curr_page, size);
+        m_curr_page = ::allocate_page(m_curr_page, size, m_chunk_alloc);
         char * result = m_curr_page;
         allocate_page();
         return result;
@@ -76,7 +77,7 @@ void * region::allocate(size_t size) {
 
 inline void region::recycle_curr_page() {
     char * prev = prev_page(m_curr_page);
-    recycle_page(m_curr_page, m_free_pages);
+    recycle_page(m_curr_page, m_free_pages, m_chunk_alloc);
     m_curr_page = prev;
 }
 
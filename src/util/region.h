@@ -20,6 +20,7 @@ Revision History:
 #define REGION_H_
 #include<cstdlib>
 #include<iostream>
+#include"chunk_allocator.h"
 
 #ifdef Z3DEBUG
 
@@ -29,6 +30,8 @@ class region {
     ptr_vector<char> m_chuncks;
     unsigned_vector  m_scopes;
 public:
+    // objects are allocated individually in debug mode, the backend is not used.
+    region(chunk_allocator * a = 0) {}
     ~region() {
         reset();
     }
@@ -91,10 +94,15 @@ class region {
     char *   m_curr_end_ptr; //!< Point to the end of the current page.
     char *   m_free_pages;
     mark *   m_mark;
+    chunk_allocator & m_chunk_alloc;
     void allocate_page();
     void recycle_curr_page();
 public:
-    region();
+    /**
+       \brief Create a region that obtains its pages from the given backend,
+       or from default_chunk_allocator() if it is 0.
+    */
+    region(chunk_allocator * a = 0);
     ~region();
     void * allocate(size_t size);
     void reset();
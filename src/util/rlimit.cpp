@@ -29,6 +29,12 @@ uint64 reslimit::count() const {
     return m_count;
 }
 
+uint64 reslimit::remaining() const {
+    if (m_limit == 0) 
+        return UINT64_MAX;
+    return m_count < m_limit ? m_limit - m_count : 0;
+}
+
 bool reslimit::inc() {
     ++m_count;
     return m_cancel == 0 && (m_limit == 0 || m_count <= m_limit);
@@ -40,6 +40,8 @@ public:
     bool inc();
     bool inc(unsigned offset);
     uint64 count() const;
+    // resources left before the limit is reached, UINT64_MAX if there is no limit.
+    uint64 remaining() const;
 
 
     bool get_cancel_flag() const { return m_cancel > 0; }
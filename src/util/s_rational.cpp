@@ -0,0 +1,77 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    s_rational.cpp
+
+Abstract:
+
+    Rational numbers whose numerator and denominator fit in 64 bits.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include<sstream>
+#include"s_rational.h"
+
+s_rational s_rational::m_zero(0);
+s_rational s_rational::m_one(1);
+s_rational s_rational::m_minus_one(-1);
+
+std::string s_rational::to_string() const {
+    std::ostringstream buffer;
+    buffer << m_num;
+    if (!is_int()) {
+        buffer << "/" << m_den;
+    }
+    return buffer.str();
+}
+
+s_rational power(const s_rational & r, unsigned p) {
+    unsigned mask = 1;
+    s_rational result = s_rational(1);
+    s_rational power = r;
+    while (mask <= p) {
+        if (mask & p) {
+            result *= power;
+        }
+        mask = mask << 1;
+        if (mask <= p) {
+            power *= power;
+        }
+    }
+    return result;
+}
+
+s_rational gcd(const s_rational & r1, const s_rational & r2) {
+    SASSERT(r1.is_int() && r2.is_int());
+    s_rational tmp1(abs(r1));
+    s_rational tmp2(abs(r2));
+    if (tmp1 < tmp2) {
+        tmp1.swap(tmp2);
+    }
+    if (tmp2.is_zero()) {
+        return tmp1;
+    }
+    for(;;) {
+        s_rational aux = tmp1 % tmp2;
+        if (aux.is_zero()) {
+            return tmp2;
+        }
+        tmp1 = tmp2;
+        tmp2 = aux;
+    }
+}
+
+s_rational lcm(const s_rational & r1, const s_rational & r2) {
+    s_rational g = gcd(r1, r2);
+    if (g.is_zero()) {
+        return g;
+    }
+    return abs(div(r1, g) * r2);
+}
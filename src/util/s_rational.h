@@ -0,0 +1,323 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    s_rational.h
+
+Abstract:
+
+    Rational numbers whose numerator and denominator fit in 64 bits.
+    The class provides the same interface as s_integer and rational,
+    so it can be used to instantiate the arithmetic solvers.
+    Operations that do not fit in 64 bits throw overflow_exception,
+    the client is expected to fall back to rational.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#ifndef S_RATIONAL_H_
+#define S_RATIONAL_H_
+
+#include"checked_int64.h"
+
+class s_rational {
+    typedef checked_int64<true> int64c;
+    int64c m_num;
+    int64c m_den; // positive and coprime with m_num.
+    static s_rational m_zero;
+    static s_rational m_one;
+    static s_rational m_minus_one;
+
+    static int64 gcd(int64 a, int64 b) {
+        if (a == INT64_MIN || b == INT64_MIN) {
+            throw overflow_exception();
+        }
+        if (a < 0) a = -a;
+        while (b != 0) {
+            int64 t = a % b;
+            a = b;
+            b = t;
+        }
+        return a < 0 ? -a : a;
+    }
+
+    s_rational(int64c const & n, int64c const & d):m_num(n), m_den(d) {}
+
+    void normalize() {
+        if (m_den.is_neg()) {
+            m_num.neg();
+            m_den.neg();
+        }
+        int64 g = gcd(m_num.get_int64(), m_den.get_int64());
+        if (g > 1) {
+            m_num = int64c(m_num.get_int64() / g);
+            m_den = int64c(m_den.get_int64() / g);
+        }
+    }
+
+public:
+    typedef int64c::overflow_exception overflow_exception;
+
+    unsigned hash() const {
+        return m_num.hash() + 3 * m_den.hash();
+    }
+
+    struct hash_proc {  unsigned operator()(s_rational const& r) const { return r.hash(); }  };
+
+    struct eq_proc { bool operator()(s_rational const& r1, s_rational const& r2) const { return r1 == r2; } };
+
+    void swap(s_rational & n) {
+        std::swap(m_num, n.m_num);
+        std::swap(m_den, n.m_den);
+    }
+
+    std::string to_string() const;
+
+public:
+    s_rational():m_num(0), m_den(1) {}
+    s_rational(const s_rational & r):m_num(r.m_num), m_den(r.m_den) {}
+    explicit s_rational(int n):m_num(n), m_den(1) {}
+    explicit s_rational(int n, int d):m_num(n), m_den(d) { SASSERT(d != 0); normalize(); }
+    struct i64 {};
+    explicit s_rational(int64 i, i64):m_num(i), m_den(1) {}
+    explicit s_rational(const rational & r):m_num(0), m_den(1) {
+        if (!numerator(r).is_int64() || !denominator(r).is_int64()) {
+            throw overflow_exception();
+        }
+        m_num = int64c(numerator(r).get_int64());
+        m_den = int64c(denominator(r).get_int64());
+    }
+
+    void reset() { m_num = int64c(0); m_den = int64c(1); }
+
+    static bool is_big() { return false; }
+    bool is_int() const { return m_den.is_one(); }
+    bool is_int64() const { return is_int(); }
+    bool is_uint64() const { return is_int() && m_num.is_nonneg(); }
+    bool is_unsigned() const { return is_uint64() && m_num.get_int64() <= static_cast<int64>(UINT_MAX); }
+    int64 get_int64() const { SASSERT(is_int64()); return m_num.get_int64(); }
+    uint64 get_uint64() const { SASSERT(is_uint64()); return static_cast<uint64>(m_num.get_int64()); }
+    unsigned get_unsigned() const { SASSERT(is_unsigned()); return static_cast<unsigned>(m_num.get_int64()); }
+    s_rational const& get_infinitesimal() const { return zero(); }
+    static bool is_rational() { return true; }
+    s_rational const& get_rational() const { return *this; }
+    s_rational & operator=(const s_rational & r) { m_num = r.m_num; m_den = r.m_den; return *this; }
+    friend inline s_rational numerator(const s_rational & r) { return s_rational(r.m_num, int64c(1)); }
+    friend inline s_rational denominator(const s_rational & r) { return s_rational(r.m_den, int64c(1)); }
+
+    s_rational & operator+=(const s_rational & r) {
+        if (is_int() && r.is_int()) {
+            m_num += r.m_num;
+        }
+        else if (m_den == r.m_den) {
+            m_num += r.m_num;
+            normalize();
+        }
+        else {
+            // use the least common multiple of the denominators.
+            int64 g = gcd(m_den.get_int64(), r.m_den.get_int64());
+            int64c d1(m_den.get_int64() / g), d2(r.m_den.get_int64() / g);
+            m_num = m_num * d2 + r.m_num * d1;
+            m_den *= d2;
+            normalize();
+        }
+        return *this;
+    }
+
+    s_rational & operator-=(const s_rational & r) {
+        if (is_int() && r.is_int()) {
+            m_num -= r.m_num;
+        }
+        else if (m_den == r.m_den) {
+            m_num -= r.m_num;
+            normalize();
+        }
+        else {
+            int64 g = gcd(m_den.get_int64(), r.m_den.get_int64());
+            int64c d1(m_den.get_int64() / g), d2(r.m_den.get_int64() / g);
+            m_num = m_num * d2 - r.m_num * d1;
+            m_den *= d2;
+            normalize();
+        }
+        return *this;
+    }
+
+    s_rational & operator*=(const s_rational & r) {
+        if (is_int() && r.is_int()) {
+            m_num *= r.m_num;
+            return *this;
+        }
+        // cross-reduce before multiplying to keep the intermediate values small.
+        int64 g1 = gcd(m_num.get_int64(), r.m_den.get_int64());
+        int64 g2 = gcd(r.m_num.get_int64(), m_den.get_int64());
+        m_num = int64c(m_num.get_int64() / g1) * int64c(r.m_num.get_int64() / g2);
+        m_den = int64c(m_den.get_int64() / g2) * int64c(r.m_den.get_int64() / g1);
+        return *this;
+    }
+
+    s_rational & operator/=(const s_rational & r) {
+        SASSERT(!r.is_zero());
+        s_rational inv(r.m_den, r.m_num);
+        inv.normalize();
+        return *this *= inv;
+    }
+
+    s_rational & operator%=(const s_rational & r) {
+        SASSERT(is_int() && r.is_int());
+        m_num = int64c(m_num.get_int64() % r.m_num.get_int64());
+        return *this;
+    }
+
+    friend inline s_rational div(const s_rational & r1, const s_rational & r2) {
+        SASSERT(r1.is_int() && r2.is_int());
+        if (r2.m_num.is_minus_one()) {
+            return -r1;
+        }
+        int64 a = r1.m_num.get_int64(), b = r2.m_num.get_int64();
+        int64 q = a / b;
+        // round towards negative infinity for negative dividends, as rational::div.
+        if (a < 0 && q * b != a) {
+            q += b > 0 ? -1 : 1;
+        }
+        return s_rational(int64c(q), int64c(1));
+    }
+
+    friend inline s_rational mod(const s_rational & r1, const s_rational & r2) {
+        s_rational r = r1;
+        r %= r2;
+        if (r.is_neg()) {
+            r += abs(r2);
+        }
+        return r;
+    }
+
+    s_rational & operator++() { return *this += one(); }
+    const s_rational operator++(int) { s_rational tmp(*this); ++(*this); return tmp; }
+    s_rational & operator--() { return *this -= one(); }
+    const s_rational operator--(int) { s_rational tmp(*this); --(*this); return tmp; }
+
+    friend inline bool operator==(const s_rational & r1, const s_rational & r2) {
+        return r1.m_num == r2.m_num && r1.m_den == r2.m_den;
+    }
+
+    friend inline bool operator<(const s_rational & r1, const s_rational & r2) {
+        if (r1.m_den == r2.m_den) {
+            return r1.m_num < r2.m_num;
+        }
+        if (r1.m_num.is_neg() != r2.m_num.is_neg()) {
+            return r1.m_num.is_neg();
+        }
+        if (r1.m_num.is_zero() || r2.m_num.is_zero()) {
+            return r1.m_num < r2.m_num;
+        }
+        int64 g = gcd(r1.m_den.get_int64(), r2.m_den.get_int64());
+        return r1.m_num * int64c(r2.m_den.get_int64() / g) < r2.m_num * int64c(r1.m_den.get_int64() / g);
+    }
+
+    void neg() { m_num.neg(); }
+    bool is_zero() const { return m_num.is_zero(); }
+    bool is_one() const { return m_num.is_one() && m_den.is_one(); }
+    bool is_minus_one() const { return m_num.is_minus_one() && m_den.is_one(); }
+    bool is_neg() const { return m_num.is_neg(); }
+    bool is_pos() const { return m_num.is_pos(); }
+    bool is_nonneg() const { return m_num.is_nonneg(); }
+    bool is_nonpos() const { return m_num.is_nonpos(); }
+    bool is_even() const { return is_int() && (m_num.get_int64() & 0x1) == 0; }
+
+    friend inline s_rational floor(const s_rational & r) {
+        if (r.is_int()) {
+            return r;
+        }
+        int64 q = r.m_num.get_int64() / r.m_den.get_int64();
+        if (r.m_num.is_neg()) {
+            --q;
+        }
+        return s_rational(int64c(q), int64c(1));
+    }
+
+    friend inline s_rational ceil(const s_rational & r) {
+        if (r.is_int()) {
+            return r;
+        }
+        int64 q = r.m_num.get_int64() / r.m_den.get_int64();
+        if (r.m_num.is_pos()) {
+            ++q;
+        }
+        return s_rational(int64c(q), int64c(1));
+    }
+
+    s_rational expt(int n) const {
+        s_rational result(1);
+        for (int i = 0; i < n; i++) {
+            result *= *this;
+        }
+        return result;
+    }
+
+    static const s_rational & zero() { return m_zero; }
+    static const s_rational & one() { return m_one; }
+    static const s_rational & minus_one() { return m_minus_one; }
+
+    // Perform:  this += c * k
+    void addmul(const s_rational & c, const s_rational & k) {
+        if (c.is_one()) {
+            *this += k;
+        }
+        else if (c.is_minus_one()) {
+            *this -= k;
+        }
+        else {
+            s_rational tmp(c);
+            tmp *= k;
+            *this += tmp;
+        }
+    }
+
+    // Perform:  this -= c * k
+    void submul(const s_rational & c, const s_rational & k) {
+        if (c.is_one()) {
+            *this -= k;
+        }
+        else if (c.is_minus_one()) {
+            *this += k;
+        }
+        else {
+            s_rational tmp(c);
+            tmp *= k;
+            *this -= tmp;
+        }
+    }
+
+    friend inline std::ostream & operator<<(std::ostream & target, const s_rational & r) {
+        target << r.to_string();
+        return target;
+    }
+
+    rational to_rational() const {
+        return rational(m_num.get_int64(), rational::i64()) / rational(m_den.get_int64(), rational::i64());
+    }
+
+    friend inline s_rational operator-(const s_rational & r) { s_rational result(r); result.neg(); return result; }
+    friend inline s_rational abs(const s_rational & r) { s_rational result(r); if (result.is_neg()) result.neg(); return result; }
+};
+
+inline bool operator!=(const s_rational & r1, const s_rational & r2) { return !operator==(r1, r2); }
+inline bool operator>(const s_rational & r1, const s_rational & r2) { return operator<(r2, r1); }
+inline bool operator<=(const s_rational & r1, const s_rational & r2) { return !operator>(r1, r2); }
+inline bool operator>=(const s_rational & r1, const s_rational & r2) { return !operator<(r1, r2); }
+inline s_rational operator+(const s_rational & r1, const s_rational & r2) { return s_rational(r1) += r2; }
+inline s_rational operator-(const s_rational & r1, const s_rational & r2) { return s_rational(r1) -= r2; }
+inline s_rational operator*(const s_rational & r1, const s_rational & r2) { return s_rational(r1) *= r2; }
+inline s_rational operator/(const s_rational & r1, const s_rational & r2) { return s_rational(r1) /= r2; }
+inline s_rational operator%(const s_rational & r1, const s_rational & r2) { return s_rational(r1) %= r2; }
+s_rational power(const s_rational & r, unsigned p);
+s_rational gcd(const s_rational & r1, const s_rational & r2);
+s_rational lcm(const s_rational & r1, const s_rational & r2);
+
+#endif /* S_RATIONAL_H_ */
+
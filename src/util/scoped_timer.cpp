@@ -15,6 +15,9 @@ Author:
 
 Revision History:
 
+    On pthread platforms, all timers are registered with a single
+    process wide timer service instead of creating one thread per timer.
+
 --*/
 #ifdef _CYGWIN
 // Hack to make CreateTimerQueueTimer available on cygwin
@@ -28,17 +31,16 @@ Revision History:
 #include<windows.h>
 #elif defined(__APPLE__) && defined(__MACH__)
 // Mac OS X
-#include<mach/mach.h>
-#include<mach/clock.h>
 #include<sys/time.h>
 #include<sys/errno.h>
 #include<pthread.h>
+#define _USE_TIMER_SERVICE
 #elif defined(_LINUX_) || defined(_FREEBSD_)
 // Linux
 #include<errno.h>
 #include<pthread.h>
-#include<sched.h>
 #include<time.h>
+#define _USE_TIMER_SERVICE
 // ---------
 #else
 // Other platforms
@@ -51,31 +53,236 @@ Revision History:
 #endif
 #include"util.h"
 #include<limits.h>
+#include<algorithm>
 #include"z3_omp.h"
 
+#ifdef _USE_TIMER_SERVICE
+
+/**
+   \brief Process wide timer service.
+
+   Timers are stored in a hashed timer wheel with one slot per millisecond:
+   a timer expiring at tick t is kept in the doubly linked list of slot t % NUM_SLOTS.
+   Registering and canceling a timer are O(1).
+   A single background thread sleeps until the next non-empty slot is due,
+   and sleeps without a deadline when no timer is registered.
+   The thread is created on demand and stopped by finalize_scoped_timer.
+*/
+namespace {
+
+    struct timer_entry {
+        event_handler * m_eh;
+        timer_entry *   m_prev;
+        timer_entry *   m_next;
+        uint64          m_expire;  // tick (milliseconds) when the timer fires.
+        bool            m_linked;
+    };
+
+    const unsigned NUM_SLOTS = 1024;
+
+    pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t  g_wakeup;         // signaled when the thread has to reconsider its deadline.
+    pthread_cond_t  g_fired;          // signaled when an event handler returned.
+    pthread_t       g_thread;
+    bool            g_initialized = false;
+    bool            g_running     = false;
+    bool            g_stop        = false;
+    timer_entry *   g_slots[NUM_SLOTS];
+    unsigned        g_num_timers  = 0;
+    uint64          g_curr        = 0;  // all slots up to this tick were processed.
+    uint64          g_wake        = 0;  // tick at which the thread wakes up, UINT64_MAX if it waits without deadline.
+    timer_entry *   g_firing      = 0;  // timer whose event handler is being executed.
+
+    uint64 now_ms() {
+#if defined(__APPLE__) && defined(__MACH__)
+        struct timeval tv;
+        gettimeofday(&tv, 0);
+        return static_cast<uint64>(tv.tv_sec) * 1000ull + tv.tv_usec / 1000;
+#else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64>(ts.tv_sec) * 1000ull + ts.tv_nsec / 1000000;
+#endif
+    }
+
+    // g_wakeup uses the same clock as now_ms.
+    void wait_until(uint64 tick) {
+        struct timespec ts;
+        ts.tv_sec  = tick / 1000;
+        ts.tv_nsec = (tick % 1000) * 1000000;
+        int e = pthread_cond_timedwait(&g_wakeup, &g_mutex, &ts);
+        ENSURE(e == 0 || e == ETIMEDOUT);
+    }
+
+    void link(timer_entry * e) {
+        timer_entry * & head = g_slots[e->m_expire % NUM_SLOTS];
+        e->m_prev = 0;
+        e->m_next = head;
+        if (head) head->m_prev = e;
+        head = e;
+        e->m_linked = true;
+        g_num_timers++;
+    }
+
+    void unlink(timer_entry * e) {
+        SASSERT(e->m_linked);
+        if (e->m_prev) 
+            e->m_prev->m_next = e->m_next;
+        else 
+            g_slots[e->m_expire % NUM_SLOTS] = e->m_next;
+        if (e->m_next) 
+            e->m_next->m_prev = e->m_prev;
+        e->m_linked = false;
+        g_num_timers--;
+    }
+
+    /**
+       \brief Execute the event handlers of all timers that expired before tick now.
+       The mutex is released while an event handler runs.
+    */
+    void fire_expired(uint64 now) {
+        if (now <= g_curr)
+            return;
+        uint64 num_ticks = std::min(now - g_curr, static_cast<uint64>(NUM_SLOTS));
+        for (uint64 i = 1; i <= num_ticks; ++i) {
+            unsigned slot = (g_curr + i) % NUM_SLOTS;
+            timer_entry * e = g_slots[slot];
+            while (e) {
+                if (e->m_expire > now) {
+                    e = e->m_next;
+                    continue;
+                }
+                unlink(e);
+                g_firing = e;
+                event_handler * eh = e->m_eh;
+                pthread_mutex_unlock(&g_mutex);
+                (*eh)();
+                pthread_mutex_lock(&g_mutex);
+                g_firing = 0;
+                pthread_cond_broadcast(&g_fired);
+                // the slot may have been modified while the mutex was released.
+                e = g_slots[slot];
+            }
+        }
+        g_curr = now;
+    }
+
+    /**
+       \brief Return the first tick after g_curr whose slot is not empty.
+    */
+    uint64 next_deadline() {
+        if (g_num_timers == 0)
+            return UINT64_MAX;
+        for (unsigned i = 1; i <= NUM_SLOTS; ++i) {
+            if (g_slots[(g_curr + i) % NUM_SLOTS])
+                return g_curr + i;
+        }
+        UNREACHABLE();
+        return UINT64_MAX;
+    }
+
+    void * timer_thread(void *) {
+        pthread_mutex_lock(&g_mutex);
+        while (!g_stop) {
+            fire_expired(now_ms());
+            g_wake = next_deadline();
+            if (g_stop)
+                break;
+            if (g_wake == UINT64_MAX) {
+                pthread_cond_wait(&g_wakeup, &g_mutex);
+            }
+            else {
+                wait_until(g_wake);
+            }
+        }
+        g_running = false;
+        pthread_mutex_unlock(&g_mutex);
+        return 0;
+    }
+
+    void init_service() {
+        if (!g_initialized) {
+            pthread_condattr_t attr;
+            ENSURE(pthread_condattr_init(&attr) == 0);
+#if !(defined(__APPLE__) && defined(__MACH__))
+            ENSURE(pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) == 0);
+#endif
+            ENSURE(pthread_cond_init(&g_wakeup, &attr) == 0);
+            ENSURE(pthread_cond_init(&g_fired, NULL) == 0);
+            pthread_condattr_destroy(&attr);
+            for (unsigned i = 0; i < NUM_SLOTS; ++i)
+                g_slots[i] = 0;
+            g_initialized = true;
+        }
+        if (!g_running) {
+            g_stop    = false;
+            g_curr    = now_ms();
+            g_wake    = UINT64_MAX;
+            g_running = true;
+            ENSURE(pthread_create(&g_thread, NULL, &timer_thread, 0) == 0);
+        }
+    }
+
+    void add_timer(timer_entry * e, unsigned ms) {
+        pthread_mutex_lock(&g_mutex);
+        init_service();
+        e->m_expire = std::max(now_ms(), g_curr) + ms;
+        link(e);
+        if (e->m_expire < g_wake) {
+            g_wake = e->m_expire;
+            pthread_cond_signal(&g_wakeup);
+        }
+        pthread_mutex_unlock(&g_mutex);
+    }
+
+    void remove_timer(timer_entry * e) {
+        pthread_mutex_lock(&g_mutex);
+        if (e->m_linked) {
+            unlink(e);
+        }
+        else if (g_firing == e && !pthread_equal(pthread_self(), g_thread)) {
+            // wait for the event handler to finish, unless it is the 
+            // event handler itself that removes the timer.
+            while (g_firing == e) 
+                pthread_cond_wait(&g_fired, &g_mutex);
+        }
+        pthread_mutex_unlock(&g_mutex);
+    }
+};
+
+struct scoped_timer::imp {
+    timer_entry m_entry;
+
+    imp(unsigned ms, event_handler * eh) {
+        m_entry.m_eh     = eh;
+        m_entry.m_linked = false;
+        add_timer(&m_entry, ms);
+    }
+
+    ~imp() {
+        remove_timer(&m_entry);
+    }
+};
+
+void finalize_scoped_timer() {
+    pthread_mutex_lock(&g_mutex);
+    bool join = g_running && !pthread_equal(pthread_self(), g_thread);
+    if (g_running) {
+        g_stop = true;
+        pthread_cond_signal(&g_wakeup);
+    }
+    pthread_mutex_unlock(&g_mutex);
+    if (join)
+        pthread_join(g_thread, NULL);
+}
+
+#else 
+
 struct scoped_timer::imp {
     event_handler *  m_eh;
 #if defined(_WINDOWS) || defined(_CYGWIN)
     HANDLE           m_timer;
     bool             m_first;
-#elif defined(__APPLE__) && defined(__MACH__)
-    // Mac OS X
-    pthread_t        m_thread_id;
-    pthread_attr_t   m_attributes;
-    unsigned         m_interval;    
-    pthread_mutex_t  m_mutex;
-    pthread_cond_t   m_condition_var;
-    struct timespec  m_end_time;
-#elif defined(_LINUX_) || defined(_FREEBSD_)
-    // Linux & FreeBSD
-    pthread_t       m_thread_id;
-    pthread_mutex_t m_mutex;
-    pthread_cond_t  m_cond;
-    unsigned        m_ms;
-    bool            m_initialized;
-    bool            m_signal_sent;
-#else
-    // Other
 #endif
 
 #if defined(_WINDOWS) || defined(_CYGWIN)
@@ -88,59 +295,8 @@ struct scoped_timer::imp {
             obj->m_eh->operator()();
         }
     }
-#elif defined(__APPLE__) && defined(__MACH__)
-    // Mac OS X
-    static void * thread_func(void * arg) {
-        scoped_timer::imp * st = static_cast<scoped_timer::imp*>(arg);  
-
-        pthread_mutex_lock(&st->m_mutex);
-
-        int e = pthread_cond_timedwait(&st->m_condition_var, &st->m_mutex, &st->m_end_time);
-        if (e != 0 && e != ETIMEDOUT)
-            throw default_exception("failed to start timed wait");
-        st->m_eh->operator()();
-
-        pthread_mutex_unlock(&st->m_mutex);
-
-        return st;
-    }
-#elif defined(_LINUX_) || defined(_FREEBSD_)
-    static void* thread_func(void *arg) {
-        scoped_timer::imp *st = static_cast<scoped_timer::imp*>(arg);
-
-        struct timespec end_time;
-        clock_gettime(CLOCK_REALTIME, &end_time);
-        end_time.tv_sec  += st->m_ms / 1000u;
-        end_time.tv_nsec += (st->m_ms % 1000u) * 1000000ull;
-        // check for overflow
-        if (end_time.tv_nsec >= 1000000000) {
-            ++end_time.tv_sec;
-            end_time.tv_nsec -= 1000000000;
-        }
-
-        pthread_mutex_lock(&st->m_mutex);
-        st->m_initialized = true;
-        int e = 0;
-        // `pthread_cond_timedwait()` may spuriously wake even if the signal
-        // was not sent so we loop until a timeout occurs or the signal was
-        // **really** sent.
-        while (!(e == 0 && st->m_signal_sent)) {
-          e = pthread_cond_timedwait(&st->m_cond, &st->m_mutex, &end_time);
-          ENSURE(e == 0 || e == ETIMEDOUT);
-          if (e == ETIMEDOUT)
-            break;
-        }
-        pthread_mutex_unlock(&st->m_mutex);
-
-        if (e == ETIMEDOUT)
-            st->m_eh->operator()();
-        return 0;
-    }
-#else
-    // Other
 #endif
 
-
     imp(unsigned ms, event_handler * eh):
         m_eh(eh) {
 #if defined(_WINDOWS) || defined(_CYGWIN)
@@ -152,37 +308,6 @@ struct scoped_timer::imp {
                               0,
                               ms,
                               WT_EXECUTEINTIMERTHREAD);
-#elif defined(__APPLE__) && defined(__MACH__)
-        // Mac OS X
-        m_interval = ms?ms:0xFFFFFFFF;
-        if (pthread_attr_init(&m_attributes) != 0)
-            throw default_exception("failed to initialize timer thread attributes");
-        if (pthread_cond_init(&m_condition_var, NULL) != 0)
-            throw default_exception("failed to initialize timer condition variable");
-        if (pthread_mutex_init(&m_mutex, NULL) != 0)
-            throw default_exception("failed to initialize timer mutex");
-
-        clock_serv_t host_clock;
-        mach_timespec_t now;
-        unsigned long long nano = static_cast<unsigned long long>(m_interval) * 1000000ull;
-        
-        host_get_clock_service(mach_host_self(), CALENDAR_CLOCK, &host_clock);
-        m_end_time.tv_sec  = nano / 1000000000ull;
-        m_end_time.tv_nsec = nano % 1000000000ull;
-        clock_get_time(host_clock, &now);
-        ADD_MACH_TIMESPEC(&m_end_time, &now);
-
-
-        if (pthread_create(&m_thread_id, &m_attributes, &thread_func, this) != 0)
-            throw default_exception("failed to start timer thread");
-#elif defined(_LINUX_) || defined(_FREEBSD_)
-        // Linux & FreeBSD
-        m_ms = ms;
-        m_initialized = false;
-        m_signal_sent = false;
-        ENSURE(pthread_mutex_init(&m_mutex, NULL) == 0);
-        ENSURE(pthread_cond_init(&m_cond, NULL) == 0);
-        ENSURE(pthread_create(&m_thread_id, NULL, &thread_func, this) == 0);
 #else
     // Other platforms
 #endif
@@ -193,50 +318,6 @@ struct scoped_timer::imp {
         DeleteTimerQueueTimer(NULL,
                               m_timer,
                               INVALID_HANDLE_VALUE);
-#elif defined(__APPLE__) && defined(__MACH__)
-        // Mac OS X
-
-        // If the waiting-thread is not up and waiting yet, 
-        // we can make sure that it finishes quickly by 
-        // setting the end-time to zero.
-        m_end_time.tv_sec = 0;
-        m_end_time.tv_nsec = 0;
-
-        // Otherwise it's already up and waiting, and
-        // we can send a signal on m_condition_var:
-        pthread_mutex_lock(&m_mutex);
-        pthread_cond_signal(&m_condition_var);
-        pthread_mutex_unlock(&m_mutex);
-
-        if (pthread_join(m_thread_id, NULL) != 0)
-            throw default_exception("failed to join thread");
-        if (pthread_mutex_destroy(&m_mutex) != 0)
-            throw default_exception("failed to destroy pthread mutex");
-        if (pthread_cond_destroy(&m_condition_var) != 0)
-            throw default_exception("failed to destroy pthread condition variable");
-        if (pthread_attr_destroy(&m_attributes) != 0)
-            throw default_exception("failed to destroy pthread attributes object");
-#elif defined(_LINUX_) || defined(_FREEBSD_)
-        // Linux & FreeBSD
-        bool init = false;
-
-        // spin until timer thread has been created
-        while (!init) {
-            pthread_mutex_lock(&m_mutex);
-            init = m_initialized;
-            pthread_mutex_unlock(&m_mutex);
-            if (!init)
-                sched_yield();
-        }
-        pthread_mutex_lock(&m_mutex);
-        m_signal_sent = true;
-        pthread_mutex_unlock(&m_mutex);
-        // Perform signal outside of lock to avoid waking timing thread twice.
-        pthread_cond_signal(&m_cond);
-
-        pthread_join(m_thread_id, NULL);
-        pthread_cond_destroy(&m_cond);
-        pthread_mutex_destroy(&m_mutex);
 #else
     // Other Platforms
 #endif
@@ -244,6 +325,12 @@ struct scoped_timer::imp {
 
 };
 
+void finalize_scoped_timer() {
+    // The timer queue is managed by Windows.
+}
+
+#endif
+
 scoped_timer::scoped_timer(unsigned ms, event_handler * eh) {
     if (ms != UINT_MAX && ms != 0)
         m_imp = alloc(imp, ms, eh);
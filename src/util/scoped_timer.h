@@ -15,6 +15,8 @@ Author:
 
 Revision History:
 
+    On Linux, FreeBSD and OS X all timers share a single thread.
+
 --*/
 #ifndef SCOPED_TIMER_H_
 #define SCOPED_TIMER_H_
@@ -29,4 +31,9 @@ public:
     ~scoped_timer();
 };
 
+void finalize_scoped_timer();
+/*
+  ADD_FINALIZER('finalize_scoped_timer();')
+*/
+
 #endif
@@ -23,27 +23,41 @@ Revision History:
 #include"debug.h"
 #include"util.h"
 #include"vector.h"
+#include"statistics.h"
 #include<iomanip>
 
-small_object_allocator::small_object_allocator(char const * id) {
+small_object_allocator::small_object_allocator(char const * id, chunk_allocator * a):
+    m_chunk_alloc(a ? *a : default_chunk_allocator()) {
     for (unsigned i = 0; i < NUM_SLOTS; i++) {
         m_chunks[i] = 0;
         m_free_list[i] = 0;
+        m_num_free[i] = 0;
+        m_num_chunks[i] = 0;
+        m_reclaim_limit[i] = i == 0 ? UINT_MAX : 4 * objs_per_chunk(i);
     }
     DEBUG_CODE({
         m_id = id;
     });
     m_alloc_size = 0;
+    m_num_reclaimed = 0;
+}
+
+void small_object_allocator::del_chunks(unsigned slot_id) {
+    chunk * c = m_chunks[slot_id];
+    while (c) {
+        chunk * next = c->m_next;
+        m_chunk_alloc.deallocate_chunk(c);
+        c = next;
+    }
+    m_chunks[slot_id] = 0;
+    m_free_list[slot_id] = 0;
+    m_num_free[slot_id] = 0;
+    m_num_chunks[slot_id] = 0;
 }
 
 small_object_allocator::~small_object_allocator() {
     for (unsigned i = 0; i < NUM_SLOTS; i++) {
-        chunk * c = m_chunks[i];
-        while (c) {
-            chunk * next = c->m_next;
-            dealloc(c);
-            c = next;
-        }
+        del_chunks(i);
     }
     DEBUG_CODE({
         if (m_alloc_size > 0) {
@@ -54,14 +68,7 @@ small_object_allocator::~small_object_allocator() {
 
 void small_object_allocator::reset() {
     for (unsigned i = 0; i < NUM_SLOTS; i++) {
-        chunk * c = m_chunks[i];
-        while (c) {
-            chunk * next = c->m_next;
-            dealloc(c);
-            c = next;
-        }
-        m_chunks[i] = 0;
-        m_free_list[i] = 0;
+        del_chunks(i);
     }
     m_alloc_size = 0;
 }
@@ -89,6 +96,9 @@ void small_object_allocator::deallocate(size_t size, void * p) {
     SASSERT(slot_id < NUM_SLOTS);
     *(reinterpret_cast<void**>(p)) = m_free_list[slot_id];
     m_free_list[slot_id] = p;
+    m_num_free[slot_id]++;
+    if (m_num_free[slot_id] >= m_reclaim_limit[slot_id]) 
+        reclaim(slot_id);
 }
 
 void * small_object_allocator::allocate(size_t size) {
@@ -111,6 +121,7 @@ void * small_object_allocator::allocate(size_t size) {
     if (m_free_list[slot_id] != 0) {
         void * r = m_free_list[slot_id];
         m_free_list[slot_id] = *(reinterpret_cast<void **>(r));
+        m_num_free[slot_id]--;
         return r;
     }
     chunk * c = m_chunks[slot_id]; 
@@ -124,7 +135,8 @@ void * small_object_allocator::allocate(size_t size) {
             return r;
         }
     }
-    chunk * new_c = alloc(chunk);
+    chunk * new_c = new (m_chunk_alloc.allocate_chunk(sizeof(chunk))) chunk();
+    m_num_chunks[slot_id]++;
     new_c->m_next = c;
     m_chunks[slot_id] = new_c;
     void * r = new_c->m_curr;
@@ -136,11 +148,7 @@ size_t small_object_allocator::get_wasted_size() const {
     size_t r = 0;
     for (unsigned slot_id = 0; slot_id < NUM_SLOTS; slot_id++) {
         size_t slot_obj_size = slot_id << PTR_ALIGNMENT;
-        void ** ptr = reinterpret_cast<void **>(const_cast<small_object_allocator*>(this)->m_free_list[slot_id]);
-        while (ptr != 0) {
-            r += slot_obj_size;
-            ptr = reinterpret_cast<void**>(*ptr);
-        }
+        r += slot_obj_size * m_num_free[slot_id];
     }
     return r;
 }
@@ -148,87 +156,131 @@ size_t small_object_allocator::get_wasted_size() const {
 size_t small_object_allocator::get_num_free_objs() const {
     size_t r = 0;
     for (unsigned slot_id = 0; slot_id < NUM_SLOTS; slot_id++) {
-        void ** ptr = reinterpret_cast<void **>(const_cast<small_object_allocator*>(this)->m_free_list[slot_id]);
-        while (ptr != 0) {
-            r ++;
-            ptr = reinterpret_cast<void**>(*ptr);
-        }
+        r += m_num_free[slot_id];
+    }
+    return r;
+}
+
+size_t small_object_allocator::get_num_chunks() const {
+    size_t r = 0;
+    for (unsigned slot_id = 0; slot_id < NUM_SLOTS; slot_id++) {
+        r += m_num_chunks[slot_id];
     }
     return r;
 }
 
+double small_object_allocator::get_occupancy() const {
+    size_t used  = 0;
+    size_t total = 0;
+    for (unsigned slot_id = 1; slot_id < NUM_SLOTS; slot_id++) {
+        size_t slot_obj_size = slot_id << PTR_ALIGNMENT;
+        for (chunk * c = m_chunks[slot_id]; c != 0; c = c->m_next) {
+            used += c->m_curr - c->m_data;
+        }
+        used  -= slot_obj_size * m_num_free[slot_id];
+        total += m_num_chunks[slot_id] * static_cast<size_t>(CHUNK_SIZE);
+    }
+    if (total == 0)
+        return 100.0;
+    return (100.0 * used) / total;
+}
+
+void small_object_allocator::collect_statistics(statistics & st) const {
+    st.update("allocator chunks", static_cast<unsigned>(get_num_chunks()));
+    st.update("allocator free objs", static_cast<unsigned>(get_num_free_objs()));
+    st.update("allocator occupancy", get_occupancy());
+    st.update("allocator reclaimed chunks", m_num_reclaimed);
+    m_chunk_alloc.collect_statistics(st);
+}
+
 template<typename T>
 struct ptr_lt {
     bool operator()(T * p1, T * p2) const { return p1 < p2; }
 };
 
-#define CONSOLIDATE_VB_LVL 20
-
-void small_object_allocator::consolidate() {
-    IF_VERBOSE(CONSOLIDATE_VB_LVL, 
-               verbose_stream() << "(allocator-consolidate :wasted-size " << get_wasted_size()
-               << " :memory " << std::fixed << std::setprecision(2) << 
-               static_cast<double>(memory::get_allocation_size())/static_cast<double>(1024*1024) << ")" << std::endl;);
-    ptr_vector<chunk> chunks;
-    ptr_vector<char> free_objs;
-    for (unsigned slot_id = 1; slot_id < NUM_SLOTS; slot_id++) {
-        if (m_free_list[slot_id] == 0)
-            continue;
-        chunks.reset();
-        free_objs.reset();
-        chunk * c = m_chunks[slot_id];
-        while (c != 0) {
+/**
+   \brief Release the chunks of the given slot that only contain free objects.
+   The chunk at the head of the list is where new objects are carved from,
+   it is kept and rewound instead of being released.
+*/
+void small_object_allocator::reclaim(unsigned slot_id) {
+    unsigned obj_size = slot_id << PTR_ALIGNMENT;
+    if (m_free_list[slot_id] != 0) {
+        ptr_vector<chunk> chunks;
+        ptr_vector<char> free_objs;
+        chunk * head = m_chunks[slot_id];
+        SASSERT(head != 0);
+        for (chunk * c = head->m_next; c != 0; c = c->m_next) {
             chunks.push_back(c);
-            c = c->m_next;
         }
+        chunks.push_back(head);
         char * ptr = static_cast<char*>(m_free_list[slot_id]);
         while (ptr != 0) {
             free_objs.push_back(ptr);
             ptr = *(reinterpret_cast<char**>(ptr));
         }
-        unsigned obj_size = slot_id << PTR_ALIGNMENT;
-        unsigned num_objs_per_chunk = CHUNK_SIZE / obj_size;
-        if (free_objs.size() < num_objs_per_chunk)
-            continue;
-        SASSERT(!chunks.empty());
         std::sort(chunks.begin(), chunks.end(), ptr_lt<chunk>());
         std::sort(free_objs.begin(), free_objs.end(), ptr_lt<char>());
         chunk *   last_chunk = 0;
         void * last_free_obj = 0;
-        unsigned chunk_idx = 0;
-        unsigned obj_idx   = 0;
-        unsigned num_chunks = chunks.size();
-        unsigned num_objs   = free_objs.size();
-        while (chunk_idx < num_chunks) {
+        unsigned num_free    = 0;
+        unsigned obj_idx     = 0;
+        unsigned num_objs    = free_objs.size();
+        for (unsigned chunk_idx = 0; chunk_idx < chunks.size(); chunk_idx++) {
             chunk * curr_chunk = chunks[chunk_idx];
-            char *  curr_begin = curr_chunk->m_data;
-            char *  curr_end   = curr_begin + CHUNK_SIZE;
+            char *  curr_end   = curr_chunk->m_data + CHUNK_SIZE;
+            unsigned num_carved = static_cast<unsigned>(curr_chunk->m_curr - curr_chunk->m_data) / obj_size;
             unsigned num_free_in_chunk = 0;
             unsigned saved_obj_idx = obj_idx;
-            while (obj_idx < num_objs) {
-                char * free_obj = free_objs[obj_idx];
-                if (free_obj > curr_end)
-                    break;
+            while (obj_idx < num_objs && free_objs[obj_idx] < curr_end) {
+                SASSERT(free_objs[obj_idx] >= curr_chunk->m_data);
                 obj_idx++;
                 num_free_in_chunk++;
             }
-            if (num_free_in_chunk == num_objs_per_chunk) {
-                dealloc(curr_chunk);
+            if (num_free_in_chunk == num_carved && curr_chunk == head) {
+                // all objects carved from the head chunk are free
+                head->m_curr = head->m_data;
+            }
+            else if (num_free_in_chunk == num_carved) {
+                m_chunk_alloc.deallocate_chunk(curr_chunk);
+                m_num_chunks[slot_id]--;
+                m_num_reclaimed++;
             }
             else {
-                curr_chunk->m_next = last_chunk;
-                last_chunk = curr_chunk;
+                if (curr_chunk != head) {
+                    curr_chunk->m_next = last_chunk;
+                    last_chunk = curr_chunk;
+                }
                 for (unsigned i = saved_obj_idx; i < obj_idx; i++) {
                     // relink objects
                     void * free_obj = free_objs[i];
                     *(reinterpret_cast<void**>(free_obj)) = last_free_obj;
                     last_free_obj = free_obj;
+                    num_free++;
                 }
             }
-            chunk_idx++;
         }
-        m_chunks[slot_id]    = last_chunk;
+        SASSERT(obj_idx == num_objs);
+        head->m_next = last_chunk;
         m_free_list[slot_id] = last_free_obj;
+        m_num_free[slot_id]  = num_free;
+    }
+    // try again when a significant fraction of the slot is free, 
+    // or the number of free objects doubled.
+    unsigned limit = std::max(4 * objs_per_chunk(slot_id), 2 * m_num_free[slot_id]);
+    limit = std::max(limit, m_num_chunks[slot_id] * objs_per_chunk(slot_id) / 8);
+    m_reclaim_limit[slot_id] = limit;
+}
+
+#define CONSOLIDATE_VB_LVL 20
+
+void small_object_allocator::consolidate() {
+    IF_VERBOSE(CONSOLIDATE_VB_LVL, 
+               verbose_stream() << "(allocator-consolidate :wasted-size " << get_wasted_size()
+               << " :memory " << std::fixed << std::setprecision(2) << 
+               static_cast<double>(memory::get_allocation_size())/static_cast<double>(1024*1024) << ")" << std::endl;);
+    for (unsigned slot_id = 1; slot_id < NUM_SLOTS; slot_id++) {
+        reclaim(slot_id);
     }
     IF_VERBOSE(CONSOLIDATE_VB_LVL, 
                verbose_stream() << "(end-allocator-consolidate :wasted-size " << get_wasted_size() 
@@ -22,6 +22,9 @@ Revision History:
 
 #include"machine.h"
 #include"debug.h"
+#include"chunk_allocator.h"
+
+class statistics;
 
 class small_object_allocator {
     static const unsigned CHUNK_SIZE     = (8192 - sizeof(void*)*2);
@@ -33,14 +36,26 @@ class small_object_allocator {
         char    m_data[CHUNK_SIZE];
         chunk():m_curr(m_data) {}
     };
+    chunk_allocator & m_chunk_alloc;
     chunk *     m_chunks[NUM_SLOTS];
     void  *     m_free_list[NUM_SLOTS];
+    unsigned    m_num_free[NUM_SLOTS];      // length of m_free_list
+    unsigned    m_num_chunks[NUM_SLOTS];
+    unsigned    m_reclaim_limit[NUM_SLOTS]; // chunks are reclaimed when m_num_free reaches this limit
     size_t      m_alloc_size;
+    unsigned    m_num_reclaimed;
 #ifdef Z3DEBUG
     char const * m_id;
 #endif
+    static unsigned objs_per_chunk(unsigned slot_id) { return CHUNK_SIZE / (slot_id << PTR_ALIGNMENT); }
+    void del_chunks(unsigned slot_id);
+    void reclaim(unsigned slot_id);
 public:
-    small_object_allocator(char const * id = "unknown");
+    /**
+       \brief Create an allocator that obtains its chunks from the given backend,
+       or from default_chunk_allocator() if it is 0.
+    */
+    small_object_allocator(char const * id = "unknown", chunk_allocator * a = 0);
     ~small_object_allocator();
     void reset();
     void * allocate(size_t size);
@@ -48,7 +63,21 @@ public:
     size_t get_allocation_size() const { return m_alloc_size; }
     size_t get_wasted_size() const;
     size_t get_num_free_objs() const;
+    static unsigned get_num_slots() { return NUM_SLOTS; }
+    size_t get_num_free_objs(unsigned slot_id) const { return m_num_free[slot_id]; }
+    size_t get_num_chunks(unsigned slot_id) const { return m_num_chunks[slot_id]; }
+    size_t get_num_chunks() const;
+    /**
+       \brief Return the percentage of the memory of chunks that is in use.
+    */
+    double get_occupancy() const;
+    /**
+       \brief Release the chunks that only contain free objects.
+       Chunks are also released automatically when the free objects of a slot
+       cover a significant fraction of its chunks.
+    */
     void consolidate();
+    void collect_statistics(statistics & st) const;
 };
 
 inline void * operator new(size_t s, small_object_allocator & r) { return r.allocate(s); }
@@ -27,23 +27,37 @@ const symbol symbol::null;
 
 /**
    \brief Symbol table manager. It stores the symbol strings created at runtime.
+
+   The table is split into stripes, each with its own lock, region and hashtable.
+   The stripe of a string is determined by its hash code, so a string
+   is always interned in the same stripe and pointer identity is preserved.
+   Threads creating different symbols rarely contend for the same lock.
 */
 class internal_symbol_table {
-    region        m_region; //!< Region used to store symbol strings.
-    str_hashtable m_table;  //!< Table of created symbol strings.
+    static const unsigned NUM_STRIPES = 64;
+    struct stripe {
+        omp_nest_lock_t m_lock;
+        region          m_region; //!< Region used to store symbol strings.
+        str_hashtable   m_table;  //!< Table of created symbol strings.
+        stripe() { omp_init_nest_lock(&m_lock); }
+        ~stripe() { omp_destroy_nest_lock(&m_lock); }
+    };
+    stripe m_stripes[NUM_STRIPES];
 public:
 
     char const * get_str(char const * d) {
         char * result;
-        #pragma omp critical (cr_symbol) 
-        {
+        size_t l   = strlen(d);
+        unsigned h = string_hash(d, static_cast<unsigned>(l), 17);
+        // the low bits of h select the bucket in the hashtable of the stripe.
+        stripe & s = m_stripes[(h >> 16) % NUM_STRIPES];
+        omp_set_nest_lock(&s.m_lock);
         char * r_d = const_cast<char *>(d);
         str_hashtable::entry * e;
-        if (m_table.insert_if_not_there_core(r_d, e)) {
+        if (s.m_table.insert_if_not_there_core(r_d, e)) {
             // new entry
-            size_t l   = strlen(d);
             // store the hash-code before the string
-            size_t * mem = static_cast<size_t*>(m_region.allocate(l + 1 + sizeof(size_t)));
+            size_t * mem = static_cast<size_t*>(s.m_region.allocate(l + 1 + sizeof(size_t)));
             *mem = e->get_hash();
             mem++;
             result = reinterpret_cast<char*>(mem);
@@ -54,8 +68,8 @@ public:
         else {
             result = e->get_data();
         }
-        SASSERT(m_table.contains(result));
-        }
+        SASSERT(s.m_table.contains(result));
+        omp_unset_nest_lock(&s.m_lock);
         return result;
     }
 };
@@ -0,0 +1,372 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    thread_pool.cpp
+
+Abstract:
+
+    Work-stealing thread pool shared by the parallel tactics.
+
+    Tasks are coarse grained (typically a tactic or a solver call),
+    so all queues are protected by a single lock.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#include"thread_pool.h"
+#include"memory_manager.h"
+#include"z3_exception.h"
+#include"vector.h"
+#include"util.h"
+#include"debug.h"
+
+#if defined(_WINDOWS)
+#include<windows.h>
+#define _USE_WIN_THREADS
+#elif defined(_LINUX_) || defined(_FREEBSD_) || (defined(__APPLE__) && defined(__MACH__))
+#include<pthread.h>
+#include<unistd.h>
+#define _USE_PTHREADS
+#else
+// Other platforms: tasks are executed by the threads that spawn them.
+#endif
+
+#if defined(_USE_WIN_THREADS)
+#define TP_THREAD_LOCAL __declspec(thread)
+#else
+#define TP_THREAD_LOCAL __thread
+#endif
+
+namespace {
+
+    class tp_lock {
+#if defined(_USE_WIN_THREADS)
+        CRITICAL_SECTION m_cs;
+    public:
+        CRITICAL_SECTION & cs() { return m_cs; }
+        tp_lock() { InitializeCriticalSection(&m_cs); }
+        ~tp_lock() { DeleteCriticalSection(&m_cs); }
+        void lock() { EnterCriticalSection(&m_cs); }
+        void unlock() { LeaveCriticalSection(&m_cs); }
+#elif defined(_USE_PTHREADS)
+        pthread_mutex_t m_mutex;
+    public:
+        pthread_mutex_t & mutex() { return m_mutex; }
+        tp_lock() { pthread_mutex_init(&m_mutex, NULL); }
+        ~tp_lock() { pthread_mutex_destroy(&m_mutex); }
+        void lock() { pthread_mutex_lock(&m_mutex); }
+        void unlock() { pthread_mutex_unlock(&m_mutex); }
+#else
+    public:
+        void lock() {}
+        void unlock() {}
+#endif
+    };
+
+    class tp_cond {
+#if defined(_USE_WIN_THREADS)
+        CONDITION_VARIABLE m_cond;
+    public:
+        tp_cond() { InitializeConditionVariable(&m_cond); }
+        void wait(tp_lock & l) { SleepConditionVariableCS(&m_cond, &l.cs(), INFINITE); }
+        void signal() { WakeConditionVariable(&m_cond); }
+        void broadcast() { WakeAllConditionVariable(&m_cond); }
+#elif defined(_USE_PTHREADS)
+        pthread_cond_t m_cond;
+    public:
+        tp_cond() { pthread_cond_init(&m_cond, NULL); }
+        ~tp_cond() { pthread_cond_destroy(&m_cond); }
+        void wait(tp_lock & l) { pthread_cond_wait(&m_cond, &l.mutex()); }
+        void signal() { pthread_cond_signal(&m_cond); }
+        void broadcast() { pthread_cond_broadcast(&m_cond); }
+#else
+    public:
+        void wait(tp_lock & l) { UNREACHABLE(); }
+        void signal() {}
+        void broadcast() {}
+#endif
+    };
+
+    struct task_entry {
+        task *       m_task;
+        task_group * m_group;
+    };
+
+    /**
+       \brief Queue of the tasks spawned by a thread.
+       The owner pushes and pops at the back, thieves steal from the front.
+    */
+    struct work_queue {
+        svector<task_entry> m_tasks;
+        unsigned            m_head;
+        work_queue(): m_head(0) {}
+        bool empty() const { return m_head == m_tasks.size(); }
+        void compact() {
+            if (empty()) {
+                m_tasks.reset();
+                m_head = 0;
+            }
+        }
+    };
+
+    tp_lock                g_task_lock;      // used by scoped_task_lock.
+    tp_lock                g_lock;           // protects all fields below and the queues.
+    tp_cond                g_work;           // signaled when tasks are queued or workers must exit.
+    tp_cond                g_done;           // signaled when a task group completes or a worker exits.
+    ptr_vector<work_queue> g_queues;
+    unsigned               g_num_queued   = 0;
+    unsigned               g_num_workers  = 0;
+    unsigned               g_max_threads  = 0;
+    unsigned               g_steal_start  = 0;
+    unsigned               g_generation   = 1;  // incremented by finalize, invalidates the thread local queues.
+    bool                   g_stop         = false;
+
+    TP_THREAD_LOCAL work_queue * t_queue     = 0;
+    TP_THREAD_LOCAL unsigned     t_queue_gen = 0;
+
+    unsigned num_processors() {
+#if defined(_USE_WIN_THREADS)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwNumberOfProcessors;
+#elif defined(_USE_PTHREADS)
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        return n > 0 ? static_cast<unsigned>(n) : 1;
+#else
+        return 1;
+#endif
+    }
+
+    // maximal number of workers, the waiting threads also execute tasks.
+    unsigned max_workers() {
+#if (defined(_USE_WIN_THREADS) || defined(_USE_PTHREADS)) && !defined(_NO_OMP_)
+        unsigned n = g_max_threads == 0 ? num_processors() : g_max_threads;
+        return n - 1;
+#else
+        return 0;
+#endif
+    }
+};
+
+struct thread_pool_imp {
+
+    // g_lock is held.
+    static work_queue & own_queue() {
+        if (t_queue == 0 || t_queue_gen != g_generation) {
+            t_queue = alloc(work_queue);
+            t_queue_gen = g_generation;
+            g_queues.push_back(t_queue);
+        }
+        return *t_queue;
+    }
+
+    // g_lock is held.
+    static bool steal(task_entry & e) {
+        unsigned sz = g_queues.size();
+        for (unsigned i = 0; i < sz; ++i) {
+            work_queue & q = *g_queues[(g_steal_start + i) % sz];
+            if (!q.empty()) {
+                e = q.m_tasks[q.m_head++];
+                q.compact();
+                g_steal_start++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // g_lock is held.
+    static bool pop(task_group & g, task_entry & e) {
+        if (t_queue == 0 || t_queue_gen != g_generation || t_queue->empty() || t_queue->m_tasks.back().m_group != &g)
+            return false;
+        e = t_queue->m_tasks.back();
+        t_queue->m_tasks.pop_back();
+        t_queue->compact();
+        return true;
+    }
+
+    // g_lock is not held.
+    static void execute(task_entry const & e) {
+        task_group & g = *e.m_group;
+        memory_budget * old_budget = memory::set_thread_budget(g.m_budget);
+        bool failed = false;
+        std::string msg;
+        try {
+            (*e.m_task)();
+        }
+        catch (z3_exception & ex) {
+            failed = true;
+            msg = ex.msg();
+        }
+        memory::set_thread_budget(old_budget);
+        g_lock.lock();
+        if (failed && !g.m_failed) {
+            g.m_failed = true;
+            g.m_ex_msg = msg;
+        }
+        if (--g.m_num_pending == 0)
+            g_done.broadcast();
+        g_lock.unlock();
+    }
+
+#if defined(_USE_WIN_THREADS) || defined(_USE_PTHREADS)
+    static void worker_loop() {
+        g_lock.lock();
+        while (!g_stop && g_num_workers <= max_workers()) {
+            task_entry e;
+            if (g_num_queued > 0 && steal(e)) {
+                g_num_queued--;
+                g_lock.unlock();
+                execute(e);
+                g_lock.lock();
+            }
+            else {
+                g_work.wait(g_lock);
+            }
+        }
+        g_num_workers--;
+        g_done.broadcast();
+        g_lock.unlock();
+    }
+#endif
+
+#if defined(_USE_WIN_THREADS)
+    static DWORD WINAPI worker_proc(LPVOID) {
+        worker_loop();
+        return 0;
+    }
+#elif defined(_USE_PTHREADS)
+    static void * worker_proc(void *) {
+        worker_loop();
+        return 0;
+    }
+#endif
+
+    // g_lock is held.
+    static void ensure_workers() {
+        unsigned target = max_workers();
+        while (g_num_workers < target) {
+#if defined(_USE_WIN_THREADS)
+            HANDLE h = CreateThread(NULL, 0, worker_proc, NULL, 0, NULL);
+            if (h == NULL)
+                return;
+            CloseHandle(h);
+#elif defined(_USE_PTHREADS)
+            pthread_t t;
+            if (pthread_create(&t, NULL, worker_proc, 0) != 0)
+                return;
+            pthread_detach(t);
+#endif
+            g_num_workers++;
+        }
+    }
+
+    static void spawn(task_group & g, task & t) {
+        task_entry e;
+        e.m_task  = &t;
+        e.m_group = &g;
+        g_lock.lock();
+        g.m_num_pending++;
+        ensure_workers();
+        if (g_num_workers == 0) {
+            // no worker can steal the task.
+            g_lock.unlock();
+            execute(e);
+            return;
+        }
+        own_queue().m_tasks.push_back(e);
+        g_num_queued++;
+        g_work.signal();
+        g_lock.unlock();
+    }
+
+    static void wait(task_group & g) {
+        g_lock.lock();
+        while (g.m_num_pending > 0) {
+            task_entry e;
+            if (pop(g, e)) {
+                g_num_queued--;
+                g_lock.unlock();
+                execute(e);
+                g_lock.lock();
+            }
+            else {
+                // the remaining tasks of g were stolen.
+                g_done.wait(g_lock);
+            }
+        }
+        bool failed = g.m_failed;
+        std::string msg = g.m_ex_msg;
+        g.m_failed = false;
+        g_lock.unlock();
+        if (failed)
+            throw default_exception(msg);
+    }
+};
+
+task_group::task_group():
+    m_num_pending(0),
+    m_budget(memory::get_thread_budget()),
+    m_failed(false) {
+}
+
+task_group::~task_group() {
+    try {
+        if (m_num_pending > 0)
+            thread_pool_imp::wait(*this);
+    }
+    catch (z3_exception &) {
+    }
+}
+
+void task_group::spawn(task & t) {
+    thread_pool_imp::spawn(*this, t);
+}
+
+void task_group::wait() {
+    thread_pool_imp::wait(*this);
+}
+
+scoped_task_lock::scoped_task_lock() {
+    g_task_lock.lock();
+}
+
+scoped_task_lock::~scoped_task_lock() {
+    g_task_lock.unlock();
+}
+
+void thread_pool::set_max_threads(unsigned n) {
+    g_lock.lock();
+    g_max_threads = n;
+    // workers above the bound exit.
+    g_work.broadcast();
+    g_lock.unlock();
+}
+
+unsigned thread_pool::get_max_threads() {
+    g_lock.lock();
+    unsigned r = max_workers() + 1;
+    g_lock.unlock();
+    return r;
+}
+
+void thread_pool::finalize() {
+    g_lock.lock();
+    g_stop = true;
+    g_work.broadcast();
+    while (g_num_workers > 0)
+        g_done.wait(g_lock);
+    SASSERT(g_num_queued == 0);
+    for (unsigned i = 0; i < g_queues.size(); ++i)
+        dealloc(g_queues[i]);
+    g_queues.finalize();
+    g_generation++;
+    g_stop = false;
+    g_lock.unlock();
+}
@@ -0,0 +1,88 @@
+/*++
+Copyright (c) 2017 Microsoft Corporation
+
+Module Name:
+
+    thread_pool.h
+
+Abstract:
+
+    Work-stealing thread pool shared by the parallel tactics.
+
+    Every thread that spawns tasks owns a queue. Tasks are pushed to
+    and popped from the back of the queue of the spawning thread,
+    idle workers steal tasks from the front of the queues.
+    A thread waiting for a task group executes the tasks of the group
+    that were not stolen yet, so task groups can be nested without
+    losing parallelism and without blocking workers.
+
+    The number of workers is bounded for the whole process (see thread_pool::set_max_threads).
+    Without OpenMP the global data-structures of Z3 are not protected by
+    critical sections, so all tasks run in the thread that spawns them.
+
+Author:
+
+
+
+Revision History:
+
+--*/
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include<string>
+
+class memory_budget;
+
+class task {
+public:
+    virtual ~task() {}
+    virtual void operator()() = 0;
+};
+
+/**
+   \brief Set of tasks that are awaited together.
+
+   Only the thread that created the group may spawn tasks in it.
+   The tasks must outlive the group, or at least the call to wait.
+   A task should not throw exceptions, the message of a z3_exception that
+   escapes a task is rethrown by wait as a default_exception.
+*/
+class task_group {
+    friend struct thread_pool_imp;
+    volatile unsigned m_num_pending;   // tasks that were spawned and did not finish.
+    memory_budget *   m_budget;        // memory budget of the thread that created the group.
+    bool              m_failed;
+    std::string       m_ex_msg;
+public:
+    task_group();
+    ~task_group();
+    void spawn(task & t);
+    void wait();
+};
+
+/**
+   \brief Critical section for short updates of state shared by tasks.
+*/
+class scoped_task_lock {
+public:
+    scoped_task_lock();
+    ~scoped_task_lock();
+};
+
+class thread_pool {
+public:
+    /**
+       \brief Bound the number of threads executing tasks, including the threads that wait for tasks.
+       0 means the number of processors. With the bound 1 all tasks run in the thread that waits for them.
+    */
+    static void set_max_threads(unsigned n);
+    static unsigned get_max_threads();
+    static void finalize();
+};
+
+/*
+  ADD_FINALIZER('thread_pool::finalize();')
+*/
+
+#endif /* THREAD_POOL_H_ */